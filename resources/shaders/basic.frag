@@ -1,6 +1,19 @@
 #version 460
+#extension GL_GOOGLE_include_directive : enable
 
+// Keywords: BINDLESS_TEXTURES (define), VERTEX_COLORS (specialization constant 0)
+
+#ifdef BINDLESS_TEXTURES
+#extension GL_EXT_nonuniform_qualifier : require
+
+#include "include/draw_data.glsl"
+
+layout(set=1, binding=0) uniform sampler2D textures[];
+#else
 layout(binding=1) uniform sampler2D texture_sampler;
+#endif
+
+layout(constant_id=0) const bool vertex_colors = true;
 
 layout(location=0) in vec4 v_color;
 layout(location=1) in vec2 v_uv;
@@ -9,5 +22,14 @@ layout(location=0) out vec4 output_color;
 
 void main()
 {
-	output_color = texture(texture_sampler, v_uv) * v_color;
+#ifdef BINDLESS_TEXTURES
+	output_color = texture(textures[nonuniformEXT(draw_data.material_index)], v_uv);
+#else
+	output_color = texture(texture_sampler, v_uv);
+#endif
+
+	if (vertex_colors)
+	{
+		output_color *= v_color;
+	}
 }
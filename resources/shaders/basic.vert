@@ -1,8 +1,10 @@
 #version 460
+#extension GL_GOOGLE_include_directive : enable
+
+#include "include/draw_data.glsl"
 
 layout(binding=0) uniform CameraData
 {
-    mat4 model;
     mat4 view;
     mat4 projection;
 } cam_data;
@@ -11,12 +13,20 @@ layout(location=0) in vec3 a_position;
 layout(location=1) in vec3 a_color;
 layout(location=2) in vec2 a_uv;
 
+// Per-instance model matrix, one column per location
+layout(location=3) in vec4 a_instance_model_0;
+layout(location=4) in vec4 a_instance_model_1;
+layout(location=5) in vec4 a_instance_model_2;
+layout(location=6) in vec4 a_instance_model_3;
+
 layout(location=0) out vec4 v_color;
 layout(location=1) out vec2 v_uv;
 
 void main()
 {
-	gl_Position = cam_data.projection * cam_data.view * cam_data.model * vec4(a_position, 1.0);
+	mat4 instance_model = mat4(a_instance_model_0, a_instance_model_1, a_instance_model_2, a_instance_model_3);
+
+	gl_Position = cam_data.projection * cam_data.view * draw_data.model * instance_model * vec4(a_position, 1.0);
     v_color = vec4(a_color, 1.0);
     v_uv = a_uv;
 }
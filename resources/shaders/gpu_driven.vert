@@ -0,0 +1,31 @@
+#version 460
+#extension GL_GOOGLE_include_directive : enable
+
+#include "include/gpu_scene.glsl"
+
+layout(binding=0) uniform CameraData
+{
+    mat4 view;
+    mat4 projection;
+} cam_data;
+
+layout(binding=2) readonly buffer Objects
+{
+	GpuObject objects[];
+};
+
+layout(location=0) in vec3 a_position;
+layout(location=1) in vec3 a_color;
+layout(location=2) in vec2 a_uv;
+
+layout(location=0) out vec4 v_color;
+layout(location=1) out vec2 v_uv;
+
+void main()
+{
+	GpuObject object = objects[gl_InstanceIndex];
+
+	gl_Position = cam_data.projection * cam_data.view * object.model * vec4(a_position, 1.0);
+    v_color = vec4(a_color, 1.0);
+    v_uv = a_uv;
+}
@@ -0,0 +1,8 @@
+// Per-draw data, shared by every stage so all stages agree on the push constant layout
+// Keep in sync with "DrawData" in renderer.cpp
+layout(push_constant) uniform DrawData
+{
+	mat4 model;
+	uint material_index;
+	uint object_id;
+} draw_data;
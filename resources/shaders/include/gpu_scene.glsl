@@ -0,0 +1,16 @@
+// Scene data of the GPU-driven path, keep in sync with "GpuObject" and "GpuMesh" in gpu_driven_scene.hpp
+struct GpuObject
+{
+	mat4 model;
+	vec4 bounding_sphere;	// World space center (xyz) and radius (w)
+	uint mesh_index;
+	uint material_index;
+	uint padding_0;
+	uint padding_1;
+};
+
+struct GpuMesh
+{
+	uint first_vertex;
+	uint vertex_count;
+};
@@ -0,0 +1,172 @@
+// Application
+#include "file_watcher.hpp"
+#include "miscellaneous/exceptions.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <algorithm>
+#include <system_error>
+
+#ifdef __linux__
+// Linux
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif // __linux__
+
+using namespace vkc::core;
+
+FileWatcher::FileWatcher() noexcept(true)
+#ifdef __linux__
+	: m_inotify_descriptor(-1)
+#endif // __linux__
+{}
+
+FileWatcher::~FileWatcher() noexcept(true)
+{}
+
+void FileWatcher::Create() noexcept(false)
+{
+#ifdef __linux__
+	m_inotify_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (m_inotify_descriptor < 0)
+	{
+		throw exception::CriticalIOError("Could not create an inotify instance.");
+	}
+#endif // __linux__
+}
+
+void FileWatcher::Destroy() noexcept(true)
+{
+#ifdef __linux__
+	if (m_inotify_descriptor >= 0)
+	{
+		// Closing the instance removes all of its watches
+		close(m_inotify_descriptor);
+		m_inotify_descriptor = -1;
+	}
+
+	m_watched_directories.clear();
+#else
+	m_write_times.clear();
+#endif // __linux__
+
+	m_watched_files.clear();
+}
+
+void FileWatcher::Watch(const std::string& path) noexcept(true)
+{
+	const auto normalized_path = NormalizePath(path);
+
+	if (!m_watched_files.insert(normalized_path).second)
+	{
+		return;
+	}
+
+#ifdef __linux__
+	auto directory = std::filesystem::path(normalized_path).parent_path().generic_string();
+
+	if (directory.empty())
+	{
+		directory = ".";
+	}
+
+	const auto is_watched = std::any_of(
+		m_watched_directories.begin(),
+		m_watched_directories.end(),
+		[&directory](const auto& watched_directory)
+		{
+			return watched_directory.second == directory;
+		});
+
+	if (is_watched)
+	{
+		return;
+	}
+
+	// Editors often write a temporary file and move it over the original, so the directory is watched instead of the file
+	const auto watch_descriptor = inotify_add_watch(m_inotify_descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+
+	if (watch_descriptor < 0)
+	{
+		spdlog::warn("Could not watch directory \"{}\", changes to \"{}\" are not detected.", directory, normalized_path);
+		return;
+	}
+
+	m_watched_directories[watch_descriptor] = directory;
+#else
+	std::error_code error;
+	m_write_times[normalized_path] = std::filesystem::last_write_time(normalized_path, error);
+#endif // __linux__
+}
+
+std::vector<std::string> FileWatcher::GetChangedFiles() noexcept(true)
+{
+	std::vector<std::string> changed_files;
+
+	const auto add_changed_file = [this, &changed_files](const std::string& path)
+	{
+		if (m_watched_files.count(path) > 0 &&
+			std::find(changed_files.begin(), changed_files.end(), path) == changed_files.end())
+		{
+			changed_files.push_back(path);
+		}
+	};
+
+#ifdef __linux__
+	if (m_inotify_descriptor < 0)
+	{
+		return changed_files;
+	}
+
+	alignas(inotify_event) char buffer[4096];
+
+	// Non-blocking, reading stops once all pending events have been consumed
+	for (;;)
+	{
+		const auto read_size = read(m_inotify_descriptor, buffer, sizeof(buffer));
+
+		if (read_size <= 0)
+		{
+			break;
+		}
+
+		for (ssize_t offset = 0; offset < read_size;)
+		{
+			const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			auto directory = m_watched_directories.find(event->wd);
+
+			if (event->len == 0 || directory == m_watched_directories.end())
+			{
+				continue;
+			}
+
+			add_changed_file(NormalizePath(directory->second + "/" + event->name));
+		}
+	}
+#else
+	for (auto& [path, write_time] : m_write_times)
+	{
+		std::error_code error;
+		const auto current_write_time = std::filesystem::last_write_time(path, error);
+
+		// Files that are being replaced may be missing for a moment, they are picked up on the next poll
+		if (!error && current_write_time != write_time)
+		{
+			write_time = current_write_time;
+			add_changed_file(path);
+		}
+	}
+#endif // __linux__
+
+	return changed_files;
+}
+
+std::string FileWatcher::NormalizePath(const std::string& path) noexcept(true)
+{
+	return std::filesystem::path(path).lexically_normal().generic_string();
+}
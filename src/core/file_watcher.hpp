@@ -0,0 +1,58 @@
+#ifndef FILE_WATCHER_HPP
+#define FILE_WATCHER_HPP
+
+// C++ standard
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace vkc::core
+{
+	/** Reports files that have been written to since the last poll */
+	/**
+	 * On Linux, the directories of the watched files are watched through
+	 * inotify, which also catches editors that save by replacing the file.
+	 * On other platforms, the modification times of the watched files are
+	 * compared on every poll instead.
+	 *
+	 * Paths are normalized with "NormalizePath", so "./a/../b.glsl" and
+	 * "b.glsl" refer to the same file. Not thread-safe.
+	 */
+	class FileWatcher
+	{
+	public:
+		FileWatcher() noexcept(true);
+		~FileWatcher() noexcept(true);
+
+		/** Start watching, throws when the platform watcher cannot be created */
+		void Create() noexcept(false);
+
+		/** Stop watching all files */
+		void Destroy() noexcept(true);
+
+		/** Watch a file, watching a file twice has no effect */
+		void Watch(const std::string& path) noexcept(true);
+
+		/** Get the watched files that changed since the previous call, never blocks */
+		std::vector<std::string> GetChangedFiles() noexcept(true);
+
+		/** Turn a path into the form the watcher reports it in */
+		static std::string NormalizePath(const std::string& path) noexcept(true);
+
+	private:
+		std::unordered_set<std::string> m_watched_files;
+
+#ifdef __linux__
+		/** Inotify instance, the watch descriptor of every watched directory maps to its path */
+		int m_inotify_descriptor;
+		std::unordered_map<int, std::string> m_watched_directories;
+#else
+		/** Modification time of every watched file at the previous poll */
+		std::unordered_map<std::string, std::filesystem::file_time_type> m_write_times;
+#endif // __linux__
+	};
+}
+
+#endif // FILE_WATCHER_HPP
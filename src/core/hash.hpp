@@ -0,0 +1,43 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+// C++ standard
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace vkc::core
+{
+	/** Starting value of a 64-bit FNV-1a hash */
+	static const constexpr std::uint64_t fnv1a_offset_basis = 0xcbf29ce484222325ull;
+
+	/** Multiplier of a 64-bit FNV-1a hash */
+	static const constexpr std::uint64_t fnv1a_prime = 0x100000001b3ull;
+
+	/** Hash a block of memory using 64-bit FNV-1a */
+	/**
+	 * Pass the result of a previous call as "hash" to hash multiple blocks of
+	 * memory as if they were a single block.
+	 */
+	inline std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t hash = fnv1a_offset_basis) noexcept(true)
+	{
+		auto bytes = static_cast<const unsigned char*>(data);
+
+		for (std::size_t index = 0; index < size; ++index)
+		{
+			hash ^= static_cast<std::uint64_t>(bytes[index]);
+			hash *= fnv1a_prime;
+		}
+
+		return hash;
+	}
+
+	/** Mix the hash of a value into an existing hash */
+	template<class T>
+	inline void HashCombine(std::uint64_t& hash, const T& value) noexcept(true)
+	{
+		hash ^= static_cast<std::uint64_t>(std::hash<T>{}(value)) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+	}
+}
+
+#endif // HASH_HPP
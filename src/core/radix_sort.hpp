@@ -0,0 +1,79 @@
+#ifndef RADIX_SORT_HPP
+#define RADIX_SORT_HPP
+
+// C++ standard
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace vkc::core
+{
+	/** Sort indices into "keys" by ascending key using a least significant digit radix sort (stable) */
+	/**
+	 * Keys are processed one byte at a time. Bytes that are identical for
+	 * every key do not affect the order, those passes are skipped, so keys
+	 * that only use a few of their bits sort in fewer passes.
+	 *
+	 * "indices" receives the sorted order, "scratch" is used as the second
+	 * buffer, pass in the same vectors every time to avoid allocations.
+	 */
+	inline void RadixSortIndices(
+		const std::vector<std::uint64_t>& keys,
+		std::vector<std::uint32_t>& indices,
+		std::vector<std::uint32_t>& scratch) noexcept(false)
+	{
+		static const constexpr std::uint32_t byte_count = sizeof(std::uint64_t);
+		static const constexpr std::uint32_t bucket_count = 256;
+
+		indices.resize(keys.size());
+		scratch.resize(keys.size());
+		std::iota(indices.begin(), indices.end(), 0);
+
+		if (keys.size() < 2)
+		{
+			return;
+		}
+
+		// Histograms of all bytes are built in a single pass over the keys
+		std::array<std::array<std::uint32_t, bucket_count>, byte_count> histograms = {};
+
+		for (auto key : keys)
+		{
+			for (std::uint32_t byte = 0; byte < byte_count; ++byte)
+			{
+				++histograms[byte][(key >> (byte * 8)) & 0xFF];
+			}
+		}
+
+		for (std::uint32_t byte = 0; byte < byte_count; ++byte)
+		{
+			auto& histogram = histograms[byte];
+
+			// All keys fall into the same bucket, this byte does not change the order
+			if (histogram[(keys[0] >> (byte * 8)) & 0xFF] == keys.size())
+			{
+				continue;
+			}
+
+			// Turn the counts into the first output position of every bucket
+			std::uint32_t offset = 0;
+
+			for (auto& count : histogram)
+			{
+				const auto bucket_size = count;
+				count = offset;
+				offset += bucket_size;
+			}
+
+			for (auto index : indices)
+			{
+				scratch[histogram[(keys[index] >> (byte * 8)) & 0xFF]++] = index;
+			}
+
+			indices.swap(scratch);
+		}
+	}
+}
+
+#endif // RADIX_SORT_HPP
@@ -0,0 +1,128 @@
+#ifndef SNAPSHOT_BUFFER_HPP
+#define SNAPSHOT_BUFFER_HPP
+
+// C++ standard
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace vkc::core
+{
+	/** Two consecutive simulation states, used by the render thread to interpolate */
+	template<class STATE>
+	struct Snapshot
+	{
+		STATE previous = {};
+		STATE current = {};
+
+		/** Simulation time (in seconds) at which the "previous" state was produced */
+		double previous_time = 0.0;
+
+		/** Simulation time (in seconds) at which the "current" state was produced */
+		double current_time = 0.0;
+	};
+
+	/** Lock-free triple buffer that hands simulation snapshots to the render thread */
+	/**
+	 * One thread (the simulation thread) publishes snapshots, another thread
+	 * (the render thread) consumes them. The writer always owns the "back"
+	 * slot, the reader always owns the "front" slot, and the "middle" slot is
+	 * exchanged atomically between the two. Neither thread ever blocks the
+	 * other, and the reader always sees the most recently published snapshot.
+	 *
+	 * Every published snapshot carries both the newest and the one-but-newest
+	 * simulation state, which allows the reader to interpolate between them
+	 * even when it skips snapshots.
+	 */
+	template<class STATE>
+	class SnapshotBuffer
+	{
+	public:
+		SnapshotBuffer() noexcept(true)
+			: m_middle(MIDDLE_SLOT_INITIAL)
+			, m_back(BACK_SLOT_INITIAL)
+			, m_front(FRONT_SLOT_INITIAL)
+			, m_has_published(false)
+		{}
+
+		~SnapshotBuffer() noexcept(true) {}
+
+		/** Publish a new simulation state (simulation thread only) */
+		void Publish(const STATE& state, double simulation_time) noexcept(true)
+		{
+			auto& slot = m_slots[m_back];
+
+			if (m_has_published)
+			{
+				slot.previous = m_last_published.current;
+				slot.previous_time = m_last_published.current_time;
+			}
+			else
+			{
+				// Nothing to interpolate from yet, use the same state twice
+				slot.previous = state;
+				slot.previous_time = simulation_time;
+			}
+
+			slot.current = state;
+			slot.current_time = simulation_time;
+
+			m_last_published = slot;
+			m_has_published = true;
+
+			// Hand the back slot over to the reader and mark it as fresh
+			auto old_middle = m_middle.exchange(
+				static_cast<std::uint8_t>(m_back | FRESH_BIT),
+				std::memory_order_acq_rel);
+
+			m_back = static_cast<std::uint8_t>(old_middle & SLOT_MASK);
+		}
+
+		/** Get hold of the most recent snapshot (render thread only) */
+		/**
+		 * Returns false when no new snapshot has been published since the
+		 * previous call. The reference stays valid (and unchanged) until the
+		 * next call to this function.
+		 */
+		bool Acquire(const Snapshot<STATE>*& snapshot) noexcept(true)
+		{
+			bool is_fresh = false;
+
+			if (m_middle.load(std::memory_order_acquire) & FRESH_BIT)
+			{
+				// Swap the front slot with the middle slot, clearing the fresh bit
+				auto old_middle = m_middle.exchange(m_front, std::memory_order_acq_rel);
+				m_front = static_cast<std::uint8_t>(old_middle & SLOT_MASK);
+				is_fresh = true;
+			}
+
+			snapshot = &m_slots[m_front];
+			return is_fresh;
+		}
+
+	private:
+		static const constexpr std::uint8_t FRONT_SLOT_INITIAL	= 0;
+		static const constexpr std::uint8_t MIDDLE_SLOT_INITIAL	= 1;
+		static const constexpr std::uint8_t BACK_SLOT_INITIAL	= 2;
+
+		static const constexpr std::uint8_t SLOT_MASK	= 0x3;
+		static const constexpr std::uint8_t FRESH_BIT	= 0x4;
+
+		std::array<Snapshot<STATE>, 3> m_slots;
+
+		/** Shared between both threads, lower bits are the slot index, FRESH_BIT marks unread data */
+		std::atomic<std::uint8_t> m_middle;
+
+		/** Owned by the writer */
+		std::uint8_t m_back;
+		Snapshot<STATE> m_last_published;
+
+		/** Owned by the reader */
+		std::uint8_t m_front;
+
+		/** Owned by the writer */
+		bool m_has_published;
+	};
+}
+
+#endif // SNAPSHOT_BUFFER_HPP
@@ -0,0 +1,79 @@
+// Application
+#include "thread_pool.hpp"
+
+// C++ standard
+#include <algorithm>
+
+using namespace vkc::core;
+
+ThreadPool::ThreadPool() noexcept(true)
+	: m_is_running(false)
+{}
+
+ThreadPool::~ThreadPool() noexcept(true)
+{}
+
+void ThreadPool::Create(std::uint32_t thread_count) noexcept(false)
+{
+	if (thread_count == 0)
+	{
+		// Leave one hardware thread for the render thread
+		auto hardware_thread_count = std::thread::hardware_concurrency();
+		thread_count = (std::max)(hardware_thread_count, 2u) - 1;
+	}
+
+	m_is_running = true;
+	m_workers.reserve(thread_count);
+
+	for (std::uint32_t index = 0; index < thread_count; ++index)
+	{
+		m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+void ThreadPool::Destroy() noexcept(true)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobs_mutex);
+		m_is_running = false;
+	}
+
+	// Wake up every worker, they will finish the remaining jobs before exiting
+	m_jobs_available.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+
+	m_workers.clear();
+}
+
+std::uint32_t ThreadPool::GetThreadCount() const noexcept(true)
+{
+	return static_cast<std::uint32_t>(m_workers.size());
+}
+
+void ThreadPool::WorkerLoop() noexcept(true)
+{
+	while (true)
+	{
+		std::function<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(m_jobs_mutex);
+			m_jobs_available.wait(lock, [this]() { return !m_is_running || !m_jobs.empty(); });
+
+			// Only exit once the queue has been drained
+			if (m_jobs.empty())
+			{
+				return;
+			}
+
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+
+		job();
+	}
+}
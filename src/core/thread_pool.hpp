@@ -0,0 +1,80 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+// C++ standard
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace vkc::core
+{
+	/** Fixed-size pool of worker threads that execute jobs in FIFO order */
+	class ThreadPool
+	{
+	public:
+		ThreadPool() noexcept(true);
+		~ThreadPool() noexcept(true);
+
+		/** Start the worker threads */
+		/**
+		 * When "thread_count" is zero, one thread less than the number of
+		 * hardware threads is used (leaving room for the render thread), with
+		 * a minimum of one worker thread.
+		 */
+		void Create(std::uint32_t thread_count = 0) noexcept(false);
+
+		/** Finish all queued jobs and join the worker threads */
+		void Destroy() noexcept(true);
+
+		/** Queue a job, the returned future becomes ready once the job has been executed */
+		/**
+		 * Exceptions thrown by the job are stored in the future and rethrown
+		 * when "get()" is called on it.
+		 */
+		template<class FUNCTION>
+		std::future<std::invoke_result_t<FUNCTION>> Enqueue(FUNCTION&& job) noexcept(false);
+
+		/** Get the number of worker threads */
+		std::uint32_t GetThreadCount() const noexcept(true);
+
+	private:
+		/** Worker thread entry point */
+		void WorkerLoop() noexcept(true);
+
+	private:
+		std::vector<std::thread> m_workers;
+		std::deque<std::function<void()>> m_jobs;
+
+		std::mutex m_jobs_mutex;
+		std::condition_variable m_jobs_available;
+
+		bool m_is_running;
+	};
+
+	template<class FUNCTION>
+	inline std::future<std::invoke_result_t<FUNCTION>> ThreadPool::Enqueue(FUNCTION&& job) noexcept(false)
+	{
+		using RESULT = std::invoke_result_t<FUNCTION>;
+
+		// Packaged tasks cannot be copied, std::function requires a copyable callable
+		auto task = std::make_shared<std::packaged_task<RESULT()>>(std::forward<FUNCTION>(job));
+		auto future = task->get_future();
+
+		{
+			std::lock_guard<std::mutex> lock(m_jobs_mutex);
+			m_jobs.emplace_back([task]() { (*task)(); });
+		}
+
+		m_jobs_available.notify_one();
+		return future;
+	}
+}
+
+#endif // THREAD_POOL_HPP
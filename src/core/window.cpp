@@ -1,9 +1,11 @@
 // Application
 #include "miscellaneous/exceptions.hpp"
+#include "miscellaneous/global_settings.hpp"
 #include "window.hpp"
 
 // C++ standard
 #include <chrono>
+#include <thread>
 
 using namespace vkc;
 using namespace std::chrono;
@@ -80,7 +82,7 @@ void Window::OnUpdate(
 }
 
 void Window::OnDraw(
-	std::function<void()> callback) noexcept(true)
+	std::function<void(double render_time)> callback) noexcept(true)
 {
 	m_draw_callback = callback;
 }
@@ -98,31 +100,32 @@ void Window::EnterMainLoop() const noexcept(true)
 		m_initialization_callback();
 	}
 
-	auto old_time = high_resolution_clock::now();
+	const auto start_time = high_resolution_clock::now();
+	const auto interpolation_delay = duration<double>(global_settings::simulation_timestep);
+
+	// Run the simulation on its own thread, the render thread only consumes its results
+	std::atomic<bool> is_running(true);
+	std::thread simulation_thread(&Window::RunSimulationLoop, this, std::cref(is_running), start_time);
 
 	while (!glfwWindowShouldClose(m_window_handle))
 	{
 		// Check for input
 		PollInput();
 
-		// Timestep calculations
-		auto new_time = high_resolution_clock::now();
-		auto delta_time = static_cast<double>((new_time - old_time).count());
-		old_time = new_time;
-
-		// Update
-		if (m_update_callback)
-		{
-			m_update_callback(delta_time);
-		}
+		// Render one simulation timestep in the past, this way there is always a state to interpolate towards
+		auto render_time = duration<double>(high_resolution_clock::now() - start_time) - interpolation_delay;
 
 		// Render
 		if (m_draw_callback)
 		{
-			m_draw_callback();
+			m_draw_callback(render_time.count());
 		}
 	}
 
+	// Stop the simulation before shutting down
+	is_running = false;
+	simulation_thread.join();
+
 	// Shut-down
 	if (m_shut_down_callback)
 	{
@@ -134,6 +137,43 @@ void Window::EnterMainLoop() const noexcept(true)
 	glfwTerminate();
 }
 
+void Window::RunSimulationLoop(
+	const std::atomic<bool>& is_running,
+	high_resolution_clock::time_point start_time) const noexcept(true)
+{
+	const auto timestep = duration_cast<high_resolution_clock::duration>(
+		duration<double>(global_settings::simulation_timestep));
+
+	auto next_update_time = start_time;
+
+	while (is_running)
+	{
+		auto current_time = high_resolution_clock::now();
+		std::uint32_t update_count = 0;
+
+		// Catch up with the wall clock using fixed-size steps
+		while (current_time >= next_update_time &&
+			update_count < global_settings::maximum_simulation_steps_per_update)
+		{
+			if (m_update_callback)
+			{
+				m_update_callback(global_settings::simulation_timestep);
+			}
+
+			next_update_time += timestep;
+			++update_count;
+		}
+
+		// The simulation cannot keep up, drop the remaining time instead of spiraling out of control
+		if (update_count == global_settings::maximum_simulation_steps_per_update)
+		{
+			next_update_time = current_time + timestep;
+		}
+
+		std::this_thread::sleep_until(next_update_time);
+	}
+}
+
 void Window::PollInput() const noexcept(true)
 {
 	glfwPollEvents();
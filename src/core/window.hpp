@@ -5,6 +5,8 @@
 #include <GLFW/glfw3.h>
 
 // C++ standard
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <string>
 
@@ -43,14 +45,26 @@ namespace vkc
 		/** Register the update callback function */
 		/**
 		 * All updates should be performed when this callback is called.
+		 *
+		 * The callback runs on a dedicated simulation thread at a fixed
+		 * timestep (see "global_settings::simulation_timestep"). The delta
+		 * time passed to the callback is that timestep, in seconds. State that
+		 * is shared with the draw callback has to be handed over in a
+		 * thread-safe manner, e.g. by using a "core::SnapshotBuffer".
 		 */
 		void OnUpdate(std::function<void(double)> callback) noexcept(true);
 
 		/** Register the draw callback function */
 		/**
 		 * All rendering should be performed when this callback is called.
+		 *
+		 * The callback runs on the main (render) thread as often as possible.
+		 * The value passed to the callback is the simulation time (in seconds)
+		 * that should be rendered. It lags one simulation timestep behind the
+		 * wall clock, which guarantees that two simulation states are
+		 * available to interpolate between.
 		 */
-		void OnDraw(std::function<void()> callback) noexcept(true);
+		void OnDraw(std::function<void(double)> callback) noexcept(true);
 
 		/** Register the shut-down callback function */
 		/**
@@ -63,9 +77,11 @@ namespace vkc
 		/**
 		 * The application main loop starts running when this function is called.
 		 * The initialization callback is called first. After that finishes, the
-		 * application enter an update/draw loop that keeps on going until the
-		 * window "Stop" function is called, after which the shut-down callback
-		 * is called.
+		 * simulation thread is started, which calls the update callback at a
+		 * fixed timestep. Meanwhile, the calling thread polls input and calls
+		 * the draw callback. This keeps on going until the window "Stop"
+		 * function is called, after which the simulation thread is joined and
+		 * the shut-down callback is called.
 		 */
 		void EnterMainLoop() const noexcept(true);
 
@@ -105,10 +121,15 @@ namespace vkc
 			int new_width,
 			int new_height) noexcept(true);
 
+		/** Simulation thread entry point, calls the update callback at a fixed timestep */
+		void RunSimulationLoop(
+			const std::atomic<bool>& is_running,
+			std::chrono::high_resolution_clock::time_point start_time) const noexcept(true);
+
 	private:
 		GLFWwindow* m_window_handle;
 
-		std::function<void()> m_draw_callback;
+		std::function<void(double render_time)> m_draw_callback;
 		std::function<void()> m_initialization_callback;
 		std::function<void()> m_shut_down_callback;
 		std::function<void(double delta_time)> m_update_callback;
@@ -48,15 +48,12 @@ int main(int argc, char* argv[])
 
 	// Application update
 	window.OnUpdate([&renderer](double delta_time) {
-		// Prevent "unreferenced formal parameter" warning from triggering
-		delta_time;
-
-		renderer.Update();
+		renderer.Update(delta_time);
 	});
 
 	// Application rendering
-	window.OnDraw([&renderer, &window]() {
-		renderer.Draw(window);
+	window.OnDraw([&renderer, &window](double render_time) {
+		renderer.Draw(window, render_time);
 	});
 
 	// Application clean-up
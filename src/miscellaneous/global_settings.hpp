@@ -2,6 +2,9 @@
 
 //////////////////////////////////////////////////////////////////////////
 
+// Application
+#include "vulkanic_literals.hpp"
+
 // C++ standard
 #include <array>
 #include <string>
@@ -27,6 +30,152 @@ namespace vkc::global_settings
 
 	static const constexpr std::uint32_t maximum_in_flight_frame_count = 2;
 
+	/** Command buffers (and fences) of the immediate submit context, one-off uploads wait for the oldest one when all are in flight */
+	static const constexpr std::uint32_t immediate_submit_command_buffer_count = 4;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Simulation
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Fixed simulation timestep in seconds */
+	static const constexpr double simulation_timestep = 1.0 / 60.0;
+
+	/** Upper limit of simulation steps taken to catch up with the wall clock */
+	static const constexpr std::uint32_t maximum_simulation_steps_per_update = 5;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Texture streaming
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Maximum number of texture bytes uploaded per frame, keeps streaming from causing hitches */
+	static const constexpr std::size_t texture_upload_budget_per_frame = 32_MB;
+
+	/** Upper limit of device-local memory used by streamed textures, the heap budget reported by the driver may lower it */
+	static const constexpr std::size_t texture_memory_budget = 512_MB;
+
+	/** Mip levels are only streamed back in while texture memory usage stays below this fraction of the budget */
+	static const constexpr double texture_stream_in_budget_fraction = 0.9;
+
+	/** Maximum number of mip level evictions and stream-ins started per frame */
+	static const constexpr std::uint32_t maximum_texture_residency_changes_per_frame = 4;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Descriptor allocation
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Number of descriptor sets that fit in the first pool of a pool chain */
+	static const constexpr std::uint32_t initial_descriptor_sets_per_pool = 64;
+
+	/** Every new pool in a chain holds twice as many sets as the previous one, up to this limit */
+	static const constexpr std::uint32_t maximum_descriptor_sets_per_pool = 4096;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Bindless textures
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Sample textures through one large descriptor array instead of a descriptor set per draw (opt-in) */
+	/**
+	 * Needs VK_EXT_descriptor_indexing, the renderer falls back to regular
+	 * descriptor sets when the device does not support it.
+	 */
+	static const constexpr bool use_bindless_textures = false;
+
+	/** Number of slots in the bindless texture array, the device limits may lower it */
+	static const constexpr std::uint32_t maximum_bindless_texture_count = 16384;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Instancing
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Number of instances the instance buffer of every frame can hold before it needs to grow */
+	static const constexpr std::uint32_t initial_instance_count_per_frame = 1024;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Depth buffer
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Draw the depth of every mesh first, so the fragment shader only runs for the nearest surface of every pixel */
+	static const constexpr bool use_depth_prepass = true;
+
+	/** Count the fragment shader invocations of the main pass, with and without the depth prepass (opt-in) */
+	/**
+	 * Needs the pipelineStatisticsQuery device feature. The depth prepass
+	 * is switched on and off while measuring, the averages of both are
+	 * logged when the renderer is destroyed.
+	 */
+	static const constexpr bool measure_fragment_shader_invocations = false;
+
+	/** Number of frames rendered in a row with (or without) the depth prepass while measuring */
+	static const constexpr std::uint32_t fragment_measurement_interval = 120;
+
+	/** Screen-filling layers drawn back to front on top of the scene, causes heavy overdraw (zero disables them) */
+	static const constexpr std::uint32_t overdraw_test_layer_count = 0;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Multisampling
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Samples per pixel of the main pass (power of two), the device limits may lower it, one disables multisampling */
+	/**
+	 * Multisampled attachments only live in the main pass and are resolved
+	 * by the render pass, so they are lazily allocated where possible.
+	 */
+	static const constexpr std::uint32_t msaa_sample_count = 4;
+
+	//////////////////////////////////////////////////////////////////////////
+	// GPU-driven rendering
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Draw a static scene that is culled and turned into indirect draws by a compute shader (opt-in) */
+	static const constexpr bool use_gpu_driven_rendering = false;
+
+	/** Number of objects in the GPU-driven demo scene */
+	static const constexpr std::uint32_t gpu_driven_object_count = 100000;
+
+	/** Threads per work group of the GPU culling shader */
+	static const constexpr std::uint32_t gpu_cull_work_group_size = 64;
+
+	//////////////////////////////////////////////////////////////////////////
+	// CPU frustum culling
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Number of objects in a scene that is frustum culled on the CPU and drawn through the instance batcher, zero disables it */
+	static const constexpr std::uint32_t cpu_culled_object_count = 0;
+
+	/** Objects per chunk of the CPU culling pass, every chunk is culled by a single thread (multiple of eight) */
+	static const constexpr std::uint32_t cpu_cull_chunk_size = 16384;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Async compute
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Submit compute work (GPU culling) on the compute queue, so it can overlap with graphics work */
+	static const constexpr bool use_async_compute = true;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Pipeline compilation
+	//////////////////////////////////////////////////////////////////////////
+
+	/** Compile pipelines on the worker threads, draws are skipped until their pipeline is ready */
+	static const constexpr bool use_async_pipeline_compilation = true;
+
+	/** File the driver's pipeline cache is stored in between runs */
+	static const constexpr char* pipeline_cache_path = "./pipeline_cache.bin";
+
+	/** Frames that take longer than this (in milliseconds) are counted as hitches */
+	static const constexpr double frame_hitch_threshold_ms = 50.0;
+
+	/** Recompile shaders whose sources (or included files) change on disk, and swap in their pipelines (opt-in) */
+	/**
+	 * Watches the shader directory and recompiles on the worker threads,
+	 * meant for iterating on shaders. Has no effect in builds without
+	 * runtime shader compilation.
+	 */
+	static const constexpr bool enable_shader_hot_reload = false;
+
+	/** Shader stages baked by the shader baker, stages missing from the bundle are compiled from source */
+	static const constexpr char* shader_bundle_path = "./resources/shaders/shaders.spvbundle";
+
 	//////////////////////////////////////////////////////////////////////////
 	// Vulkan validation layers
 	//////////////////////////////////////////////////////////////////////////
@@ -51,4 +200,13 @@ namespace vkc::global_settings
 		// ADD ADDITIONAL REQUIRED EXTENSION NAMES HERE
 		"VK_KHR_swapchain"
 	};
+
+	/** Device extensions that are enabled when available, the renderer works without them */
+	static const std::vector<std::string> optional_device_extension_names =
+	{
+		// ADD ADDITIONAL OPTIONAL EXTENSION NAMES HERE
+		"VK_EXT_memory_budget",
+		"VK_EXT_descriptor_indexing",
+		"VK_KHR_draw_indirect_count"
+	};
 }
\ No newline at end of file
@@ -0,0 +1,491 @@
+// Application
+#include "frustum_culler.hpp"
+#include "miscellaneous/global_settings.hpp"
+
+// GLM
+#include <glm/geometric.hpp>
+
+// C++ standard
+#include <algorithm>
+#include <cmath>
+
+// SSE is part of every x86-64 CPU, AVX2 is detected at runtime and compiled for just the functions that use it
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define VKC_FRUSTUM_CULLER_SIMD
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define VKC_TARGET_AVX2
+#else
+#define VKC_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+using namespace vkc;
+
+namespace
+{
+	static_assert(global_settings::cpu_cull_chunk_size > 0 && global_settings::cpu_cull_chunk_size % 8 == 0, "Chunks have to hold whole AVX2 registers.");
+
+	/** Plane of the frustum, with the absolute normal that projects the box extents onto the normal */
+	struct CullPlane
+	{
+		float normal_x;
+		float normal_y;
+		float normal_z;
+		float distance;
+		float absolute_normal_x;
+		float absolute_normal_y;
+		float absolute_normal_z;
+	};
+
+	std::array<CullPlane, 6> MakeCullPlanes(const std::array<glm::vec4, 6>& frustum_planes)
+	{
+		std::array<CullPlane, 6> planes = {};
+
+		for (std::size_t index = 0; index < planes.size(); ++index)
+		{
+			const auto& plane = frustum_planes[index];
+			planes[index] = { plane.x, plane.y, plane.z, plane.w, std::fabs(plane.x), std::fabs(plane.y), std::fabs(plane.z) };
+		}
+
+		return planes;
+	}
+
+	/** Append the objects of a SIMD register whose bit is set in the mask */
+	void AppendVisibleLanes(int mask, std::uint32_t first_object, std::uint32_t lane_count, std::vector<CullObjectHandle>& visible_objects)
+	{
+		for (std::uint32_t lane = 0; lane < lane_count; ++lane)
+		{
+			if ((mask & (1 << lane)) != 0)
+			{
+				visible_objects.push_back(first_object + lane);
+			}
+		}
+	}
+
+	/** Tests one object at a time */
+	void CullScalar(
+		const std::array<CullPlane, 6>& planes,
+		const float* center_x, const float* center_y, const float* center_z,
+		const float* extent_x, const float* extent_y, const float* extent_z,
+		const float* radius,
+		std::uint32_t first_object,
+		std::uint32_t end_object,
+		std::vector<CullObjectHandle>& visible_objects)
+	{
+		for (auto object = first_object; object < end_object; ++object)
+		{
+			auto is_visible = true;
+
+			for (const auto& plane : planes)
+			{
+				const auto distance = plane.normal_x * center_x[object] + plane.normal_y * center_y[object] + plane.normal_z * center_z[object] + plane.distance;
+				const auto box_radius = plane.absolute_normal_x * extent_x[object] + plane.absolute_normal_y * extent_y[object] + plane.absolute_normal_z * extent_z[object];
+
+				// Outside when the smaller of the two volumes is completely behind the plane
+				if (distance + (std::min)(radius[object], box_radius) < 0.0f)
+				{
+					is_visible = false;
+					break;
+				}
+			}
+
+			if (is_visible)
+			{
+				visible_objects.push_back(object);
+			}
+		}
+	}
+
+#ifdef VKC_FRUSTUM_CULLER_SIMD
+	/** Tests four objects at a time, returns the first object that has not been tested */
+	std::uint32_t CullSSE(
+		const std::array<CullPlane, 6>& planes,
+		const float* center_x, const float* center_y, const float* center_z,
+		const float* extent_x, const float* extent_y, const float* extent_z,
+		const float* radius,
+		std::uint32_t first_object,
+		std::uint32_t end_object,
+		std::vector<CullObjectHandle>& visible_objects)
+	{
+		const auto zero = _mm_setzero_ps();
+		auto object = first_object;
+
+		for (; object + 4 <= end_object; object += 4)
+		{
+			const auto x = _mm_loadu_ps(center_x + object);
+			const auto y = _mm_loadu_ps(center_y + object);
+			const auto z = _mm_loadu_ps(center_z + object);
+			const auto ex = _mm_loadu_ps(extent_x + object);
+			const auto ey = _mm_loadu_ps(extent_y + object);
+			const auto ez = _mm_loadu_ps(extent_z + object);
+			const auto r = _mm_loadu_ps(radius + object);
+
+			auto inside = _mm_cmpeq_ps(zero, zero);
+
+			for (const auto& plane : planes)
+			{
+				auto distance = _mm_mul_ps(_mm_set1_ps(plane.normal_x), x);
+				distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normal_y), y));
+				distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normal_z), z));
+				distance = _mm_add_ps(distance, _mm_set1_ps(plane.distance));
+
+				auto box_radius = _mm_mul_ps(_mm_set1_ps(plane.absolute_normal_x), ex);
+				box_radius = _mm_add_ps(box_radius, _mm_mul_ps(_mm_set1_ps(plane.absolute_normal_y), ey));
+				box_radius = _mm_add_ps(box_radius, _mm_mul_ps(_mm_set1_ps(plane.absolute_normal_z), ez));
+
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, _mm_min_ps(r, box_radius)), zero));
+
+				// All four objects are outside, the remaining planes do not matter
+				if (_mm_movemask_ps(inside) == 0)
+				{
+					break;
+				}
+			}
+
+			AppendVisibleLanes(_mm_movemask_ps(inside), object, 4, visible_objects);
+		}
+
+		return object;
+	}
+
+	/** Tests eight objects at a time, returns the first object that has not been tested */
+	VKC_TARGET_AVX2 std::uint32_t CullAVX2(
+		const std::array<CullPlane, 6>& planes,
+		const float* center_x, const float* center_y, const float* center_z,
+		const float* extent_x, const float* extent_y, const float* extent_z,
+		const float* radius,
+		std::uint32_t first_object,
+		std::uint32_t end_object,
+		std::vector<CullObjectHandle>& visible_objects)
+	{
+		const auto zero = _mm256_setzero_ps();
+		auto object = first_object;
+
+		for (; object + 8 <= end_object; object += 8)
+		{
+			const auto x = _mm256_loadu_ps(center_x + object);
+			const auto y = _mm256_loadu_ps(center_y + object);
+			const auto z = _mm256_loadu_ps(center_z + object);
+			const auto ex = _mm256_loadu_ps(extent_x + object);
+			const auto ey = _mm256_loadu_ps(extent_y + object);
+			const auto ez = _mm256_loadu_ps(extent_z + object);
+			const auto r = _mm256_loadu_ps(radius + object);
+
+			auto inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+
+			for (const auto& plane : planes)
+			{
+				auto distance = _mm256_mul_ps(_mm256_set1_ps(plane.normal_x), x);
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.normal_y), y));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.normal_z), z));
+				distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.distance));
+
+				auto box_radius = _mm256_mul_ps(_mm256_set1_ps(plane.absolute_normal_x), ex);
+				box_radius = _mm256_add_ps(box_radius, _mm256_mul_ps(_mm256_set1_ps(plane.absolute_normal_y), ey));
+				box_radius = _mm256_add_ps(box_radius, _mm256_mul_ps(_mm256_set1_ps(plane.absolute_normal_z), ez));
+
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, _mm256_min_ps(r, box_radius)), zero, _CMP_GE_OQ));
+
+				// All eight objects are outside, the remaining planes do not matter
+				if (_mm256_movemask_ps(inside) == 0)
+				{
+					break;
+				}
+			}
+
+			AppendVisibleLanes(_mm256_movemask_ps(inside), object, 8, visible_objects);
+		}
+
+		return object;
+	}
+
+	bool SupportsAVX2()
+	{
+#if defined(_MSC_VER)
+		int registers[4] = {};
+
+		// The OS has to save the AVX registers (OSXSAVE, then the YMM state in XCR0)
+		__cpuid(registers, 1);
+
+		if ((registers[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		__cpuidex(registers, 7, 0);
+		return (registers[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+}
+
+FrustumCuller::FrustumCuller() noexcept(true)
+	: m_implementation(CullingImplementation::Scalar)
+{
+	if (IsSupported(CullingImplementation::AVX2))
+	{
+		m_implementation = CullingImplementation::AVX2;
+	}
+	else if (IsSupported(CullingImplementation::SSE))
+	{
+		m_implementation = CullingImplementation::SSE;
+	}
+}
+
+FrustumCuller::~FrustumCuller() noexcept(true)
+{}
+
+CullObjectHandle FrustumCuller::Add(const glm::vec3& center, const glm::vec3& extents) noexcept(false)
+{
+	return Add(center, extents, glm::length(extents));
+}
+
+CullObjectHandle FrustumCuller::Add(const glm::vec3& center, const glm::vec3& extents, float radius) noexcept(false)
+{
+	m_center_x.push_back(center.x);
+	m_center_y.push_back(center.y);
+	m_center_z.push_back(center.z);
+	m_extent_x.push_back(extents.x);
+	m_extent_y.push_back(extents.y);
+	m_extent_z.push_back(extents.z);
+	m_radius.push_back(radius);
+
+	return static_cast<CullObjectHandle>(m_radius.size() - 1);
+}
+
+void FrustumCuller::Update(CullObjectHandle object, const glm::vec3& center, const glm::vec3& extents, float radius) noexcept(true)
+{
+	m_center_x[object] = center.x;
+	m_center_y[object] = center.y;
+	m_center_z[object] = center.z;
+	m_extent_x[object] = extents.x;
+	m_extent_y[object] = extents.y;
+	m_extent_z[object] = extents.z;
+	m_radius[object] = radius;
+}
+
+void FrustumCuller::Clear() noexcept(true)
+{
+	m_center_x.clear();
+	m_center_y.clear();
+	m_center_z.clear();
+	m_extent_x.clear();
+	m_extent_y.clear();
+	m_extent_z.clear();
+	m_radius.clear();
+
+	m_visible_objects.clear();
+}
+
+const std::vector<CullObjectHandle>& FrustumCuller::Cull(const glm::mat4& view_projection_matrix, core::ThreadPool* thread_pool) noexcept(false)
+{
+	m_visible_objects.clear();
+
+	const auto object_count = GetObjectCount();
+
+	if (object_count == 0)
+	{
+		return m_visible_objects;
+	}
+
+	// Jobs of a previous call that did not get to run yet still refer to the old batch
+	if (!m_batch || m_batch.use_count() > 1)
+	{
+		m_batch = std::make_shared<CullBatch>();
+	}
+
+	auto& batch = *m_batch;
+	batch.frustum_planes = ExtractFrustumPlanes(view_projection_matrix);
+	batch.implementation = m_implementation;
+	batch.center_x = m_center_x.data();
+	batch.center_y = m_center_y.data();
+	batch.center_z = m_center_z.data();
+	batch.extent_x = m_extent_x.data();
+	batch.extent_y = m_extent_y.data();
+	batch.extent_z = m_extent_z.data();
+	batch.radius = m_radius.data();
+	batch.object_count = object_count;
+	batch.chunk_count = (object_count + global_settings::cpu_cull_chunk_size - 1) / global_settings::cpu_cull_chunk_size;
+	batch.next_chunk = 0;
+	batch.completed_chunk_count = 0;
+
+	// Reserved up front, culling a chunk never allocates
+	if (batch.chunk_results.size() < batch.chunk_count)
+	{
+		batch.chunk_results.resize(batch.chunk_count);
+	}
+
+	for (std::uint32_t chunk = 0; chunk < batch.chunk_count; ++chunk)
+	{
+		batch.chunk_results[chunk].reserve(global_settings::cpu_cull_chunk_size);
+	}
+
+	// The calling thread culls chunks as well, so one worker less than the number of chunks is enough
+	if (thread_pool != nullptr && batch.chunk_count > 1)
+	{
+		const auto worker_count = (std::min)(thread_pool->GetThreadCount(), batch.chunk_count - 1);
+
+		for (std::uint32_t worker = 0; worker < worker_count; ++worker)
+		{
+			thread_pool->Enqueue([batch = m_batch]() { CullChunks(*batch); });
+		}
+	}
+
+	CullChunks(batch);
+
+	// Only chunks that have been claimed by a worker are waited for
+	{
+		std::unique_lock<std::mutex> lock(batch.mutex);
+		batch.chunks_completed.wait(lock, [&batch]() { return batch.completed_chunk_count == batch.chunk_count; });
+	}
+
+	for (std::uint32_t chunk = 0; chunk < batch.chunk_count; ++chunk)
+	{
+		const auto& chunk_result = batch.chunk_results[chunk];
+		m_visible_objects.insert(m_visible_objects.end(), chunk_result.begin(), chunk_result.end());
+	}
+
+	return m_visible_objects;
+}
+
+bool FrustumCuller::SetImplementation(CullingImplementation implementation) noexcept(true)
+{
+	if (!IsSupported(implementation))
+	{
+		return false;
+	}
+
+	m_implementation = implementation;
+	return true;
+}
+
+CullingImplementation FrustumCuller::GetImplementation() const noexcept(true)
+{
+	return m_implementation;
+}
+
+std::uint32_t FrustumCuller::GetObjectCount() const noexcept(true)
+{
+	return static_cast<std::uint32_t>(m_radius.size());
+}
+
+bool FrustumCuller::IsSupported(CullingImplementation implementation) noexcept(true)
+{
+	switch (implementation)
+	{
+#ifdef VKC_FRUSTUM_CULLER_SIMD
+	case CullingImplementation::SSE:
+		return true;
+
+	case CullingImplementation::AVX2:
+		return SupportsAVX2();
+#endif
+
+	case CullingImplementation::Scalar:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+std::array<glm::vec4, 6> FrustumCuller::ExtractFrustumPlanes(const glm::mat4& view_projection_matrix) noexcept(true)
+{
+	// Gribb / Hartmann, rows of the matrix combined (GLM matrices are column-major)
+	const auto row_0 = glm::vec4(view_projection_matrix[0][0], view_projection_matrix[1][0], view_projection_matrix[2][0], view_projection_matrix[3][0]);
+	const auto row_1 = glm::vec4(view_projection_matrix[0][1], view_projection_matrix[1][1], view_projection_matrix[2][1], view_projection_matrix[3][1]);
+	const auto row_2 = glm::vec4(view_projection_matrix[0][2], view_projection_matrix[1][2], view_projection_matrix[2][2], view_projection_matrix[3][2]);
+	const auto row_3 = glm::vec4(view_projection_matrix[0][3], view_projection_matrix[1][3], view_projection_matrix[2][3], view_projection_matrix[3][3]);
+
+	// The near plane assumes a [-1, 1] depth range, which is conservative for a [0, 1] depth range as well
+	std::array<glm::vec4, 6> planes =
+	{
+		row_3 + row_0,	// Left
+		row_3 - row_0,	// Right
+		row_3 + row_1,	// Bottom
+		row_3 - row_1,	// Top
+		row_3 + row_2,	// Near
+		row_3 - row_2	// Far
+	};
+
+	// Normalized planes give real distances, which the sphere radius is compared against
+	for (auto& plane : planes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+
+	return planes;
+}
+
+void FrustumCuller::CullChunks(CullBatch& batch) noexcept(true)
+{
+	for (auto chunk = batch.next_chunk.fetch_add(1); chunk < batch.chunk_count; chunk = batch.next_chunk.fetch_add(1))
+	{
+		const auto first_object = chunk * global_settings::cpu_cull_chunk_size;
+		const auto end_object = (std::min)(first_object + global_settings::cpu_cull_chunk_size, batch.object_count);
+
+		auto& visible_objects = batch.chunk_results[chunk];
+		visible_objects.clear();
+
+		CullRange(batch, first_object, end_object, visible_objects);
+
+		std::lock_guard<std::mutex> lock(batch.mutex);
+
+		if (++batch.completed_chunk_count == batch.chunk_count)
+		{
+			batch.chunks_completed.notify_all();
+		}
+	}
+}
+
+void FrustumCuller::CullRange(
+	const CullBatch& batch,
+	std::uint32_t first_object,
+	std::uint32_t end_object,
+	std::vector<CullObjectHandle>& visible_objects) noexcept(true)
+{
+	const auto planes = MakeCullPlanes(batch.frustum_planes);
+	auto object = first_object;
+
+#ifdef VKC_FRUSTUM_CULLER_SIMD
+	if (batch.implementation == CullingImplementation::AVX2)
+	{
+		object = CullAVX2(
+			planes,
+			batch.center_x, batch.center_y, batch.center_z,
+			batch.extent_x, batch.extent_y, batch.extent_z,
+			batch.radius,
+			object,
+			end_object,
+			visible_objects);
+	}
+
+	// Also picks up the last four objects of the AVX2 path
+	if (batch.implementation != CullingImplementation::Scalar)
+	{
+		object = CullSSE(
+			planes,
+			batch.center_x, batch.center_y, batch.center_z,
+			batch.extent_x, batch.extent_y, batch.extent_z,
+			batch.radius,
+			object,
+			end_object,
+			visible_objects);
+	}
+#endif
+
+	// Objects that do not fill a whole register
+	CullScalar(
+		planes,
+		batch.center_x, batch.center_y, batch.center_z,
+		batch.extent_x, batch.extent_y, batch.extent_z,
+		batch.radius,
+		object,
+		end_object,
+		visible_objects);
+}
@@ -0,0 +1,156 @@
+#ifndef FRUSTUM_CULLER_HPP
+#define FRUSTUM_CULLER_HPP
+
+// Application
+#include "core/thread_pool.hpp"
+
+// GLM
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+// C++ standard
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vkc
+{
+	/** Index of an object added to the frustum culler */
+	using CullObjectHandle = std::uint32_t;
+
+	/** Code path that tests the bounding volumes against the frustum planes */
+	enum class CullingImplementation
+	{
+		Scalar,	// One object at a time, available everywhere
+		SSE,	// Four objects at a time (x86-64)
+		AVX2	// Eight objects at a time (x86-64 CPUs that support AVX2)
+	};
+
+	/** Tests the bounding volumes of many objects against the view frustum on the CPU */
+	/**
+	 * Every object has a bounding sphere and an axis-aligned bounding box
+	 * that share the same center. Both are stored as a structure of arrays,
+	 * so the SIMD paths load the same component of four (SSE) or eight
+	 * (AVX2) objects with a single instruction. An object is culled as soon
+	 * as either volume is completely outside of one of the planes, which is
+	 * tighter than testing only one of them.
+	 *
+	 * The fastest implementation the CPU supports is picked on creation,
+	 * the scalar path handles the objects that do not fill a whole SIMD
+	 * register.
+	 *
+	 * When a thread pool is passed to "Cull", the objects are split into
+	 * chunks that the calling thread and the worker threads take turns on.
+	 * The calling thread never waits for a worker that has not started yet,
+	 * so culling does not stall behind long jobs in the queue.
+	 */
+	class FrustumCuller
+	{
+	public:
+		FrustumCuller() noexcept(true);
+		~FrustumCuller() noexcept(true);
+
+		/** Add an object, "extents" are the half sizes of the box, the sphere radius defaults to the half diagonal of the box */
+		CullObjectHandle Add(const glm::vec3& center, const glm::vec3& extents) noexcept(false);
+
+		/** Add an object with a bounding sphere that is tighter than the half diagonal of its box */
+		CullObjectHandle Add(const glm::vec3& center, const glm::vec3& extents, float radius) noexcept(false);
+
+		/** Move an object, or change its bounding volumes */
+		void Update(CullObjectHandle object, const glm::vec3& center, const glm::vec3& extents, float radius) noexcept(true);
+
+		/** Remove all objects, memory is kept around */
+		void Clear() noexcept(true);
+
+		/** Test all objects against the frustum of a view projection matrix, returns the visible objects in ascending order */
+		/**
+		 * The returned list stays valid until the next call to "Cull". Chunks
+		 * are handed to the worker threads only when there is more than one
+		 * chunk.
+		 */
+		const std::vector<CullObjectHandle>& Cull(const glm::mat4& view_projection_matrix, core::ThreadPool* thread_pool = nullptr) noexcept(false);
+
+		/** Use a different implementation, returns false (and keeps the current one) when the CPU does not support it */
+		bool SetImplementation(CullingImplementation implementation) noexcept(true);
+
+		/** Implementation that is used by "Cull" */
+		CullingImplementation GetImplementation() const noexcept(true);
+
+		/** Number of objects that have been added */
+		std::uint32_t GetObjectCount() const noexcept(true);
+
+		/** Check whether the CPU (and the compiler) support an implementation */
+		static bool IsSupported(CullingImplementation implementation) noexcept(true);
+
+		/** Extract the six (inward facing, normalized) frustum planes out of a view projection matrix */
+		static std::array<glm::vec4, 6> ExtractFrustumPlanes(const glm::mat4& view_projection_matrix) noexcept(true);
+
+	private:
+		/** Shared by the calling thread and the worker threads of a single "Cull" call */
+		/**
+		 * Workers hold on to the batch until their job has run, which may be
+		 * after "Cull" returned. The batch is only reused once no job refers
+		 * to it anymore, and a job that does not claim a chunk does not touch
+		 * the bounding volumes.
+		 */
+		struct CullBatch
+		{
+			std::array<glm::vec4, 6> frustum_planes;
+			CullingImplementation implementation = CullingImplementation::Scalar;
+
+			/** Bounding volume arrays of the culler */
+			const float* center_x = nullptr;
+			const float* center_y = nullptr;
+			const float* center_z = nullptr;
+			const float* extent_x = nullptr;
+			const float* extent_y = nullptr;
+			const float* extent_z = nullptr;
+			const float* radius = nullptr;
+
+			std::uint32_t object_count = 0;
+			std::uint32_t chunk_count = 0;
+
+			/** Next chunk that has not been claimed by any thread */
+			std::atomic<std::uint32_t> next_chunk{ 0 };
+
+			/** Visible objects of every chunk, merged in chunk order once all chunks have been culled */
+			std::vector<std::vector<CullObjectHandle>> chunk_results;
+
+			std::mutex mutex;
+			std::condition_variable chunks_completed;
+			std::uint32_t completed_chunk_count = 0;
+		};
+
+		/** Claim and cull chunks until none are left */
+		static void CullChunks(CullBatch& batch) noexcept(true);
+
+		/** Append the visible objects in [first_object, end_object) to the list */
+		static void CullRange(
+			const CullBatch& batch,
+			std::uint32_t first_object,
+			std::uint32_t end_object,
+			std::vector<CullObjectHandle>& visible_objects) noexcept(true);
+
+	private:
+		/** Bounding volumes, one entry per object in every array */
+		std::vector<float> m_center_x;
+		std::vector<float> m_center_y;
+		std::vector<float> m_center_z;
+		std::vector<float> m_extent_x;
+		std::vector<float> m_extent_y;
+		std::vector<float> m_extent_z;
+		std::vector<float> m_radius;
+
+		std::shared_ptr<CullBatch> m_batch;
+		std::vector<CullObjectHandle> m_visible_objects;
+
+		CullingImplementation m_implementation;
+	};
+}
+
+#endif // FRUSTUM_CULLER_HPP
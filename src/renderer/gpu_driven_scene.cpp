@@ -0,0 +1,495 @@
+// Application
+#include "frustum_culler.hpp"
+#include "gpu_driven_scene.hpp"
+#include "miscellaneous/exceptions.hpp"
+#include "miscellaneous/global_settings.hpp"
+#include "vulkan_wrapper/vulkan_functions.hpp"
+#include "vulkan_wrapper/vulkan_utility.hpp"
+
+// GLM
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <algorithm>
+#include <cstring>
+
+using namespace vkc;
+using namespace vkc::exception;
+using namespace vkc::memory;
+using namespace vkc::vk_wrapper;
+
+namespace
+{
+	/** Create a device local buffer and record the copy that fills it through a staging buffer */
+	/**
+	 * The staging buffer is added to "staging_buffers", it has to be freed
+	 * once the copy has been executed.
+	 *
+	 * The copy is recorded on the graphics queue, buffers that are read by
+	 * another queue family as well use concurrent sharing, so their contents
+	 * stay defined without an ownership transfer.
+	 */
+	VulkanBuffer CreateDeviceLocalBuffer(
+		const VkCommandBuffer& command_buffer,
+		const void* data,
+		VkDeviceSize size,
+		VkBufferUsageFlags usage,
+		const std::vector<std::uint32_t>& shared_queue_families,
+		std::vector<VulkanBuffer>& staging_buffers) noexcept(false)
+	{
+		BufferAllocationInfo staging_buffer_alloc_info = {};
+		staging_buffer_alloc_info.buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		staging_buffer_alloc_info.buffer_create_info.size = size;
+		staging_buffer_alloc_info.buffer_create_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		staging_buffer_alloc_info.buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		staging_buffer_alloc_info.allocation_info.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+		staging_buffer_alloc_info.allocation_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+		auto staging_buffer = MemoryManager::GetInstance().Allocate(staging_buffer_alloc_info);
+		memcpy(staging_buffer.info.pMappedData, data, static_cast<size_t>(size));
+
+		BufferAllocationInfo buffer_alloc_info = {};
+		buffer_alloc_info.buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		buffer_alloc_info.buffer_create_info.size = size;
+		buffer_alloc_info.buffer_create_info.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		buffer_alloc_info.buffer_create_info.sharingMode = shared_queue_families.empty() ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT;
+		buffer_alloc_info.buffer_create_info.queueFamilyIndexCount = static_cast<std::uint32_t>(shared_queue_families.size());
+		buffer_alloc_info.buffer_create_info.pQueueFamilyIndices = shared_queue_families.data();
+
+		buffer_alloc_info.allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+		auto buffer = MemoryManager::GetInstance().Allocate(buffer_alloc_info);
+
+		func::RecordBufferCopy(command_buffer, staging_buffer, buffer);
+		staging_buffers.push_back(staging_buffer);
+
+		return buffer;
+	}
+
+	/** Create a device local buffer that is only written by the GPU */
+	/**
+	 * Buffers that are shared between queue families use concurrent sharing,
+	 * which saves the ownership transfers every frame.
+	 */
+	VulkanBuffer CreateGpuOnlyBuffer(
+		VkDeviceSize size,
+		VkBufferUsageFlags usage,
+		const std::vector<std::uint32_t>& shared_queue_families) noexcept(false)
+	{
+		BufferAllocationInfo buffer_alloc_info = {};
+		buffer_alloc_info.buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		buffer_alloc_info.buffer_create_info.size = size;
+		buffer_alloc_info.buffer_create_info.usage = usage;
+		buffer_alloc_info.buffer_create_info.sharingMode = shared_queue_families.empty() ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT;
+		buffer_alloc_info.buffer_create_info.queueFamilyIndexCount = static_cast<std::uint32_t>(shared_queue_families.size());
+		buffer_alloc_info.buffer_create_info.pQueueFamilyIndices = shared_queue_families.data();
+
+		buffer_alloc_info.allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+		return MemoryManager::GetInstance().Allocate(buffer_alloc_info);
+	}
+
+	VkBufferMemoryBarrier MakeBufferBarrier(VkBuffer buffer, VkAccessFlags source_access, VkAccessFlags destination_access) noexcept(true)
+	{
+		VkBufferMemoryBarrier barrier = {};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = source_access;
+		barrier.dstAccessMask = destination_access;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = buffer;
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+
+		return barrier;
+	}
+}
+
+GpuDrivenScene::GpuDrivenScene() noexcept(true)
+	: m_object_count(0)
+	, m_object_buffer({})
+	, m_mesh_buffer({})
+	, m_cull_pipeline_layout(VK_NULL_HANDLE)
+	, m_draw_pipeline_layout(VK_NULL_HANDLE)
+	, m_draw_set_layout(VK_NULL_HANDLE)
+	, m_draw_descriptor_template(nullptr)
+	, m_cmd_draw_indirect_count(nullptr)
+	, m_supports_multi_draw_indirect(false)
+	, m_max_draw_indirect_count(1)
+{}
+
+GpuDrivenScene::~GpuDrivenScene() noexcept(true)
+{}
+
+MeshHandle GpuDrivenScene::AddMesh(const std::vector<VertexPCT>& vertices) noexcept(false)
+{
+	GpuMesh mesh = {};
+	mesh.first_vertex = static_cast<std::uint32_t>(m_vertices.size());
+	mesh.vertex_count = static_cast<std::uint32_t>(vertices.size());
+
+	// Bounding sphere around the center of the vertices, not the tightest fit but cheap to compute
+	glm::vec3 center(0.0f);
+
+	for (const auto& vertex : vertices)
+	{
+		center += vertex.position;
+	}
+
+	center /= static_cast<float>(std::max<std::size_t>(vertices.size(), 1));
+
+	float radius = 0.0f;
+
+	for (const auto& vertex : vertices)
+	{
+		radius = std::max(radius, glm::length(vertex.position - center));
+	}
+
+	m_vertices.insert(m_vertices.end(), vertices.begin(), vertices.end());
+	m_meshes.push_back(mesh);
+	m_mesh_bounding_spheres.emplace_back(center, radius);
+
+	return static_cast<MeshHandle>(m_meshes.size() - 1);
+}
+
+void GpuDrivenScene::AddObject(MeshHandle mesh, std::uint32_t material_index, const glm::mat4& model_matrix) noexcept(false)
+{
+	const auto& local_sphere = m_mesh_bounding_spheres[mesh];
+
+	// Non-uniform scaling stretches the sphere, the largest axis scale keeps it conservative
+	const auto maximum_scale = std::max({
+		glm::length(glm::vec3(model_matrix[0])),
+		glm::length(glm::vec3(model_matrix[1])),
+		glm::length(glm::vec3(model_matrix[2])) });
+
+	GpuObject object = {};
+	object.model_matrix = model_matrix;
+	object.bounding_sphere = glm::vec4(glm::vec3(model_matrix * glm::vec4(glm::vec3(local_sphere), 1.0f)), local_sphere.w * maximum_scale);
+	object.mesh_index = mesh;
+	object.material_index = material_index;
+
+	m_objects.push_back(object);
+}
+
+void GpuDrivenScene::Build(
+	const VulkanDevice& device,
+	VulkanImmediateSubmitContext& immediate_submit,
+	VulkanLayoutCache& layout_cache,
+	VulkanDescriptorAllocator& descriptor_allocator,
+	std::uint32_t frame_count,
+	const std::vector<std::uint32_t>& shared_queue_families) noexcept(false)
+{
+	if (m_objects.empty())
+	{
+		throw CriticalVulkanError("Cannot build a GPU-driven scene without objects.");
+	}
+
+	// The vertex shader finds its object through the first instance of the draw command
+	if (!device.SupportsDrawIndirectFirstInstance())
+	{
+		throw CriticalVulkanError("The GPU-driven scene needs indirect draws with a first instance (drawIndirectFirstInstance).");
+	}
+
+	m_object_count = static_cast<std::uint32_t>(m_objects.size());
+
+	// Indirect draw capabilities decide how the draw commands are laid out
+	VkPhysicalDeviceProperties device_properties = {};
+	vkGetPhysicalDeviceProperties(device.GetPhysicalDeviceNative(), &device_properties);
+
+	m_supports_multi_draw_indirect = device.SupportsMultiDrawIndirect();
+	m_max_draw_indirect_count = m_supports_multi_draw_indirect ? device_properties.limits.maxDrawIndirectCount : 1;
+
+	// A single count draw has to be able to draw every object, otherwise the commands are split up without a count
+	if (device.SupportsDrawIndirectCount() && m_max_draw_indirect_count >= m_object_count)
+	{
+		m_cmd_draw_indirect_count = reinterpret_cast<PFN_vkCmdDrawIndirectCountKHR>(
+			vkGetDeviceProcAddr(device.GetLogicalDeviceNative(), "vkCmdDrawIndirectCountKHR"));
+	}
+
+	if (!m_supports_multi_draw_indirect)
+	{
+		spdlog::warn("Device does not support multi-draw indirect, the GPU-driven scene needs one draw call per object.");
+	}
+
+	// Upload the scene, it never changes after this
+	m_vertex_buffer.Create(device, immediate_submit, m_vertices);
+
+	std::vector<VulkanBuffer> staging_buffers;
+
+	// Both scene buffers are uploaded with a single submission, culling reads them on the compute queue
+	const auto& command_buffer = immediate_submit.Begin(device);
+	m_object_buffer = CreateDeviceLocalBuffer(command_buffer, m_objects.data(), sizeof(GpuObject) * m_objects.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, shared_queue_families, staging_buffers);
+	m_mesh_buffer = CreateDeviceLocalBuffer(command_buffer, m_meshes.data(), sizeof(GpuMesh) * m_meshes.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, shared_queue_families, staging_buffers);
+	immediate_submit.Submit(device);
+
+	for (const auto& staging_buffer : staging_buffers)
+	{
+		MemoryManager::GetInstance().Free(staging_buffer);
+	}
+
+	for (std::uint32_t frame_index = 0; frame_index < frame_count; ++frame_index)
+	{
+		m_draw_command_buffers.push_back(CreateGpuOnlyBuffer(
+			sizeof(VkDrawIndirectCommand) * m_object_count,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+			shared_queue_families));
+
+		m_draw_count_buffers.push_back(CreateGpuOnlyBuffer(
+			sizeof(std::uint32_t),
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			shared_queue_families));
+	}
+
+	spdlog::info("Uploaded a GPU-driven scene with {} object(s) and {} mesh(es).", m_object_count, m_meshes.size());
+
+	m_vertices.clear();
+	m_objects.clear();
+
+	// Culling pipeline, its descriptor sets only reference static buffers so they are written once
+	m_cull_shader.Create(device, { { "./resources/shaders/cull_objects.comp", ShaderType::Compute } });
+
+	const auto cull_set_layouts = layout_cache.GetDescriptorSetLayouts(device, m_cull_shader.GetReflection());
+	m_cull_pipeline_layout = layout_cache.GetPipelineLayout(device, cull_set_layouts, m_cull_shader.GetReflection().push_constant_ranges);
+
+	VulkanComputePipelineInfo compute_pipeline_info = {};
+	compute_pipeline_info.local_size = { global_settings::gpu_cull_work_group_size, 0, 0 };
+
+	m_cull_pipeline.Create(device, &compute_pipeline_info, PipelineType::Compute, m_cull_pipeline_layout, VK_NULL_HANDLE, m_cull_shader);
+
+	for (std::uint32_t frame_index = 0; frame_index < frame_count; ++frame_index)
+	{
+		m_cull_descriptor_sets.push_back(descriptor_allocator.Allocate(device, cull_set_layouts[0]));
+
+		std::vector<DescriptorWrite> cull_writes(4);
+		const VkBuffer cull_buffers[] =
+		{
+			m_object_buffer.buffer,
+			m_mesh_buffer.buffer,
+			m_draw_command_buffers[frame_index].buffer,
+			m_draw_count_buffers[frame_index].buffer
+		};
+
+		for (std::uint32_t binding = 0; binding < cull_writes.size(); ++binding)
+		{
+			cull_writes[binding].binding = binding;
+			cull_writes[binding].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			cull_writes[binding].buffer_info.buffer = cull_buffers[binding];
+			cull_writes[binding].buffer_info.offset = 0;
+			cull_writes[binding].buffer_info.range = VK_WHOLE_SIZE;
+		}
+
+		VulkanDescriptorAllocator::WriteDescriptorSet(device, m_cull_descriptor_sets.back(), cull_writes);
+	}
+
+	// Draw shader, objects are looked up through the instance index
+	m_draw_shader.Create(
+		device,
+		{
+			{ "./resources/shaders/gpu_driven.vert", ShaderType::Vertex },
+			{ "./resources/shaders/basic.frag", ShaderType::Fragment }
+		});
+
+	m_draw_set_layout = layout_cache.GetDescriptorSetLayouts(device, m_draw_shader.GetReflection())[0];
+	m_draw_pipeline_layout = layout_cache.GetPipelineLayout(device, m_draw_shader.GetReflection());
+
+	m_draw_descriptor_template = &layout_cache.GetUpdateTemplate(device, m_draw_set_layout);
+	m_draw_descriptor_data.resize(m_draw_descriptor_template->GetDescriptorCount());
+
+	auto& objects = m_draw_descriptor_data[m_draw_descriptor_template->GetDescriptorIndex(2)];
+	objects.buffer_info.buffer = m_object_buffer.buffer;
+	objects.buffer_info.offset = 0;
+	objects.buffer_info.range = VK_WHOLE_SIZE;
+}
+
+void GpuDrivenScene::CreatePipeline(
+	const VulkanDevice& device,
+	VkRenderPass render_pass,
+	const VkExtent2D& extent,
+	VkSampleCountFlagBits sample_count) noexcept(false)
+{
+	VkViewport viewport = {};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(extent.width);
+	viewport.height = static_cast<float>(extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+
+	VkRect2D scissor_rect = {};
+	scissor_rect.offset = { 0, 0 };
+	scissor_rect.extent = extent;
+
+	VulkanGraphicsPipelineInfo graphics_pipeline_info = {};
+	graphics_pipeline_info.cull_mode = PolygonFaceCullMode::FrontFace;
+	graphics_pipeline_info.discard_rasterizer_output = false;
+	graphics_pipeline_info.enable_depth_clamping = false;
+	graphics_pipeline_info.enable_depth_bias = false;
+	graphics_pipeline_info.line_width = 1.0f;
+	graphics_pipeline_info.polygon_fill_mode = PolygonFillMode::Fill;
+	graphics_pipeline_info.scissor_rect = scissor_rect;
+	graphics_pipeline_info.topology = VertexTopologyType::TriangleList;
+	graphics_pipeline_info.vertex_attribute_descs = VertexPCT::GetAttributeDescriptions();
+	graphics_pipeline_info.vertex_binding_descs = VertexPCT::GetBindingDescriptions();
+	graphics_pipeline_info.viewport = viewport;
+	graphics_pipeline_info.winding_order = TriangleWindingOrder::Clockwise;
+	graphics_pipeline_info.sample_count = sample_count;
+
+	// Drawn in the main pass after the regular meshes, without a prepass of its own
+	graphics_pipeline_info.enable_depth_test = true;
+	graphics_pipeline_info.enable_depth_write = true;
+	graphics_pipeline_info.depth_compare_operation = CompareOperation::LessOrEqual;
+
+	m_draw_pipeline.Create(device, &graphics_pipeline_info, PipelineType::Graphics, m_draw_pipeline_layout, render_pass, m_draw_shader);
+}
+
+void GpuDrivenScene::DestroyPipeline(const VulkanDevice& device) noexcept(true)
+{
+	m_draw_pipeline.Destroy(device);
+}
+
+void GpuDrivenScene::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	m_cull_pipeline.Destroy(device);
+	m_cull_shader.Destroy(device);
+	m_draw_shader.Destroy(device);
+
+	m_vertex_buffer.Destroy();
+	MemoryManager::GetInstance().Free(m_object_buffer);
+	MemoryManager::GetInstance().Free(m_mesh_buffer);
+
+	for (auto& buffer : m_draw_command_buffers)
+	{
+		MemoryManager::GetInstance().Free(buffer);
+	}
+
+	for (auto& buffer : m_draw_count_buffers)
+	{
+		MemoryManager::GetInstance().Free(buffer);
+	}
+
+	m_draw_command_buffers.clear();
+	m_draw_count_buffers.clear();
+
+	// Layouts are owned by the layout cache, the descriptor sets by the descriptor allocator
+	m_cull_pipeline_layout = VK_NULL_HANDLE;
+	m_draw_pipeline_layout = VK_NULL_HANDLE;
+	m_cull_descriptor_sets.clear();
+	m_object_count = 0;
+}
+
+void GpuDrivenScene::RecordCulling(
+	const VkCommandBuffer& command_buffer,
+	std::uint32_t frame_index,
+	const glm::mat4& view_projection_matrix) const noexcept(true)
+{
+	// The draw buffers of a frame are only reused after its fence has been waited on, so no barrier is needed before the reset
+	const auto& draw_command_buffer = m_draw_command_buffers[frame_index];
+	const auto& draw_count_buffer = m_draw_count_buffers[frame_index];
+
+	vkCmdFillBuffer(command_buffer, draw_count_buffer.buffer, 0, sizeof(std::uint32_t), 0);
+
+	auto count_barrier = MakeBufferBarrier(draw_count_buffer.buffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+	vkCmdPipelineBarrier(
+		command_buffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		0,
+		0,
+		nullptr,
+		1,
+		&count_barrier,
+		0,
+		nullptr);
+
+	CullData cull_data = {};
+	cull_data.frustum_planes = FrustumCuller::ExtractFrustumPlanes(view_projection_matrix);
+	cull_data.object_count = m_object_count;
+	cull_data.compact_draws = (m_cmd_draw_indirect_count != nullptr) ? 1 : 0;
+
+	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cull_pipeline.GetNative());
+	vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cull_pipeline_layout, 0, 1, &m_cull_descriptor_sets[frame_index], 0, nullptr);
+	utility::RecordPushConstants(command_buffer, m_cull_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, cull_data);
+
+	// One invocation per object
+	utility::RecordDispatch(command_buffer, m_cull_pipeline, m_object_count);
+
+	// Draw commands and the draw count are consumed by the indirect draw (on the compute queue the semaphore takes care of this)
+	VkBufferMemoryBarrier draw_barriers[] =
+	{
+		MakeBufferBarrier(draw_count_buffer.buffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT),
+		MakeBufferBarrier(draw_command_buffer.buffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT)
+	};
+
+	vkCmdPipelineBarrier(
+		command_buffer,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+		0,
+		0,
+		nullptr,
+		sizeof(draw_barriers) / sizeof(draw_barriers[0]),
+		draw_barriers,
+		0,
+		nullptr);
+}
+
+void GpuDrivenScene::RecordDraw(
+	const VulkanDevice& device,
+	const VkCommandBuffer& command_buffer,
+	VulkanDescriptorAllocator& descriptor_allocator,
+	std::uint32_t frame_index,
+	const VkDescriptorBufferInfo& camera_data,
+	const VkDescriptorImageInfo& texture) noexcept(false)
+{
+	auto descriptor_set = descriptor_allocator.AllocateForFrame(device, m_draw_set_layout, frame_index);
+
+	m_draw_descriptor_data[m_draw_descriptor_template->GetDescriptorIndex(0)].buffer_info = camera_data;
+	m_draw_descriptor_data[m_draw_descriptor_template->GetDescriptorIndex(1)].image_info = texture;
+	m_draw_descriptor_template->Write(device, descriptor_set, m_draw_descriptor_data);
+
+	vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_draw_pipeline.GetNative());
+	vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_draw_pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
+
+	VkDeviceSize vertex_buffer_offset = 0;
+	vkCmdBindVertexBuffers(command_buffer, 0, 1, &m_vertex_buffer.GetNative(), &vertex_buffer_offset);
+
+	const auto stride = static_cast<std::uint32_t>(sizeof(VkDrawIndirectCommand));
+
+	if (m_cmd_draw_indirect_count)
+	{
+		// Only the visible objects are drawn, the CPU does not know how many there are
+		m_cmd_draw_indirect_count(
+			command_buffer,
+			m_draw_command_buffers[frame_index].buffer,
+			0,
+			m_draw_count_buffers[frame_index].buffer,
+			0,
+			std::min(m_object_count, m_max_draw_indirect_count),
+			stride);
+
+		return;
+	}
+
+	// Every object has a command slot, split up into as few draw calls as the device allows
+	for (std::uint32_t first_draw = 0; first_draw < m_object_count; first_draw += m_max_draw_indirect_count)
+	{
+		const auto draw_count = std::min(m_max_draw_indirect_count, m_object_count - first_draw);
+
+		vkCmdDrawIndirect(
+			command_buffer,
+			m_draw_command_buffers[frame_index].buffer,
+			static_cast<VkDeviceSize>(first_draw) * stride,
+			draw_count,
+			stride);
+	}
+}
+
+std::uint32_t GpuDrivenScene::GetObjectCount() const noexcept(true)
+{
+	return m_object_count;
+}
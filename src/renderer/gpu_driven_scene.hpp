@@ -0,0 +1,173 @@
+#ifndef GPU_DRIVEN_SCENE_HPP
+#define GPU_DRIVEN_SCENE_HPP
+
+// Application
+#include "instance_batcher.hpp"
+#include "memory_manager/memory_manager.hpp"
+#include "vertex.hpp"
+#include "vulkan_wrapper/vulkan_descriptor_allocator.hpp"
+#include "vulkan_wrapper/vulkan_descriptor_update_template.hpp"
+#include "vulkan_wrapper/vulkan_device.hpp"
+#include "vulkan_wrapper/vulkan_immediate_submit_context.hpp"
+#include "vulkan_wrapper/vulkan_layout_cache.hpp"
+#include "vulkan_wrapper/vulkan_pipeline.hpp"
+#include "vulkan_wrapper/vulkan_shader.hpp"
+#include "vulkan_wrapper/vulkan_vertex_buffer.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// GLM
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+// C++ standard
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace vkc
+{
+	/** Object of the GPU-driven scene as it is stored in the object storage buffer (std430) */
+	struct GpuObject
+	{
+		glm::mat4 model_matrix;
+
+		/** World space center (xyz) and radius (w) */
+		glm::vec4 bounding_sphere;
+
+		std::uint32_t mesh_index;
+		std::uint32_t material_index;
+		std::uint32_t padding[2];
+	};
+
+	/** Range of a mesh in the shared vertex buffer of the GPU-driven scene */
+	struct GpuMesh
+	{
+		std::uint32_t first_vertex;
+		std::uint32_t vertex_count;
+	};
+
+	/** Static scene that is culled and drawn without any per-object work on the CPU */
+	/**
+	 * Objects and meshes live in storage buffers on the GPU. Every frame a
+	 * compute shader tests all objects against the view frustum and writes
+	 * an indirect draw command for each visible object, after which the
+	 * whole scene is drawn with a single indirect draw call.
+	 *
+	 * When VK_KHR_draw_indirect_count is available, visible draws are packed
+	 * together and the draw count comes from a buffer. Otherwise every object
+	 * keeps its own command slot, and culled objects draw zero instances.
+	 *
+	 * Usage: add meshes and objects, call "Build" once, then record the
+	 * culling pass outside of a render pass and the draw inside of it. Every
+	 * in-flight frame has its own draw commands, so culling can run on the
+	 * async compute queue while the graphics queue still draws older frames.
+	 */
+	class GpuDrivenScene
+	{
+	public:
+		GpuDrivenScene() noexcept(true);
+		~GpuDrivenScene() noexcept(true);
+
+		/** Add a mesh, all meshes end up in a single vertex buffer */
+		MeshHandle AddMesh(const std::vector<VertexPCT>& vertices) noexcept(false);
+
+		/** Add an object, the bounding sphere of its mesh is transformed to world space right away */
+		void AddObject(MeshHandle mesh, std::uint32_t material_index, const glm::mat4& model_matrix) noexcept(false);
+
+		/** Upload the scene and create the culling pipeline */
+		/**
+		 * "shared_queue_families" lists the queue families that access the scene
+		 * buffers and the draw commands when culling and drawing happen on
+		 * different queue families, leave it empty when both happen on the
+		 * same family.
+		 */
+		void Build(
+			const vk_wrapper::VulkanDevice& device,
+			vk_wrapper::VulkanImmediateSubmitContext& immediate_submit,
+			vk_wrapper::VulkanLayoutCache& layout_cache,
+			vk_wrapper::VulkanDescriptorAllocator& descriptor_allocator,
+			std::uint32_t frame_count,
+			const std::vector<std::uint32_t>& shared_queue_families = {}) noexcept(false);
+
+		/** Create the graphics pipeline, needs to be recreated with the swapchain */
+		void CreatePipeline(
+			const vk_wrapper::VulkanDevice& device,
+			VkRenderPass render_pass,
+			const VkExtent2D& extent,
+			VkSampleCountFlagBits sample_count) noexcept(false);
+
+		/** Destroy the graphics pipeline */
+		void DestroyPipeline(const vk_wrapper::VulkanDevice& device) noexcept(true);
+
+		/** Destroy all Vulkan objects and free the scene buffers */
+		void Destroy(const vk_wrapper::VulkanDevice& device) noexcept(true);
+
+		/** Record frustum culling and draw command generation (outside of a render pass, graphics or compute queue) */
+		void RecordCulling(
+			const VkCommandBuffer& command_buffer,
+			std::uint32_t frame_index,
+			const glm::mat4& view_projection_matrix) const noexcept(true);
+
+		/** Record the indirect draw of all visible objects (inside of a render pass) */
+		void RecordDraw(
+			const vk_wrapper::VulkanDevice& device,
+			const VkCommandBuffer& command_buffer,
+			vk_wrapper::VulkanDescriptorAllocator& descriptor_allocator,
+			std::uint32_t frame_index,
+			const VkDescriptorBufferInfo& camera_data,
+			const VkDescriptorImageInfo& texture) noexcept(false);
+
+		/** Number of objects in the scene */
+		std::uint32_t GetObjectCount() const noexcept(true);
+
+	private:
+		/** Push constants of the culling shader (matches "CullData" in cull_objects.comp) */
+		struct CullData
+		{
+			std::array<glm::vec4, 6> frustum_planes;
+			std::uint32_t object_count;
+			std::uint32_t compact_draws;
+		};
+
+	private:
+		/** Scene contents, only used until the scene is built */
+		std::vector<VertexPCT> m_vertices;
+		std::vector<GpuMesh> m_meshes;
+		std::vector<glm::vec4> m_mesh_bounding_spheres;
+		std::vector<GpuObject> m_objects;
+
+		std::uint32_t m_object_count;
+
+		vk_wrapper::VulkanVertexBuffer m_vertex_buffer;
+		memory::VulkanBuffer m_object_buffer;
+		memory::VulkanBuffer m_mesh_buffer;
+
+		/** Written by the culling pass, one buffer per in-flight frame */
+		std::vector<memory::VulkanBuffer> m_draw_command_buffers;
+		std::vector<memory::VulkanBuffer> m_draw_count_buffers;
+
+		vk_wrapper::VulkanShader m_cull_shader;
+		vk_wrapper::VulkanPipeline m_cull_pipeline;
+		VkPipelineLayout m_cull_pipeline_layout;
+		std::vector<VkDescriptorSet> m_cull_descriptor_sets;
+
+		vk_wrapper::VulkanShader m_draw_shader;
+		vk_wrapper::VulkanPipeline m_draw_pipeline;
+		VkPipelineLayout m_draw_pipeline_layout;
+		VkDescriptorSetLayout m_draw_set_layout;
+
+		/** Writes the per-frame set of the draw (camera, texture, objects) in a single call, owned by the layout cache */
+		const vk_wrapper::VulkanDescriptorUpdateTemplate* m_draw_descriptor_template;
+		std::vector<vk_wrapper::DescriptorTemplateData> m_draw_descriptor_data;
+
+		/** Extension function, only set when the draw count can be read from a buffer */
+		PFN_vkCmdDrawIndirectCountKHR m_cmd_draw_indirect_count;
+
+		bool m_supports_multi_draw_indirect;
+		std::uint32_t m_max_draw_indirect_count;
+	};
+}
+
+#endif // GPU_DRIVEN_SCENE_HPP
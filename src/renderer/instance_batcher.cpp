@@ -0,0 +1,110 @@
+// Application
+#include "instance_batcher.hpp"
+
+// C++ standard
+#include <algorithm>
+
+using namespace vkc;
+
+InstanceBatcher::InstanceBatcher() noexcept(true)
+{}
+
+InstanceBatcher::~InstanceBatcher() noexcept(true)
+{}
+
+void InstanceBatcher::Submit(MeshHandle mesh, std::uint32_t material_index, const glm::mat4& model_matrix) noexcept(false)
+{
+	const auto batch_index = GetBatchIndex(mesh, material_index);
+
+	m_submissions.push_back({ batch_index, static_cast<std::uint32_t>(m_submitted_instances.size()), 1 });
+	m_submitted_instances.emplace_back(model_matrix);
+
+	++m_batches[batch_index].instance_count;
+}
+
+void InstanceBatcher::Submit(MeshHandle mesh, std::uint32_t material_index, const std::vector<glm::mat4>& model_matrices) noexcept(false)
+{
+	if (model_matrices.empty())
+	{
+		return;
+	}
+
+	const auto batch_index = GetBatchIndex(mesh, material_index);
+	const auto instance_count = static_cast<std::uint32_t>(model_matrices.size());
+
+	m_submissions.push_back({ batch_index, static_cast<std::uint32_t>(m_submitted_instances.size()), instance_count });
+	m_submitted_instances.insert(m_submitted_instances.end(), model_matrices.begin(), model_matrices.end());
+
+	m_batches[batch_index].instance_count += instance_count;
+}
+
+void InstanceBatcher::Build() noexcept(false)
+{
+	// Batch sizes are known already, so every batch gets its range up front
+	std::uint32_t first_instance = 0;
+
+	for (auto& batch : m_batches)
+	{
+		batch.first_instance = first_instance;
+		first_instance += batch.instance_count;
+	}
+
+	m_instances.resize(m_submitted_instances.size());
+
+	// Scatter the submissions into their batch, keeping the submission order within a batch
+	m_batch_cursors.resize(m_batches.size());
+
+	for (std::size_t index = 0; index < m_batches.size(); ++index)
+	{
+		m_batch_cursors[index] = m_batches[index].first_instance;
+	}
+
+	for (const auto& submission : m_submissions)
+	{
+		auto& cursor = m_batch_cursors[submission.batch_index];
+
+		std::copy(
+			m_submitted_instances.begin() + submission.first_instance,
+			m_submitted_instances.begin() + submission.first_instance + submission.instance_count,
+			m_instances.begin() + cursor);
+
+		cursor += submission.instance_count;
+	}
+}
+
+void InstanceBatcher::Clear() noexcept(true)
+{
+	m_batch_indices.clear();
+	m_batches.clear();
+	m_submissions.clear();
+	m_submitted_instances.clear();
+	m_instances.clear();
+}
+
+const std::vector<InstanceBatch>& InstanceBatcher::GetBatches() const noexcept(true)
+{
+	return m_batches;
+}
+
+const std::vector<InstanceData>& InstanceBatcher::GetInstances() const noexcept(true)
+{
+	return m_instances;
+}
+
+std::uint32_t InstanceBatcher::GetSubmissionCount() const noexcept(true)
+{
+	return static_cast<std::uint32_t>(m_submissions.size());
+}
+
+std::uint32_t InstanceBatcher::GetBatchIndex(MeshHandle mesh, std::uint32_t material_index) noexcept(false)
+{
+	const auto key = (static_cast<std::uint64_t>(mesh) << 32) | material_index;
+	const auto [entry, inserted] = m_batch_indices.try_emplace(key, static_cast<std::uint32_t>(m_batches.size()));
+
+	if (inserted)
+	{
+		m_batches.push_back({ mesh, material_index, 0, 0 });
+	}
+
+	return entry->second;
+}
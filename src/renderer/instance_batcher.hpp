@@ -0,0 +1,97 @@
+#ifndef INSTANCE_BATCHER_HPP
+#define INSTANCE_BATCHER_HPP
+
+// Application
+#include "vertex.hpp"
+
+// GLM
+#include <glm/mat4x4.hpp>
+
+// C++ standard
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace vkc
+{
+	/** Index of a mesh owned by the renderer */
+	using MeshHandle = std::uint32_t;
+
+	/** Instances that share a mesh and material, drawn with a single instanced draw call */
+	struct InstanceBatch
+	{
+		MeshHandle mesh;
+		std::uint32_t material_index;
+
+		/** Range of the batch in the packed instance data */
+		std::uint32_t first_instance;
+		std::uint32_t instance_count;
+	};
+
+	/** Collects the meshes submitted during a frame and merges identical mesh + material pairs into instanced draws */
+	/**
+	 * Call "Build" once all meshes have been submitted, after that the
+	 * instances of every batch are stored next to each other, ready to be
+	 * uploaded to an instance buffer. Batches keep the order in which their
+	 * first instance was submitted.
+	 *
+	 * Memory is kept around between frames, "Clear" does not free anything.
+	 */
+	class InstanceBatcher
+	{
+	public:
+		InstanceBatcher() noexcept(true);
+		~InstanceBatcher() noexcept(true);
+
+		/** Submit a single instance of a mesh */
+		void Submit(MeshHandle mesh, std::uint32_t material_index, const glm::mat4& model_matrix) noexcept(false);
+
+		/** Submit many instances of a mesh at once */
+		void Submit(MeshHandle mesh, std::uint32_t material_index, const std::vector<glm::mat4>& model_matrices) noexcept(false);
+
+		/** Pack the instance data of every batch together */
+		void Build() noexcept(false);
+
+		/** Remove all submissions, call at the start of every frame */
+		void Clear() noexcept(true);
+
+		/** Batches built by the last call to "Build" */
+		const std::vector<InstanceBatch>& GetBatches() const noexcept(true);
+
+		/** Instance data built by the last call to "Build", indexed by "InstanceBatch::first_instance" */
+		const std::vector<InstanceData>& GetInstances() const noexcept(true);
+
+		/** Number of "Submit" calls since the last clear, each of them would have been a draw call without batching */
+		std::uint32_t GetSubmissionCount() const noexcept(true);
+
+	private:
+		/** Get the batch for a mesh + material pair, creates one when it does not exist yet */
+		std::uint32_t GetBatchIndex(MeshHandle mesh, std::uint32_t material_index) noexcept(false);
+
+	private:
+		/** A contiguous range of submitted instances that belongs to a single batch */
+		struct Submission
+		{
+			std::uint32_t batch_index;
+			std::uint32_t first_instance;
+			std::uint32_t instance_count;
+		};
+
+		/** Key is the mesh handle in the high 32 bits, and the material index in the low 32 bits */
+		std::unordered_map<std::uint64_t, std::uint32_t> m_batch_indices;
+
+		std::vector<InstanceBatch> m_batches;
+		std::vector<Submission> m_submissions;
+
+		/** Instances in submission order */
+		std::vector<InstanceData> m_submitted_instances;
+
+		/** Instances grouped per batch */
+		std::vector<InstanceData> m_instances;
+
+		/** Next free slot of every batch while building */
+		std::vector<std::uint32_t> m_batch_cursors;
+	};
+}
+
+#endif // INSTANCE_BATCHER_HPP
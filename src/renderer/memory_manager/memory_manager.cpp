@@ -27,6 +27,13 @@ void MemoryManager::Initialize(const VulkanDevice& device) noexcept(false)
 	VmaAllocatorCreateInfo create_info = {};
 	create_info.device = device.GetLogicalDeviceNative();
 	create_info.physicalDevice = device.GetPhysicalDeviceNative();
+	create_info.vulkanApiVersion = VK_API_VERSION_1_1;
+
+	// Let the driver report the real heap budgets when possible
+	if (device.IsExtensionEnabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+	{
+		create_info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+	}
 
 	auto result = vmaCreateAllocator(&create_info, &m_allocator);
 
@@ -35,6 +42,19 @@ void MemoryManager::Initialize(const VulkanDevice& device) noexcept(false)
 		throw CriticalVulkanError("Failed to create an allocator.");
 	}
 
+	const VkPhysicalDeviceMemoryProperties* memory_properties = nullptr;
+	vmaGetMemoryProperties(m_allocator, &memory_properties);
+
+	m_device_local_heaps.clear();
+
+	for (std::uint32_t heap_index = 0; heap_index < memory_properties->memoryHeapCount; ++heap_index)
+	{
+		if (memory_properties->memoryHeaps[heap_index].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+		{
+			m_device_local_heaps.push_back(heap_index);
+		}
+	}
+
 	// Successfully initialized the memory manager
 	m_is_initialized = true;
 }
@@ -151,7 +171,11 @@ const VulkanImage& MemoryManager::Allocate(const ImageAllocationInfo& image_info
 
 	image.id = CreateNewID();
 
-	if (result != VK_SUCCESS)
+	if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY)
+	{
+		throw GPUOutOfMemoryError("Could not create an image, the device ran out of memory.");
+	}
+	else if (result != VK_SUCCESS)
 	{
 		throw CriticalVulkanError("Could not create an image.");
 	}
@@ -161,6 +185,27 @@ const VulkanImage& MemoryManager::Allocate(const ImageAllocationInfo& image_info
 	return m_images[m_images.size() - 1];
 }
 
+void MemoryManager::SetCurrentFrameIndex(std::uint32_t frame_index) noexcept(true)
+{
+	vmaSetCurrentFrameIndex(m_allocator, frame_index);
+}
+
+MemoryBudget MemoryManager::GetDeviceLocalBudget() const noexcept(true)
+{
+	VmaBudget heap_budgets[VK_MAX_MEMORY_HEAPS] = {};
+	vmaGetBudget(m_allocator, heap_budgets);
+
+	MemoryBudget device_local_budget = {};
+
+	for (auto heap_index : m_device_local_heaps)
+	{
+		device_local_budget.usage += heap_budgets[heap_index].usage;
+		device_local_budget.budget += heap_budgets[heap_index].budget;
+	}
+
+	return device_local_budget;
+}
+
 const VmaAllocator& MemoryManager::GetVMAAllocation() const noexcept(true)
 {
 	return m_allocator;
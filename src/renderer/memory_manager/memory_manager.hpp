@@ -51,6 +51,16 @@ namespace vkc
 			std::uint64_t id;
 		};
 
+		/** Memory usage and budget of a group of memory heaps, in bytes */
+		struct MemoryBudget
+		{
+			/** Memory currently used by this process */
+			VkDeviceSize usage = 0;
+
+			/** Memory this process can use before allocations start to fail or hurt performance */
+			VkDeviceSize budget = 0;
+		};
+
 		/** Singleton! */
 		class MemoryManager
 		{
@@ -89,8 +99,25 @@ namespace vkc
 			const VulkanBuffer& Allocate(const BufferAllocationInfo& buffer_info) noexcept(false);
 
 			/** Allocate a new image */
+			/**
+			 * Throws a "GPUOutOfMemoryError" when the device ran out of memory,
+			 * callers that can live with less memory (e.g. texture streaming)
+			 * can catch it and try again with a smaller image.
+			 */
 			const VulkanImage& Allocate(const ImageAllocationInfo& image_info) noexcept(false);
 
+			/** Let the allocator know a new frame has started, refreshes the memory budget */
+			void SetCurrentFrameIndex(std::uint32_t frame_index) noexcept(true);
+
+			/** Get the combined usage and budget of all device-local memory heaps */
+			/**
+			 * When VK_EXT_memory_budget is enabled, the values are reported by
+			 * the driver and include allocations made by other processes. Without
+			 * the extension, the allocator estimates them from its own allocations
+			 * and the heap sizes.
+			 */
+			MemoryBudget GetDeviceLocalBudget() const noexcept(true);
+
 			/** Get a reference to the VulkanMemoryAllocator allocator object */
 			const VmaAllocator& GetVMAAllocation() const noexcept(true);
 
@@ -105,6 +132,9 @@ namespace vkc
 			/** VulkanMemoryAllocator allocator */
 			VmaAllocator m_allocator;
 
+			/** Heaps that are device-local, used to sum up the device-local budget */
+			std::vector<std::uint32_t> m_device_local_heaps;
+
 			/** Container for all allocated buffers */
 			std::vector<VulkanBuffer> m_buffers;
 
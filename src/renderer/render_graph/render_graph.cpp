@@ -0,0 +1,1323 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "render_graph.hpp"
+#include "renderer/memory_manager/memory_manager.hpp"
+#include "renderer/vulkan_wrapper/vulkan_device.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+using namespace vkc::exception;
+using namespace vkc::render_graph;
+using namespace vkc::vk_wrapper;
+
+namespace
+{
+	/** What a resource usage means for the image */
+	struct UsageInfo
+	{
+		VkImageLayout layout;
+		VkPipelineStageFlags stages;
+		VkAccessFlags access;
+		VkImageUsageFlags image_usage;
+		bool is_write;
+	};
+
+	UsageInfo GetUsageInfo(ResourceUsage usage) noexcept(true)
+	{
+		switch (usage)
+		{
+			case ResourceUsage::ColorAttachment:
+				return {
+					VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+					VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+					VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+					VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+					true };
+
+			case ResourceUsage::DepthStencilAttachment:
+				return {
+					VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+					VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+					VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+					VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+					true };
+
+			case ResourceUsage::ResolveAttachment:
+				return {
+					VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+					VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+					VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+					VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+					true };
+
+			case ResourceUsage::DepthStencilReadOnly:
+				return {
+					VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+					VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+					VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+					VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+					false };
+
+			case ResourceUsage::FragmentShaderRead:
+				return {
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+					VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+					VK_ACCESS_SHADER_READ_BIT,
+					VK_IMAGE_USAGE_SAMPLED_BIT,
+					false };
+
+			case ResourceUsage::ComputeShaderRead:
+				return {
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+					VK_ACCESS_SHADER_READ_BIT,
+					VK_IMAGE_USAGE_SAMPLED_BIT,
+					false };
+
+			case ResourceUsage::ComputeShaderWrite:
+				return {
+					VK_IMAGE_LAYOUT_GENERAL,
+					VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+					VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+					VK_IMAGE_USAGE_STORAGE_BIT,
+					true };
+
+			case ResourceUsage::TransferSource:
+				return {
+					VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					VK_PIPELINE_STAGE_TRANSFER_BIT,
+					VK_ACCESS_TRANSFER_READ_BIT,
+					VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+					false };
+
+			case ResourceUsage::TransferDestination:
+				return {
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					VK_PIPELINE_STAGE_TRANSFER_BIT,
+					VK_ACCESS_TRANSFER_WRITE_BIT,
+					VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+					true };
+		}
+
+		return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT, 0, true };
+	}
+
+	bool IsDepthFormat(VkFormat format) noexcept(true)
+	{
+		switch (format)
+		{
+			case VK_FORMAT_D16_UNORM:
+			case VK_FORMAT_X8_D24_UNORM_PACK32:
+			case VK_FORMAT_D32_SFLOAT:
+			case VK_FORMAT_D16_UNORM_S8_UINT:
+			case VK_FORMAT_D24_UNORM_S8_UINT:
+			case VK_FORMAT_D32_SFLOAT_S8_UINT:
+				return true;
+
+			default:
+				return false;
+		}
+	}
+
+	bool HasStencilComponent(VkFormat format) noexcept(true)
+	{
+		return
+			format == VK_FORMAT_S8_UINT ||
+			format == VK_FORMAT_D16_UNORM_S8_UINT ||
+			format == VK_FORMAT_D24_UNORM_S8_UINT ||
+			format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+	}
+
+	VkImageAspectFlags GetAspectMask(VkFormat format) noexcept(true)
+	{
+		VkImageAspectFlags aspect_mask = 0;
+
+		if (IsDepthFormat(format))
+		{
+			aspect_mask |= VK_IMAGE_ASPECT_DEPTH_BIT;
+		}
+
+		if (HasStencilComponent(format))
+		{
+			aspect_mask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+		}
+
+		return (aspect_mask != 0) ? aspect_mask : VK_IMAGE_ASPECT_COLOR_BIT;
+	}
+
+	VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) noexcept(true)
+	{
+		return (alignment > 1) ? (value + alignment - 1) / alignment * alignment : value;
+	}
+}
+
+RenderGraph::RenderGraph() noexcept(true)
+	: m_is_compiled(false)
+{}
+
+RenderGraph::~RenderGraph() noexcept(true)
+{}
+
+ResourceHandle RenderGraph::ImportImage(
+	const std::string& name,
+	VkFormat format,
+	const VkExtent2D& extent,
+	const ImageState& initial_state,
+	const ImageState& final_state) noexcept(false)
+{
+	Resource resource = {};
+	resource.name = name;
+	resource.is_imported = true;
+	resource.info.format = format;
+	resource.info.extent = extent;
+	resource.initial_state = initial_state;
+	resource.final_state = final_state;
+
+	m_resources.push_back(resource);
+
+	return static_cast<ResourceHandle>(m_resources.size() - 1);
+}
+
+ResourceHandle RenderGraph::CreateImage(
+	const std::string& name,
+	const TransientImageInfo& info) noexcept(false)
+{
+	Resource resource = {};
+	resource.name = name;
+	resource.info = info;
+
+	m_resources.push_back(resource);
+
+	return static_cast<ResourceHandle>(m_resources.size() - 1);
+}
+
+PassHandle RenderGraph::AddPass(
+	const std::string& name,
+	PassType type,
+	const PassRecordCallback& record) noexcept(false)
+{
+	if (m_is_compiled)
+	{
+		throw CriticalVulkanError("Cannot add a pass to a render graph that has been compiled already.");
+	}
+
+	Pass pass = {};
+	pass.name = name;
+	pass.type = type;
+	pass.record = record;
+
+	m_passes.push_back(std::move(pass));
+
+	return static_cast<PassHandle>(m_passes.size() - 1);
+}
+
+void RenderGraph::AddColorAttachment(
+	PassHandle pass,
+	ResourceHandle resource,
+	VkAttachmentLoadOp load_op,
+	const VkClearColorValue& clear_color) noexcept(false)
+{
+	if (m_passes[pass].type != PassType::Graphics)
+	{
+		throw CriticalVulkanError("Attachments can only be added to graphics passes.");
+	}
+
+	Attachment attachment = {};
+	attachment.resource = resource;
+	attachment.load_op = load_op;
+	attachment.clear_value.color = clear_color;
+
+	m_passes[pass].attachments.push_back(attachment);
+	m_passes[pass].accesses.push_back({ resource, ResourceUsage::ColorAttachment });
+}
+
+void RenderGraph::AddDepthStencilAttachment(
+	PassHandle pass,
+	ResourceHandle resource,
+	VkAttachmentLoadOp load_op,
+	const VkClearDepthStencilValue& clear_value,
+	bool read_only) noexcept(false)
+{
+	auto& attachments = m_passes[pass].attachments;
+
+	if (m_passes[pass].type != PassType::Graphics)
+	{
+		throw CriticalVulkanError("Attachments can only be added to graphics passes.");
+	}
+
+	if (std::any_of(attachments.begin(), attachments.end(), [](const Attachment& attachment) { return attachment.is_depth_stencil; }))
+	{
+		throw CriticalVulkanError("A pass can only have a single depth stencil attachment.");
+	}
+
+	Attachment attachment = {};
+	attachment.resource = resource;
+	attachment.load_op = load_op;
+	attachment.clear_value.depthStencil = clear_value;
+	attachment.is_depth_stencil = true;
+	attachment.is_read_only = read_only;
+
+	attachments.push_back(attachment);
+	m_passes[pass].accesses.push_back({ resource, read_only ? ResourceUsage::DepthStencilReadOnly : ResourceUsage::DepthStencilAttachment });
+}
+
+void RenderGraph::AddResolveAttachment(
+	PassHandle pass,
+	ResourceHandle source,
+	ResourceHandle destination) noexcept(false)
+{
+	auto& attachments = m_passes[pass].attachments;
+
+	const auto is_color_attachment = std::any_of(
+		attachments.begin(),
+		attachments.end(),
+		[source](const Attachment& attachment)
+		{
+			return attachment.resource == source && !attachment.is_depth_stencil && !attachment.is_resolve;
+		});
+
+	if (!is_color_attachment)
+	{
+		throw CriticalVulkanError("Only color attachments of render graph pass \"" + m_passes[pass].name + "\" can be resolved.");
+	}
+
+	const auto& source_info = m_resources[source].info;
+	const auto& destination_info = m_resources[destination].info;
+
+	if (source_info.samples == VK_SAMPLE_COUNT_1_BIT || destination_info.samples != VK_SAMPLE_COUNT_1_BIT || source_info.format != destination_info.format)
+	{
+		throw CriticalVulkanError("Resolve attachments need a multisampled source and a single-sampled destination of the same format.");
+	}
+
+	// Every sample of the destination is overwritten, its previous contents are never loaded
+	Attachment attachment = {};
+	attachment.resource = destination;
+	attachment.load_op = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachment.is_resolve = true;
+	attachment.resolve_source = source;
+
+	attachments.push_back(attachment);
+	m_passes[pass].accesses.push_back({ destination, ResourceUsage::ResolveAttachment });
+}
+
+void RenderGraph::AddImageAccess(
+	PassHandle pass,
+	ResourceHandle resource,
+	ResourceUsage usage) noexcept(false)
+{
+	if (usage == ResourceUsage::ColorAttachment ||
+		usage == ResourceUsage::DepthStencilAttachment ||
+		usage == ResourceUsage::DepthStencilReadOnly ||
+		usage == ResourceUsage::ResolveAttachment)
+	{
+		throw CriticalVulkanError("Attachments have to be added through \"AddColorAttachment\", \"AddDepthStencilAttachment\", or \"AddResolveAttachment\".");
+	}
+
+	m_passes[pass].accesses.push_back({ resource, usage });
+}
+
+void RenderGraph::SetSideEffects(PassHandle pass) noexcept(true)
+{
+	m_passes[pass].has_side_effects = true;
+}
+
+void RenderGraph::Compile(const VulkanDevice& device) noexcept(false)
+{
+	if (m_is_compiled)
+	{
+		throw CriticalVulkanError("Render graph has been compiled already, destroy it before building it again.");
+	}
+
+	m_statistics = {};
+
+	CullPasses();
+	OrderPasses();
+	CreateTransientImages(device);
+	CreateBarriers();
+	CreateRenderPasses(device);
+
+	m_is_compiled = true;
+
+	m_statistics.pass_count = static_cast<std::uint32_t>(m_execution_order.size());
+	m_statistics.culled_pass_count = static_cast<std::uint32_t>(m_passes.size() - m_execution_order.size());
+
+	for (const auto& pass : m_passes)
+	{
+		if (pass.is_culled)
+		{
+			spdlog::info("Culled render graph pass \"{}\", none of its results are used.", pass.name);
+		}
+	}
+
+	spdlog::info(
+		"Compiled render graph: {} pass(es), {} image barrier(s) in {} batch(es), {} transient image(s) ({} lazily allocated) in {} byte(s) ({} byte(s) without aliasing).",
+		m_statistics.pass_count,
+		m_statistics.image_barrier_count,
+		m_statistics.pipeline_barrier_count,
+		m_statistics.transient_image_count,
+		m_statistics.lazily_allocated_image_count,
+		m_statistics.transient_memory_size,
+		m_statistics.unaliased_transient_memory_size);
+}
+
+void RenderGraph::SetImportedImage(
+	ResourceHandle resource,
+	VkImage image,
+	VkImageView image_view) noexcept(true)
+{
+	m_resources[resource].image = image;
+	m_resources[resource].image_view = image_view;
+}
+
+void RenderGraph::Execute(
+	const VulkanDevice& device,
+	const VkCommandBuffer& command_buffer) noexcept(false)
+{
+	if (!m_is_compiled)
+	{
+		throw CriticalVulkanError("Render graph has to be compiled before it can be executed.");
+	}
+
+	for (auto handle : m_execution_order)
+	{
+		auto& pass = m_passes[handle];
+
+		// Every transition into the state this pass needs, in a single call
+		RecordBarriers(command_buffer, pass.barriers);
+
+		if (pass.type == PassType::Compute)
+		{
+			pass.record(command_buffer);
+			continue;
+		}
+
+		VkRenderPassBeginInfo render_pass_begin_info = {};
+		render_pass_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		render_pass_begin_info.renderPass = pass.render_pass.GetNative();
+		render_pass_begin_info.framebuffer = GetFramebuffer(device, pass);
+		render_pass_begin_info.renderArea.offset = { 0, 0 };
+		render_pass_begin_info.renderArea.extent = pass.extent;
+		render_pass_begin_info.clearValueCount = static_cast<std::uint32_t>(pass.clear_values.size());
+		render_pass_begin_info.pClearValues = pass.clear_values.data();
+
+		vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+		pass.record(command_buffer);
+		vkCmdEndRenderPass(command_buffer);
+	}
+
+	// Hand the imported images back in the state their owners expect
+	RecordBarriers(command_buffer, m_final_barriers);
+}
+
+VkRenderPass RenderGraph::GetRenderPass(PassHandle pass) const noexcept(true)
+{
+	return m_passes[pass].render_pass.GetNative();
+}
+
+const RenderGraphStatistics& RenderGraph::GetStatistics() const noexcept(true)
+{
+	return m_statistics;
+}
+
+void RenderGraph::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	for (auto& pass : m_passes)
+	{
+		for (const auto& framebuffer : pass.framebuffers)
+		{
+			vkDestroyFramebuffer(device.GetLogicalDeviceNative(), framebuffer.second, nullptr);
+		}
+
+		pass.render_pass.Destroy(device);
+	}
+
+	for (const auto& resource : m_resources)
+	{
+		if (resource.is_imported)
+		{
+			continue;
+		}
+
+		vkDestroyImageView(device.GetLogicalDeviceNative(), resource.image_view, nullptr);
+		vkDestroyImage(device.GetLogicalDeviceNative(), resource.image, nullptr);
+	}
+
+	const auto& allocator = memory::MemoryManager::GetInstance().GetVMAAllocation();
+
+	for (const auto& allocation : m_transient_allocations)
+	{
+		vmaFreeMemory(allocator, allocation);
+	}
+
+	m_passes.clear();
+	m_resources.clear();
+	m_execution_order.clear();
+	m_final_barriers = {};
+	m_transient_allocations.clear();
+	m_statistics = {};
+	m_is_compiled = false;
+}
+
+void RenderGraph::CullPasses() noexcept(true)
+{
+	// Imported images are the output of the graph, everything else only matters when a pass that is kept reads it
+	std::vector<bool> is_needed(m_resources.size());
+
+	for (std::size_t index = 0; index < m_resources.size(); ++index)
+	{
+		is_needed[index] = m_resources[index].is_imported;
+	}
+
+	for (auto pass = m_passes.rbegin(); pass != m_passes.rend(); ++pass)
+	{
+		pass->is_culled = !pass->has_side_effects && std::none_of(
+			pass->accesses.begin(),
+			pass->accesses.end(),
+			[this, &pass, &is_needed](const ResourceAccess& access)
+			{
+				return is_needed[access.resource] && WritesResource(*pass, access.resource);
+			});
+
+		if (pass->is_culled)
+		{
+			continue;
+		}
+
+		// Earlier writes to an image this pass overwrites completely are never seen
+		for (const auto& access : pass->accesses)
+		{
+			if (WritesResource(*pass, access.resource) && !ReadsResource(*pass, access.resource))
+			{
+				is_needed[access.resource] = false;
+			}
+		}
+
+		for (const auto& access : pass->accesses)
+		{
+			if (ReadsResource(*pass, access.resource))
+			{
+				is_needed[access.resource] = true;
+			}
+		}
+	}
+}
+
+void RenderGraph::OrderPasses() noexcept(false)
+{
+	std::vector<PassHandle> passes;
+
+	for (PassHandle handle = 0; handle < m_passes.size(); ++handle)
+	{
+		if (!m_passes[handle].is_culled)
+		{
+			passes.push_back(handle);
+		}
+	}
+
+	// "depends_on[a][b]" is set when pass "a" has to run after pass "b" (indices into "passes")
+	const auto pass_count = passes.size();
+	std::vector<std::vector<bool>> depends_on(pass_count, std::vector<bool>(pass_count, false));
+
+	// Most recent writer and the readers after it, per image
+	std::vector<std::size_t> last_writers(m_resources.size(), pass_count);
+	std::vector<std::vector<std::size_t>> readers(m_resources.size());
+	auto last_side_effect_pass = pass_count;
+
+	for (std::size_t index = 0; index < pass_count; ++index)
+	{
+		const auto& pass = m_passes[passes[index]];
+
+		// Passes with side effects stay where they were added
+		if (pass.has_side_effects)
+		{
+			for (std::size_t other_index = 0; other_index < index; ++other_index)
+			{
+				depends_on[index][other_index] = true;
+			}
+
+			last_side_effect_pass = index;
+		}
+		else if (last_side_effect_pass != pass_count)
+		{
+			depends_on[index][last_side_effect_pass] = true;
+		}
+
+		std::vector<ResourceHandle> resources;
+
+		for (const auto& access : pass.accesses)
+		{
+			if (std::find(resources.begin(), resources.end(), access.resource) == resources.end())
+			{
+				resources.push_back(access.resource);
+			}
+		}
+
+		for (auto resource : resources)
+		{
+			const auto reads = ReadsResource(pass, resource);
+			const auto writes = WritesResource(pass, resource);
+
+			// Read after write, write after write, and write after read
+			if ((reads || writes) && last_writers[resource] != pass_count)
+			{
+				depends_on[index][last_writers[resource]] = true;
+			}
+
+			if (writes)
+			{
+				for (auto reader : readers[resource])
+				{
+					depends_on[index][reader] = true;
+				}
+
+				last_writers[resource] = index;
+				readers[resource].clear();
+			}
+			else if (reads)
+			{
+				readers[resource].push_back(index);
+			}
+		}
+	}
+
+	// Topological sort, a pass that does not depend on the pass right before it is preferred so the GPU can overlap them
+	std::vector<bool> is_scheduled(pass_count, false);
+	auto previous_index = pass_count;
+
+	m_execution_order.clear();
+
+	for (std::size_t step = 0; step < pass_count; ++step)
+	{
+		auto selected_index = pass_count;
+
+		for (std::size_t index = 0; index < pass_count; ++index)
+		{
+			if (is_scheduled[index])
+			{
+				continue;
+			}
+
+			auto is_ready = true;
+
+			for (std::size_t other_index = 0; other_index < pass_count && is_ready; ++other_index)
+			{
+				is_ready = !depends_on[index][other_index] || is_scheduled[other_index];
+			}
+
+			if (!is_ready)
+			{
+				continue;
+			}
+
+			if (selected_index == pass_count)
+			{
+				selected_index = index;
+			}
+
+			if (previous_index == pass_count || !depends_on[index][previous_index])
+			{
+				selected_index = index;
+				break;
+			}
+		}
+
+		is_scheduled[selected_index] = true;
+		previous_index = selected_index;
+		m_execution_order.push_back(passes[selected_index]);
+	}
+
+	// Lifetimes of the images in the execution order
+	for (std::uint32_t position = 0; position < m_execution_order.size(); ++position)
+	{
+		for (const auto& access : m_passes[m_execution_order[position]].accesses)
+		{
+			auto& resource = m_resources[access.resource];
+
+			if (!resource.is_used)
+			{
+				resource.first_use = position;
+				resource.is_used = true;
+			}
+
+			resource.last_use = position;
+		}
+	}
+}
+
+void RenderGraph::CreateTransientImages(const VulkanDevice& device) noexcept(false)
+{
+	std::vector<ResourceHandle> transient_resources;
+
+	for (ResourceHandle handle = 0; handle < m_resources.size(); ++handle)
+	{
+		auto& resource = m_resources[handle];
+
+		// Images that only culled passes use are not created at all
+		if (resource.is_imported || !resource.is_used)
+		{
+			continue;
+		}
+
+		VkImageUsageFlags image_usage = 0;
+
+		for (auto pass : m_execution_order)
+		{
+			for (const auto& access : m_passes[pass].accesses)
+			{
+				if (access.resource == handle)
+				{
+					image_usage |= GetUsageInfo(access.usage).image_usage;
+				}
+			}
+		}
+
+		// Contents never leave the tile memory of the render pass, so the image may not need any memory at all
+		resource.is_transient_attachment = IsTransientAttachment(handle);
+
+		if (resource.is_transient_attachment)
+		{
+			image_usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+		}
+
+		VkImageCreateInfo image_create_info = {};
+		image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		image_create_info.imageType = VK_IMAGE_TYPE_2D;
+		image_create_info.format = resource.info.format;
+		image_create_info.extent = { resource.info.extent.width, resource.info.extent.height, 1 };
+		image_create_info.mipLevels = 1;
+		image_create_info.arrayLayers = 1;
+		image_create_info.samples = resource.info.samples;
+		image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+		image_create_info.usage = image_usage;
+		image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		if (vkCreateImage(device.GetLogicalDeviceNative(), &image_create_info, nullptr, &resource.image) != VK_SUCCESS)
+		{
+			throw CriticalVulkanError("Could not create a transient image for the render graph.");
+		}
+
+		vkGetImageMemoryRequirements(device.GetLogicalDeviceNative(), resource.image, &resource.memory_requirements);
+
+		transient_resources.push_back(handle);
+		m_statistics.unaliased_transient_memory_size += resource.memory_requirements.size;
+	}
+
+	m_statistics.transient_image_count = static_cast<std::uint32_t>(transient_resources.size());
+
+	const auto& allocator = memory::MemoryManager::GetInstance().GetVMAAllocation();
+
+	VmaAllocationCreateInfo allocation_info = {};
+	allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+	// Every image gets its own allocation, used when images cannot (or should not) share memory
+	const auto allocate_image_memory = [this, &allocator](ResourceHandle handle, const VmaAllocationCreateInfo& image_allocation_info)
+	{
+		auto& resource = m_resources[handle];
+
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		VmaAllocationInfo allocation_result = {};
+
+		const auto result = vmaAllocateMemoryForImage(allocator, resource.image, &image_allocation_info, &allocation, &allocation_result);
+
+		if (result != VK_SUCCESS)
+		{
+			return result;
+		}
+
+		m_transient_allocations.push_back(allocation);
+		resource.memory_block = static_cast<std::uint32_t>(m_transient_allocations.size() - 1);
+		resource.memory_offset = 0;
+
+		vmaBindImageMemory(allocator, allocation, resource.image);
+
+		VkMemoryPropertyFlags memory_properties = 0;
+		vmaGetMemoryTypeProperties(allocator, allocation_result.memoryType, &memory_properties);
+
+		// Lazily allocated memory is only committed when the tile memory runs out, it does not count towards the total
+		if ((memory_properties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0)
+		{
+			++m_statistics.lazily_allocated_image_count;
+		}
+		else
+		{
+			m_statistics.transient_memory_size += resource.memory_requirements.size;
+		}
+
+		return result;
+	};
+
+	// Transient attachments are not aliased, lazily allocated memory types cannot hold any other image
+	std::vector<ResourceHandle> aliased_resources;
+
+	for (auto handle : transient_resources)
+	{
+		if (!m_resources[handle].is_transient_attachment)
+		{
+			aliased_resources.push_back(handle);
+			continue;
+		}
+
+		VmaAllocationCreateInfo lazy_allocation_info = allocation_info;
+		lazy_allocation_info.requiredFlags = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
+		// Tilers expose lazily allocated memory, other devices fall back to regular device-local memory
+		if (allocate_image_memory(handle, lazy_allocation_info) != VK_SUCCESS &&
+			allocate_image_memory(handle, allocation_info) != VK_SUCCESS)
+		{
+			throw CriticalVulkanError("Could not allocate memory for a transient attachment of the render graph.");
+		}
+	}
+
+	// Largest images are placed first, smaller ones fill the gaps between them
+	std::sort(
+		aliased_resources.begin(),
+		aliased_resources.end(),
+		[this](ResourceHandle resource, ResourceHandle other_resource)
+		{
+			return m_resources[resource].memory_requirements.size > m_resources[other_resource].memory_requirements.size;
+		});
+
+	VkMemoryRequirements heap_requirements = {};
+	heap_requirements.memoryTypeBits = ~0u;
+
+	for (auto handle : aliased_resources)
+	{
+		heap_requirements.memoryTypeBits &= m_resources[handle].memory_requirements.memoryTypeBits;
+		heap_requirements.alignment = std::max(heap_requirements.alignment, m_resources[handle].memory_requirements.alignment);
+	}
+
+	// No memory type fits every image, so they cannot share a single allocation
+	if (heap_requirements.memoryTypeBits == 0)
+	{
+		spdlog::warn("Transient images of the render graph need different memory types, they will not be aliased.");
+
+		for (auto handle : aliased_resources)
+		{
+			if (allocate_image_memory(handle, allocation_info) != VK_SUCCESS)
+			{
+				throw CriticalVulkanError("Could not allocate memory for a transient image of the render graph.");
+			}
+		}
+	}
+	else if (!aliased_resources.empty())
+	{
+		std::vector<ResourceHandle> placed_resources;
+
+		for (auto handle : aliased_resources)
+		{
+			auto& resource = m_resources[handle];
+
+			// Only images that are alive at the same time as this one have to stay out of its way
+			std::vector<std::pair<VkDeviceSize, VkDeviceSize>> occupied_ranges;
+
+			for (auto placed_handle : placed_resources)
+			{
+				const auto& placed_resource = m_resources[placed_handle];
+
+				if (placed_resource.last_use >= resource.first_use && resource.last_use >= placed_resource.first_use)
+				{
+					occupied_ranges.emplace_back(placed_resource.memory_offset, placed_resource.memory_offset + placed_resource.memory_requirements.size);
+				}
+			}
+
+			std::sort(occupied_ranges.begin(), occupied_ranges.end());
+
+			// First gap that is large enough
+			VkDeviceSize offset = 0;
+
+			for (const auto& range : occupied_ranges)
+			{
+				if (AlignUp(offset, resource.memory_requirements.alignment) + resource.memory_requirements.size <= range.first)
+				{
+					break;
+				}
+
+				offset = std::max(offset, range.second);
+			}
+
+			resource.memory_offset = AlignUp(offset, resource.memory_requirements.alignment);
+			heap_requirements.size = std::max(heap_requirements.size, resource.memory_offset + resource.memory_requirements.size);
+
+			placed_resources.push_back(handle);
+		}
+
+		VmaAllocation allocation = VK_NULL_HANDLE;
+
+		if (vmaAllocateMemory(allocator, &heap_requirements, &allocation_info, &allocation, nullptr) != VK_SUCCESS)
+		{
+			throw CriticalVulkanError("Could not allocate memory for the transient images of the render graph.");
+		}
+
+		m_transient_allocations.push_back(allocation);
+		m_statistics.transient_memory_size += heap_requirements.size;
+
+		for (auto handle : aliased_resources)
+		{
+			m_resources[handle].memory_block = static_cast<std::uint32_t>(m_transient_allocations.size() - 1);
+			vmaBindImageMemory2(allocator, allocation, m_resources[handle].memory_offset, m_resources[handle].image, nullptr);
+		}
+	}
+
+	for (auto handle : transient_resources)
+	{
+		auto& resource = m_resources[handle];
+
+		VkImageViewCreateInfo image_view_create_info = {};
+		image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		image_view_create_info.image = resource.image;
+		image_view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		image_view_create_info.format = resource.info.format;
+		image_view_create_info.subresourceRange.aspectMask = GetAspectMask(resource.info.format);
+		image_view_create_info.subresourceRange.baseMipLevel = 0;
+		image_view_create_info.subresourceRange.levelCount = 1;
+		image_view_create_info.subresourceRange.baseArrayLayer = 0;
+		image_view_create_info.subresourceRange.layerCount = 1;
+
+		if (vkCreateImageView(device.GetLogicalDeviceNative(), &image_view_create_info, nullptr, &resource.image_view) != VK_SUCCESS)
+		{
+			throw CriticalVulkanError("Could not create an image view for a transient image of the render graph.");
+		}
+	}
+}
+
+bool RenderGraph::IsTransientAttachment(ResourceHandle resource) const noexcept(true)
+{
+	const auto& transient_resource = m_resources[resource];
+
+	// Anything that is used by another pass has to be stored to memory in between
+	if (transient_resource.is_imported || !transient_resource.is_used || transient_resource.first_use != transient_resource.last_use)
+	{
+		return false;
+	}
+
+	const auto& pass = m_passes[m_execution_order[transient_resource.first_use]];
+
+	if (pass.type != PassType::Graphics)
+	{
+		return false;
+	}
+
+	const auto is_attachment_only = std::all_of(
+		pass.accesses.begin(),
+		pass.accesses.end(),
+		[resource](const ResourceAccess& access)
+		{
+			return
+				access.resource != resource ||
+				access.usage == ResourceUsage::ColorAttachment ||
+				access.usage == ResourceUsage::DepthStencilAttachment ||
+				access.usage == ResourceUsage::DepthStencilReadOnly ||
+				access.usage == ResourceUsage::ResolveAttachment;
+		});
+
+	// Loading would read memory that lazily allocated images do not have
+	const auto is_loaded = std::any_of(
+		pass.attachments.begin(),
+		pass.attachments.end(),
+		[resource](const Attachment& attachment)
+		{
+			return attachment.resource == resource && attachment.load_op == VK_ATTACHMENT_LOAD_OP_LOAD;
+		});
+
+	return is_attachment_only && !is_loaded;
+}
+
+void RenderGraph::CreateBarriers() noexcept(false)
+{
+	// State an image has to be in for a pass, all accesses of a pass have to agree on the layout
+	const auto get_pass_state = [this](const Pass& pass, ResourceHandle resource)
+	{
+		ImageState state = {};
+		state.stages = 0;
+
+		auto has_layout = false;
+
+		for (const auto& access : pass.accesses)
+		{
+			if (access.resource != resource)
+			{
+				continue;
+			}
+
+			const auto usage_info = GetUsageInfo(access.usage);
+
+			if (has_layout && state.layout != usage_info.layout)
+			{
+				throw CriticalVulkanError("Render graph pass \"" + pass.name + "\" uses image \"" + m_resources[resource].name + "\" in two different layouts.");
+			}
+
+			state.layout = usage_info.layout;
+			state.stages |= usage_info.stages;
+			state.access |= usage_info.access;
+			has_layout = true;
+		}
+
+		return state;
+	};
+
+	// The last use of every image, transient images are waited on at the start of the next execution
+	std::vector<ImageState> last_states(m_resources.size());
+
+	for (ResourceHandle handle = 0; handle < m_resources.size(); ++handle)
+	{
+		if (m_resources[handle].is_used)
+		{
+			last_states[handle] = get_pass_state(m_passes[m_execution_order[m_resources[handle].last_use]], handle);
+		}
+	}
+
+	std::vector<ImageState> states(m_resources.size());
+
+	for (ResourceHandle handle = 0; handle < m_resources.size(); ++handle)
+	{
+		const auto& resource = m_resources[handle];
+
+		if (resource.is_imported)
+		{
+			states[handle] = resource.initial_state;
+			continue;
+		}
+
+		// Contents are discarded, but every image that shares memory with this one has to be done with it
+		states[handle].layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		for (ResourceHandle other_handle = 0; other_handle < m_resources.size(); ++other_handle)
+		{
+			const auto& other_resource = m_resources[other_handle];
+
+			if (!resource.is_used ||
+				!other_resource.is_used ||
+				other_resource.is_imported ||
+				other_resource.memory_block != resource.memory_block ||
+				other_resource.memory_offset >= resource.memory_offset + resource.memory_requirements.size ||
+				resource.memory_offset >= other_resource.memory_offset + other_resource.memory_requirements.size)
+			{
+				continue;
+			}
+
+			const auto& other_state = last_states[other_handle];
+
+			states[handle].stages |= other_state.stages;
+			states[handle].access |= other_state.access;
+
+			if ((other_state.access & write_access_mask) != 0)
+			{
+				states[handle].write_stages |= other_state.stages;
+				states[handle].write_access |= other_state.access & write_access_mask;
+			}
+		}
+	}
+
+	const auto add_barrier = [this](BarrierBatch& batch, ResourceHandle resource, ImageState& current_state, const ImageState& required_state)
+	{
+		if (!NeedsImageBarrier(current_state, required_state))
+		{
+			MergeImageSubresourceStates(current_state, required_state);
+			return;
+		}
+
+		batch.barriers.push_back({ resource, current_state, required_state });
+		batch.source_stages |= GetBarrierSourceStageMask(current_state);
+		batch.destination_stages |= required_state.stages;
+		current_state = GetStateAfterImageBarrier(current_state, required_state);
+
+		++m_statistics.image_barrier_count;
+	};
+
+	for (auto handle : m_execution_order)
+	{
+		auto& pass = m_passes[handle];
+		pass.barriers = {};
+
+		std::vector<ResourceHandle> resources;
+
+		for (const auto& access : pass.accesses)
+		{
+			if (std::find(resources.begin(), resources.end(), access.resource) == resources.end())
+			{
+				resources.push_back(access.resource);
+			}
+		}
+
+		for (auto resource : resources)
+		{
+			add_barrier(pass.barriers, resource, states[resource], get_pass_state(pass, resource));
+		}
+
+		if (!pass.barriers.barriers.empty())
+		{
+			++m_statistics.pipeline_barrier_count;
+		}
+	}
+
+	m_final_barriers = {};
+
+	for (ResourceHandle handle = 0; handle < m_resources.size(); ++handle)
+	{
+		if (m_resources[handle].is_imported && m_resources[handle].is_used)
+		{
+			add_barrier(m_final_barriers, handle, states[handle], m_resources[handle].final_state);
+		}
+	}
+
+	if (!m_final_barriers.barriers.empty())
+	{
+		++m_statistics.pipeline_barrier_count;
+	}
+}
+
+void RenderGraph::CreateRenderPasses(const VulkanDevice& device) noexcept(false)
+{
+	for (std::uint32_t position = 0; position < m_execution_order.size(); ++position)
+	{
+		auto& pass = m_passes[m_execution_order[position]];
+
+		if (pass.type != PassType::Graphics)
+		{
+			continue;
+		}
+
+		if (pass.attachments.empty())
+		{
+			throw CriticalVulkanError("Render graph pass \"" + pass.name + "\" is a graphics pass without attachments.");
+		}
+
+		pass.extent = m_resources[pass.attachments.front().resource].info.extent;
+		pass.clear_values.clear();
+
+		std::vector<VkAttachmentDescription> attachment_descriptions;
+		std::vector<VkAttachmentReference> color_attachment_refs;
+		std::vector<ResourceHandle> color_attachment_resources;
+		VkAttachmentReference depth_stencil_attachment_ref = {};
+		auto has_depth_stencil_attachment = false;
+
+		// Resolve references have to line up with the color attachments, so they are matched up after the loop
+		std::vector<std::pair<ResourceHandle, VkAttachmentReference>> resolve_attachment_refs_by_source;
+
+		for (const auto& attachment : pass.attachments)
+		{
+			const auto& resource = m_resources[attachment.resource];
+
+			if (resource.info.extent.width != pass.extent.width || resource.info.extent.height != pass.extent.height)
+			{
+				throw CriticalVulkanError("Attachments of render graph pass \"" + pass.name + "\" differ in size.");
+			}
+
+			// Only store the contents when the next pass that uses the image reads them
+			auto is_stored = resource.is_imported && resource.last_use == position;
+
+			for (auto next_position = position + 1; next_position < m_execution_order.size(); ++next_position)
+			{
+				const auto& next_pass = m_passes[m_execution_order[next_position]];
+
+				if (ReadsResource(next_pass, attachment.resource))
+				{
+					is_stored = true;
+					break;
+				}
+
+				if (WritesResource(next_pass, attachment.resource))
+				{
+					break;
+				}
+			}
+
+			auto usage = ResourceUsage::ColorAttachment;
+
+			if (attachment.is_depth_stencil)
+			{
+				usage = attachment.is_read_only ? ResourceUsage::DepthStencilReadOnly : ResourceUsage::DepthStencilAttachment;
+			}
+			else if (attachment.is_resolve)
+			{
+				usage = ResourceUsage::ResolveAttachment;
+			}
+
+			const auto layout = GetUsageInfo(usage).layout;
+			const auto store_op = is_stored ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+			// Layout transitions are done by the barriers before the pass
+			VkAttachmentDescription attachment_description = {};
+			attachment_description.format = resource.info.format;
+			attachment_description.samples = resource.info.samples;
+			attachment_description.loadOp = attachment.load_op;
+			attachment_description.storeOp = store_op;
+			attachment_description.stencilLoadOp = HasStencilComponent(resource.info.format) ? attachment.load_op : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			attachment_description.stencilStoreOp = HasStencilComponent(resource.info.format) ? store_op : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			attachment_description.initialLayout = layout;
+			attachment_description.finalLayout = layout;
+
+			VkAttachmentReference attachment_ref = {};
+			attachment_ref.attachment = static_cast<std::uint32_t>(attachment_descriptions.size());
+			attachment_ref.layout = layout;
+
+			if (attachment.is_depth_stencil)
+			{
+				depth_stencil_attachment_ref = attachment_ref;
+				has_depth_stencil_attachment = true;
+			}
+			else if (attachment.is_resolve)
+			{
+				resolve_attachment_refs_by_source.emplace_back(attachment.resolve_source, attachment_ref);
+			}
+			else
+			{
+				color_attachment_refs.push_back(attachment_ref);
+				color_attachment_resources.push_back(attachment.resource);
+			}
+
+			attachment_descriptions.push_back(attachment_description);
+			pass.clear_values.push_back(attachment.clear_value);
+		}
+
+		// Color attachments without a resolve attachment are left unresolved
+		std::vector<VkAttachmentReference> resolve_attachment_refs;
+
+		if (!resolve_attachment_refs_by_source.empty())
+		{
+			resolve_attachment_refs.resize(color_attachment_refs.size(), { VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED });
+
+			for (const auto& resolve_attachment_ref : resolve_attachment_refs_by_source)
+			{
+				const auto source = std::find(color_attachment_resources.begin(), color_attachment_resources.end(), resolve_attachment_ref.first);
+				resolve_attachment_refs[std::distance(color_attachment_resources.begin(), source)] = resolve_attachment_ref.second;
+			}
+		}
+
+		VkSubpassDescription subpass = {};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = static_cast<std::uint32_t>(color_attachment_refs.size());
+		subpass.pColorAttachments = color_attachment_refs.data();
+		subpass.pResolveAttachments = resolve_attachment_refs.empty() ? nullptr : resolve_attachment_refs.data();
+		subpass.pDepthStencilAttachment = has_depth_stencil_attachment ? &depth_stencil_attachment_ref : nullptr;
+
+		// No subpass dependencies, the barriers recorded by the graph synchronize with the passes before and after
+		VulkanRenderPassInfo render_pass_info = {};
+		render_pass_info.attachment_descriptions = attachment_descriptions;
+		render_pass_info.subpass_descriptions = { subpass };
+
+		pass.render_pass.Create(device, render_pass_info);
+	}
+}
+
+VkFramebuffer RenderGraph::GetFramebuffer(const VulkanDevice& device, Pass& pass) noexcept(false)
+{
+	std::vector<VkImageView> image_views;
+
+	for (const auto& attachment : pass.attachments)
+	{
+		image_views.push_back(m_resources[attachment.resource].image_view);
+	}
+
+	const auto framebuffer = pass.framebuffers.find(image_views);
+
+	if (framebuffer != pass.framebuffers.end())
+	{
+		return framebuffer->second;
+	}
+
+	VkFramebufferCreateInfo framebuffer_info = {};
+	framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebuffer_info.renderPass = pass.render_pass.GetNative();
+	framebuffer_info.attachmentCount = static_cast<std::uint32_t>(image_views.size());
+	framebuffer_info.pAttachments = image_views.data();
+	framebuffer_info.width = pass.extent.width;
+	framebuffer_info.height = pass.extent.height;
+	framebuffer_info.layers = 1;
+
+	VkFramebuffer new_framebuffer = VK_NULL_HANDLE;
+
+	if (vkCreateFramebuffer(device.GetLogicalDeviceNative(), &framebuffer_info, nullptr, &new_framebuffer) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create a framebuffer for render graph pass \"" + pass.name + "\".");
+	}
+
+	pass.framebuffers.emplace(image_views, new_framebuffer);
+
+	return new_framebuffer;
+}
+
+void RenderGraph::RecordBarriers(const VkCommandBuffer& command_buffer, const BarrierBatch& batch) const noexcept(true)
+{
+	if (batch.barriers.empty())
+	{
+		return;
+	}
+
+	std::vector<VkImageMemoryBarrier> image_barriers;
+	image_barriers.reserve(batch.barriers.size());
+
+	for (const auto& barrier : batch.barriers)
+	{
+		const auto& resource = m_resources[barrier.resource];
+
+		VkImageMemoryBarrier image_barrier = {};
+		image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		image_barrier.srcAccessMask = GetBarrierSourceAccessMask(barrier.old_state);
+		image_barrier.dstAccessMask = barrier.new_state.access;
+		image_barrier.oldLayout = barrier.old_state.layout;
+		image_barrier.newLayout = barrier.new_state.layout;
+		image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		image_barrier.image = resource.image;
+		image_barrier.subresourceRange.aspectMask = GetAspectMask(resource.info.format);
+		image_barrier.subresourceRange.baseMipLevel = 0;
+		image_barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+		image_barrier.subresourceRange.baseArrayLayer = 0;
+		image_barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+		image_barriers.push_back(image_barrier);
+	}
+
+	vkCmdPipelineBarrier(
+		command_buffer,
+		(batch.source_stages != 0) ? batch.source_stages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		batch.destination_stages,
+		0,
+		0,
+		nullptr,
+		0,
+		nullptr,
+		static_cast<std::uint32_t>(image_barriers.size()),
+		image_barriers.data());
+}
+
+bool RenderGraph::ReadsResource(const Pass& pass, ResourceHandle resource) const noexcept(true)
+{
+	const auto reads_access = std::any_of(
+		pass.accesses.begin(),
+		pass.accesses.end(),
+		[resource](const ResourceAccess& access)
+		{
+			return access.resource == resource && !GetUsageInfo(access.usage).is_write;
+		});
+
+	// Loading an attachment reads what was in it before
+	const auto loads_attachment = std::any_of(
+		pass.attachments.begin(),
+		pass.attachments.end(),
+		[resource](const Attachment& attachment)
+		{
+			return attachment.resource == resource && attachment.load_op == VK_ATTACHMENT_LOAD_OP_LOAD;
+		});
+
+	return reads_access || loads_attachment;
+}
+
+bool RenderGraph::WritesResource(const Pass& pass, ResourceHandle resource) const noexcept(true)
+{
+	return std::any_of(
+		pass.accesses.begin(),
+		pass.accesses.end(),
+		[resource](const ResourceAccess& access)
+		{
+			return access.resource == resource && GetUsageInfo(access.usage).is_write;
+		});
+}
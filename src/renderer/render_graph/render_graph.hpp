@@ -0,0 +1,347 @@
+#ifndef RENDER_GRAPH_HPP
+#define RENDER_GRAPH_HPP
+
+// Application
+#include "renderer/vulkan_wrapper/vulkan_image_state_tracker.hpp"
+#include "renderer/vulkan_wrapper/vulkan_render_pass.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// VulkanMemoryAllocator
+#include <vk_mem_alloc.h>
+
+// C++ standard
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vkc
+{
+	namespace vk_wrapper
+	{
+		class VulkanDevice;
+	}
+
+	namespace render_graph
+	{
+		/** Handle to an image in the render graph, stays valid until the graph is destroyed */
+		using ResourceHandle = std::uint32_t;
+
+		/** Handle to a pass in the render graph, stays valid until the graph is destroyed */
+		using PassHandle = std::uint32_t;
+
+		/** Records the commands of a pass, called every time the graph is executed */
+		using PassRecordCallback = std::function<void(const VkCommandBuffer&)>;
+
+		/** Kind of work a pass records */
+		enum class PassType
+		{
+			Graphics,	// Draws into attachments, the graph begins and ends the render pass around the callback
+			Compute		// Dispatches or transfers, recorded outside of a render pass
+		};
+
+		/** Ways a pass can use an image, every usage implies an image layout, pipeline stages and access */
+		enum class ResourceUsage
+		{
+			ColorAttachment,		// Added through "AddColorAttachment"
+			DepthStencilAttachment,	// Added through "AddDepthStencilAttachment"
+			DepthStencilReadOnly,	// Added through "AddDepthStencilAttachment" with "read_only" set
+			ResolveAttachment,		// Added through "AddResolveAttachment"
+			FragmentShaderRead,
+			ComputeShaderRead,
+			ComputeShaderWrite,
+			TransferSource,
+			TransferDestination
+		};
+
+		/** Layout of an image, and the pipeline stages and access of its last use */
+		using ImageState = vk_wrapper::ImageSubresourceState;
+
+		/** Image that only lives while the graph executes, created by the graph itself */
+		struct TransientImageInfo
+		{
+			VkFormat format = VK_FORMAT_UNDEFINED;
+			VkExtent2D extent = {};
+			VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+		};
+
+		/** Results of the last compilation */
+		struct RenderGraphStatistics
+		{
+			std::uint32_t pass_count = 0;
+			std::uint32_t culled_pass_count = 0;
+
+			/** Image barriers and "vkCmdPipelineBarrier" calls recorded per execution */
+			std::uint32_t image_barrier_count = 0;
+			std::uint32_t pipeline_barrier_count = 0;
+
+			std::uint32_t transient_image_count = 0;
+
+			/** Transient images that never leave the tile memory of a single render pass, and got lazily allocated memory */
+			std::uint32_t lazily_allocated_image_count = 0;
+
+			/** Memory used by the transient images, and the memory they would need without aliasing */
+			VkDeviceSize transient_memory_size = 0;
+			VkDeviceSize unaliased_transient_memory_size = 0;
+		};
+
+		/** Frame graph that derives render passes, barriers, and transient images from the passes of a frame */
+		/**
+		 * Passes declare which images they read and write. Compiling the graph:
+		 *
+		 * - culls passes whose results are never used (unless they have side effects)
+		 * - orders the passes, dependent passes are spaced apart where possible
+		 * - creates a render pass for every graphics pass, attachments that are
+		 *   not used afterwards are not stored, and multisampled attachments
+		 *   are resolved by the render pass itself
+		 * - derives the layout transitions and barriers between passes, and
+		 *   batches the barriers of a pass into a single "vkCmdPipelineBarrier"
+		 * - creates the transient images, images that are never alive at the
+		 *   same time share the same memory
+		 * - creates images that are only used as attachments of a single pass
+		 *   (and neither loaded nor stored) as transient attachments, backed by
+		 *   lazily allocated memory when the device has it
+		 *
+		 * A pass reads the most recent write of an image that was added before
+		 * it. Images from outside the graph (such as the swapchain image) are
+		 * imported, and their image and view are set before every execution.
+		 *
+		 * The graph is compiled once and executed every frame, it has to be
+		 * destroyed and built again when any of the images change (e.g. when the
+		 * swapchain is recreated). Transient images are shared by the frames in
+		 * flight, the first barrier of every frame waits for their last use in
+		 * the previous frame.
+		 */
+		class RenderGraph
+		{
+		public:
+			RenderGraph() noexcept(true);
+			~RenderGraph() noexcept(true);
+
+			/** Add an image that is owned by someone else */
+			/**
+			 * The image is in "initial_state" when the graph starts executing, and
+			 * is transitioned to "final_state" after the last pass that uses it.
+			 */
+			ResourceHandle ImportImage(
+				const std::string& name,
+				VkFormat format,
+				const VkExtent2D& extent,
+				const ImageState& initial_state,
+				const ImageState& final_state) noexcept(false);
+
+			/** Add an image that is created by the graph, its contents do not survive between executions */
+			ResourceHandle CreateImage(
+				const std::string& name,
+				const TransientImageInfo& info) noexcept(false);
+
+			/** Add a pass, passes are executed in order of their dependencies */
+			PassHandle AddPass(
+				const std::string& name,
+				PassType type,
+				const PassRecordCallback& record) noexcept(false);
+
+			/** Render to an image in a graphics pass, attachments are bound in the order they are added */
+			void AddColorAttachment(
+				PassHandle pass,
+				ResourceHandle resource,
+				VkAttachmentLoadOp load_op,
+				const VkClearColorValue& clear_color = {}) noexcept(false);
+
+			/** Depth test (and write, unless "read_only" is set) against an image in a graphics pass */
+			void AddDepthStencilAttachment(
+				PassHandle pass,
+				ResourceHandle resource,
+				VkAttachmentLoadOp load_op,
+				const VkClearDepthStencilValue& clear_value = { 1.0f, 0 },
+				bool read_only = false) noexcept(false);
+
+			/** Resolve a multisampled color attachment of a graphics pass into a single-sampled image at the end of the pass */
+			/**
+			 * The resolve happens as part of the render pass, on tilers the
+			 * multisampled samples never have to leave tile memory. Both images
+			 * need the same format, the source has to be a color attachment of
+			 * the pass already.
+			 */
+			void AddResolveAttachment(
+				PassHandle pass,
+				ResourceHandle source,
+				ResourceHandle destination) noexcept(false);
+
+			/** Read from or write to an image outside of the attachments, e.g. sampling or storage */
+			void AddImageAccess(
+				PassHandle pass,
+				ResourceHandle resource,
+				ResourceUsage usage) noexcept(false);
+
+			/** Never cull the pass, for passes whose work is not visible to the graph (e.g. buffer writes) */
+			/**
+			 * Passes with side effects keep their place relative to every other
+			 * pass, they are only ever moved by culling the passes around them.
+			 */
+			void SetSideEffects(PassHandle pass) noexcept(true);
+
+			/** Cull and order the passes, and create all render passes and transient images */
+			void Compile(const vk_wrapper::VulkanDevice& device) noexcept(false);
+
+			/** Set the image and view an imported image refers to for the next execution */
+			void SetImportedImage(
+				ResourceHandle resource,
+				VkImage image,
+				VkImageView image_view) noexcept(true);
+
+			/** Record all passes into a command buffer that is being recorded (outside of a render pass) */
+			void Execute(
+				const vk_wrapper::VulkanDevice& device,
+				const VkCommandBuffer& command_buffer) noexcept(false);
+
+			/** Get the render pass of a graphics pass, pipelines that draw in the pass are created with it */
+			VkRenderPass GetRenderPass(PassHandle pass) const noexcept(true);
+
+			/** Get the results of the last compilation */
+			const RenderGraphStatistics& GetStatistics() const noexcept(true);
+
+			/** Destroy all Vulkan objects, and remove every pass and resource */
+			void Destroy(const vk_wrapper::VulkanDevice& device) noexcept(true);
+
+		private:
+			/** Single use of an image by a pass */
+			struct ResourceAccess
+			{
+				ResourceHandle resource = 0;
+				ResourceUsage usage = ResourceUsage::FragmentShaderRead;
+			};
+
+			/** Attachment of a graphics pass */
+			struct Attachment
+			{
+				ResourceHandle resource = 0;
+				VkAttachmentLoadOp load_op = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+				VkClearValue clear_value = {};
+				bool is_depth_stencil = false;
+				bool is_read_only = false;
+
+				/** Resolve attachments receive the resolved samples of the color attachment that uses "resolve_source" */
+				bool is_resolve = false;
+				ResourceHandle resolve_source = 0;
+			};
+
+			/** Layout transition or memory dependency of a single image */
+			struct ImageBarrier
+			{
+				ResourceHandle resource = 0;
+				ImageState old_state;
+				ImageState new_state;
+			};
+
+			/** Barriers recorded together in a single "vkCmdPipelineBarrier" */
+			struct BarrierBatch
+			{
+				std::vector<ImageBarrier> barriers;
+				VkPipelineStageFlags source_stages = 0;
+				VkPipelineStageFlags destination_stages = 0;
+			};
+
+			struct Pass
+			{
+				std::string name;
+				PassType type = PassType::Graphics;
+				PassRecordCallback record;
+
+				std::vector<ResourceAccess> accesses;
+				std::vector<Attachment> attachments;
+				bool has_side_effects = false;
+
+				/** Set during compilation */
+				bool is_culled = false;
+				BarrierBatch barriers;
+				vk_wrapper::VulkanRenderPass render_pass;
+				VkExtent2D extent = {};
+				std::vector<VkClearValue> clear_values;
+
+				/** Framebuffers are created the first time a combination of image views is executed */
+				std::map<std::vector<VkImageView>, VkFramebuffer> framebuffers;
+			};
+
+			struct Resource
+			{
+				std::string name;
+				bool is_imported = false;
+				TransientImageInfo info;
+
+				/** Only used by imported images */
+				ImageState initial_state;
+				ImageState final_state;
+
+				/** Set during compilation (transient images) or before every execution (imported images) */
+				VkImage image = VK_NULL_HANDLE;
+				VkImageView image_view = VK_NULL_HANDLE;
+
+				/** Position of the first and last pass that uses the image in the execution order */
+				std::uint32_t first_use = 0;
+				std::uint32_t last_use = 0;
+				bool is_used = false;
+
+				/** Only lives in the attachments of a single render pass, set during compilation */
+				bool is_transient_attachment = false;
+
+				/** Range of the image in the transient memory */
+				std::uint32_t memory_block = 0;
+				VkDeviceSize memory_offset = 0;
+				VkMemoryRequirements memory_requirements = {};
+			};
+
+		private:
+			/** Mark the passes that contribute to an imported image or have side effects */
+			void CullPasses() noexcept(true);
+
+			/** Order the remaining passes, a pass always comes after the passes it depends on */
+			void OrderPasses() noexcept(false);
+
+			/** Create the transient images, and place them in memory so that images that are never alive at the same time overlap */
+			void CreateTransientImages(const vk_wrapper::VulkanDevice& device) noexcept(false);
+
+			/** Check whether an image is only used as an attachment of a single pass, and its contents are neither loaded nor stored */
+			bool IsTransientAttachment(ResourceHandle resource) const noexcept(true);
+
+			/** Derive the barriers before every pass, and after the last pass */
+			void CreateBarriers() noexcept(false);
+
+			/** Create a render pass for every graphics pass */
+			void CreateRenderPasses(const vk_wrapper::VulkanDevice& device) noexcept(false);
+
+			/** Find or create the framebuffer for the current image views of a pass */
+			VkFramebuffer GetFramebuffer(const vk_wrapper::VulkanDevice& device, Pass& pass) noexcept(false);
+
+			/** Record a batch of barriers, nothing is recorded for an empty batch */
+			void RecordBarriers(const VkCommandBuffer& command_buffer, const BarrierBatch& batch) const noexcept(true);
+
+			/** Check whether a pass reads the previous contents of an image */
+			bool ReadsResource(const Pass& pass, ResourceHandle resource) const noexcept(true);
+
+			/** Check whether a pass changes the contents of an image */
+			bool WritesResource(const Pass& pass, ResourceHandle resource) const noexcept(true);
+
+		private:
+			std::vector<Pass> m_passes;
+			std::vector<Resource> m_resources;
+
+			/** Passes that are not culled, in execution order */
+			std::vector<PassHandle> m_execution_order;
+
+			/** Transitions imported images to their final state */
+			BarrierBatch m_final_barriers;
+
+			/** Memory of the transient images, either one allocation shared by all of them or one per image */
+			std::vector<VmaAllocation> m_transient_allocations;
+
+			RenderGraphStatistics m_statistics;
+			bool m_is_compiled;
+		};
+	}
+}
+
+#endif // RENDER_GRAPH_HPP
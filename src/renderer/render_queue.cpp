@@ -0,0 +1,117 @@
+// Application
+#include "core/radix_sort.hpp"
+#include "render_queue.hpp"
+#include "vulkan_wrapper/vulkan_utility.hpp"
+
+// GLM
+#include <glm/common.hpp>
+
+using namespace vkc;
+
+RenderQueue::RenderQueue() noexcept(true)
+{}
+
+RenderQueue::~RenderQueue() noexcept(true)
+{}
+
+std::uint64_t RenderQueue::MakeSortKey(
+	RenderQueuePass pass,
+	std::uint32_t pipeline_id,
+	std::uint32_t material_id,
+	std::uint32_t mesh_id,
+	float depth) noexcept(true)
+{
+	const auto pass_bits = static_cast<std::uint64_t>(pass) & 0xF;
+	const auto pipeline_bits = static_cast<std::uint64_t>(pipeline_id) & 0xFFF;
+	const auto material_bits = static_cast<std::uint64_t>(material_id) & 0xFFFF;
+	const auto mesh_bits = static_cast<std::uint64_t>(mesh_id) & 0xFFFF;
+	const auto depth_bits = static_cast<std::uint64_t>(glm::clamp(depth, 0.0f, 1.0f) * 65535.0f) & 0xFFFF;
+
+	if (pass == RenderQueuePass::Transparent)
+	{
+		// Back to front, blending needs the correct order more than it needs fewer binds
+		return (pass_bits << 60) | ((0xFFFF - depth_bits) << 44) | (pipeline_bits << 32) | (material_bits << 16) | mesh_bits;
+	}
+
+	return (pass_bits << 60) | (pipeline_bits << 48) | (material_bits << 32) | (mesh_bits << 16) | depth_bits;
+}
+
+void RenderQueue::Push(const DrawPacket& packet) noexcept(false)
+{
+	m_packets.push_back(packet);
+	m_sort_keys.push_back(packet.sort_key);
+}
+
+void RenderQueue::Sort() noexcept(false)
+{
+	core::RadixSortIndices(m_sort_keys, m_sorted_indices, m_sort_scratch);
+}
+
+void RenderQueue::Record(const VkCommandBuffer& command_buffer) noexcept(true)
+{
+	m_statistics = {};
+	m_statistics.packet_count = static_cast<std::uint32_t>(m_sorted_indices.size());
+
+	VkPipeline bound_pipeline = VK_NULL_HANDLE;
+	VkDescriptorSet bound_descriptor_set = VK_NULL_HANDLE;
+	VkBuffer bound_vertex_buffer = VK_NULL_HANDLE;
+
+	for (auto index : m_sorted_indices)
+	{
+		const auto& packet = m_packets[index];
+
+		if (packet.pipeline != bound_pipeline)
+		{
+			vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, packet.pipeline);
+			bound_pipeline = packet.pipeline;
+			++m_statistics.pipeline_bind_count;
+		}
+		else
+		{
+			++m_statistics.eliminated_state_change_count;
+		}
+
+		if (packet.descriptor_set != bound_descriptor_set)
+		{
+			vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, packet.pipeline_layout, 0, 1, &packet.descriptor_set, 0, nullptr);
+			bound_descriptor_set = packet.descriptor_set;
+			++m_statistics.descriptor_set_bind_count;
+		}
+		else
+		{
+			++m_statistics.eliminated_state_change_count;
+		}
+
+		if (packet.vertex_buffer != bound_vertex_buffer)
+		{
+			VkDeviceSize offset = 0;
+			vkCmdBindVertexBuffers(command_buffer, 0, 1, &packet.vertex_buffer, &offset);
+			bound_vertex_buffer = packet.vertex_buffer;
+			++m_statistics.vertex_buffer_bind_count;
+		}
+		else
+		{
+			++m_statistics.eliminated_state_change_count;
+		}
+
+		// Push constants are tiny, and differ for nearly every draw anyway
+		if (packet.draw_data_stages != 0)
+		{
+			vk_wrapper::utility::RecordPushConstants(command_buffer, packet.pipeline_layout, packet.draw_data_stages, packet.draw_data);
+		}
+
+		vkCmdDraw(command_buffer, packet.vertex_count, packet.instance_count, 0, packet.first_instance);
+	}
+}
+
+void RenderQueue::Clear() noexcept(true)
+{
+	m_packets.clear();
+	m_sort_keys.clear();
+	m_sorted_indices.clear();
+}
+
+const RenderQueueStatistics& RenderQueue::GetStatistics() const noexcept(true)
+{
+	return m_statistics;
+}
@@ -0,0 +1,115 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// GLM
+#include <glm/mat4x4.hpp>
+
+// C++ standard
+#include <cstdint>
+#include <vector>
+
+namespace vkc
+{
+	/** Per-draw data, pushed as push constants (matches "resources/shaders/include/draw_data.glsl") */
+	struct DrawData
+	{
+		glm::mat4 model_matrix;
+		std::uint32_t material_index;
+		std::uint32_t object_id;
+	};
+
+	/** Passes are the most significant part of a sort key, draws of a pass are always recorded together */
+	enum class RenderQueuePass
+	{
+		DepthPrepass = 0,
+		Opaque = 1,
+		Transparent = 2
+	};
+
+	/** Everything needed to record a single (instanced) draw call */
+	struct DrawPacket
+	{
+		std::uint64_t sort_key = 0;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+
+		/** Bound to set 0, sets with a higher number are left alone */
+		VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+
+		VkBuffer vertex_buffer = VK_NULL_HANDLE;
+		std::uint32_t vertex_count = 0;
+		std::uint32_t first_instance = 0;
+		std::uint32_t instance_count = 1;
+
+		DrawData draw_data = {};
+		VkShaderStageFlags draw_data_stages = 0;
+	};
+
+	/** Bind counts of the last recorded frame */
+	struct RenderQueueStatistics
+	{
+		std::uint32_t packet_count = 0;
+		std::uint32_t pipeline_bind_count = 0;
+		std::uint32_t descriptor_set_bind_count = 0;
+		std::uint32_t vertex_buffer_bind_count = 0;
+
+		/** Binds that were skipped because the state was bound already */
+		std::uint32_t eliminated_state_change_count = 0;
+	};
+
+	/** Collects the draw packets of a frame, sorts them by state, and records them without redundant binds */
+	/**
+	 * Sort keys are 64 bits (most significant first):
+	 *
+	 * Opaque:      pass (4) | pipeline (12) | material (16) | mesh (16) | depth (16)
+	 * Transparent: pass (4) | depth (16, inverted) | pipeline (12) | material (16) | mesh (16)
+	 *
+	 * Opaque draws are grouped by state and drawn front to back within a
+	 * group, transparent draws are drawn back to front regardless of state.
+	 */
+	class RenderQueue
+	{
+	public:
+		RenderQueue() noexcept(true);
+		~RenderQueue() noexcept(true);
+
+		/** Build a sort key, "depth" is the normalized view depth of the draw (0 is the near plane) */
+		static std::uint64_t MakeSortKey(
+			RenderQueuePass pass,
+			std::uint32_t pipeline_id,
+			std::uint32_t material_id,
+			std::uint32_t mesh_id,
+			float depth) noexcept(true);
+
+		/** Add a draw packet to the queue */
+		void Push(const DrawPacket& packet) noexcept(false);
+
+		/** Sort the queued packets by their sort key */
+		void Sort() noexcept(false);
+
+		/** Record the sorted packets into a command buffer (inside a render pass) */
+		void Record(const VkCommandBuffer& command_buffer) noexcept(true);
+
+		/** Remove all packets, call at the start of every frame */
+		void Clear() noexcept(true);
+
+		/** Get the bind counts of the last call to "Record" */
+		const RenderQueueStatistics& GetStatistics() const noexcept(true);
+
+	private:
+		std::vector<DrawPacket> m_packets;
+
+		/** Sort keys are copied out of the packets to keep the radix sort cache friendly */
+		std::vector<std::uint64_t> m_sort_keys;
+		std::vector<std::uint32_t> m_sorted_indices;
+		std::vector<std::uint32_t> m_sort_scratch;
+
+		RenderQueueStatistics m_statistics;
+	};
+}
+
+#endif // RENDER_QUEUE_HPP
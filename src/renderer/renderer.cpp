@@ -10,6 +10,8 @@
 //////////////////////////////////////////////////////////////////////////
 
 // GLM
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
@@ -24,6 +26,8 @@
 
 // C++ standard
 #include <algorithm>
+#include <cmath>
+#include <filesystem>
 #include <fstream>
 #include <set>
 #include <string>
@@ -33,6 +37,13 @@
 
 using namespace vkc;
 
+// Hot reload recompiles shaders from GLSL, builds without runtime shader compilation cannot do that
+#ifdef VKC_NO_RUNTIME_SHADER_COMPILATION
+static const constexpr bool use_shader_hot_reload = false;
+#else
+static const constexpr bool use_shader_hot_reload = global_settings::enable_shader_hot_reload;
+#endif // VKC_NO_RUNTIME_SHADER_COMPILATION
+
 // Hard-coded model
 const std::vector<VertexPCT> vertices =
 {
@@ -44,7 +55,6 @@ const std::vector<VertexPCT> vertices =
 
 struct CameraData
 {
-	glm::mat4 model_matrix;
 	glm::mat4 view_matrix;
 	glm::mat4 projection_matrix;
 };
@@ -53,6 +63,40 @@ Renderer::Renderer()
 	: m_frame_index(0)
 	, m_current_swapchain_image_index(0)
 	, m_framebuffer_resized(false)
+	, m_simulation_time(0.0)
+	, m_view_projection_matrix(1.0f)
+	, m_pipeline_layout(VK_NULL_HANDLE)
+	, m_draw_data_stages(0)
+	, m_frame_descriptor_template(nullptr)
+	, m_triangle_mesh(0)
+	, m_recorded_frame_count(0)
+	, m_eliminated_state_change_count(0)
+	, m_timed_frame_count(0)
+	, m_hitch_count(0)
+	, m_use_gpu_driven_rendering(false)
+	, m_culled_frame_count(0)
+	, m_visible_object_count(0)
+	, m_cull_time_ms(0.0)
+	, m_use_async_compute(false)
+	, m_uv_map_checker_texture(0)
+	, m_use_bindless_textures(false)
+	, m_uv_map_checker_bindless_index(0)
+	, m_bindless_texture_generation(0)
+	, m_basic_shader_key(0)
+	, m_graphics_pipeline(0)
+	, m_basic_shader_watch(0)
+	, m_back_buffer(0)
+	, m_main_pass(0)
+	, m_depth_buffer(0)
+	, m_multisampled_color_buffer(0)
+	, m_sample_count(VK_SAMPLE_COUNT_1_BIT)
+	, m_depth_prepass_pipeline(0)
+	, m_use_depth_prepass(false)
+	, m_measure_fragment_invocations(false)
+	, m_fragment_invocation_counts{}
+	, m_fragment_measured_frame_counts{}
+	, m_frame_descriptor_set(VK_NULL_HANDLE)
+	, m_default_sampler(VK_NULL_HANDLE)
 {}
 
 Renderer::~Renderer()
@@ -96,71 +140,183 @@ void Renderer::Initialize(const Window& window)
 	m_swapchain.CreateSurface(m_instance, window);
 
 	// Create the logical device (physical device is created as well internally)
-	m_device.Create(m_instance, m_swapchain, global_settings::device_extension_names);
+	m_device.Create(m_instance, m_swapchain, global_settings::device_extension_names, global_settings::optional_device_extension_names);
 
 	// Initialize the memory manager
 	memory::MemoryManager::GetInstance().Initialize(m_device);
 
+	// Bindless textures are opt-in, and need descriptor indexing support
+	if (global_settings::use_bindless_textures)
+	{
+		m_use_bindless_textures = m_device.SupportsBindlessDescriptors();
+
+		if (m_use_bindless_textures)
+		{
+			m_bindless_textures.Create(m_device, global_settings::maximum_bindless_texture_count, global_settings::maximum_in_flight_frame_count);
+		}
+		else
+		{
+			spdlog::warn("Bindless textures are not supported by this device, falling back to per-draw descriptor sets.");
+		}
+	}
+
+	// Highest sample count up to the requested one, the device limits may lower it
+	m_sample_count = m_device.FindSupportedSampleCount(global_settings::msaa_sample_count);
+
+	if (static_cast<std::uint32_t>(m_sample_count) != global_settings::msaa_sample_count)
+	{
+		spdlog::warn("Multisampling with {} samples is not supported by this device, using {} sample(s) instead.", global_settings::msaa_sample_count, static_cast<std::uint32_t>(m_sample_count));
+	}
+
+	// Switched on and off between frames while fragment shader invocations are measured
+	m_use_depth_prepass = global_settings::use_depth_prepass;
+
+	// Counting fragment shader invocations needs pipeline statistics queries
+	m_measure_fragment_invocations = global_settings::measure_fragment_shader_invocations && m_device.SupportsPipelineStatisticsQueries();
+
+	if (m_measure_fragment_invocations)
+	{
+		m_fragment_statistics_query_pool.Create(
+			m_device,
+			VK_QUERY_TYPE_PIPELINE_STATISTICS,
+			global_settings::maximum_in_flight_frame_count,
+			VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT);
+
+		m_fragment_statistics_queries.resize(global_settings::maximum_in_flight_frame_count);
+	}
+	else if (global_settings::measure_fragment_shader_invocations)
+	{
+		spdlog::warn("Pipeline statistics queries are not supported by this device, fragment shader invocations will not be measured.");
+	}
+
 	// Create the swapchain (also creates all related objects such as image views)
 	m_swapchain.Create(m_device, window);
 
-	// Create a render pass
-	VkAttachmentDescription color_attachment = {};
-	color_attachment.format = m_swapchain.GetFormat();
-	color_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
-	color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-	color_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-	color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	color_attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-	VkAttachmentReference color_attachment_ref = {};
-	color_attachment_ref.attachment = 0;
-	color_attachment_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-	VkSubpassDescription subpass = {};
-	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-	subpass.colorAttachmentCount = 1;
-	subpass.pColorAttachments = &color_attachment_ref;
-
-	VkSubpassDependency subpass_dependency = {};
-	subpass_dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-	subpass_dependency.dstSubpass = 0;
-	subpass_dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	subpass_dependency.srcAccessMask = 0;
-	subpass_dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	subpass_dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-	vk_wrapper::VulkanRenderPassInfo render_pass_info = {};
-	render_pass_info.attachment_descriptions = { color_attachment };
-	render_pass_info.subpass_descriptions = { subpass };
-	render_pass_info.subpass_dependencies = { subpass_dependency };
-
-	m_render_pass.Create(m_device, render_pass_info);
-
-	CreateDescriptorSetLayout();
+	// Used for shader compilation, pipeline compilation, and texture streaming
+	m_worker_threads.Create();
+	m_pipeline_compiler.Create(m_device, m_worker_threads, global_settings::pipeline_cache_path);
+
+	if (use_shader_hot_reload)
+	{
+		m_shader_hot_reloader.Create(m_worker_threads);
+	}
+
+	// Baked shaders skip the GLSL compiler, stages whose sources changed since baking are compiled from source
+	if (std::filesystem::exists(global_settings::shader_bundle_path))
+	{
+		m_shader_bundle.Open(global_settings::shader_bundle_path);
+		vk_wrapper::VulkanShader::UseShaderBundle(&m_shader_bundle);
+	}
+
+	// The GPU-driven scene is opt-in, and its draw commands select objects through their first instance
+	m_use_gpu_driven_rendering = global_settings::use_gpu_driven_rendering && m_device.SupportsDrawIndirectFirstInstance();
+
+	if (global_settings::use_gpu_driven_rendering && !m_use_gpu_driven_rendering)
+	{
+		spdlog::warn("Indirect draws with a first instance are not supported by this device, the GPU-driven scene is disabled.");
+	}
+
+	// GPU culling is the only compute work, the compute queue is not needed without it
+	m_use_async_compute = m_use_gpu_driven_rendering && global_settings::use_async_compute;
+
+	CreateShaders();
+	CreateRenderGraph();
 	CreateGraphicsPipeline();
-	CreateFramebuffers();
 
-	m_graphics_command_pool.Create(m_device, vk_wrapper::CommandPoolType::Graphics);
+	// Frame command buffers are re-recorded every frame
+	m_graphics_command_pool.Create(m_device, vk_wrapper::CommandPoolType::Graphics, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+
+	// Uploads wait on their own fence instead of idling the graphics queue
+	m_immediate_submit.Create(m_device, vk_wrapper::CommandPoolType::Graphics, global_settings::immediate_submit_command_buffer_count);
 
-	m_vertex_buffer.Create(m_device, m_graphics_command_pool, vertices);
+	m_triangle_mesh = CreateMesh(vertices);
 	CreateUniformBuffers();
 
-	m_uv_map_checker_texture.Create("./resources/textures/uv_checker_map.png", VK_FORMAT_R8G8B8A8_UNORM, m_device, m_graphics_command_pool);
-	m_default_sampler.Create(m_device);
+	// Instance data is rewritten every frame
+	m_instance_buffer.Create(global_settings::maximum_in_flight_frame_count, sizeof(InstanceData) * global_settings::initial_instance_count_per_frame);
+
+	// Textures are streamed in the background, a placeholder is used until they are resident
+	m_texture_streamer.Create(m_device, m_worker_threads, m_immediate_submit);
+	m_uv_map_checker_texture = m_texture_streamer.RequestTexture("./resources/textures/uv_checker_map.png", VK_FORMAT_R8G8B8A8_UNORM);
+
+	// Sample from every mip level that is resident
+	m_sampler_cache.Create(m_device);
+	m_default_sampler_settings.max_lod = VK_LOD_CLAMP_NONE;
+	m_default_sampler = m_sampler_cache.Acquire(m_device, m_default_sampler_settings);
+
+	if (m_use_bindless_textures)
+	{
+		m_uv_map_checker_bindless_index = m_bindless_textures.Register(m_texture_streamer.GetImageView(m_uv_map_checker_texture), m_default_sampler);
+		m_bindless_texture_generation = m_texture_streamer.GetResidencyGeneration();
+	}
+
+	// Descriptor sets are allocated every frame, the pools of a frame are reset once its fence is signaled
+	m_descriptor_allocator.Create(global_settings::maximum_in_flight_frame_count);
 
-	CreateDescriptorPool();
-	CreateDescriptorSets();
-	RecordFrameCommands();
+	if (m_use_async_compute)
+	{
+		m_async_compute.Create(m_device, global_settings::maximum_in_flight_frame_count);
+	}
+
+	if (m_use_gpu_driven_rendering)
+	{
+		CreateGpuDrivenScene();
+	}
+
+	if (global_settings::cpu_culled_object_count > 0)
+	{
+		CreateCpuCulledScene();
+	}
+
+	CreateFrameCommandBuffers();
 	CreateSynchronizationObjects();
 }
 
-void Renderer::Draw(const Window& window)
+void Renderer::Draw(const Window& window, double render_time)
 {
+	// Anything that blocks the render thread (such as creating a pipeline) shows up as a long frame
+	const auto frame_start = std::chrono::steady_clock::now();
+
+	if (m_timed_frame_count++ > 0)
+	{
+		const auto frame_time = std::chrono::duration<double, std::milli>(frame_start - m_previous_frame_start);
+
+		if (frame_time.count() > global_settings::frame_hitch_threshold_ms)
+		{
+			++m_hitch_count;
+		}
+	}
+
+	m_previous_frame_start = frame_start;
+
 	// Wait for the fence of the old frame to be completed
 	vkWaitForFences(m_device.GetLogicalDeviceNative(), 1, &m_in_flight_fences[m_frame_index], VK_TRUE, std::numeric_limits<uint64_t>::max());
+
+	// Query results of the old frame are available now
+	if (m_measure_fragment_invocations)
+	{
+		CollectFragmentStatistics();
+	}
+
+	// Frame boundary, pipelines of reloaded shaders can be swapped in before anything is recorded
+	if (use_shader_hot_reload)
+	{
+		UpdateShaderHotReload();
+	}
+
+	// Descriptor sets of the old frame are no longer in use
+	m_descriptor_allocator.ResetFrame(m_device, static_cast<std::uint32_t>(m_frame_index));
+
+	// Evict or stream in mip levels to stay within the texture memory budget
+	m_texture_residency.Update(m_texture_streamer);
+
+	// Make textures that finished streaming resident and kick off new uploads
+	m_texture_streamer.Update(m_device);
+
+	if (m_use_bindless_textures)
+	{
+		UpdateBindlessTextures();
+	}
 	
 	// Retrieve an image from the swapchain for writing (wait indefinitely for the image to become available)
 	auto result = vkAcquireNextImageKHR(
@@ -182,20 +338,46 @@ void Renderer::Draw(const Window& window)
 		spdlog::error("Could not acquire a new swapchain image.");
 	}
 
+	// The previous frame that rendered to this swapchain image may still be using its resources
+	if (m_images_in_flight[m_current_swapchain_image_index] != VK_NULL_HANDLE)
+	{
+		vkWaitForFences(m_device.GetLogicalDeviceNative(), 1, &m_images_in_flight[m_current_swapchain_image_index], VK_TRUE, std::numeric_limits<uint64_t>::max());
+	}
+
+	// This swapchain image now belongs to the current frame
+	m_images_in_flight[m_current_swapchain_image_index] = m_in_flight_fences[m_frame_index];
+
+	// Safe to write to the uniform buffer and descriptor set of this swapchain image now
+	UpdateCameraData(render_time);
+
+	RecordFrameCommands(m_current_swapchain_image_index, CreateFrameDescriptorSet(m_current_swapchain_image_index));
+
 	// Wait on these semaphores before execution can start
-	VkSemaphore wait_semaphores[] = { m_in_flight_frame_image_available_semaphores[m_frame_index] };
+	std::vector<VkSemaphore> wait_semaphores = { m_in_flight_frame_image_available_semaphores[m_frame_index] };
 
 	// Signal these semaphores once execution finishes
 	VkSemaphore signal_semaphores[] = { m_in_flight_render_finished_semaphores[m_frame_index] };
 
 	// Wait in these stages of the pipeline on the semaphores
-	VkPipelineStageFlags wait_stages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+	std::vector<VkPipelineStageFlags> wait_stages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+
+	// Culling runs on the compute queue, everything before the indirect draws can already start
+	if (m_use_async_compute)
+	{
+		const auto frame_index = static_cast<std::uint32_t>(m_frame_index);
+		const auto& compute_command_buffer = m_async_compute.BeginFrame(m_device, frame_index);
+
+		m_gpu_driven_scene.RecordCulling(compute_command_buffer, frame_index, m_view_projection_matrix);
+
+		wait_semaphores.push_back(m_async_compute.Submit(m_device, frame_index));
+		wait_stages.push_back(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+	}
 
 	VkSubmitInfo submit_info = {};
 	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submit_info.waitSemaphoreCount = sizeof(wait_semaphores) / sizeof(wait_semaphores[0]);
-	submit_info.pWaitSemaphores = wait_semaphores;
-	submit_info.pWaitDstStageMask = wait_stages;
+	submit_info.waitSemaphoreCount = static_cast<std::uint32_t>(wait_semaphores.size());
+	submit_info.pWaitSemaphores = wait_semaphores.data();
+	submit_info.pWaitDstStageMask = wait_stages.data();
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers = &m_graphics_command_buffers.GetNative(m_current_swapchain_image_index);
 	submit_info.signalSemaphoreCount = sizeof(signal_semaphores) / sizeof(signal_semaphores[0]);
@@ -239,13 +421,33 @@ void Renderer::Draw(const Window& window)
 	m_frame_index = (m_frame_index + 1) % global_settings::maximum_in_flight_frame_count;
 }
 
-void Renderer::Update()
+void Renderer::Update(double delta_time)
 {
-	static float rotate_amount = 0.0f;
-	rotate_amount += 0.00001f;
+	// Runs on the simulation thread, do not touch any Vulkan objects in here
+	m_simulation_state.rotation += static_cast<float>(delta_time) * glm::radians(45.0f);
+	m_simulation_time += delta_time;
+
+	m_simulation_snapshots.Publish(m_simulation_state, m_simulation_time);
+}
+
+void Renderer::UpdateCameraData(double render_time)
+{
+	const core::Snapshot<SimulationState>* snapshot = nullptr;
+	m_simulation_snapshots.Acquire(snapshot);
+
+	// Interpolate between the two most recent simulation states
+	auto interpolation_factor = 1.0;
+	auto snapshot_delta_time = snapshot->current_time - snapshot->previous_time;
+
+	if (snapshot_delta_time > 0.0)
+	{
+		interpolation_factor = std::clamp((render_time - snapshot->previous_time) / snapshot_delta_time, 0.0, 1.0);
+	}
+
+	// Objects are positioned through push constants when the frame is recorded
+	m_render_state.rotation = glm::mix(snapshot->previous.rotation, snapshot->current.rotation, static_cast<float>(interpolation_factor));
 
 	CameraData cam_data = {};
-	cam_data.model_matrix = glm::rotate(glm::mat4(1.0f), rotate_amount * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
 	cam_data.view_matrix = glm::lookAt(glm::vec3(0.0f, 0.25f, 0.75f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
 	cam_data.projection_matrix = glm::perspective(
 		90.0f,
@@ -254,6 +456,8 @@ void Renderer::Update()
 		1000.0f);
 
 	m_camera_ubos[m_current_swapchain_image_index].Update(cam_data);
+
+	m_view_projection_matrix = cam_data.projection_matrix * cam_data.view_matrix;
 }
 
 void Renderer::TriggerFramebufferResized()
@@ -268,10 +472,103 @@ void vkc::Renderer::Destroy()
 
 	CleanUpSwapchain();
 
-	m_default_sampler.Destroy(m_device);
-	m_uv_map_checker_texture.Destroy(m_device);
+	const auto descriptor_statistics = m_descriptor_allocator.GetStatistics();
+	spdlog::info(
+		"Descriptor allocator: {} pool(s), {} set(s) allocated, {} set(s) cached, {:.1f}% cache hit ratio.",
+		descriptor_statistics.pool_count,
+		descriptor_statistics.allocated_set_count,
+		descriptor_statistics.cached_set_count,
+		descriptor_statistics.cache_hit_ratio * 100.0);
 
-	vkDestroyDescriptorSetLayout(m_device.GetLogicalDeviceNative(), m_camera_data_descriptor_set_layout, nullptr);
+	m_descriptor_allocator.Destroy(m_device);
+
+	if (m_recorded_frame_count > 0)
+	{
+		spdlog::info(
+			"Render queue: {:.1f} redundant state change(s) eliminated per frame on average.",
+			static_cast<double>(m_eliminated_state_change_count) / static_cast<double>(m_recorded_frame_count));
+	}
+
+	const auto& pipeline_statistics = m_pipeline_compiler.GetStatistics();
+	spdlog::info(
+		"Pipelines: {} requested, {} failed, {:.1f} ms compile time, {} lookup(s) used a fallback, {} lookup(s) skipped their draws.",
+		pipeline_statistics.requested_pipeline_count,
+		pipeline_statistics.failed_pipeline_count,
+		pipeline_statistics.compile_time_ms,
+		pipeline_statistics.fallback_count,
+		pipeline_statistics.skipped_count);
+
+	spdlog::info(
+		"Frame hitches: {} of {} frame(s) took longer than {:.1f} ms ({} pipeline compilation).",
+		m_hitch_count,
+		m_timed_frame_count,
+		global_settings::frame_hitch_threshold_ms,
+		global_settings::use_async_pipeline_compilation ? "asynchronous" : "synchronous");
+
+	if (m_culled_frame_count > 0)
+	{
+		spdlog::info(
+			"CPU frustum culling: {:.1f} of {} object(s) visible per frame on average, {:.3f} ms per frame.",
+			static_cast<double>(m_visible_object_count) / static_cast<double>(m_culled_frame_count),
+			m_frustum_culler.GetObjectCount(),
+			m_cull_time_ms / static_cast<double>(m_culled_frame_count));
+	}
+
+	if (m_measure_fragment_invocations && m_fragment_measured_frame_counts[0] > 0 && m_fragment_measured_frame_counts[1] > 0)
+	{
+		const auto invocations_without_prepass = static_cast<double>(m_fragment_invocation_counts[0]) / static_cast<double>(m_fragment_measured_frame_counts[0]);
+		const auto invocations_with_prepass = static_cast<double>(m_fragment_invocation_counts[1]) / static_cast<double>(m_fragment_measured_frame_counts[1]);
+
+		spdlog::info(
+			"Depth prepass: {:.0f} fragment shader invocation(s) per frame without, {:.0f} with, {:.1f}% saved ({} overdraw test layer(s)).",
+			invocations_without_prepass,
+			invocations_with_prepass,
+			(invocations_without_prepass > 0.0) ? (1.0 - invocations_with_prepass / invocations_without_prepass) * 100.0 : 0.0,
+			global_settings::overdraw_test_layer_count);
+	}
+
+	if (m_measure_fragment_invocations)
+	{
+		m_fragment_statistics_query_pool.Destroy(m_device);
+	}
+
+	m_pipeline_compiler.Destroy(m_device);
+
+	if (m_use_bindless_textures)
+	{
+		m_bindless_textures.Destroy(m_device);
+	}
+
+	m_sampler_cache.Release(m_default_sampler_settings);
+	m_sampler_cache.Destroy(m_device);
+	m_texture_streamer.Destroy(m_device);
+
+	if (m_use_gpu_driven_rendering)
+	{
+		m_gpu_driven_scene.Destroy(m_device);
+	}
+
+	if (m_use_async_compute)
+	{
+		m_async_compute.Destroy(m_device);
+	}
+
+	if (use_shader_hot_reload)
+	{
+		m_shader_hot_reloader.Destroy(m_device);
+	}
+
+	m_basic_shaders.Destroy(m_device);
+	m_layout_cache.Destroy(m_device);
+
+	m_instance_buffer.Destroy();
+
+	for (const auto& mesh : m_meshes)
+	{
+		mesh.vertex_buffer.Destroy();
+	}
+
+	m_meshes.clear();
 
 	// This will automatically clean up any allocated buffers and images
 	memory::MemoryManager::GetInstance().Destroy();
@@ -287,6 +584,7 @@ void vkc::Renderer::Destroy()
 		vkDestroyFence(m_device.GetLogicalDeviceNative(), m_in_flight_fences[index], nullptr);
 	}
 
+	m_immediate_submit.Destroy(m_device);
 	m_graphics_command_pool.Destroy(m_device);
 
 	m_device.Destroy();
@@ -297,10 +595,88 @@ void vkc::Renderer::Destroy()
 
 	m_swapchain.DestroySurface(m_instance);
 	m_instance.Destroy();
+
+	m_worker_threads.Destroy();
+
+	vk_wrapper::VulkanShader::UseShaderBundle(nullptr);
+	m_shader_bundle.Close();
+}
+
+void Renderer::CreateShaders()
+{
+	// Shaders survive swapchain recreation, only the pipelines that use them are recreated
+	m_basic_shaders.Create(
+		{
+			{ "./resources/shaders/basic.vert", vk_wrapper::ShaderType::Vertex },
+			{ "./resources/shaders/basic.frag", vk_wrapper::ShaderType::Fragment }
+		},
+		{
+			{ "BINDLESS_TEXTURES", vk_wrapper::ShaderKeywordType::Define },
+			{ "VERTEX_COLORS", vk_wrapper::ShaderKeywordType::SpecializationConstant, 0 }
+		});
+
+	std::vector<std::string> enabled_keywords = { "VERTEX_COLORS" };
+
+	if (m_use_bindless_textures)
+	{
+		enabled_keywords.push_back("BINDLESS_TEXTURES");
+	}
+
+	// Only the variant that is used gets compiled, its stages are compiled in parallel
+	m_basic_shader_key = m_basic_shaders.GetKey(enabled_keywords);
+	m_basic_shaders.CompileVariants(m_device, m_worker_threads, { m_basic_shader_key });
+
+	const auto& reflection = m_basic_shaders.GetShader(m_device, m_basic_shader_key).GetReflection();
+
+	if (use_shader_hot_reload)
+	{
+		m_basic_shader_watch = m_shader_hot_reloader.Watch(
+			m_basic_shaders.GetShader(m_device, m_basic_shader_key),
+			m_basic_shaders.GetCompileRequest(m_basic_shader_key));
+	}
+
+	// Layouts are derived from the resources the shader declares
+	if (m_use_bindless_textures)
+	{
+		// Set 1 is the texture array, its layout needs flags the reflection data does not know about
+		m_descriptor_set_layouts =
+		{
+			m_layout_cache.GetDescriptorSetLayout(m_device, vk_wrapper::GetDescriptorSetLayoutBindings(reflection, 0)),
+			m_bindless_textures.GetLayout()
+		};
+	}
+	else
+	{
+		m_descriptor_set_layouts = m_layout_cache.GetDescriptorSetLayouts(m_device, reflection);
+	}
+
+	m_pipeline_layout = m_layout_cache.GetPipelineLayout(m_device, m_descriptor_set_layouts, reflection.push_constant_ranges);
+
+	// Per-draw data has to be pushed to every stage that declares the push constant block
+	m_draw_data_stages = reflection.push_constant_ranges.empty() ? 0 : reflection.push_constant_ranges[0].stageFlags;
+
+	// The per-frame set is rewritten every frame, an update template keeps that to a single call
+	m_frame_descriptor_template = &m_layout_cache.GetUpdateTemplate(m_device, m_descriptor_set_layouts[0]);
+	m_frame_descriptor_data.resize(m_frame_descriptor_template->GetDescriptorCount());
+
+	spdlog::info("Successfully created the shader layouts.");
 }
 
 void Renderer::CreateGraphicsPipeline()
-{	
+{
+	// The depth prepass pipeline is cheap, creating it regardless allows switching the prepass on and off between frames
+	m_graphics_pipeline = RequestGraphicsPipeline(false);
+	m_depth_prepass_pipeline = RequestGraphicsPipeline(true);
+
+	if (!global_settings::use_async_pipeline_compilation)
+	{
+		m_pipeline_compiler.Wait(m_graphics_pipeline);
+		m_pipeline_compiler.Wait(m_depth_prepass_pipeline);
+	}
+}
+
+vk_wrapper::PipelineHandle Renderer::RequestGraphicsPipeline(bool depth_only)
+{
 	// Configure the viewport
 	VkViewport viewport = {};
 	viewport.x = 0.0f;
@@ -315,19 +691,8 @@ void Renderer::CreateGraphicsPipeline()
 	scissor_rect.offset = { 0, 0 };
 	scissor_rect.extent = m_swapchain.GetExtent();
 
-	// Pipeline layout
-	VkPipelineLayoutCreateInfo pipeline_layout_info = {};
-	pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipeline_layout_info.setLayoutCount = 1;
-	pipeline_layout_info.pSetLayouts = &m_camera_data_descriptor_set_layout;
-
-	if (vkCreatePipelineLayout(m_device.GetLogicalDeviceNative(), &pipeline_layout_info, nullptr, &m_pipeline_layout) != VK_SUCCESS)
-		spdlog::error("Could not create a pipeline layout.");
-
-	spdlog::info("Successfully created a pipeline layout.");
-
-	// Structure used to configure the graphics pipeline
-	auto* graphics_pipeline_info = new vk_wrapper::VulkanGraphicsPipelineInfo();
+	// Structure used to configure the graphics pipeline, shared with the compile job
+	auto graphics_pipeline_info = std::make_shared<vk_wrapper::VulkanGraphicsPipelineInfo>();
 
 	graphics_pipeline_info->cull_mode = vk_wrapper::PolygonFaceCullMode::FrontFace;
 	graphics_pipeline_info->discard_rasterizer_output = false;
@@ -338,118 +703,366 @@ void Renderer::CreateGraphicsPipeline()
 	graphics_pipeline_info->topology = vk_wrapper::VertexTopologyType::TriangleList;
 	graphics_pipeline_info->vertex_attribute_descs = VertexPCT::GetAttributeDescriptions();
 	graphics_pipeline_info->vertex_binding_descs = VertexPCT::GetBindingDescriptions();
+
+	// Per-instance data comes from a second vertex buffer
+	const auto instance_attribute_descs = InstanceData::GetAttributeDescriptions();
+	const auto instance_binding_descs = InstanceData::GetBindingDescriptions();
+	graphics_pipeline_info->vertex_attribute_descs.insert(graphics_pipeline_info->vertex_attribute_descs.end(), instance_attribute_descs.begin(), instance_attribute_descs.end());
+	graphics_pipeline_info->vertex_binding_descs.insert(graphics_pipeline_info->vertex_binding_descs.end(), instance_binding_descs.begin(), instance_binding_descs.end());
 	graphics_pipeline_info->viewport = viewport;
 	graphics_pipeline_info->winding_order = vk_wrapper::TriangleWindingOrder::Clockwise;
+	graphics_pipeline_info->sample_count = m_sample_count;
+
+	// Equal depths pass, so the color draws shade exactly the surfaces the depth prepass kept
+	graphics_pipeline_info->enable_depth_test = true;
+	graphics_pipeline_info->depth_compare_operation = vk_wrapper::CompareOperation::LessOrEqual;
+	graphics_pipeline_info->depth_only = depth_only;
+
+	// Depth is already there after the prepass, the color draws only write it when they may run without one
+	graphics_pipeline_info->enable_depth_write = depth_only || !global_settings::use_depth_prepass || m_measure_fragment_invocations;
+
+	m_basic_shaders.ApplySpecializationConstants(m_basic_shader_key, *graphics_pipeline_info);
 
-	// Create the graphics pipeline
-	m_graphics_pipeline.Create(
+	// Create the graphics pipeline, the draws that use it are skipped until it is ready
+	return m_pipeline_compiler.RequestPipeline(
 		m_device,
 		graphics_pipeline_info,
 		vk_wrapper::PipelineType::Graphics,
 		m_pipeline_layout,
-		m_render_pass.GetNative(),
+		m_render_graph.GetRenderPass(m_main_pass),
+		m_basic_shaders.GetShader(m_device, m_basic_shader_key));
+}
+
+void Renderer::UpdateShaderHotReload()
+{
+	// The fence of this frame index has been waited on, so every frame up to the previous use of this index has finished
+	for (auto retired_pipeline = m_retired_pipelines.begin(); retired_pipeline != m_retired_pipelines.end();)
+	{
+		if (m_timed_frame_count >= retired_pipeline->first + global_settings::maximum_in_flight_frame_count)
 		{
-			{ "./resources/shaders/basic.vert", vk_wrapper::ShaderType::Vertex },
-			{ "./resources/shaders/basic.frag", vk_wrapper::ShaderType::Fragment }
-		});
+			m_pipeline_compiler.Release(m_device, retired_pipeline->second);
+			retired_pipeline = m_retired_pipelines.erase(retired_pipeline);
+		}
+		else
+		{
+			++retired_pipeline;
+		}
+	}
+
+	for (auto& reloaded_shader : m_shader_hot_reloader.Update(m_device))
+	{
+		if (reloaded_shader.handle != m_basic_shader_watch)
+		{
+			reloaded_shader.shader.Destroy(m_device);
+			continue;
+		}
+
+		// Layouts are created once, a shader that declares different resources needs a restart
+		const auto& current_shader = m_basic_shaders.GetShader(m_device, m_basic_shader_key);
+
+		if (!vk_wrapper::IsLayoutCompatible(current_shader.GetReflection(), reloaded_shader.shader.GetReflection()))
+		{
+			spdlog::warn("Reloaded shader declares different resources than the shader it replaces, restart to apply the changes.");
+			reloaded_shader.shader.Destroy(m_device);
+			continue;
+		}
+
+		// Pipelines do not need their shader modules once they are created, only pending compilations do
+		m_pipeline_compiler.Wait(m_graphics_pipeline);
+		m_pipeline_compiler.Wait(m_depth_prepass_pipeline);
+
+		if (m_reloaded_graphics_pipeline)
+		{
+			m_pipeline_compiler.Release(m_device, *m_reloaded_graphics_pipeline);
+			m_pipeline_compiler.Release(m_device, *m_reloaded_depth_prepass_pipeline);
+		}
+
+		m_basic_shaders.ReplaceVariant(m_basic_shader_key, reloaded_shader.shader).Destroy(m_device);
 
-	// No need to keep the info around after pipeline creation
-	delete graphics_pipeline_info;
+		// The current pipelines keep drawing until the new ones are ready
+		m_reloaded_graphics_pipeline = RequestGraphicsPipeline(false);
+		m_reloaded_depth_prepass_pipeline = RequestGraphicsPipeline(true);
+	}
+
+	if (!m_reloaded_graphics_pipeline)
+	{
+		return;
+	}
+
+	// Both pipelines share the vertex stage, swapping them separately would make the prepass depth differ from the color draws
+	const auto state = m_pipeline_compiler.GetState(*m_reloaded_graphics_pipeline);
+	const auto depth_prepass_state = m_pipeline_compiler.GetState(*m_reloaded_depth_prepass_pipeline);
+
+	if (state == vk_wrapper::PipelineState::Ready && depth_prepass_state == vk_wrapper::PipelineState::Ready)
+	{
+		m_retired_pipelines.emplace_back(m_timed_frame_count, m_graphics_pipeline);
+		m_retired_pipelines.emplace_back(m_timed_frame_count, m_depth_prepass_pipeline);
+		m_graphics_pipeline = *m_reloaded_graphics_pipeline;
+		m_depth_prepass_pipeline = *m_reloaded_depth_prepass_pipeline;
+		m_reloaded_graphics_pipeline.reset();
+		m_reloaded_depth_prepass_pipeline.reset();
+	}
+	else if (state == vk_wrapper::PipelineState::Failed || depth_prepass_state == vk_wrapper::PipelineState::Failed)
+	{
+		m_pipeline_compiler.Release(m_device, *m_reloaded_graphics_pipeline);
+		m_pipeline_compiler.Release(m_device, *m_reloaded_depth_prepass_pipeline);
+		m_reloaded_graphics_pipeline.reset();
+		m_reloaded_depth_prepass_pipeline.reset();
+	}
 }
 
-void Renderer::CreateFramebuffers()
+void Renderer::CreateRenderGraph()
 {
-	// Allocate enough memory to hold all framebuffers for the swapchain
-	m_swapchain_framebuffers.resize(m_swapchain.GetImageViews().size());
+	// The swapchain image is cleared on first use, and handed to the presentation engine afterwards
+	render_graph::ImageState back_buffer_initial_state = {};
+	back_buffer_initial_state.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+	back_buffer_initial_state.stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;	// Stage that waits on the image available semaphore
+
+	render_graph::ImageState back_buffer_final_state = {};
+	back_buffer_final_state.layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	back_buffer_final_state.stages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+	m_back_buffer = m_render_graph.ImportImage(
+		"back buffer",
+		m_swapchain.GetFormat(),
+		m_swapchain.GetExtent(),
+		back_buffer_initial_state,
+		back_buffer_final_state);
+
+	// Culling writes the indirect draw commands, the graph does not track buffers so the pass keeps its place
+	if (m_use_gpu_driven_rendering && !m_use_async_compute)
+	{
+		const auto culling_pass = m_render_graph.AddPass(
+			"gpu culling",
+			render_graph::PassType::Compute,
+			[this](const VkCommandBuffer& command_buffer)
+			{
+				m_gpu_driven_scene.RecordCulling(command_buffer, static_cast<std::uint32_t>(m_frame_index), m_view_projection_matrix);
+			});
+
+		m_render_graph.SetSideEffects(culling_pass);
+	}
 
-	// Index for the for-loop
-	std::uint32_t index = 0;
+	m_main_pass = m_render_graph.AddPass(
+		"main",
+		render_graph::PassType::Graphics,
+		[this](const VkCommandBuffer& command_buffer)
+		{
+			RecordMainPass(command_buffer);
+		});
 
-	// Create a new framebuffer for each image view
-	for (const auto& image_view : m_swapchain.GetImageViews())
+	// Black clear color
+	if (m_sample_count == VK_SAMPLE_COUNT_1_BIT)
 	{
-		VkFramebufferCreateInfo framebuffer_info = {};
-		framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-		framebuffer_info.renderPass = m_render_pass.GetNative();
-		framebuffer_info.attachmentCount = 1;
-		framebuffer_info.pAttachments = &image_view;
-		framebuffer_info.width = m_swapchain.GetExtent().width;
-		framebuffer_info.height = m_swapchain.GetExtent().height;
-		framebuffer_info.layers = 1;
+		m_render_graph.AddColorAttachment(m_main_pass, m_back_buffer, VK_ATTACHMENT_LOAD_OP_CLEAR, { 0.0f, 0.0f, 0.0f, 1.0f });
+	}
+	else
+	{
+		render_graph::TransientImageInfo multisampled_color_info = {};
+		multisampled_color_info.format = m_swapchain.GetFormat();
+		multisampled_color_info.extent = m_swapchain.GetExtent();
+		multisampled_color_info.samples = m_sample_count;
+
+		// Samples are resolved into the swapchain image at the end of the pass, they are never stored themselves
+		m_multisampled_color_buffer = m_render_graph.CreateImage("multisampled color buffer", multisampled_color_info);
+		m_render_graph.AddColorAttachment(m_main_pass, m_multisampled_color_buffer, VK_ATTACHMENT_LOAD_OP_CLEAR, { 0.0f, 0.0f, 0.0f, 1.0f });
+		m_render_graph.AddResolveAttachment(m_main_pass, m_multisampled_color_buffer, m_back_buffer);
+	}
 
-		if (vkCreateFramebuffer(m_device.GetLogicalDeviceNative(), &framebuffer_info, nullptr, &m_swapchain_framebuffers[index]) != VK_SUCCESS)
-			spdlog::error("Could not create a framebuffer for the swapchain image view.");
+	// Stencil is not used, so formats without a stencil component are preferred
+	render_graph::TransientImageInfo depth_buffer_info = {};
+	depth_buffer_info.extent = m_swapchain.GetExtent();
+	depth_buffer_info.samples = m_sample_count;
+	depth_buffer_info.format = m_device.FindSupportedFormat(
+		{ VK_FORMAT_D32_SFLOAT, VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D16_UNORM },
+		VK_IMAGE_TILING_OPTIMAL,
+		VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
 
-		++index;
-	}
+	// Cleared and discarded within the main pass, its contents never have to leave tile memory
+	m_depth_buffer = m_render_graph.CreateImage("depth buffer", depth_buffer_info);
+	m_render_graph.AddDepthStencilAttachment(m_main_pass, m_depth_buffer, VK_ATTACHMENT_LOAD_OP_CLEAR, { 1.0f, 0 });
 
-	spdlog::info("Successfully created a framebuffer for each swapchain image view.");
+	m_render_graph.Compile(m_device);
 }
 
-void Renderer::RecordFrameCommands()
+void Renderer::CreateFrameCommandBuffers()
 {
 	m_graphics_command_buffers.Create(
 		m_device,
 		m_graphics_command_pool,
-		static_cast<std::uint32_t>(m_swapchain_framebuffers.size()));
+		static_cast<std::uint32_t>(m_swapchain.GetImages().size()));
+}
+
+void Renderer::RecordFrameCommands(std::uint32_t swapchain_image_index, VkDescriptorSet descriptor_set)
+{
+	const auto& command_buffer = m_graphics_command_buffers.GetNative(swapchain_image_index);
+
+	// Begin recording (implicitly resets the command buffer)
+	m_graphics_command_buffers.BeginRecording(swapchain_image_index, vk_wrapper::CommandBufferUsage::OneTimeSubmit);
+
+	// Used by the passes while the graph executes
+	m_frame_descriptor_set = descriptor_set;
+	m_render_graph.SetImportedImage(m_back_buffer, m_swapchain.GetImages()[swapchain_image_index], m_swapchain.GetImageViews()[swapchain_image_index]);
 
-	// Record commands into command buffers
-	for (auto i = 0; i < m_swapchain_framebuffers.size(); ++i)
+	// Queries cannot be reset inside of a render pass
+	if (m_measure_fragment_invocations)
 	{
-		// Begin recording
-		m_graphics_command_buffers.BeginRecording(i, vk_wrapper::CommandBufferUsage::SimultaneousUse);
+		m_fragment_statistics_query_pool.Reset(command_buffer, static_cast<std::uint32_t>(m_frame_index));
+	}
 
-		// Black clear color
-		VkClearValue clear_color = { 0.0f, 0.0f, 0.0f, 1.0f };
+	m_render_graph.Execute(m_device, command_buffer);
 
-		// Prepare the render pass
-		VkRenderPassBeginInfo render_pass_begin_info = {};
-		render_pass_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		render_pass_begin_info.renderPass = m_render_pass.GetNative();
-		render_pass_begin_info.framebuffer = m_swapchain_framebuffers[i];
-		render_pass_begin_info.renderArea.offset = { 0, 0 };
-		render_pass_begin_info.renderArea.extent = m_swapchain.GetExtent();
-		render_pass_begin_info.clearValueCount = 1;
-		render_pass_begin_info.pClearValues = &clear_color;
+	// Finish recording
+	m_graphics_command_buffers.StopRecording(swapchain_image_index);
+}
 
-		// Start the render pass
-		vkCmdBeginRenderPass(m_graphics_command_buffers.GetNative(i), &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+void Renderer::RecordMainPass(const VkCommandBuffer& command_buffer)
+{
+	// Counts the fragment shader invocations of every draw in the pass, the depth prepass has no fragment stage
+	if (m_measure_fragment_invocations)
+	{
+		m_fragment_statistics_query_pool.Begin(command_buffer, static_cast<std::uint32_t>(m_frame_index));
+	}
 
-		// Bind the graphics pipeline
-		vkCmdBindPipeline(m_graphics_command_buffers.GetNative(i), VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphics_pipeline.GetNative());
+	// The descriptor set samples from the UV checker texture
+	m_texture_residency.MarkUsed(m_uv_map_checker_texture);
 
-		// Bind the triangle vertex buffer
-		VkBuffer vertex_buffers[] = { m_vertex_buffer.GetNative() };
-		VkDeviceSize offsets[] = { 0 };
-		vkCmdBindVertexBuffers(m_graphics_command_buffers.GetNative(i), 0, 1, vertex_buffers, offsets);
+	if (m_use_bindless_textures)
+	{
+		// The texture array is shared by every draw, draws select their texture through the material index
+		VkDescriptorSet bindless_texture_set = m_bindless_textures.GetSet(static_cast<std::uint32_t>(m_frame_index));
 
-		// Bind the camera UBO
 		vkCmdBindDescriptorSets(
-			m_graphics_command_buffers.GetNative(i),
+			command_buffer,
 			VK_PIPELINE_BIND_POINT_GRAPHICS,
 			m_pipeline_layout,
-			0,
 			1,
-			&m_descriptor_sets[i],
+			1,
+			&bindless_texture_set,
 			0,
 			nullptr);
+	}
+
+	// Merge identical mesh + material pairs, and upload the instance data of this frame
+	m_instance_batcher.Clear();
+	SubmitMeshes();
+	m_instance_batcher.Build();
 
-		// Draw the triangle using hard-coded shader vertices
-		vkCmdDraw(m_graphics_command_buffers.GetNative(i), static_cast<std::uint32_t>(vertices.size()), 1, 0, 0);
+	m_instance_buffer.Update(static_cast<std::uint32_t>(m_frame_index), m_instance_batcher.GetInstances());
 
-		// End the render pass
-		vkCmdEndRenderPass(m_graphics_command_buffers.GetNative(i));
+	// Instances of every batch are stored next to each other, "firstInstance" selects the range of a batch
+	VkDeviceSize instance_buffer_offset = 0;
+	vkCmdBindVertexBuffers(command_buffer, 1, 1, &m_instance_buffer.GetNative(static_cast<std::uint32_t>(m_frame_index)), &instance_buffer_offset);
 
-		// Finish recording
-		m_graphics_command_buffers.StopRecording(i);
+	// Every batch becomes a draw packet, the render queue orders them by state and skips redundant binds
+	m_render_queue.Clear();
+
+	// No fallback pipeline, nothing is drawn until the pipeline has been compiled
+	const auto graphics_pipeline = m_pipeline_compiler.GetPipeline(m_graphics_pipeline);
+	const auto depth_prepass_pipeline = m_use_depth_prepass ? m_pipeline_compiler.GetPipeline(m_depth_prepass_pipeline) : VK_NULL_HANDLE;
+
+	// The color draws do not write depth when the prepass is used, without the prepass pipeline nothing would
+	const auto are_pipelines_ready = graphics_pipeline != VK_NULL_HANDLE && (!m_use_depth_prepass || depth_prepass_pipeline != VK_NULL_HANDLE);
+
+	for (const auto& batch : m_instance_batcher.GetBatches())
+	{
+		if (!are_pipelines_ready)
+		{
+			break;
+		}
+
+		const auto& mesh = m_meshes[batch.mesh];
+
+		DrawPacket packet = {};
+		packet.pipeline = graphics_pipeline;
+		packet.pipeline_layout = m_pipeline_layout;
+		packet.descriptor_set = m_frame_descriptor_set;
+		packet.vertex_buffer = mesh.vertex_buffer.GetNative();
+		packet.vertex_count = mesh.vertex_count;
+		packet.first_instance = batch.first_instance;
+		packet.instance_count = batch.instance_count;
+
+		// Per-draw data goes through push constants, no descriptor needs to be written or bound per object
+		packet.draw_data.model_matrix = glm::mat4(1.0f);
+		packet.draw_data.material_index = batch.material_index;
+		packet.draw_data.object_id = batch.first_instance;	// Objects of a batch are numbered from its first instance onwards
+		packet.draw_data_stages = m_draw_data_stages;
+
+		// Batches span many objects, so they are ordered by state only
+		packet.sort_key = RenderQueue::MakeSortKey(RenderQueuePass::Opaque, 0, batch.material_index, batch.mesh, 0.0f);
+
+		m_render_queue.Push(packet);
+
+		// Same draw without a fragment stage, the prepass sorts before every opaque draw
+		if (m_use_depth_prepass)
+		{
+			packet.pipeline = depth_prepass_pipeline;
+			packet.sort_key = RenderQueue::MakeSortKey(RenderQueuePass::DepthPrepass, 0, 0, batch.mesh, 0.0f);
+
+			m_render_queue.Push(packet);
+		}
+	}
+
+	m_render_queue.Sort();
+	m_render_queue.Record(command_buffer);
+
+	++m_recorded_frame_count;
+	m_eliminated_state_change_count += m_render_queue.GetStatistics().eliminated_state_change_count;
+
+	if (m_use_gpu_driven_rendering)
+	{
+		VkDescriptorBufferInfo camera_data = {};
+		camera_data.buffer = m_camera_ubos[m_current_swapchain_image_index].GetNative();
+		camera_data.offset = 0;
+		camera_data.range = sizeof(CameraData);
+
+		VkDescriptorImageInfo texture = {};
+		texture.sampler = m_default_sampler;
+		texture.imageView = m_texture_streamer.GetImageView(m_uv_map_checker_texture);
+		texture.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		m_gpu_driven_scene.RecordDraw(m_device, command_buffer, m_descriptor_allocator, static_cast<std::uint32_t>(m_frame_index), camera_data, texture);
+	}
+
+	if (m_measure_fragment_invocations)
+	{
+		m_fragment_statistics_query_pool.End(command_buffer, static_cast<std::uint32_t>(m_frame_index));
+
+		m_fragment_statistics_queries[m_frame_index].is_pending = true;
+		m_fragment_statistics_queries[m_frame_index].used_depth_prepass = m_use_depth_prepass;
 	}
 }
 
+void Renderer::CollectFragmentStatistics()
+{
+	auto& query = m_fragment_statistics_queries[m_frame_index];
+
+	if (query.is_pending)
+	{
+		std::vector<std::uint64_t> results;
+
+		// The fence of this frame has been waited on, so the results are only missing when the frame was never submitted
+		if (m_fragment_statistics_query_pool.GetResults(m_device, static_cast<std::uint32_t>(m_frame_index), results))
+		{
+			const auto mode = query.used_depth_prepass ? 1 : 0;
+
+			m_fragment_invocation_counts[mode] += results[0];
+			++m_fragment_measured_frame_counts[mode];
+		}
+
+		query.is_pending = false;
+	}
+
+	// Alternate between runs of frames with and without the prepass, so both are measured on the same content
+	m_use_depth_prepass = (m_timed_frame_count / global_settings::fragment_measurement_interval) % 2 == 0;
+}
+
 void Renderer::CreateSynchronizationObjects()
 {
 	m_in_flight_frame_image_available_semaphores.resize(global_settings::maximum_in_flight_frame_count);
 	m_in_flight_render_finished_semaphores.resize(global_settings::maximum_in_flight_frame_count);
 	m_in_flight_fences.resize(global_settings::maximum_in_flight_frame_count);
+	m_images_in_flight.resize(m_swapchain.GetImages().size(), VK_NULL_HANDLE);
 
 	VkSemaphoreCreateInfo semaphore_create_info = {};
 	semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -498,47 +1111,18 @@ void Renderer::RecreateSwapchain(const Window& window)
 	// Create a new swapchain
 	m_swapchain.Create(m_device, window);
 
-	// Create a new render pass
-	VkAttachmentDescription color_attachment = {};
-	color_attachment.format = m_swapchain.GetFormat();
-	color_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
-	color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-	color_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-	color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	color_attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-	VkAttachmentReference color_attachment_ref = {};
-	color_attachment_ref.attachment = 0;
-	color_attachment_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-	VkSubpassDescription subpass = {};
-	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-	subpass.colorAttachmentCount = 1;
-	subpass.pColorAttachments = &color_attachment_ref;
-
-	VkSubpassDependency subpass_dependency = {};
-	subpass_dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-	subpass_dependency.dstSubpass = 0;
-	subpass_dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	subpass_dependency.srcAccessMask = 0;
-	subpass_dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	subpass_dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-	vk_wrapper::VulkanRenderPassInfo render_pass_info = {};
-	render_pass_info.attachment_descriptions = { color_attachment };
-	render_pass_info.subpass_descriptions = { subpass };
-	render_pass_info.subpass_dependencies = { subpass_dependency };
-
-	m_render_pass.Create(m_device, render_pass_info);
-
+	CreateRenderGraph();
 	CreateGraphicsPipeline();
-	CreateFramebuffers();
 	CreateUniformBuffers();
-	CreateDescriptorPool();
-	CreateDescriptorSets();
-	RecordFrameCommands();
+	CreateFrameCommandBuffers();
+
+	if (m_use_gpu_driven_rendering)
+	{
+		m_gpu_driven_scene.CreatePipeline(m_device, m_render_graph.GetRenderPass(m_main_pass), m_swapchain.GetExtent(), m_sample_count);
+	}
+
+	// None of the new swapchain images are in use yet
+	m_images_in_flight.assign(m_swapchain.GetImages().size(), VK_NULL_HANDLE);
 
 	spdlog::info("Recreated the swapchain successfully.");
 }
@@ -547,19 +1131,39 @@ void Renderer::CleanUpSwapchain()
 {
 	for (auto index = 0; index < m_swapchain.GetImages().size(); ++index)
 	{
-		vkDestroyFramebuffer(m_device.GetLogicalDeviceNative(), m_swapchain_framebuffers[index], nullptr);
 		m_camera_ubos[index].Destroy();
 	}
 
-	vkDestroyDescriptorPool(m_device.GetLogicalDeviceNative(), m_descriptor_pool, nullptr);
+	// Render passes, framebuffers, and transient images all depend on the swapchain
+	m_render_graph.Destroy(m_device);
 
 	// No need to recreate the pool, freeing the command buffers is enough
 	m_graphics_command_buffers.Destroy(m_device, m_graphics_command_pool);
 
-	m_graphics_pipeline.Destroy(m_device);
-	vkDestroyPipelineLayout(m_device.GetLogicalDeviceNative(), m_pipeline_layout, nullptr);
-	
-	m_render_pass.Destroy(m_device);
+	m_pipeline_compiler.Release(m_device, m_graphics_pipeline);
+	m_pipeline_compiler.Release(m_device, m_depth_prepass_pipeline);
+
+	// The device is idle, pipelines of reloaded shaders can go right away
+	if (m_reloaded_graphics_pipeline)
+	{
+		m_pipeline_compiler.Release(m_device, *m_reloaded_graphics_pipeline);
+		m_pipeline_compiler.Release(m_device, *m_reloaded_depth_prepass_pipeline);
+		m_reloaded_graphics_pipeline.reset();
+		m_reloaded_depth_prepass_pipeline.reset();
+	}
+
+	for (const auto& retired_pipeline : m_retired_pipelines)
+	{
+		m_pipeline_compiler.Release(m_device, retired_pipeline.second);
+	}
+
+	m_retired_pipelines.clear();
+
+	if (m_use_gpu_driven_rendering)
+	{
+		m_gpu_driven_scene.DestroyPipeline(m_device);
+	}
+
 	m_swapchain.Destroy(m_device);
 }
 
@@ -576,139 +1180,184 @@ void Renderer::CreateUniformBuffers()
 	}
 }
 
-void Renderer::CreateDescriptorPool()
+VkDescriptorSet Renderer::CreateFrameDescriptorSet(std::uint32_t swapchain_image_index)
 {
-	VkDescriptorPoolSize descriptor_pool_sizes[2] = {};
+	// Written every frame, so texture residency changes are picked up right away
+	auto descriptor_set = m_descriptor_allocator.AllocateForFrame(
+		m_device,
+		m_descriptor_set_layouts[0],
+		static_cast<std::uint32_t>(m_frame_index));
 
-	descriptor_pool_sizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	descriptor_pool_sizes[0].descriptorCount = static_cast<std::uint32_t>(m_swapchain.GetImages().size());
+	auto& camera_data = m_frame_descriptor_data[m_frame_descriptor_template->GetDescriptorIndex(0)];
+	camera_data.buffer_info.buffer = m_camera_ubos[swapchain_image_index].GetNative();
+	camera_data.buffer_info.offset = 0;
+	camera_data.buffer_info.range = sizeof(CameraData);
 
-	descriptor_pool_sizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	descriptor_pool_sizes[1].descriptorCount = static_cast<std::uint32_t>(m_swapchain.GetImages().size());
+	// Textures live in the bindless texture table when it is used
+	if (!m_use_bindless_textures)
+	{
+		auto& texture = m_frame_descriptor_data[m_frame_descriptor_template->GetDescriptorIndex(1)];
+		texture.image_info.sampler = m_default_sampler;
+		texture.image_info.imageView = m_texture_streamer.GetImageView(m_uv_map_checker_texture);
+		texture.image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	}
 
-	VkDescriptorPoolCreateInfo pool_create_info = {};
-	pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	pool_create_info.poolSizeCount = sizeof(descriptor_pool_sizes) / sizeof(VkDescriptorPoolSize);
-	pool_create_info.pPoolSizes = descriptor_pool_sizes;
-	pool_create_info.maxSets = static_cast<std::uint32_t>(m_swapchain.GetImages().size());
+	m_frame_descriptor_template->Write(m_device, descriptor_set, m_frame_descriptor_data);
 
-	if (vkCreateDescriptorPool(m_device.GetLogicalDeviceNative(), &pool_create_info, nullptr, &m_descriptor_pool) != VK_SUCCESS)
+	return descriptor_set;
+}
+
+void Renderer::UpdateBindlessTextures()
+{
+	// Image views change whenever a texture gains or loses mip levels
+	if (m_bindless_texture_generation != m_texture_streamer.GetResidencyGeneration())
 	{
-		spdlog::error("Could not create a descriptor pool.");
-		return;
+		m_bindless_textures.Update(m_uv_map_checker_bindless_index, m_texture_streamer.GetImageView(m_uv_map_checker_texture), m_default_sampler);
+		m_bindless_texture_generation = m_texture_streamer.GetResidencyGeneration();
 	}
 
-	spdlog::info("Successfully created a descriptor pool.");
+	// The fence of this frame has been waited on, so its copy of the table is not in use
+	m_bindless_textures.Flush(m_device, static_cast<std::uint32_t>(m_frame_index));
 }
 
-void Renderer::CreateDescriptorSetLayout()
+MeshHandle Renderer::CreateMesh(const std::vector<VertexPCT>& mesh_vertices)
 {
-	VkDescriptorSetLayoutBinding camera_data_layout_binding = {};
-	camera_data_layout_binding.binding = 0;
-	camera_data_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	camera_data_layout_binding.descriptorCount = 1;
-	camera_data_layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-
-	VkDescriptorSetLayoutBinding sampler_layout_binding = {};
-	sampler_layout_binding.binding = 1;
-	sampler_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	sampler_layout_binding.descriptorCount = 1;
-	sampler_layout_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-	VkDescriptorSetLayoutBinding layouts[] = { camera_data_layout_binding, sampler_layout_binding };
-
-	VkDescriptorSetLayoutCreateInfo layout_create_info = {};
-	layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	layout_create_info.bindingCount = sizeof(layouts) / sizeof(VkDescriptorSetLayoutBinding);
-	layout_create_info.pBindings = layouts;
-
-	if (vkCreateDescriptorSetLayout(m_device.GetLogicalDeviceNative(), &layout_create_info, nullptr, &m_camera_data_descriptor_set_layout) != VK_SUCCESS)
-		spdlog::error("Could not create a descriptor set layout for the camera data.");
+	Mesh mesh = {};
+	mesh.vertex_buffer.Create(m_device, m_immediate_submit, mesh_vertices);
+	mesh.vertex_count = static_cast<std::uint32_t>(mesh_vertices.size());
+
+	if (!mesh_vertices.empty())
+	{
+		auto minimum = mesh_vertices.front().position;
+		auto maximum = mesh_vertices.front().position;
+
+		for (const auto& vertex : mesh_vertices)
+		{
+			minimum = glm::min(minimum, vertex.position);
+			maximum = glm::max(maximum, vertex.position);
+		}
+
+		mesh.bounds_center = (minimum + maximum) * 0.5f;
+		mesh.bounds_extents = (maximum - minimum) * 0.5f;
+
+		for (const auto& vertex : mesh_vertices)
+		{
+			mesh.bounds_radius = std::max(mesh.bounds_radius, glm::length(vertex.position - mesh.bounds_center));
+		}
+	}
+
+	m_meshes.push_back(mesh);
+
+	return static_cast<MeshHandle>(m_meshes.size() - 1);
 }
 
-void Renderer::CreateDescriptorSets()
+void Renderer::SubmitMeshes()
 {
-	std::vector<VkDescriptorSetLayout> layouts(m_swapchain.GetImages().size(), m_camera_data_descriptor_set_layout);
+	// Without bindless textures there is only the texture in the per-frame descriptor set
+	const auto material_index = m_use_bindless_textures ? m_uv_map_checker_bindless_index : 0;
 
-	VkDescriptorSetAllocateInfo alloc_info = {};
-	alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	alloc_info.descriptorPool = m_descriptor_pool;
-	alloc_info.descriptorSetCount = static_cast<std::uint32_t>(m_swapchain.GetImages().size());
-	alloc_info.pSetLayouts = layouts.data();
+	m_instance_batcher.Submit(
+		m_triangle_mesh,
+		material_index,
+		glm::rotate(glm::mat4(1.0f), m_render_state.rotation, glm::vec3(0.0f, 0.0f, 1.0f)));
 
-	m_descriptor_sets.resize(m_swapchain.GetImages().size());
-	if (vkAllocateDescriptorSets(m_device.GetLogicalDeviceNative(), &alloc_info, m_descriptor_sets.data()) != VK_SUCCESS)
+	if (m_frustum_culler.GetObjectCount() > 0)
+	{
+		const auto cull_start = std::chrono::steady_clock::now();
+
+		// The render thread culls chunks as well, it only waits for chunks a worker thread has already started on
+		const auto& visible_objects = m_frustum_culler.Cull(m_view_projection_matrix, &m_worker_threads);
+
+		m_visible_object_matrices.clear();
+
+		for (const auto object : visible_objects)
+		{
+			m_visible_object_matrices.push_back(m_culled_object_matrices[object]);
+		}
+
+		m_instance_batcher.Submit(m_triangle_mesh, material_index, m_visible_object_matrices);
+
+		m_cull_time_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cull_start).count();
+		m_visible_object_count += visible_objects.size();
+		++m_culled_frame_count;
+	}
+
+	if (global_settings::overdraw_test_layer_count == 0)
 	{
-		spdlog::error("Could not allocate descriptor sets.");
 		return;
 	}
 
-	spdlog::info("Successfully allocated descriptor sets.");
+	// Back to front, without a depth prepass every layer is shaded on top of the layers behind it
+	std::vector<glm::mat4> overdraw_layers;
+	overdraw_layers.reserve(global_settings::overdraw_test_layer_count);
 
-	// Populate the newly allocated descriptor sets
-	for (auto index = 0; index < m_swapchain.GetImages().size(); ++index)
+	for (auto layer = global_settings::overdraw_test_layer_count; layer > 0; --layer)
 	{
-		VkDescriptorBufferInfo buffer_info = {};
-		buffer_info.buffer = m_camera_ubos[index].GetNative();
-		buffer_info.offset = 0;
-		buffer_info.range = sizeof(CameraData);
-
-		VkDescriptorImageInfo image_info = {};
-		image_info.sampler = m_default_sampler.GetNative();
-		image_info.imageView = m_uv_map_checker_texture.GetImageView();
-		image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-		VkWriteDescriptorSet descriptor_writes[2] = {};
-
-		descriptor_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptor_writes[0].dstSet = m_descriptor_sets[index];
-		descriptor_writes[0].dstBinding = 0;
-		descriptor_writes[0].dstArrayElement = 0;
-		descriptor_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		descriptor_writes[0].descriptorCount = 1;
-		descriptor_writes[0].pBufferInfo = &buffer_info;
-
-		descriptor_writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptor_writes[1].dstSet = m_descriptor_sets[index];
-		descriptor_writes[1].dstBinding = 1;
-		descriptor_writes[1].dstArrayElement = 0;
-		descriptor_writes[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		descriptor_writes[1].descriptorCount = 1;
-		descriptor_writes[1].pImageInfo = &image_info;
-
-		vkUpdateDescriptorSets(
-			m_device.GetLogicalDeviceNative(),
-			sizeof(descriptor_writes) / sizeof(VkWriteDescriptorSet),
-			descriptor_writes,
-			0,
-			nullptr);
+		const auto layer_transform = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -0.05f * static_cast<float>(layer)));
+		overdraw_layers.push_back(glm::scale(layer_transform, glm::vec3(8.0f)));
 	}
+
+	m_instance_batcher.Submit(m_triangle_mesh, material_index, overdraw_layers);
 }
 
-void Renderer::CopyStagingBufferToDeviceLocalBuffer(
-	const vk_wrapper::VulkanDevice& device,
-	const memory::VulkanBuffer& source,
-	const memory::VulkanBuffer& destination,
-	const VkQueue& queue,
-	const vk_wrapper::VulkanCommandPool& pool)
+void Renderer::CreateGpuDrivenScene()
 {
-	vk_wrapper::VulkanCommandBuffer cmd_buffer;
-	cmd_buffer.Create(device, pool, 1);
-	cmd_buffer.BeginRecording(vk_wrapper::CommandBufferUsage::OneTimeSubmit);
+	const auto triangle_mesh = m_gpu_driven_scene.AddMesh(vertices);
 
-	VkBufferCopy copy_region = {};
-	copy_region.srcOffset = source.info.offset;
-	copy_region.size = source.info.size;
-	copy_region.dstOffset = destination.info.offset;
+	// A large grid of triangles behind the regular scene, most of it is outside of the view frustum
+	const auto grid_size = static_cast<std::uint32_t>(std::ceil(std::sqrt(static_cast<float>(global_settings::gpu_driven_object_count))));
+	const auto grid_spacing = 1.5f;
 
-	// Issue a command that copies the staging buffer to the destination buffer
-	vkCmdCopyBuffer(cmd_buffer.GetNative(), source.buffer, destination.buffer, 1, &copy_region);
-	
-	// Execute the commands
-	cmd_buffer.StopRecording();
-	cmd_buffer.Submit(queue);
-	vkQueueWaitIdle(queue);
+	for (std::uint32_t index = 0; index < global_settings::gpu_driven_object_count; ++index)
+	{
+		const auto x = (static_cast<float>(index % grid_size) - static_cast<float>(grid_size) * 0.5f) * grid_spacing;
+		const auto z = -static_cast<float>(index / grid_size + 1) * grid_spacing;
+
+		m_gpu_driven_scene.AddObject(triangle_mesh, 0, glm::translate(glm::mat4(1.0f), glm::vec3(x, 0.0f, z)));
+	}
+
+	// Draw commands are shared with the compute queue when culling runs on a different queue family
+	m_gpu_driven_scene.Build(
+		m_device,
+		m_immediate_submit,
+		m_layout_cache,
+		m_descriptor_allocator,
+		global_settings::maximum_in_flight_frame_count,
+		m_use_async_compute ? m_async_compute.GetQueueFamilyIndices() : std::vector<std::uint32_t>{});
+	m_gpu_driven_scene.CreatePipeline(m_device, m_render_graph.GetRenderPass(m_main_pass), m_swapchain.GetExtent(), m_sample_count);
+}
+
+void Renderer::CreateCpuCulledScene()
+{
+	const auto& mesh = m_meshes[m_triangle_mesh];
 
-	// No longer need the command buffer to stick around
-	cmd_buffer.Destroy(device, pool);
+	// A large grid of triangles above the regular scene, most of it is outside of the view frustum
+	const auto grid_size = static_cast<std::uint32_t>(std::ceil(std::sqrt(static_cast<float>(global_settings::cpu_culled_object_count))));
+	const auto grid_spacing = 1.5f;
+
+	m_culled_object_matrices.reserve(global_settings::cpu_culled_object_count);
+
+	for (std::uint32_t index = 0; index < global_settings::cpu_culled_object_count; ++index)
+	{
+		const auto x = (static_cast<float>(index % grid_size) - static_cast<float>(grid_size) * 0.5f) * grid_spacing;
+		const auto z = -static_cast<float>(index / grid_size + 1) * grid_spacing;
+		const auto model_matrix = glm::translate(glm::mat4(1.0f), glm::vec3(x, 1.5f, z));
+
+		// Every axis of the model matrix stretches the box along its absolute direction (Arvo)
+		glm::vec3 extents(0.0f);
+
+		for (glm::length_t axis = 0; axis < 3; ++axis)
+		{
+			extents += glm::abs(glm::vec3(model_matrix[axis])) * mesh.bounds_extents[axis];
+		}
+
+		// Non-uniform scaling stretches the sphere, the largest axis scale keeps it conservative
+		const auto maximum_scale = std::max({
+			glm::length(glm::vec3(model_matrix[0])),
+			glm::length(glm::vec3(model_matrix[1])),
+			glm::length(glm::vec3(model_matrix[2])) });
+
+		m_frustum_culler.Add(glm::vec3(model_matrix * glm::vec4(mesh.bounds_center, 1.0f)), extents, mesh.bounds_radius * maximum_scale);
+		m_culled_object_matrices.push_back(model_matrix);
+	}
 }
@@ -1,12 +1,32 @@
 #pragma once
 
 // Application Vulkan wrappers
+#include "frustum_culler.hpp"
+#include "gpu_driven_scene.hpp"
+#include "instance_batcher.hpp"
 #include "memory_manager/memory_manager.hpp"
+#include "render_queue.hpp"
+#include "render_graph/render_graph.hpp"
+#include "shader_hot_reloader.hpp"
+#include "texture_manager/texture_residency.hpp"
+#include "texture_manager/texture_streamer.hpp"
+#include "vulkan_wrapper/vulkan_async_compute.hpp"
+#include "vulkan_wrapper/vulkan_bindless_texture_table.hpp"
 #include "vulkan_wrapper/vulkan_debug_messenger.hpp"
+#include "vulkan_wrapper/vulkan_descriptor_allocator.hpp"
 #include "vulkan_wrapper/vulkan_device.hpp"
+#include "vulkan_wrapper/vulkan_immediate_submit_context.hpp"
 #include "vulkan_wrapper/vulkan_instance.hpp"
+#include "vulkan_wrapper/vulkan_instance_buffer.hpp"
+#include "vulkan_wrapper/vulkan_layout_cache.hpp"
 #include "vulkan_wrapper/vulkan_pipeline.hpp"
+#include "vulkan_wrapper/vulkan_pipeline_compiler.hpp"
+#include "vulkan_wrapper/vulkan_query_pool.hpp"
 #include "vulkan_wrapper/vulkan_render_pass.hpp"
+#include "vulkan_wrapper/vulkan_sampler_cache.hpp"
+#include "vulkan_wrapper/vulkan_shader.hpp"
+#include "vulkan_wrapper/vulkan_shader_bundle.hpp"
+#include "vulkan_wrapper/vulkan_shader_permutations.hpp"
 #include "vulkan_wrapper/vulkan_swapchain.hpp"
 #include "vulkan_wrapper/vulkan_command_buffer.hpp"
 #include "vulkan_wrapper/vulkan_command_pool.hpp"
@@ -17,6 +37,8 @@
 #include "memory_manager/memory_manager.hpp"
 
 // Application core
+#include "core/snapshot_buffer.hpp"
+#include "core/thread_pool.hpp"
 #include "core/window.hpp"
 
 //////////////////////////////////////////////////////////////////////////
@@ -27,6 +49,8 @@
 //////////////////////////////////////////////////////////////////////////
 
 // C++ standard
+#include <array>
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -35,6 +59,32 @@
 
 namespace vkc
 {
+	/** Everything the simulation thread hands over to the render thread */
+	struct SimulationState
+	{
+		float rotation = 0.0f;
+	};
+
+	/** Vertex data of a mesh, every draw of a mesh is an instanced draw */
+	struct Mesh
+	{
+		vk_wrapper::VulkanVertexBuffer vertex_buffer;
+		std::uint32_t vertex_count = 0;
+
+		/** Axis-aligned bounding box, and a bounding sphere around the center of the box (mesh space) */
+		glm::vec3 bounds_center = glm::vec3(0.0f);
+		glm::vec3 bounds_extents = glm::vec3(0.0f);
+		float bounds_radius = 0.0f;
+	};
+
+	/** Fragment shader invocation query of a frame in flight */
+	struct FragmentStatisticsQuery
+	{
+		/** Recorded, but its results have not been read yet */
+		bool is_pending = false;
+		bool used_depth_prepass = false;
+	};
+
 	class Renderer
 	{
 	public:
@@ -42,29 +92,32 @@ namespace vkc
 		~Renderer();
 
 		void Initialize(const Window& window);
-		void Draw(const Window& window);
-		void Update();
+		void Draw(const Window& window, double render_time);
+		void Update(double delta_time);
 		void TriggerFramebufferResized();
 		void Destroy();
 
 	private:
+		void UpdateCameraData(double render_time);
+		void CreateShaders();
 		void CreateGraphicsPipeline();
-		void CreateFramebuffers();
-		void RecordFrameCommands();
+		vk_wrapper::PipelineHandle RequestGraphicsPipeline(bool depth_only);
+		void UpdateShaderHotReload();
+		void CreateRenderGraph();
+		void CreateFrameCommandBuffers();
+		void RecordFrameCommands(std::uint32_t swapchain_image_index, VkDescriptorSet descriptor_set);
+		void RecordMainPass(const VkCommandBuffer& command_buffer);
+		void CollectFragmentStatistics();
 		void CreateSynchronizationObjects();
 		void RecreateSwapchain(const Window& window);
 		void CleanUpSwapchain();
 		void CreateUniformBuffers();
-		void CreateDescriptorPool();
-		void CreateDescriptorSetLayout();
-		void CreateDescriptorSets();
-		
-		static void CopyStagingBufferToDeviceLocalBuffer(
-			const vk_wrapper::VulkanDevice& device,
-			const memory::VulkanBuffer&  source,
-			const memory::VulkanBuffer& destination,
-			const VkQueue& queue,
-			const vk_wrapper::VulkanCommandPool& pool);
+		VkDescriptorSet CreateFrameDescriptorSet(std::uint32_t swapchain_image_index);
+		void UpdateBindlessTextures();
+		MeshHandle CreateMesh(const std::vector<VertexPCT>& mesh_vertices);
+		void SubmitMeshes();
+		void CreateGpuDrivenScene();
+		void CreateCpuCulledScene();
 
 	private:
 		GLFWwindow* m_window;
@@ -73,28 +126,147 @@ namespace vkc
 
 		bool m_framebuffer_resized;
 
-		VkDescriptorSetLayout m_camera_data_descriptor_set_layout;
+		/** Simulation state, owned by the simulation thread */
+		SimulationState m_simulation_state;
+		double m_simulation_time;
+
+		/** Snapshots handed from the simulation thread to the render thread */
+		core::SnapshotBuffer<SimulationState> m_simulation_snapshots;
+
+		/** Simulation state interpolated for the frame that is being rendered */
+		SimulationState m_render_state;
+
+		/** Camera of the frame that is being rendered */
+		glm::mat4 m_view_projection_matrix;
+
+		/** Layouts are owned by the layout cache, index is the descriptor set number */
+		std::vector<VkDescriptorSetLayout> m_descriptor_set_layouts;
 		VkPipelineLayout m_pipeline_layout;
-		VkDescriptorPool m_descriptor_pool;
 
-		vk_wrapper::VulkanVertexBuffer m_vertex_buffer;
+		/** Shader stages that declare the per-draw push constant block */
+		VkShaderStageFlags m_draw_data_stages;
+
+		vk_wrapper::VulkanDescriptorAllocator m_descriptor_allocator;
+
+		/** Writes the per-frame set (set 0) in a single call, owned by the layout cache */
+		const vk_wrapper::VulkanDescriptorUpdateTemplate* m_frame_descriptor_template;
+		std::vector<vk_wrapper::DescriptorTemplateData> m_frame_descriptor_data;
+
+		std::vector<Mesh> m_meshes;
+		MeshHandle m_triangle_mesh;
+
+		/** Meshes submitted this frame, identical mesh + material pairs are merged into one instanced draw */
+		InstanceBatcher m_instance_batcher;
+		vk_wrapper::VulkanInstanceBuffer m_instance_buffer;
+
+		/** Draw packets of the frame, sorted by state before they are recorded */
+		RenderQueue m_render_queue;
+		std::uint64_t m_recorded_frame_count;
+		std::uint64_t m_eliminated_state_change_count;
+
+		/** Frames that took longer than the hitch threshold, measured from the start of one frame to the next */
+		std::chrono::steady_clock::time_point m_previous_frame_start;
+		std::uint64_t m_timed_frame_count;
+		std::uint64_t m_hitch_count;
+
+		/** Static scene that is culled and drawn by the GPU, only used when GPU-driven rendering is enabled and supported */
+		bool m_use_gpu_driven_rendering;
+		GpuDrivenScene m_gpu_driven_scene;
 		std::vector<vk_wrapper::VulkanUniformBuffer> m_camera_ubos;
 
-		std::vector<VkFramebuffer> m_swapchain_framebuffers;
+		/** Scene that is frustum culled on the CPU, the model matrices are indexed by the handles of the culler */
+		FrustumCuller m_frustum_culler;
+		std::vector<glm::mat4> m_culled_object_matrices;
+
+		/** Model matrices of the objects that passed culling this frame, kept around to avoid allocations */
+		std::vector<glm::mat4> m_visible_object_matrices;
+
+		std::uint64_t m_culled_frame_count;
+		std::uint64_t m_visible_object_count;
+		double m_cull_time_ms;
+
+		/** GPU culling is submitted to the compute queue, the graphics queue waits for it before the indirect draws */
+		bool m_use_async_compute;
+		vk_wrapper::VulkanAsyncCompute m_async_compute;
+
 		std::vector<VkSemaphore> m_in_flight_frame_image_available_semaphores;
 		std::vector<VkSemaphore> m_in_flight_render_finished_semaphores;
 		std::vector<VkFence> m_in_flight_fences;
-		std::vector<VkDescriptorSet> m_descriptor_sets;
+		std::vector<VkFence> m_images_in_flight;
+
+		core::ThreadPool m_worker_threads;
+		texture::TextureStreamer m_texture_streamer;
+		texture::TextureResidencyManager m_texture_residency;
+		texture::TextureHandle m_uv_map_checker_texture;
+
+		/** Textures are sampled through the bindless texture table instead of per-draw descriptors */
+		bool m_use_bindless_textures;
+		vk_wrapper::VulkanBindlessTextureTable m_bindless_textures;
+		std::uint32_t m_uv_map_checker_bindless_index;
+
+		/** Texture residency generation the bindless texture table was last updated with */
+		std::uint64_t m_bindless_texture_generation;
 
 		vk_wrapper::VulkanInstance m_instance;
 		vk_wrapper::VulkanDebugMessenger m_debug_messenger;
 		vk_wrapper::VulkanSwapchain m_swapchain;
 		vk_wrapper::VulkanDevice m_device;
-		vk_wrapper::VulkanPipeline m_graphics_pipeline;
-		vk_wrapper::VulkanRenderPass m_render_pass;
+		vk_wrapper::VulkanShaderPermutations m_basic_shaders;
+		vk_wrapper::ShaderPermutationKey m_basic_shader_key;
+		vk_wrapper::VulkanLayoutCache m_layout_cache;
+		vk_wrapper::VulkanPipelineCompiler m_pipeline_compiler;
+		vk_wrapper::PipelineHandle m_graphics_pipeline;
+
+		/** Baked SPIR-V, stays mapped for as long as shaders can be created */
+		vk_wrapper::VulkanShaderBundle m_shader_bundle;
+
+		/** Recompiles the basic shader when its sources change, only used when shader hot-reloading is enabled */
+		ShaderHotReloader m_shader_hot_reloader;
+		WatchedShaderHandle m_basic_shader_watch;
+
+		/** Pipelines of a reloaded shader that are still compiling, the current pipelines are used until both are ready */
+		std::optional<vk_wrapper::PipelineHandle> m_reloaded_graphics_pipeline;
+		std::optional<vk_wrapper::PipelineHandle> m_reloaded_depth_prepass_pipeline;
+
+		/** Replaced pipelines are destroyed once the frames in flight that use them have finished */
+		std::vector<std::pair<std::uint64_t, vk_wrapper::PipelineHandle>> m_retired_pipelines;
+
+		/** Passes of a frame, built again whenever the swapchain is recreated */
+		render_graph::RenderGraph m_render_graph;
+		render_graph::ResourceHandle m_back_buffer;
+		render_graph::PassHandle m_main_pass;
+
+		/** Only lives in the main pass, so it is a transient attachment (lazily allocated where possible) */
+		render_graph::ResourceHandle m_depth_buffer;
+
+		/** Rendered to instead of the swapchain image when multisampling, resolved by the main pass itself */
+		render_graph::ResourceHandle m_multisampled_color_buffer;
+		VkSampleCountFlagBits m_sample_count;
+
+		/** Vertex stage of the basic shader only, fills the depth buffer before the color draws */
+		vk_wrapper::PipelineHandle m_depth_prepass_pipeline;
+		bool m_use_depth_prepass;
+
+		/** Fragment shader invocations of the main pass, one query per frame in flight */
+		bool m_measure_fragment_invocations;
+		vk_wrapper::VulkanQueryPool m_fragment_statistics_query_pool;
+		std::vector<FragmentStatisticsQuery> m_fragment_statistics_queries;
+
+		/** Index 0 counts the frames without the depth prepass, index 1 the frames with it */
+		std::array<std::uint64_t, 2> m_fragment_invocation_counts;
+		std::array<std::uint64_t, 2> m_fragment_measured_frame_counts;
+
+		/** Per-frame set (set 0) of the frame that is being recorded */
+		VkDescriptorSet m_frame_descriptor_set;
+
 		vk_wrapper::VulkanCommandPool m_graphics_command_pool;
 		vk_wrapper::VulkanCommandBuffer m_graphics_command_buffers;
-		vk_wrapper::VulkanTexture m_uv_map_checker_texture;
-		vk_wrapper::VulkanTextureSampler m_default_sampler;
+
+		/** One-off uploads outside of the frame command buffers */
+		vk_wrapper::VulkanImmediateSubmitContext m_immediate_submit;
+
+		vk_wrapper::VulkanSamplerCache m_sampler_cache;
+		vk_wrapper::TextureSamplerSettings m_default_sampler_settings;
+		VkSampler m_default_sampler;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,174 @@
+// Application
+#include "core/thread_pool.hpp"
+#include "miscellaneous/exceptions.hpp"
+#include "shader_hot_reloader.hpp"
+#include "vulkan_wrapper/vulkan_device.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <algorithm>
+#include <chrono>
+
+using namespace vkc;
+
+ShaderHotReloader::ShaderHotReloader() noexcept(true)
+	: m_thread_pool(nullptr)
+{}
+
+ShaderHotReloader::~ShaderHotReloader() noexcept(true)
+{}
+
+void ShaderHotReloader::Create(core::ThreadPool& thread_pool) noexcept(false)
+{
+	m_thread_pool = &thread_pool;
+	m_file_watcher.Create();
+}
+
+void ShaderHotReloader::Destroy(const vk_wrapper::VulkanDevice& device) noexcept(true)
+{
+	for (auto& watched_shader : m_watched_shaders)
+	{
+		if (!watched_shader.is_compiling)
+		{
+			continue;
+		}
+
+		// Nobody is going to use the result anymore
+		try
+		{
+			watched_shader.job.get().Destroy(device);
+		}
+		catch (...)
+		{}
+	}
+
+	m_watched_shaders.clear();
+	m_file_watcher.Destroy();
+}
+
+WatchedShaderHandle ShaderHotReloader::Watch(
+	const vk_wrapper::VulkanShader& shader,
+	const vk_wrapper::ShaderCompileRequest& request) noexcept(true)
+{
+	WatchedShader watched_shader = {};
+	watched_shader.request = request;
+	SetDependencies(watched_shader, shader);
+
+	m_watched_shaders.push_back(std::move(watched_shader));
+
+	return static_cast<WatchedShaderHandle>(m_watched_shaders.size() - 1);
+}
+
+std::vector<ReloadedShader> ShaderHotReloader::Update(const vk_wrapper::VulkanDevice& device) noexcept(true)
+{
+	const auto changed_files = m_file_watcher.GetChangedFiles();
+
+	for (const auto& path : changed_files)
+	{
+		spdlog::info("Shader source \"{}\" changed.", path);
+	}
+
+	std::vector<ReloadedShader> reloaded_shaders;
+
+	for (WatchedShaderHandle handle = 0; handle < m_watched_shaders.size(); ++handle)
+	{
+		auto& watched_shader = m_watched_shaders[handle];
+
+		// Only the shaders that depend on a changed file are recompiled
+		const auto is_affected = std::any_of(
+			changed_files.begin(),
+			changed_files.end(),
+			[&watched_shader](const std::string& path)
+			{
+				return std::binary_search(watched_shader.dependencies.begin(), watched_shader.dependencies.end(), path);
+			});
+
+		if (is_affected)
+		{
+			if (watched_shader.is_compiling)
+			{
+				watched_shader.is_outdated = true;
+			}
+			else
+			{
+				StartCompiling(device, watched_shader);
+			}
+		}
+
+		if (!watched_shader.is_compiling || watched_shader.job.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			continue;
+		}
+
+		watched_shader.is_compiling = false;
+
+		try
+		{
+			auto shader = watched_shader.job.get();
+
+			if (watched_shader.is_outdated)
+			{
+				shader.Destroy(device);
+			}
+			else
+			{
+				SetDependencies(watched_shader, shader);
+				reloaded_shaders.push_back({ handle, shader });
+
+				spdlog::info("Reloaded shader \"{}\".", watched_shader.request.shader_files.front().first);
+			}
+		}
+		catch (exception::CriticalVulkanError& error)
+		{
+			spdlog::error("Could not reload shader \"{}\": {}", watched_shader.request.shader_files.front().first, error.what());
+		}
+		catch (exception::CriticalIOError& error)
+		{
+			// Editors may briefly remove the file while saving, the next write triggers another attempt
+			spdlog::error("Could not reload shader \"{}\": {}", watched_shader.request.shader_files.front().first, error.what());
+		}
+		catch (...)
+		{
+			spdlog::error("Could not reload shader \"{}\".", watched_shader.request.shader_files.front().first);
+		}
+
+		if (watched_shader.is_outdated)
+		{
+			watched_shader.is_outdated = false;
+			StartCompiling(device, watched_shader);
+		}
+	}
+
+	return reloaded_shaders;
+}
+
+void ShaderHotReloader::StartCompiling(const vk_wrapper::VulkanDevice& device, WatchedShader& watched_shader) noexcept(true)
+{
+	watched_shader.is_compiling = true;
+	watched_shader.job = m_thread_pool->Enqueue(
+		[&device, request = watched_shader.request]()
+		{
+			vk_wrapper::VulkanShader shader;
+			shader.Create(device, request.shader_files, request.defines);
+
+			return shader;
+		});
+}
+
+void ShaderHotReloader::SetDependencies(WatchedShader& watched_shader, const vk_wrapper::VulkanShader& shader) noexcept(true)
+{
+	watched_shader.dependencies.clear();
+
+	for (const auto& path : shader.GetDependencies())
+	{
+		const auto normalized_path = core::FileWatcher::NormalizePath(path);
+
+		watched_shader.dependencies.push_back(normalized_path);
+		m_file_watcher.Watch(normalized_path);
+	}
+
+	// Sorted for the lookups in "Update"
+	std::sort(watched_shader.dependencies.begin(), watched_shader.dependencies.end());
+}
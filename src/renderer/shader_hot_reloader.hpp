@@ -0,0 +1,100 @@
+#ifndef SHADER_HOT_RELOADER_HPP
+#define SHADER_HOT_RELOADER_HPP
+
+// Application
+#include "core/file_watcher.hpp"
+#include "vulkan_wrapper/vulkan_shader.hpp"
+
+// C++ standard
+#include <cstdint>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace vkc
+{
+	namespace core
+	{
+		class ThreadPool;
+	}
+
+	namespace vk_wrapper
+	{
+		class VulkanDevice;
+	}
+
+	/** Index of a shader watched by the shader hot-reloader */
+	using WatchedShaderHandle = std::uint32_t;
+
+	/** Shader that finished recompiling after one of its source files changed */
+	struct ReloadedShader
+	{
+		WatchedShaderHandle handle;
+		vk_wrapper::VulkanShader shader;
+	};
+
+	/** Recompiles shaders in the background whenever one of their source files changes */
+	/**
+	 * Every watched shader remembers the files it was compiled from,
+	 * including the files pulled in through "#include", so a change to a
+	 * shared include file only recompiles the shaders that include it.
+	 *
+	 * "Update" is meant to be called at the start of a frame. It hands out
+	 * the shaders that finished recompiling, the caller swaps them in (and
+	 * recreates the pipelines that use them) and owns them from then on.
+	 * Shaders that fail to compile are logged and skipped, the previous
+	 * version stays in use until the source is fixed.
+	 *
+	 * Only call the hot-reloader from the render thread.
+	 */
+	class ShaderHotReloader
+	{
+	public:
+		ShaderHotReloader() noexcept(true);
+		~ShaderHotReloader() noexcept(true);
+
+		/** Start watching for file changes */
+		void Create(core::ThreadPool& thread_pool) noexcept(false);
+
+		/** Wait for pending recompilations and stop watching */
+		void Destroy(const vk_wrapper::VulkanDevice& device) noexcept(true);
+
+		/** Recompile the shader with the same sources and definitions whenever one of its dependencies changes */
+		WatchedShaderHandle Watch(
+			const vk_wrapper::VulkanShader& shader,
+			const vk_wrapper::ShaderCompileRequest& request) noexcept(true);
+
+		/** Start recompiling the shaders affected by file changes, and return the shaders that finished recompiling */
+		std::vector<ReloadedShader> Update(const vk_wrapper::VulkanDevice& device) noexcept(true);
+
+	private:
+		struct WatchedShader
+		{
+			vk_wrapper::ShaderCompileRequest request;
+
+			/** Normalized paths of the files the shader was last compiled from */
+			std::vector<std::string> dependencies;
+
+			std::future<vk_wrapper::VulkanShader> job;
+			bool is_compiling = false;
+
+			/** A dependency changed again while the shader was compiling, the result is already outdated */
+			bool is_outdated = false;
+		};
+
+		/** Queue a recompilation of the shader on a worker thread */
+		void StartCompiling(const vk_wrapper::VulkanDevice& device, WatchedShader& watched_shader) noexcept(true);
+
+		/** Remember the dependencies of a compiled shader, and watch the ones that are new */
+		void SetDependencies(WatchedShader& watched_shader, const vk_wrapper::VulkanShader& shader) noexcept(true);
+
+	private:
+		core::ThreadPool* m_thread_pool;
+		core::FileWatcher m_file_watcher;
+
+		/** Index is the handle of the watched shader */
+		std::vector<WatchedShader> m_watched_shaders;
+	};
+}
+
+#endif // SHADER_HOT_RELOADER_HPP
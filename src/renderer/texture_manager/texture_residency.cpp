@@ -0,0 +1,220 @@
+// Application
+#include "miscellaneous/global_settings.hpp"
+#include "renderer/memory_manager/memory_manager.hpp"
+#include "texture_residency.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+using namespace vkc::memory;
+using namespace vkc::texture;
+
+TextureResidencyManager::TextureResidencyManager() noexcept(true)
+	: m_frame_index(1)
+	, m_budget(global_settings::texture_memory_budget)
+{}
+
+TextureResidencyManager::~TextureResidencyManager() noexcept(true)
+{}
+
+void TextureResidencyManager::MarkUsed(TextureHandle handle, std::uint32_t required_mip_level) noexcept(false)
+{
+	if (handle >= m_texture_usage.size())
+	{
+		m_texture_usage.resize(static_cast<std::size_t>(handle) + 1);
+	}
+
+	auto& usage = m_texture_usage[handle];
+
+	if (usage.last_used_frame == m_frame_index)
+	{
+		usage.required_mip_level = (std::min)(usage.required_mip_level, required_mip_level);
+	}
+	else
+	{
+		usage.last_used_frame = m_frame_index;
+		usage.required_mip_level = required_mip_level;
+	}
+}
+
+void TextureResidencyManager::Update(TextureStreamer& texture_streamer) noexcept(false)
+{
+	auto& memory_manager = MemoryManager::GetInstance();
+
+	// Textures marked from here on belong to the next frame
+	auto previous_frame_index = m_frame_index++;
+
+	// Refreshes the heap budget reported by the driver
+	memory_manager.SetCurrentFrameIndex(static_cast<std::uint32_t>(m_frame_index));
+
+	auto texture_size = texture_streamer.GetResidentSize();
+	auto heap_budget = memory_manager.GetDeviceLocalBudget();
+
+	// Memory used by other resources cannot be reclaimed by evicting mip levels
+	auto other_usage = (heap_budget.usage > texture_size) ? heap_budget.usage - texture_size : 0;
+	auto heap_texture_budget = (heap_budget.budget > other_usage) ? heap_budget.budget - other_usage : 0;
+
+	m_budget = (std::min)(static_cast<VkDeviceSize>(global_settings::texture_memory_budget), heap_texture_budget);
+
+	std::vector<ResidencyCandidate> candidates;
+	std::unordered_map<TextureHandle, std::size_t> candidate_indices;
+	std::vector<std::pair<TextureHandle, TextureUsage>> shared_image_usage;
+
+	auto texture_count = texture_streamer.GetTextureCount();
+
+	for (TextureHandle handle = 0; handle < texture_count; ++handle)
+	{
+		auto residency = texture_streamer.GetResidency(handle);
+
+		if (residency.state != TextureState::Resident || residency.is_changing_residency)
+		{
+			continue;
+		}
+
+		TextureUsage usage = {};
+
+		if (handle < m_texture_usage.size())
+		{
+			usage = m_texture_usage[handle];
+		}
+
+		// Textures that share an image count as uses of the owner of the image
+		if (residency.owner != handle)
+		{
+			shared_image_usage.emplace_back(residency.owner, usage);
+			continue;
+		}
+
+		ResidencyCandidate candidate = {};
+		candidate.handle = handle;
+		candidate.residency = residency;
+		candidate.usage = usage;
+
+		candidate_indices[handle] = candidates.size();
+		candidates.push_back(candidate);
+	}
+
+	for (const auto& [owner, usage] : shared_image_usage)
+	{
+		auto candidate_index = candidate_indices.find(owner);
+
+		if (candidate_index == candidate_indices.end())
+		{
+			continue;
+		}
+
+		auto& owner_usage = candidates[candidate_index->second].usage;
+
+		if (usage.last_used_frame > owner_usage.last_used_frame)
+		{
+			owner_usage = usage;
+		}
+		else if (usage.last_used_frame == owner_usage.last_used_frame)
+		{
+			owner_usage.required_mip_level = (std::min)(owner_usage.required_mip_level, usage.required_mip_level);
+		}
+	}
+
+	std::uint32_t change_count = 0;
+	auto projected_size = texture_size;
+
+	if (projected_size > m_budget)
+	{
+		// Least recently used textures lose their detailed mip levels first
+		std::sort(candidates.begin(), candidates.end(), [](const ResidencyCandidate& lhs, const ResidencyCandidate& rhs) {
+			return (lhs.usage.last_used_frame < rhs.usage.last_used_frame);
+		});
+
+		for (const auto& candidate : candidates)
+		{
+			if (projected_size <= m_budget || change_count >= global_settings::maximum_texture_residency_changes_per_frame)
+			{
+				break;
+			}
+
+			const auto& residency = candidate.residency;
+			auto evicted_mip_level = residency.resident_mip_level;
+
+			// The smallest mip level always stays resident
+			if (evicted_mip_level + 1 >= residency.mip_level_count)
+			{
+				continue;
+			}
+
+			if (texture_streamer.SetResidentMipLevel(candidate.handle, evicted_mip_level + 1))
+			{
+				projected_size -= (std::min)(projected_size,
+					CalculateMipChainSize(residency, evicted_mip_level) - CalculateMipChainSize(residency, evicted_mip_level + 1));
+
+				++change_count;
+			}
+		}
+
+		return;
+	}
+
+	// Leave some room between the stream-in limit and the budget to avoid evicting the same mip levels again
+	auto stream_in_budget = static_cast<VkDeviceSize>(static_cast<double>(m_budget) * global_settings::texture_stream_in_budget_fraction);
+
+	// Most recently used textures get their detailed mip levels back first
+	std::sort(candidates.begin(), candidates.end(), [](const ResidencyCandidate& lhs, const ResidencyCandidate& rhs) {
+		return (lhs.usage.last_used_frame > rhs.usage.last_used_frame);
+	});
+
+	for (const auto& candidate : candidates)
+	{
+		if (change_count >= global_settings::maximum_texture_residency_changes_per_frame)
+		{
+			break;
+		}
+
+		// Only textures used by the last frame are worth streaming in
+		if (candidate.usage.last_used_frame != previous_frame_index)
+		{
+			break;
+		}
+
+		const auto& residency = candidate.residency;
+		auto required_mip_level = candidate.usage.required_mip_level;
+
+		if (residency.resident_mip_level <= required_mip_level)
+		{
+			continue;
+		}
+
+		auto additional_size = CalculateMipChainSize(residency, required_mip_level) - CalculateMipChainSize(residency, residency.resident_mip_level);
+
+		if (projected_size + additional_size > stream_in_budget)
+		{
+			continue;
+		}
+
+		if (texture_streamer.SetResidentMipLevel(candidate.handle, required_mip_level))
+		{
+			projected_size += additional_size;
+			++change_count;
+		}
+	}
+}
+
+VkDeviceSize TextureResidencyManager::GetBudget() const noexcept(true)
+{
+	return m_budget;
+}
+
+VkDeviceSize TextureResidencyManager::CalculateMipChainSize(const TextureResidency& residency, std::uint32_t first_mip_level) noexcept(true)
+{
+	VkDeviceSize size = 0;
+
+	for (auto mip_level = first_mip_level; mip_level < residency.mip_level_count; ++mip_level)
+	{
+		auto mip_width = (std::max)(residency.width >> mip_level, 1u);
+		auto mip_height = (std::max)(residency.height >> mip_level, 1u);
+
+		size += static_cast<VkDeviceSize>(mip_width) * mip_height * residency.bytes_per_texel;
+	}
+
+	return size;
+}
@@ -0,0 +1,83 @@
+#ifndef TEXTURE_RESIDENCY_HPP
+#define TEXTURE_RESIDENCY_HPP
+
+// Application
+#include "texture_streamer.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <vector>
+
+namespace vkc::texture
+{
+	/** Keeps streamed textures within the texture memory budget by evicting and streaming in mip levels */
+	/**
+	 * The budget is the smaller of the configured texture memory budget and
+	 * the part of the device-local heap budget that is not used by other
+	 * resources. The heap budget is reported by the driver when
+	 * VK_EXT_memory_budget is available.
+	 *
+	 * When textures use more memory than the budget allows, the detailed
+	 * mip levels of the least recently used textures are evicted one level at
+	 * a time. Once there is room again, recently used textures stream their
+	 * required mip levels back in, most recently used textures first. Mip
+	 * levels are only streamed in below a fraction of the budget, which keeps
+	 * textures from being evicted and streamed in over and over again.
+	 *
+	 * All functions have to be called on the render thread.
+	 */
+	class TextureResidencyManager
+	{
+	public:
+		TextureResidencyManager() noexcept(true);
+		~TextureResidencyManager() noexcept(true);
+
+		/** Let the residency manager know a texture is used by the frame that is being recorded */
+		/**
+		 * "required_mip_level" is the most detailed mip level the frame
+		 * samples from, when a texture is used multiple times in a frame the
+		 * most detailed level wins.
+		 */
+		void MarkUsed(TextureHandle handle, std::uint32_t required_mip_level = 0) noexcept(false);
+
+		/** Start mip level evictions and stream-ins, call this once per frame before updating the texture streamer */
+		void Update(TextureStreamer& texture_streamer) noexcept(false);
+
+		/** Get the texture memory budget that was used during the last update */
+		VkDeviceSize GetBudget() const noexcept(true);
+
+	private:
+		/** Usage of a single texture by recent frames */
+		struct TextureUsage
+		{
+			/** Zero when the texture has never been used */
+			std::uint64_t last_used_frame = 0;
+			std::uint32_t required_mip_level = 0;
+		};
+
+		/** Texture that is resident and can change its resident mip levels */
+		struct ResidencyCandidate
+		{
+			TextureHandle handle = 0;
+			TextureResidency residency;
+			TextureUsage usage;
+		};
+
+		/** Calculate the memory used by all mip levels from "first_mip_level" onward */
+		static VkDeviceSize CalculateMipChainSize(const TextureResidency& residency, std::uint32_t first_mip_level) noexcept(true);
+
+	private:
+		/** Indexed by texture handle */
+		std::vector<TextureUsage> m_texture_usage;
+
+		/** Starts at one, zero marks textures that have never been used */
+		std::uint64_t m_frame_index;
+
+		VkDeviceSize m_budget;
+	};
+}
+
+#endif // TEXTURE_RESIDENCY_HPP
@@ -0,0 +1,752 @@
+// Application
+#include "core/hash.hpp"
+#include "core/thread_pool.hpp"
+#include "miscellaneous/exceptions.hpp"
+#include "miscellaneous/global_settings.hpp"
+#include "renderer/vulkan_wrapper/vulkan_barrier_batcher.hpp"
+#include "renderer/vulkan_wrapper/vulkan_device.hpp"
+#include "renderer/vulkan_wrapper/vulkan_utility.hpp"
+#include "texture_streamer.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <limits>
+
+using namespace vkc::exception;
+using namespace vkc::memory;
+using namespace vkc::texture;
+using namespace vkc::vk_wrapper;
+
+TextureStreamer::TextureStreamer() noexcept(true)
+	: m_thread_pool(nullptr)
+	, m_residency_generation(0)
+	, m_resident_size(0)
+{}
+
+TextureStreamer::~TextureStreamer() noexcept(true)
+{}
+
+void TextureStreamer::Create(
+	const VulkanDevice& device,
+	core::ThreadPool& thread_pool,
+	VulkanImmediateSubmitContext& immediate_submit) noexcept(false)
+{
+	m_thread_pool = &thread_pool;
+
+	// Upload command buffers are freed individually once their fence has been signaled
+	m_upload_command_pool.Create(device, CommandPoolType::Graphics);
+
+	CreatePlaceholderTexture(device, immediate_submit);
+}
+
+void TextureStreamer::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+
+	// Worker threads may still be decoding, their results are not needed anymore
+	for (auto handle : m_decoding_textures)
+	{
+		m_textures[handle].decoded_texture.wait();
+	}
+
+	m_decoding_textures.clear();
+	m_evicting_textures.clear();
+
+	// Retire all in-flight uploads
+	FinishUploads(device, true);
+	DestroyRetiredTextures(device, true);
+
+	for (auto& texture : m_textures)
+	{
+		if (texture.texture)
+		{
+			texture.texture->Destroy(device);
+		}
+	}
+
+	m_textures.clear();
+	m_textures_by_path.clear();
+	m_textures_by_content.clear();
+	m_resident_size = 0;
+
+	m_placeholder_texture.Destroy(device);
+	m_upload_command_pool.Destroy(device);
+}
+
+TextureHandle TextureStreamer::RequestTexture(const std::string& path, VkFormat format) noexcept(false)
+{
+	// Different spellings of the same path should resolve to the same texture
+	auto path_key = std::filesystem::path(path).lexically_normal().generic_string() + "|" + std::to_string(format);
+
+	// Keep the lock while decoding is started, concurrent requests for the same file have to share it
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+
+	auto existing_texture = m_textures_by_path.find(path_key);
+
+	if (existing_texture != m_textures_by_path.end())
+	{
+		++m_textures[existing_texture->second].reference_count;
+		return existing_texture->second;
+	}
+
+	auto handle = static_cast<TextureHandle>(m_textures.size());
+
+	StreamedTexture texture = {};
+	texture.path = path;
+	texture.format = format;
+	texture.state = TextureState::Decoding;
+	texture.path_key = path_key;
+	texture.owner = handle;
+	texture.reference_count = 1;
+
+	// Decode the image file and generate its mip chain on a worker thread
+	texture.decoded_texture = m_thread_pool->Enqueue([path]() {
+		return DecodeTexture(path);
+	});
+
+	m_textures.push_back(std::move(texture));
+	m_textures_by_path[path_key] = handle;
+	m_decoding_textures.push_back(handle);
+
+	return handle;
+}
+
+void TextureStreamer::ReleaseTexture(TextureHandle handle) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+	RemoveReference(handle);
+}
+
+void TextureStreamer::Update(const VulkanDevice& device) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+
+	DestroyRetiredTextures(device, false);
+	FinishUploads(device, false);
+	StartUploads(device);
+}
+
+TextureState TextureStreamer::GetState(TextureHandle handle) const noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+	return GetOwner(handle).state;
+}
+
+std::uint32_t TextureStreamer::GetTextureCount() const noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+	return static_cast<std::uint32_t>(m_textures.size());
+}
+
+TextureResidency TextureStreamer::GetResidency(TextureHandle handle) const noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+	const auto& texture = GetOwner(handle);
+
+	TextureResidency residency = {};
+	residency.state = texture.state;
+	residency.owner = texture.owner;
+	residency.width = texture.width;
+	residency.height = texture.height;
+	residency.bytes_per_texel = texture.channel_count * utility::VulkanFormatToBytesPerChannel(texture.format);
+	residency.mip_level_count = texture.mip_level_count;
+	residency.resident_mip_level = texture.resident_mip_level;
+	residency.resident_size = texture.texture ? texture.texture->GetImage().info.size : 0;
+	residency.is_changing_residency = texture.is_changing_residency;
+
+	return residency;
+}
+
+VkDeviceSize TextureStreamer::GetResidentSize() const noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+	return m_resident_size;
+}
+
+bool TextureStreamer::SetResidentMipLevel(TextureHandle handle, std::uint32_t mip_level) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+	// Textures that share an image change the residency of the owner of the image
+	auto owner = GetOwner(handle).owner;
+	auto& texture = m_textures[owner];
+
+	if (texture.state != TextureState::Resident || texture.is_changing_residency)
+	{
+		return false;
+	}
+
+	// The smallest mip level always stays resident
+	mip_level = (std::min)(mip_level, texture.mip_level_count - 1);
+
+	if (mip_level == texture.resident_mip_level)
+	{
+		return true;
+	}
+
+	texture.requested_mip_level = mip_level;
+	texture.is_changing_residency = true;
+
+	if (mip_level > texture.resident_mip_level)
+	{
+		// Dropping mip levels does not need the image file, the remaining levels are copied on the GPU
+		m_evicting_textures.push_back(owner);
+	}
+	else
+	{
+		// The detailed mip levels are gone, decode the image file again
+		auto path = texture.path;
+
+		texture.decoded_texture = m_thread_pool->Enqueue([path]() {
+			return DecodeTexture(path);
+		});
+
+		m_decoding_textures.push_back(owner);
+	}
+
+	return true;
+}
+
+const VkImageView& TextureStreamer::GetImageView(TextureHandle handle) const noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+	const auto& texture = GetOwner(handle);
+
+	if (texture.state != TextureState::Resident)
+	{
+		return m_placeholder_texture.GetImageView();
+	}
+
+	return texture.texture->GetImageView();
+}
+
+std::uint64_t TextureStreamer::GetResidencyGeneration() const noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_textures_mutex);
+	return m_residency_generation;
+}
+
+TextureStreamer::DecodedTexture TextureStreamer::DecodeTexture(const std::string& path) noexcept(false)
+{
+	auto pixel_data = VulkanTexture::LoadPixelData(path);
+
+	DecodedTexture decoded_texture = {};
+	decoded_texture.content_hash = core::HashBytes(pixel_data.pixels.data(), pixel_data.pixels.size());
+	decoded_texture.mip_chain = VulkanTexture::GenerateMipChain(std::move(pixel_data));
+
+	return decoded_texture;
+}
+
+TextureStreamer::DecodedTexture TextureStreamer::VerifyContent(const std::string& candidate_path, DecodedTexture decoded_texture) noexcept(false)
+{
+	const auto& pixel_data = decoded_texture.mip_chain[0];
+	TexturePixelData candidate_pixel_data = {};
+
+	try
+	{
+		candidate_pixel_data = VulkanTexture::LoadPixelData(candidate_path);
+	}
+	catch (CriticalIOError&)
+	{
+		// The candidate cannot be compared with anymore, the texture is uploaded on its own
+		decoded_texture.matches_content_candidate = false;
+		return decoded_texture;
+	}
+
+	decoded_texture.matches_content_candidate =
+		candidate_pixel_data.width == pixel_data.width &&
+		candidate_pixel_data.height == pixel_data.height &&
+		candidate_pixel_data.channel_count == pixel_data.channel_count &&
+		candidate_pixel_data.pixels == pixel_data.pixels;
+
+	return decoded_texture;
+}
+
+const TextureStreamer::StreamedTexture& TextureStreamer::GetOwner(TextureHandle handle) const noexcept(false)
+{
+	const auto& texture = m_textures.at(handle);
+
+	// A released texture no longer shares the image of its owner
+	if (texture.state == TextureState::Released)
+	{
+		return texture;
+	}
+
+	return m_textures[texture.owner];
+}
+
+void TextureStreamer::RemoveReference(TextureHandle handle) noexcept(false)
+{
+	auto& texture = m_textures.at(handle);
+
+	if (texture.reference_count == 0)
+	{
+		spdlog::warn("Texture \"{}\" has been released more often than it has been requested.", texture.path);
+		return;
+	}
+
+	if (--texture.reference_count > 0)
+	{
+		return;
+	}
+
+	m_textures_by_path.erase(texture.path_key);
+	texture.is_released = true;
+
+	// Textures that share an image hold a reference to the owner of the image
+	if (texture.owner != handle)
+	{
+		texture.state = TextureState::Released;
+		RemoveReference(texture.owner);
+		return;
+	}
+
+	auto content_texture = m_textures_by_content.find(texture.content_key);
+
+	if (content_texture != m_textures_by_content.end() && content_texture->second == handle)
+	{
+		m_textures_by_content.erase(content_texture);
+	}
+
+	// In-progress decodes and uploads retire the texture once they complete
+	auto is_busy = (texture.state == TextureState::Decoding || texture.state == TextureState::Uploading || texture.is_changing_residency);
+
+	if (!is_busy)
+	{
+		RetireReleasedTexture(texture);
+	}
+}
+
+void TextureStreamer::RetireReleasedTexture(StreamedTexture& texture) noexcept(false)
+{
+	if (texture.texture)
+	{
+		m_resident_size -= texture.texture->GetImage().info.size;
+
+		RetiredTexture retired_texture = {};
+		retired_texture.texture = std::move(texture.texture);
+		retired_texture.remaining_updates = global_settings::maximum_in_flight_frame_count + 1;
+		m_retired_textures.push_back(std::move(retired_texture));
+	}
+
+	texture.state = TextureState::Released;
+	texture.is_changing_residency = false;
+}
+
+void TextureStreamer::CreatePlaceholderTexture(
+	const VulkanDevice& device,
+	VulkanImmediateSubmitContext& immediate_submit) noexcept(false)
+{
+	// Single white texel, does not affect the vertex color when sampled
+	TexturePixelData pixel_data = {};
+	pixel_data.width = 1;
+	pixel_data.height = 1;
+	pixel_data.channel_count = 4;
+	pixel_data.pixels = { 255, 255, 255, 255 };
+
+	m_placeholder_texture.Create(pixel_data, VK_FORMAT_R8G8B8A8_UNORM, device);
+
+	auto staging_buffer = m_placeholder_texture.CreateStagingBuffer(pixel_data);
+
+	// Blocking is fine here, this only happens once during initialization
+	immediate_submit.Execute(
+		device,
+		[this, &staging_buffer](const VkCommandBuffer& command_buffer)
+		{
+			m_placeholder_texture.RecordUpload(command_buffer, staging_buffer);
+		});
+
+	MemoryManager::GetInstance().Free(staging_buffer);
+}
+
+void TextureStreamer::StartUploads(const VulkanDevice& device) noexcept(false)
+{
+	UploadBatch batch = {};
+	VkDeviceSize batch_size = 0;
+
+	// Textures that drop mip levels, and the index of the first level to keep in their current texture
+	std::vector<std::pair<TextureHandle, std::uint32_t>> copies;
+
+	// Textures that are uploaded from the staging buffer at the same index in the batch
+	std::vector<TextureHandle> uploads;
+
+	// Record the upload commands on first use of the batch
+	auto begin_batch = [this, &batch, &device]() {
+		if (batch.textures.empty())
+		{
+			batch.command_buffer.Create(device, m_upload_command_pool, 1);
+			batch.command_buffer.BeginRecording(CommandBufferUsage::OneTimeSubmit);
+		}
+	};
+
+	for (auto handle : m_evicting_textures)
+	{
+		auto& texture = m_textures[handle];
+
+		if (texture.is_released)
+		{
+			RetireReleasedTexture(texture);
+			continue;
+		}
+
+		if (!CreatePendingTexture(device, texture, false))
+		{
+			// Keep sampling from the current texture, the residency manager will try again later
+			texture.is_changing_residency = false;
+			continue;
+		}
+
+		begin_batch();
+
+		copies.emplace_back(handle, texture.requested_mip_level - texture.resident_mip_level);
+		batch.textures.push_back(handle);
+	}
+
+	m_evicting_textures.clear();
+
+	for (auto it = m_decoding_textures.begin(); it != m_decoding_textures.end();)
+	{
+		// Do not exceed the upload budget, the remaining textures will be uploaded next frame
+		if (batch_size >= global_settings::texture_upload_budget_per_frame)
+		{
+			break;
+		}
+
+		auto& texture = m_textures[*it];
+
+		// Still decoding
+		if (texture.decoded_texture.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			++it;
+			continue;
+		}
+
+		DecodedTexture decoded_texture = {};
+
+		try
+		{
+			decoded_texture = texture.decoded_texture.get();
+		}
+		catch (CriticalIOError& error)
+		{
+			// Keep using the placeholder (or the resident mip levels), a missing texture should not take the application down
+			spdlog::error("Could not stream texture \"{}\": {}", texture.path, error.what());
+
+			if (texture.state == TextureState::Decoding)
+			{
+				texture.state = TextureState::Failed;
+			}
+
+			texture.is_changing_residency = false;
+
+			if (texture.is_released)
+			{
+				RetireReleasedTexture(texture);
+			}
+
+			it = m_decoding_textures.erase(it);
+			continue;
+		}
+
+		// Nobody is interested in the result anymore
+		if (texture.is_released)
+		{
+			RetireReleasedTexture(texture);
+			it = m_decoding_textures.erase(it);
+			continue;
+		}
+
+		const auto& mip_chain = decoded_texture.mip_chain;
+		auto is_initial_upload = (texture.state == TextureState::Decoding);
+
+		if (is_initial_upload)
+		{
+			texture.width = mip_chain[0].width;
+			texture.height = mip_chain[0].height;
+			texture.channel_count = mip_chain[0].channel_count;
+			texture.mip_level_count = static_cast<std::uint32_t>(mip_chain.size());
+
+			auto content_key = decoded_texture.content_hash;
+			core::HashCombine(content_key, texture.width);
+			core::HashCombine(content_key, texture.height);
+			core::HashCombine(content_key, static_cast<std::uint32_t>(texture.format));
+
+			auto content_texture = m_textures_by_content.find(content_key);
+
+			if (texture.is_verifying_content)
+			{
+				texture.is_verifying_content = false;
+
+				// Share the image of a texture with identical pixels instead of uploading it again
+				if (decoded_texture.matches_content_candidate &&
+					content_texture != m_textures_by_content.end() &&
+					content_texture->second == texture.content_candidate)
+				{
+					spdlog::info("Texture \"{}\" is identical to \"{}\", sharing its image.", texture.path, m_textures[content_texture->second].path);
+
+					texture.owner = content_texture->second;
+					++m_textures[texture.owner].reference_count;
+
+					it = m_decoding_textures.erase(it);
+					continue;
+				}
+			}
+			else if (content_texture != m_textures_by_content.end())
+			{
+				// Hashes can collide, compare the pixels before sharing the image
+				auto candidate_path = m_textures[content_texture->second].path;
+
+				texture.content_candidate = content_texture->second;
+				texture.is_verifying_content = true;
+				texture.decoded_texture = m_thread_pool->Enqueue([candidate_path, decoded_texture = std::move(decoded_texture)]() mutable {
+					return VerifyContent(candidate_path, std::move(decoded_texture));
+				});
+
+				++it;
+				continue;
+			}
+
+			// A texture whose pixels differ from the candidate keeps the candidate in the lookup table
+			if (content_texture == m_textures_by_content.end())
+			{
+				texture.content_key = content_key;
+				m_textures_by_content[content_key] = *it;
+			}
+		}
+
+		// Uploading fewer mip levels is better than not showing the texture at all
+		if (!CreatePendingTexture(device, texture, is_initial_upload))
+		{
+			if (is_initial_upload)
+			{
+				texture.state = TextureState::Failed;
+
+				auto content_texture = m_textures_by_content.find(texture.content_key);
+
+				if (content_texture != m_textures_by_content.end() && content_texture->second == *it)
+				{
+					m_textures_by_content.erase(content_texture);
+				}
+			}
+
+			texture.is_changing_residency = false;
+			it = m_decoding_textures.erase(it);
+			continue;
+		}
+
+		begin_batch();
+
+		auto staging_buffer = texture.pending_texture->CreateStagingBuffer(mip_chain, texture.requested_mip_level);
+		uploads.push_back(*it);
+
+		if (is_initial_upload)
+		{
+			texture.state = TextureState::Uploading;
+		}
+
+		batch.textures.push_back(*it);
+		batch.staging_buffers.push_back(staging_buffer);
+		batch_size += staging_buffer.info.size;
+
+		it = m_decoding_textures.erase(it);
+	}
+
+	// Nothing to upload this frame
+	if (batch.textures.empty())
+	{
+		return;
+	}
+
+	RecordUploads(batch, copies, uploads);
+	batch.command_buffer.StopRecording();
+
+	VkFenceCreateInfo fence_create_info = {};
+	fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	if (vkCreateFence(device.GetLogicalDeviceNative(), &fence_create_info, nullptr, &batch.fence) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create a texture upload fence.");
+	}
+
+	VkSubmitInfo submit_info = {};
+	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers = &batch.command_buffer.GetNative();
+
+	// Do not wait for the upload to finish, completion is polled in "FinishUploads"
+	if (vkQueueSubmit(device.GetQueueNativeOfType(VulkanQueueType::Graphics), 1, &submit_info, batch.fence) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not submit the texture uploads.");
+	}
+
+	m_upload_batches.push_back(std::move(batch));
+}
+
+void TextureStreamer::RecordUploads(
+	const UploadBatch& batch,
+	const std::vector<std::pair<TextureHandle, std::uint32_t>>& copies,
+	const std::vector<TextureHandle>& uploads) const noexcept(false)
+{
+	const auto& command_buffer = batch.command_buffer.GetNative();
+
+	VulkanImageStateTracker image_states;
+	VulkanBarrierBatcher barriers(image_states);
+
+	// Every texture in the batch is transitioned by a single barrier before the copies, and another one after them
+	for (const auto& [handle, source_mip_level] : copies)
+	{
+		const auto& texture = m_textures[handle];
+
+		texture.texture->Track(image_states, image_state::fragment_shader_read);
+		texture.pending_texture->Track(image_states, image_state::undefined);
+
+		texture.texture->Transition(barriers, image_state::transfer_source, source_mip_level, texture.pending_texture->GetMipLevelCount());
+		texture.pending_texture->Transition(barriers, image_state::transfer_destination);
+	}
+
+	for (auto handle : uploads)
+	{
+		const auto& texture = m_textures[handle];
+
+		texture.pending_texture->Track(image_states, image_state::undefined);
+		texture.pending_texture->Transition(barriers, image_state::transfer_destination);
+	}
+
+	barriers.Flush(command_buffer);
+
+	for (const auto& [handle, source_mip_level] : copies)
+	{
+		const auto& texture = m_textures[handle];
+		texture.pending_texture->RecordCopyFromTexture(command_buffer, *texture.texture, source_mip_level);
+
+		// The current texture is still sampled from until the pending texture replaces it
+		texture.texture->Transition(barriers, image_state::fragment_shader_read, source_mip_level, texture.pending_texture->GetMipLevelCount());
+		texture.pending_texture->Transition(barriers, image_state::fragment_shader_read);
+	}
+
+	for (std::size_t index = 0; index < uploads.size(); ++index)
+	{
+		const auto& texture = m_textures[uploads[index]];
+		texture.pending_texture->RecordCopyFromBuffer(command_buffer, batch.staging_buffers[index]);
+		texture.pending_texture->Transition(barriers, image_state::fragment_shader_read);
+	}
+
+	barriers.Flush(command_buffer);
+}
+
+bool TextureStreamer::CreatePendingTexture(
+	const VulkanDevice& device,
+	StreamedTexture& texture,
+	bool allow_fewer_mip_levels) noexcept(false)
+{
+	while (true)
+	{
+		// Only the dimensions are needed to create the image
+		TexturePixelData first_mip_level = {};
+		first_mip_level.width = (std::max)(texture.width >> texture.requested_mip_level, 1u);
+		first_mip_level.height = (std::max)(texture.height >> texture.requested_mip_level, 1u);
+		first_mip_level.channel_count = texture.channel_count;
+
+		auto pending_texture = std::make_unique<VulkanTexture>();
+
+		try
+		{
+			pending_texture->Create(first_mip_level, texture.format, device, texture.mip_level_count - texture.requested_mip_level);
+			texture.pending_texture = std::move(pending_texture);
+			return true;
+		}
+		catch (GPUOutOfMemoryError& error)
+		{
+			if (!allow_fewer_mip_levels || texture.requested_mip_level + 1 >= texture.mip_level_count)
+			{
+				spdlog::warn("Could not create texture \"{}\": {}", texture.path, error.what());
+				return false;
+			}
+
+			spdlog::warn("Device ran out of memory while creating texture \"{}\", skipping mip level {}.", texture.path, texture.requested_mip_level);
+			++texture.requested_mip_level;
+		}
+	}
+}
+
+void TextureStreamer::FinishUploads(const VulkanDevice& device, bool wait_for_completion) noexcept(false)
+{
+	for (auto it = m_upload_batches.begin(); it != m_upload_batches.end();)
+	{
+		if (wait_for_completion)
+		{
+			vkWaitForFences(device.GetLogicalDeviceNative(), 1, &it->fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+		}
+		else if (vkGetFenceStatus(device.GetLogicalDeviceNative(), it->fence) != VK_SUCCESS)
+		{
+			// Upload is still being executed
+			++it;
+			continue;
+		}
+
+		for (auto handle : it->textures)
+		{
+			auto& texture = m_textures[handle];
+
+			// Frames in flight may still sample from the texture that is being replaced
+			if (texture.texture)
+			{
+				m_resident_size -= texture.texture->GetImage().info.size;
+
+				RetiredTexture retired_texture = {};
+				retired_texture.texture = std::move(texture.texture);
+				retired_texture.remaining_updates = global_settings::maximum_in_flight_frame_count + 1;
+				m_retired_textures.push_back(std::move(retired_texture));
+			}
+
+			texture.texture = std::move(texture.pending_texture);
+			texture.resident_mip_level = texture.requested_mip_level;
+			texture.is_changing_residency = false;
+			texture.state = TextureState::Resident;
+
+			m_resident_size += texture.texture->GetImage().info.size;
+
+			// Released while the upload was in flight
+			if (texture.is_released)
+			{
+				RetireReleasedTexture(texture);
+			}
+		}
+
+		++m_residency_generation;
+
+		DestroyUploadBatch(device, *it);
+		it = m_upload_batches.erase(it);
+	}
+}
+
+void TextureStreamer::DestroyRetiredTextures(const VulkanDevice& device, bool destroy_all) noexcept(true)
+{
+	for (auto it = m_retired_textures.begin(); it != m_retired_textures.end();)
+	{
+		if (!destroy_all && it->remaining_updates > 0)
+		{
+			--it->remaining_updates;
+			++it;
+			continue;
+		}
+
+		it->texture->Destroy(device);
+		it = m_retired_textures.erase(it);
+	}
+}
+
+void TextureStreamer::DestroyUploadBatch(const VulkanDevice& device, const UploadBatch& batch) const noexcept(true)
+{
+	for (const auto& staging_buffer : batch.staging_buffers)
+	{
+		MemoryManager::GetInstance().Free(staging_buffer);
+	}
+
+	vkDestroyFence(device.GetLogicalDeviceNative(), batch.fence, nullptr);
+	batch.command_buffer.Destroy(device, m_upload_command_pool);
+}
@@ -0,0 +1,353 @@
+#ifndef TEXTURE_STREAMER_HPP
+#define TEXTURE_STREAMER_HPP
+
+// Application
+#include "renderer/memory_manager/memory_manager.hpp"
+#include "renderer/vulkan_wrapper/vulkan_command_buffer.hpp"
+#include "renderer/vulkan_wrapper/vulkan_command_pool.hpp"
+#include "renderer/vulkan_wrapper/vulkan_immediate_submit_context.hpp"
+#include "renderer/vulkan_wrapper/vulkan_texture.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vkc
+{
+	namespace core
+	{
+		class ThreadPool;
+	}
+
+	namespace vk_wrapper
+	{
+		class VulkanDevice;
+	}
+
+	namespace texture
+	{
+		/** Handle to a streamed texture, stays valid until the texture streamer is destroyed */
+		using TextureHandle = std::uint32_t;
+
+		/** Life cycle of a streamed texture */
+		enum class TextureState
+		{
+			Decoding,	// Image file is being decoded on a worker thread
+			Uploading,	// Upload commands have been submitted, waiting for the GPU to finish
+			Resident,	// Texture is ready to be sampled from
+			Failed,		// Image file could not be loaded, the placeholder texture is used instead
+			Released	// Every user released the texture, the placeholder texture is used instead
+		};
+
+		/** Snapshot of the mip levels of a streamed texture that are in device memory */
+		struct TextureResidency
+		{
+			TextureState state = TextureState::Decoding;
+
+			/** Texture that owns the image, differs from the handle itself when the image is shared */
+			TextureHandle owner = 0;
+
+			/** Size of the most detailed mip level in the image file */
+			std::uint32_t width = 0;
+			std::uint32_t height = 0;
+			std::uint32_t bytes_per_texel = 0;
+
+			/** Number of mip levels in the full mip chain */
+			std::uint32_t mip_level_count = 0;
+
+			/** Most detailed mip level that is resident, zero means the full mip chain is resident */
+			std::uint32_t resident_mip_level = 0;
+
+			/** Device memory used by the resident mip levels */
+			VkDeviceSize resident_size = 0;
+
+			/** A mip level eviction or stream-in has been started but did not finish yet */
+			bool is_changing_residency = false;
+		};
+
+		/** Loads textures asynchronously without stalling the render thread */
+		/**
+		 * Requesting a texture returns a handle immediately. Until the texture
+		 * is resident, the handle resolves to a placeholder texture. Image
+		 * files are decoded on the worker threads of a thread pool, uploads
+		 * are recorded into a command buffer owned by the streamer and
+		 * submitted without waiting for the queue to become idle. Completion
+		 * is detected by polling a fence once per frame.
+		 *
+		 * Textures are uploaded with a full mip chain. The detailed mip levels
+		 * can be dropped and streamed back in later on using
+		 * "SetResidentMipLevel", the policy that decides which mip levels
+		 * should be resident lives in the texture residency manager. When the
+		 * device runs out of memory during an upload, fewer mip levels are
+		 * uploaded instead of failing.
+		 *
+		 * Textures are reference counted and deduplicated. Requesting a path
+		 * that has been requested before returns the existing handle, which
+		 * also shares the decode work of concurrent requests. When a decoded
+		 * image has the same pixels as a texture that has been uploaded
+		 * already, the new handle shares the image of that texture instead of
+		 * uploading it again. A matching content hash is verified by
+		 * comparing the pixels on a worker thread before the image is shared.
+		 *
+		 * All functions except "RequestTexture" and "ReleaseTexture" have to
+		 * be called on the render thread. "RequestTexture" and
+		 * "ReleaseTexture" may be called from any thread.
+		 */
+		class TextureStreamer
+		{
+		public:
+			TextureStreamer() noexcept(true);
+			~TextureStreamer() noexcept(true);
+
+			/** Create the placeholder texture and the upload command pool */
+			void Create(
+				const vk_wrapper::VulkanDevice& device,
+				core::ThreadPool& thread_pool,
+				vk_wrapper::VulkanImmediateSubmitContext& immediate_submit) noexcept(false);
+
+			/** Wait for outstanding work and destroy all streamed textures */
+			/**
+			 * The device should be idle when this function is called.
+			 */
+			void Destroy(const vk_wrapper::VulkanDevice& device) noexcept(true);
+
+			/** Start loading a texture, returns immediately */
+			/**
+			 * Image files are always decoded into four 8-bit channels, so the
+			 * format should be a four-channel format with 8 bits per channel.
+			 *
+			 * Every request adds a reference to the texture, which has to be
+			 * removed again using "ReleaseTexture".
+			 */
+			TextureHandle RequestTexture(const std::string& path, VkFormat format) noexcept(false);
+
+			/** Remove a reference from a texture, the texture is destroyed once no references are left */
+			void ReleaseTexture(TextureHandle handle) noexcept(false);
+
+			/** Advance all streaming operations, call this once per frame */
+			/**
+			 * Finished uploads become resident, and textures that finished
+			 * decoding are uploaded (up to the per-frame upload budget). Textures
+			 * replaced by a texture with a different number of mip levels are
+			 * destroyed once no frame in flight can use them anymore.
+			 */
+			void Update(const vk_wrapper::VulkanDevice& device) noexcept(false);
+
+			/** Get the current state of a texture */
+			TextureState GetState(TextureHandle handle) const noexcept(false);
+
+			/** Get the number of textures that have been requested so far, handles range from zero to this value */
+			std::uint32_t GetTextureCount() const noexcept(true);
+
+			/** Get the resident mip levels of a texture */
+			TextureResidency GetResidency(TextureHandle handle) const noexcept(false);
+
+			/** Get the device memory used by all resident textures */
+			VkDeviceSize GetResidentSize() const noexcept(true);
+
+			/** Make "mip_level" the most detailed resident mip level of a texture */
+			/**
+			 * Evicting mip levels copies the remaining levels into a smaller
+			 * image on the GPU, streaming mip levels in decodes the image file
+			 * again on a worker thread. In both cases the old image is sampled
+			 * from until the new image is ready.
+			 *
+			 * Returns false when the texture is not resident yet or when a
+			 * residency change of the texture is still in progress.
+			 */
+			bool SetResidentMipLevel(TextureHandle handle, std::uint32_t mip_level) noexcept(false);
+
+			/** Get the image view of a texture, or the placeholder image view when it is not resident yet */
+			const VkImageView& GetImageView(TextureHandle handle) const noexcept(false);
+
+			/** Counter that is incremented whenever a texture becomes resident or its image view changes */
+			/**
+			 * Users that store image views (e.g. in descriptor sets) can compare
+			 * this value against the value they saw last time to find out when
+			 * they have to refresh their image views.
+			 */
+			std::uint64_t GetResidencyGeneration() const noexcept(true);
+
+		private:
+			/** Result of decoding an image file on a worker thread */
+			struct DecodedTexture
+			{
+				std::vector<vk_wrapper::TexturePixelData> mip_chain;
+
+				/** Hash of the pixels of the most detailed mip level */
+				std::uint64_t content_hash = 0;
+
+				/** Whether the pixels are identical to those of the content candidate, only set by "VerifyContent" */
+				bool matches_content_candidate = false;
+			};
+
+			/** Bookkeeping for a single streamed texture */
+			struct StreamedTexture
+			{
+				std::string path;
+				VkFormat format = VK_FORMAT_UNDEFINED;
+				TextureState state = TextureState::Decoding;
+
+				/** Keys of this texture in the path and content lookup tables */
+				std::string path_key;
+				std::uint64_t content_key = 0;
+
+				/** Texture that owns the image, equal to the handle of this texture unless the image is shared */
+				TextureHandle owner = 0;
+
+				/** Texture with the same content key, its pixels are compared with those of this texture before its image is shared */
+				TextureHandle content_candidate = 0;
+				bool is_verifying_content = false;
+
+				/** Number of requests plus the number of textures that share the image of this texture */
+				std::uint32_t reference_count = 0;
+
+				/** Released while a decode or upload was in progress, the texture is retired once it completes */
+				bool is_released = false;
+
+				std::uint32_t width = 0;
+				std::uint32_t height = 0;
+				std::uint32_t channel_count = 0;
+				std::uint32_t mip_level_count = 0;
+
+				/** Index in the full mip chain of the first mip level of "texture" */
+				std::uint32_t resident_mip_level = 0;
+
+				/** Index in the full mip chain of the first mip level of "pending_texture" */
+				std::uint32_t requested_mip_level = 0;
+
+				bool is_changing_residency = false;
+
+				std::future<DecodedTexture> decoded_texture;
+
+				/** Texture that is sampled from */
+				std::unique_ptr<vk_wrapper::VulkanTexture> texture;
+
+				/** Texture that is being uploaded, replaces "texture" once the upload completes */
+				std::unique_ptr<vk_wrapper::VulkanTexture> pending_texture;
+			};
+
+			/** Texture that has been replaced, but may still be used by frames in flight */
+			struct RetiredTexture
+			{
+				std::unique_ptr<vk_wrapper::VulkanTexture> texture;
+				std::uint32_t remaining_updates = 0;
+			};
+
+			/** Uploads that were submitted together and complete together */
+			struct UploadBatch
+			{
+				vk_wrapper::VulkanCommandBuffer command_buffer;
+				VkFence fence = VK_NULL_HANDLE;
+
+				std::vector<TextureHandle> textures;
+				std::vector<memory::VulkanBuffer> staging_buffers;
+			};
+
+			/** Decode an image file and generate its mip chain (thread-safe) */
+			static DecodedTexture DecodeTexture(const std::string& path) noexcept(false);
+
+			/** Decode the image file of the content candidate and compare its pixels with those of a decoded texture (thread-safe) */
+			/**
+			 * Equal content keys only mean the hashes, dimensions, and formats
+			 * match, an image is shared only once the pixels are identical.
+			 */
+			static DecodedTexture VerifyContent(const std::string& candidate_path, DecodedTexture decoded_texture) noexcept(false);
+
+			/** Get the texture that owns the image of a texture */
+			const StreamedTexture& GetOwner(TextureHandle handle) const noexcept(false);
+
+			/** Remove a reference from a texture, "m_textures_mutex" has to be locked */
+			void RemoveReference(TextureHandle handle) noexcept(false);
+
+			/** Stop sampling from a released texture and destroy its image once frames in flight are done with it */
+			void RetireReleasedTexture(StreamedTexture& texture) noexcept(false);
+
+			/** Create the 1x1 texture that is used while textures are being streamed in */
+			void CreatePlaceholderTexture(
+				const vk_wrapper::VulkanDevice& device,
+				vk_wrapper::VulkanImmediateSubmitContext& immediate_submit) noexcept(false);
+
+			/** Upload textures that finished decoding and record the copies of textures that drop mip levels */
+			void StartUploads(const vk_wrapper::VulkanDevice& device) noexcept(false);
+
+			/** Record the copies and uploads of a batch, the layout transitions of all textures are batched together */
+			/**
+			 * "copies" holds the textures that drop mip levels and the first mip
+			 * level of their current texture to keep, every upload is copied from
+			 * the staging buffer at the same index in the batch.
+			 */
+			void RecordUploads(
+				const UploadBatch& batch,
+				const std::vector<std::pair<TextureHandle, std::uint32_t>>& copies,
+				const std::vector<TextureHandle>& uploads) const noexcept(false);
+
+			/** Create the pending texture of a streamed texture, starting at the requested mip level */
+			/**
+			 * Returns false when the device ran out of memory. When
+			 * "allow_fewer_mip_levels" is set, less detailed mip levels are
+			 * tried before giving up, and the requested mip level is updated.
+			 */
+			bool CreatePendingTexture(
+				const vk_wrapper::VulkanDevice& device,
+				StreamedTexture& texture,
+				bool allow_fewer_mip_levels) noexcept(false);
+
+			/** Destroy textures that cannot be used by frames in flight anymore */
+			void DestroyRetiredTextures(const vk_wrapper::VulkanDevice& device, bool destroy_all) noexcept(true);
+
+			/** Mark textures of completed upload batches as resident */
+			void FinishUploads(const vk_wrapper::VulkanDevice& device, bool wait_for_completion) noexcept(false);
+
+			/** Release the Vulkan objects and staging buffers of an upload batch */
+			void DestroyUploadBatch(const vk_wrapper::VulkanDevice& device, const UploadBatch& batch) const noexcept(true);
+
+		private:
+			core::ThreadPool* m_thread_pool;
+
+			vk_wrapper::VulkanCommandPool m_upload_command_pool;
+			vk_wrapper::VulkanTexture m_placeholder_texture;
+
+			/** Deque to keep references to textures stable while new textures are requested */
+			std::deque<StreamedTexture> m_textures;
+
+			/** Textures by normalized path and format, used to return existing handles */
+			std::unordered_map<std::string, TextureHandle> m_textures_by_path;
+
+			/** Textures by pixel content and format, used to share images between identical textures */
+			std::unordered_map<std::uint64_t, TextureHandle> m_textures_by_content;
+
+			/** Textures that are still being decoded on a worker thread */
+			std::vector<TextureHandle> m_decoding_textures;
+
+			/** Textures that drop mip levels during the next update */
+			std::vector<TextureHandle> m_evicting_textures;
+
+			/** Replaced textures that are waiting to be destroyed */
+			std::vector<RetiredTexture> m_retired_textures;
+
+			/** Submitted uploads that have not been completed yet */
+			std::vector<UploadBatch> m_upload_batches;
+
+			/** Protects the texture containers, textures can be requested from any thread */
+			mutable std::mutex m_textures_mutex;
+
+			std::uint64_t m_residency_generation;
+
+			/** Device memory used by the images of all sampled textures */
+			VkDeviceSize m_resident_size;
+		};
+	}
+}
+
+#endif // TEXTURE_STREAMER_HPP
@@ -50,3 +50,43 @@ std::vector<VkVertexInputAttributeDescription> vkc::VertexPCT::GetAttributeDescr
 
 	return { position_attrib, color_attrib, texture_coordinate_attrib };
 }
+
+InstanceData::InstanceData() noexcept(true)
+	: model_matrix(1.0f)
+{}
+
+InstanceData::InstanceData(const glm::mat4& model_matrix)
+	: model_matrix(model_matrix)
+{}
+
+InstanceData::~InstanceData() noexcept(true)
+{}
+
+std::vector<VkVertexInputBindingDescription> vkc::InstanceData::GetBindingDescriptions() noexcept(true)
+{
+	VkVertexInputBindingDescription binding_desc = {};
+	binding_desc.binding = 1;
+	binding_desc.stride = sizeof(InstanceData);
+	binding_desc.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+	return { binding_desc };
+}
+
+std::vector<VkVertexInputAttributeDescription> vkc::InstanceData::GetAttributeDescriptions() noexcept(true)
+{
+	// A matrix does not fit in a single attribute, every column gets its own location
+	std::vector<VkVertexInputAttributeDescription> attribute_descs;
+
+	for (std::uint32_t column = 0; column < 4; ++column)
+	{
+		VkVertexInputAttributeDescription model_matrix_column_attrib = {};
+		model_matrix_column_attrib.binding = 1;
+		model_matrix_column_attrib.location = 3 + column;
+		model_matrix_column_attrib.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		model_matrix_column_attrib.offset = static_cast<std::uint32_t>(offsetof(InstanceData, model_matrix) + sizeof(glm::vec4) * column);
+
+		attribute_descs.push_back(model_matrix_column_attrib);
+	}
+
+	return attribute_descs;
+}
@@ -5,6 +5,7 @@
 #include <vulkan/vulkan.h>
 
 // GLM
+#include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
@@ -32,6 +33,24 @@ namespace vkc
 		glm::vec3 color;
 		glm::vec2 texture_coordinate;
 	};
+
+	/** Per-instance data, streamed from a second vertex buffer that advances once per instance */
+	class InstanceData
+	{
+	public:
+		InstanceData() noexcept(true);
+		InstanceData(const glm::mat4& model_matrix);
+		~InstanceData() noexcept(true);
+
+		/** Get a list of input binding description structures needed to work with this instance data (binding 1) */
+		static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions() noexcept(true);
+
+		/** Get a list of input attribute description structures needed to work with this instance data (locations 3 to 6) */
+		static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions() noexcept(true);
+
+	public:
+		glm::mat4 model_matrix;
+	};
 }
 
 #endif // VERTEX_HPP
@@ -0,0 +1,126 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_async_compute.hpp"
+#include "vulkan_device.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <limits>
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+VulkanAsyncCompute::VulkanAsyncCompute() noexcept(true)
+{}
+
+VulkanAsyncCompute::~VulkanAsyncCompute() noexcept(true)
+{}
+
+void VulkanAsyncCompute::Create(const VulkanDevice& device, std::uint32_t frame_count) noexcept(false)
+{
+	m_command_pool.Create(device, CommandPoolType::Compute, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+	m_command_buffers.Create(device, m_command_pool, frame_count);
+
+	VkSemaphoreCreateInfo semaphore_create_info = {};
+	semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	// Signaled on creation, the first frame does not have any previous work to wait on
+	VkFenceCreateInfo fence_create_info = {};
+	fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	fence_create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+	m_fences.resize(frame_count, VK_NULL_HANDLE);
+	m_finished_semaphores.resize(frame_count, VK_NULL_HANDLE);
+
+	for (std::uint32_t frame_index = 0; frame_index < frame_count; ++frame_index)
+	{
+		if (vkCreateSemaphore(device.GetLogicalDeviceNative(), &semaphore_create_info, nullptr, &m_finished_semaphores[frame_index]) != VK_SUCCESS ||
+			vkCreateFence(device.GetLogicalDeviceNative(), &fence_create_info, nullptr, &m_fences[frame_index]) != VK_SUCCESS)
+		{
+			throw CriticalVulkanError("Could not create the synchronization objects of the async compute queue.");
+		}
+	}
+
+	const auto& queue_family_indices = device.GetQueueFamilyIndices();
+	const auto graphics_family = queue_family_indices.graphics_family_index->first;
+	const auto compute_family = queue_family_indices.compute_family_index->first;
+
+	m_queue_family_indices.clear();
+
+	if (graphics_family != compute_family)
+	{
+		m_queue_family_indices = { graphics_family, compute_family };
+	}
+
+	spdlog::info(
+		"Async compute runs on queue family {} ({}).",
+		compute_family,
+		UsesDedicatedQueueFamily() ? "dedicated compute family" : "shared with graphics");
+}
+
+void VulkanAsyncCompute::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	for (auto semaphore : m_finished_semaphores)
+	{
+		vkDestroySemaphore(device.GetLogicalDeviceNative(), semaphore, nullptr);
+	}
+
+	for (auto fence : m_fences)
+	{
+		vkDestroyFence(device.GetLogicalDeviceNative(), fence, nullptr);
+	}
+
+	m_finished_semaphores.clear();
+	m_fences.clear();
+
+	m_command_buffers.Destroy(device, m_command_pool);
+	m_command_pool.Destroy(device);
+}
+
+const VkCommandBuffer& VulkanAsyncCompute::BeginFrame(const VulkanDevice& device, std::uint32_t frame_index) noexcept(false)
+{
+	// The command buffer of the frame may still be executing
+	vkWaitForFences(device.GetLogicalDeviceNative(), 1, &m_fences[frame_index], VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+
+	m_command_buffers.BeginRecording(frame_index, CommandBufferUsage::OneTimeSubmit);
+
+	return m_command_buffers.GetNative(frame_index);
+}
+
+VkSemaphore VulkanAsyncCompute::Submit(const VulkanDevice& device, std::uint32_t frame_index) noexcept(false)
+{
+	m_command_buffers.StopRecording(frame_index);
+
+	VkSubmitInfo submit_info = {};
+	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers = &m_command_buffers.GetNative(frame_index);
+	submit_info.signalSemaphoreCount = 1;
+	submit_info.pSignalSemaphores = &m_finished_semaphores[frame_index];
+
+	vkResetFences(device.GetLogicalDeviceNative(), 1, &m_fences[frame_index]);
+
+	if (vkQueueSubmit(device.GetQueueNativeOfType(VulkanQueueType::Compute), 1, &submit_info, m_fences[frame_index]) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not submit work to the compute queue.");
+	}
+
+	return m_finished_semaphores[frame_index];
+}
+
+bool VulkanAsyncCompute::UsesDedicatedQueueFamily() const noexcept(true)
+{
+	return !m_queue_family_indices.empty();
+}
+
+VkSharingMode VulkanAsyncCompute::GetSharingMode() const noexcept(true)
+{
+	return UsesDedicatedQueueFamily() ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+}
+
+const std::vector<std::uint32_t>& VulkanAsyncCompute::GetQueueFamilyIndices() const noexcept(true)
+{
+	return m_queue_family_indices;
+}
@@ -0,0 +1,74 @@
+#ifndef VULKAN_ASYNC_COMPUTE_HPP
+#define VULKAN_ASYNC_COMPUTE_HPP
+
+// Application
+#include "vulkan_command_buffer.hpp"
+#include "vulkan_command_pool.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	class VulkanDevice;
+
+	/** Records and submits work on the compute queue that overlaps with the graphics work of a frame */
+	/**
+	 * Every in-flight frame has its own command buffer, fence, and semaphore.
+	 * The semaphore returned by "Submit" is signaled once the compute work of
+	 * the frame finishes, the graphics submission of the same frame has to
+	 * wait on it in the stage that consumes the results. The semaphore makes
+	 * all compute writes visible, no additional barriers are needed.
+	 *
+	 * Resources that are written on the compute queue and read on the
+	 * graphics queue have to be created with "GetSharingMode" and
+	 * "GetQueueFamilyIndices", so no queue family ownership transfers are
+	 * needed when the compute queue belongs to a different family.
+	 */
+	class VulkanAsyncCompute
+	{
+	public:
+		VulkanAsyncCompute() noexcept(true);
+		~VulkanAsyncCompute() noexcept(true);
+
+		/** Create the command buffers and synchronization objects of every in-flight frame */
+		void Create(const VulkanDevice& device, std::uint32_t frame_count) noexcept(false);
+
+		/** Destroy all Vulkan objects, the compute queue needs to be idle */
+		void Destroy(const VulkanDevice& device) noexcept(true);
+
+		/** Wait until the previous compute work of the frame is done, and start recording its command buffer */
+		const VkCommandBuffer& BeginFrame(const VulkanDevice& device, std::uint32_t frame_index) noexcept(false);
+
+		/** Submit the compute work of the frame, returns the semaphore that the graphics submission waits on */
+		/**
+		 * Only submit when the graphics work of the frame is submitted as well,
+		 * a signaled semaphore that nobody waits on cannot be signaled again.
+		 */
+		VkSemaphore Submit(const VulkanDevice& device, std::uint32_t frame_index) noexcept(false);
+
+		/** Check whether compute work runs on a different queue family than graphics work */
+		bool UsesDedicatedQueueFamily() const noexcept(true);
+
+		/** Sharing mode for resources that are used by both the compute and the graphics queue */
+		VkSharingMode GetSharingMode() const noexcept(true);
+
+		/** Queue families that share resources, empty when both queues belong to the same family */
+		const std::vector<std::uint32_t>& GetQueueFamilyIndices() const noexcept(true);
+
+	private:
+		VulkanCommandPool m_command_pool;
+		VulkanCommandBuffer m_command_buffers;
+
+		std::vector<VkFence> m_fences;
+		std::vector<VkSemaphore> m_finished_semaphores;
+
+		std::vector<std::uint32_t> m_queue_family_indices;
+	};
+}
+
+#endif // VULKAN_ASYNC_COMPUTE_HPP
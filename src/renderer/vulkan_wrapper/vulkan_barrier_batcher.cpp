@@ -0,0 +1,225 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_barrier_batcher.hpp"
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+namespace
+{
+	bool IsSameState(const ImageSubresourceState& state, const ImageSubresourceState& other_state)
+	{
+		return
+			state.layout == other_state.layout &&
+			state.stages == other_state.stages &&
+			state.access == other_state.access &&
+			state.write_stages == other_state.write_stages &&
+			state.write_access == other_state.write_access &&
+			state.visible_stages == other_state.visible_stages &&
+			state.visible_access == other_state.visible_access;
+	}
+
+	/** Check whether a barrier transitions the same mip levels of the array layer right after the one of the previous barrier */
+	bool IsNextArrayLayer(const VkImageMemoryBarrier& previous_barrier, const VkImageMemoryBarrier& barrier)
+	{
+		const auto& previous_range = previous_barrier.subresourceRange;
+		const auto& range = barrier.subresourceRange;
+
+		return
+			previous_barrier.image == barrier.image &&
+			previous_barrier.oldLayout == barrier.oldLayout &&
+			previous_barrier.newLayout == barrier.newLayout &&
+			previous_barrier.srcAccessMask == barrier.srcAccessMask &&
+			previous_barrier.dstAccessMask == barrier.dstAccessMask &&
+			previous_range.baseMipLevel == range.baseMipLevel &&
+			previous_range.levelCount == range.levelCount &&
+			previous_range.baseArrayLayer + previous_range.layerCount == range.baseArrayLayer;
+	}
+}
+
+VulkanBarrierBatcher::VulkanBarrierBatcher(VulkanImageStateTracker& tracker) noexcept(true)
+	: m_tracker(tracker)
+	, m_source_stages(0)
+	, m_destination_stages(0)
+{}
+
+VulkanBarrierBatcher::~VulkanBarrierBatcher() noexcept(true)
+{}
+
+void VulkanBarrierBatcher::Transition(
+	VkImage image,
+	const ImageSubresourceState& new_state,
+	std::uint32_t base_mip_level,
+	std::uint32_t mip_level_count,
+	std::uint32_t base_array_layer,
+	std::uint32_t array_layer_count) noexcept(false)
+{
+	const auto image_mip_level_count = m_tracker.GetMipLevelCount(image);
+	const auto image_array_layer_count = m_tracker.GetArrayLayerCount(image);
+
+	if (mip_level_count == VK_REMAINING_MIP_LEVELS)
+	{
+		mip_level_count = (base_mip_level < image_mip_level_count) ? image_mip_level_count - base_mip_level : 0;
+	}
+
+	if (array_layer_count == VK_REMAINING_ARRAY_LAYERS)
+	{
+		array_layer_count = (base_array_layer < image_array_layer_count) ? image_array_layer_count - base_array_layer : 0;
+	}
+
+	if (mip_level_count == 0 || array_layer_count == 0 ||
+		base_mip_level + mip_level_count > image_mip_level_count ||
+		base_array_layer + array_layer_count > image_array_layer_count)
+	{
+		throw CriticalVulkanError("Image subresource range is out of range.");
+	}
+
+	VkImageSubresourceRange range = {};
+	range.aspectMask = m_tracker.GetAspectMask(image);
+	range.baseMipLevel = base_mip_level;
+	range.levelCount = mip_level_count;
+	range.baseArrayLayer = base_array_layer;
+	range.layerCount = array_layer_count;
+
+	// Barriers in the same batch execute at the same time, the second transition would not see the first one
+	if (IsPending(image, range))
+	{
+		throw CriticalVulkanError("Image subresource is already being transitioned, flush the barriers first.");
+	}
+
+	const auto end_mip_level = base_mip_level + mip_level_count;
+
+	for (auto array_layer = base_array_layer; array_layer < base_array_layer + array_layer_count; ++array_layer)
+	{
+		auto mip_level = base_mip_level;
+
+		while (mip_level < end_mip_level)
+		{
+			const auto old_state = m_tracker.GetState(image, mip_level, array_layer);
+
+			if (!NeedsImageBarrier(old_state, new_state))
+			{
+				auto merged_state = old_state;
+				MergeImageSubresourceStates(merged_state, new_state);
+
+				m_tracker.SetState(image, mip_level, array_layer, merged_state);
+				++mip_level;
+				continue;
+			}
+
+			// Mip levels that share the same state are transitioned by the same barrier
+			auto run_end_mip_level = mip_level + 1;
+
+			while (run_end_mip_level < end_mip_level && IsSameState(m_tracker.GetState(image, run_end_mip_level, array_layer), old_state))
+			{
+				++run_end_mip_level;
+			}
+
+			VkImageMemoryBarrier barrier = {};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.oldLayout = old_state.layout;
+			barrier.newLayout = new_state.layout;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = image;
+			barrier.subresourceRange.aspectMask = range.aspectMask;
+			barrier.subresourceRange.baseMipLevel = mip_level;
+			barrier.subresourceRange.levelCount = run_end_mip_level - mip_level;
+			barrier.subresourceRange.baseArrayLayer = array_layer;
+			barrier.subresourceRange.layerCount = 1;
+
+			barrier.srcAccessMask = GetBarrierSourceAccessMask(old_state);
+			barrier.dstAccessMask = new_state.access;
+
+			// The same mip levels of the previous array layer are transitioned in the same way
+			if (!m_image_barriers.empty() && IsNextArrayLayer(m_image_barriers.back(), barrier))
+			{
+				++m_image_barriers.back().subresourceRange.layerCount;
+			}
+			else
+			{
+				m_image_barriers.push_back(barrier);
+			}
+
+			m_source_stages |= GetBarrierSourceStageMask(old_state);
+			m_destination_stages |= new_state.stages;
+
+			const auto state_after_barrier = GetStateAfterImageBarrier(old_state, new_state);
+
+			for (; mip_level < run_end_mip_level; ++mip_level)
+			{
+				m_tracker.SetState(image, mip_level, array_layer, state_after_barrier);
+			}
+		}
+	}
+}
+
+void VulkanBarrierBatcher::Flush(const VkCommandBuffer& command_buffer) noexcept(true)
+{
+	if (m_image_barriers.empty())
+	{
+		return;
+	}
+
+	// Stage masks must not be zero
+	VkPipelineStageFlags source_stages = (m_source_stages != 0) ? m_source_stages : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	VkPipelineStageFlags destination_stages = (m_destination_stages != 0) ? m_destination_stages : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+	vkCmdPipelineBarrier(
+		command_buffer,
+		source_stages,
+		destination_stages,
+		0,	// Flags
+		0,	// No memory barriers
+		nullptr,
+		0,	// No buffer memory barriers
+		nullptr,
+		static_cast<std::uint32_t>(m_image_barriers.size()),
+		m_image_barriers.data());
+
+	Reset();
+}
+
+void VulkanBarrierBatcher::Reset() noexcept(true)
+{
+	m_image_barriers.clear();
+	m_source_stages = 0;
+	m_destination_stages = 0;
+}
+
+bool VulkanBarrierBatcher::HasPendingBarriers() const noexcept(true)
+{
+	return !m_image_barriers.empty();
+}
+
+std::uint32_t VulkanBarrierBatcher::GetPendingBarrierCount() const noexcept(true)
+{
+	return static_cast<std::uint32_t>(m_image_barriers.size());
+}
+
+VulkanImageStateTracker& VulkanBarrierBatcher::GetTracker() const noexcept(true)
+{
+	return m_tracker;
+}
+
+bool VulkanBarrierBatcher::IsPending(VkImage image, const VkImageSubresourceRange& range) const noexcept(true)
+{
+	const auto overlaps = [](std::uint32_t base, std::uint32_t count, std::uint32_t other_base, std::uint32_t other_count)
+	{
+		return base < other_base + other_count && other_base < base + count;
+	};
+
+	for (const auto& barrier : m_image_barriers)
+	{
+		const auto& pending_range = barrier.subresourceRange;
+
+		if (barrier.image == image &&
+			overlaps(range.baseMipLevel, range.levelCount, pending_range.baseMipLevel, pending_range.levelCount) &&
+			overlaps(range.baseArrayLayer, range.layerCount, pending_range.baseArrayLayer, pending_range.layerCount))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,76 @@
+#ifndef VULKAN_BARRIER_BATCHER_HPP
+#define VULKAN_BARRIER_BATCHER_HPP
+
+// Application
+#include "vulkan_image_state_tracker.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	/** Accumulates image transitions and records all of them with a single "vkCmdPipelineBarrier" */
+	/**
+	 * The source layout, stages, and access of every barrier come from the
+	 * image state tracker, callers only specify the state an image needs to
+	 * be in next. The tracker is updated as soon as a transition is added.
+	 *
+	 * Adjacent subresources that share the same state are combined into a
+	 * single image barrier. Reads in the same layout that the last write
+	 * has already been made visible to do not need a barrier at all, the
+	 * tracker remembers every reader instead so that the next write waits
+	 * for all of them. A read by any other stage or access still gets a
+	 * barrier that waits for the last write.
+	 *
+	 * All barriers of a batch execute at the same time, a subresource cannot
+	 * be transitioned twice without flushing in between.
+	 */
+	class VulkanBarrierBatcher
+	{
+	public:
+		VulkanBarrierBatcher(VulkanImageStateTracker& tracker) noexcept(true);
+		~VulkanBarrierBatcher() noexcept(true);
+
+		/** Add the barriers that transition a range of subresources of a tracked image to a new state */
+		void Transition(
+			VkImage image,
+			const ImageSubresourceState& new_state,
+			std::uint32_t base_mip_level = 0,
+			std::uint32_t mip_level_count = VK_REMAINING_MIP_LEVELS,
+			std::uint32_t base_array_layer = 0,
+			std::uint32_t array_layer_count = VK_REMAINING_ARRAY_LAYERS) noexcept(false);
+
+		/** Record all pending barriers into a command buffer that is being recorded, nothing is recorded when no barriers are pending */
+		void Flush(const VkCommandBuffer& command_buffer) noexcept(true);
+
+		/** Drop all pending barriers without recording them, the tracked states are not restored */
+		void Reset() noexcept(true);
+
+		/** Check whether any barriers are waiting to be flushed */
+		bool HasPendingBarriers() const noexcept(true);
+
+		/** Get the number of image barriers waiting to be flushed */
+		std::uint32_t GetPendingBarrierCount() const noexcept(true);
+
+		/** Get the tracker that holds the image states */
+		VulkanImageStateTracker& GetTracker() const noexcept(true);
+
+	private:
+		/** Check whether a pending barrier already covers part of the subresource range */
+		bool IsPending(VkImage image, const VkImageSubresourceRange& range) const noexcept(true);
+
+	private:
+		VulkanImageStateTracker& m_tracker;
+
+		std::vector<VkImageMemoryBarrier> m_image_barriers;
+
+		VkPipelineStageFlags m_source_stages;
+		VkPipelineStageFlags m_destination_stages;
+	};
+}
+
+#endif // VULKAN_BARRIER_BATCHER_HPP
@@ -0,0 +1,271 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_bindless_texture_table.hpp"
+#include "vulkan_device.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <algorithm>
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+VulkanBindlessTextureTable::VulkanBindlessTextureTable() noexcept(true)
+	: m_layout(VK_NULL_HANDLE)
+	, m_pool(VK_NULL_HANDLE)
+	, m_capacity(0)
+{}
+
+VulkanBindlessTextureTable::~VulkanBindlessTextureTable() noexcept(true)
+{}
+
+void VulkanBindlessTextureTable::Create(
+	const VulkanDevice& device,
+	std::uint32_t maximum_texture_count,
+	std::uint32_t frame_count) noexcept(false)
+{
+	// Update-after-bind sets have their own (much higher) descriptor limits
+	VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptor_indexing_properties = {};
+	descriptor_indexing_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+	VkPhysicalDeviceProperties2 device_properties = {};
+	device_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	device_properties.pNext = &descriptor_indexing_properties;
+
+	vkGetPhysicalDeviceProperties2(device.GetPhysicalDeviceNative(), &device_properties);
+
+	m_capacity = std::min({
+		maximum_texture_count,
+		descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+		descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSamplers,
+		descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+	if (m_capacity < maximum_texture_count)
+	{
+		spdlog::warn("Bindless texture table is limited to {} texture(s) by the device.", m_capacity);
+	}
+
+	// Slots can be updated while the set is bound, and do not all need to be valid
+	VkDescriptorBindingFlagsEXT binding_flags =
+		VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+		VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_info = {};
+	binding_flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+	binding_flags_info.bindingCount = 1;
+	binding_flags_info.pBindingFlags = &binding_flags;
+
+	VkDescriptorSetLayoutBinding texture_binding = {};
+	texture_binding.binding = 0;
+	texture_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	texture_binding.descriptorCount = m_capacity;
+	texture_binding.stageFlags = VK_SHADER_STAGE_ALL;
+
+	VkDescriptorSetLayoutCreateInfo layout_info = {};
+	layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layout_info.pNext = &binding_flags_info;
+	layout_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+	layout_info.bindingCount = 1;
+	layout_info.pBindings = &texture_binding;
+
+	if (vkCreateDescriptorSetLayout(device.GetLogicalDeviceNative(), &layout_info, nullptr, &m_layout) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create the bindless texture descriptor set layout.");
+	}
+
+	VkDescriptorPoolSize pool_size = {};
+	pool_size.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	pool_size.descriptorCount = m_capacity * frame_count;
+
+	VkDescriptorPoolCreateInfo pool_info = {};
+	pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+	pool_info.maxSets = frame_count;
+	pool_info.poolSizeCount = 1;
+	pool_info.pPoolSizes = &pool_size;
+
+	if (vkCreateDescriptorPool(device.GetLogicalDeviceNative(), &pool_info, nullptr, &m_pool) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create the bindless texture descriptor pool.");
+	}
+
+	std::vector<VkDescriptorSetLayout> layouts(frame_count, m_layout);
+
+	VkDescriptorSetAllocateInfo alloc_info = {};
+	alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	alloc_info.descriptorPool = m_pool;
+	alloc_info.descriptorSetCount = frame_count;
+	alloc_info.pSetLayouts = layouts.data();
+
+	m_sets.resize(frame_count);
+
+	if (vkAllocateDescriptorSets(device.GetLogicalDeviceNative(), &alloc_info, m_sets.data()) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not allocate the bindless texture descriptor sets.");
+	}
+
+	m_dirty_slots.resize(frame_count);
+
+	spdlog::info("Created a bindless texture table with {} slot(s).", m_capacity);
+}
+
+void VulkanBindlessTextureTable::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_slots_mutex);
+
+	// Destroying the pool frees the sets as well
+	vkDestroyDescriptorPool(device.GetLogicalDeviceNative(), m_pool, nullptr);
+	vkDestroyDescriptorSetLayout(device.GetLogicalDeviceNative(), m_layout, nullptr);
+
+	m_pool = VK_NULL_HANDLE;
+	m_layout = VK_NULL_HANDLE;
+	m_sets.clear();
+	m_slots.clear();
+	m_free_slots.clear();
+	m_dirty_slots.clear();
+}
+
+std::uint32_t VulkanBindlessTextureTable::Register(VkImageView image_view, VkSampler sampler) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_slots_mutex);
+
+	std::uint32_t index = 0;
+
+	if (!m_free_slots.empty())
+	{
+		index = m_free_slots.back();
+		m_free_slots.pop_back();
+	}
+	else if (m_slots.size() < m_capacity)
+	{
+		index = static_cast<std::uint32_t>(m_slots.size());
+		m_slots.emplace_back();
+	}
+	else
+	{
+		throw CriticalVulkanError("Bindless texture table is full.");
+	}
+
+	m_slots[index].image_view = image_view;
+	m_slots[index].sampler = sampler;
+	MarkSlotDirty(index);
+
+	return index;
+}
+
+void VulkanBindlessTextureTable::Update(std::uint32_t index, VkImageView image_view, VkSampler sampler) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_slots_mutex);
+
+	if (index >= m_slots.size())
+	{
+		spdlog::warn("Tried to update bindless texture slot {}, which does not exist.", index);
+		return;
+	}
+
+	if (m_slots[index].image_view == image_view && m_slots[index].sampler == sampler)
+	{
+		return;
+	}
+
+	m_slots[index].image_view = image_view;
+	m_slots[index].sampler = sampler;
+	MarkSlotDirty(index);
+}
+
+void VulkanBindlessTextureTable::Unregister(std::uint32_t index) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_slots_mutex);
+
+	if (index >= m_slots.size() || m_slots[index].image_view == VK_NULL_HANDLE)
+	{
+		spdlog::warn("Tried to unregister bindless texture slot {}, which is not in use.", index);
+		return;
+	}
+
+	// The old descriptor stays in the sets, which is fine for a partially bound array nobody indexes into
+	m_slots[index] = {};
+	m_free_slots.push_back(index);
+}
+
+void VulkanBindlessTextureTable::Flush(const VulkanDevice& device, std::uint32_t frame_index) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_slots_mutex);
+
+	auto& dirty_slots = m_dirty_slots[frame_index];
+
+	if (dirty_slots.empty())
+	{
+		return;
+	}
+
+	// A slot may have changed multiple times, only its latest contents are written
+	std::sort(dirty_slots.begin(), dirty_slots.end());
+	dirty_slots.erase(std::unique(dirty_slots.begin(), dirty_slots.end()), dirty_slots.end());
+
+	std::vector<VkDescriptorImageInfo> image_infos;
+	std::vector<VkWriteDescriptorSet> descriptor_writes;
+	image_infos.reserve(dirty_slots.size());
+	descriptor_writes.reserve(dirty_slots.size());
+
+	for (auto index : dirty_slots)
+	{
+		const auto& slot = m_slots[index];
+
+		if (slot.image_view == VK_NULL_HANDLE)
+		{
+			continue;
+		}
+
+		VkDescriptorImageInfo image_info = {};
+		image_info.sampler = slot.sampler;
+		image_info.imageView = slot.image_view;
+		image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		image_infos.push_back(image_info);
+
+		VkWriteDescriptorSet descriptor_write = {};
+		descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptor_write.dstSet = m_sets[frame_index];
+		descriptor_write.dstBinding = 0;
+		descriptor_write.dstArrayElement = index;
+		descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptor_write.descriptorCount = 1;
+		descriptor_write.pImageInfo = &image_infos.back();
+		descriptor_writes.push_back(descriptor_write);
+	}
+
+	vkUpdateDescriptorSets(
+		device.GetLogicalDeviceNative(),
+		static_cast<std::uint32_t>(descriptor_writes.size()),
+		descriptor_writes.data(),
+		0,
+		nullptr);
+
+	dirty_slots.clear();
+}
+
+VkDescriptorSetLayout VulkanBindlessTextureTable::GetLayout() const noexcept(true)
+{
+	return m_layout;
+}
+
+VkDescriptorSet VulkanBindlessTextureTable::GetSet(std::uint32_t frame_index) const noexcept(true)
+{
+	return m_sets[frame_index];
+}
+
+std::uint32_t VulkanBindlessTextureTable::GetCapacity() const noexcept(true)
+{
+	return m_capacity;
+}
+
+void VulkanBindlessTextureTable::MarkSlotDirty(std::uint32_t index) noexcept(true)
+{
+	for (auto& dirty_slots : m_dirty_slots)
+	{
+		dirty_slots.push_back(index);
+	}
+}
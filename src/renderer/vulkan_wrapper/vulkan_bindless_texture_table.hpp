@@ -0,0 +1,105 @@
+#ifndef VULKAN_BINDLESS_TEXTURE_TABLE_HPP
+#define VULKAN_BINDLESS_TEXTURE_TABLE_HPP
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	// Forward declarations
+	class VulkanDevice;
+
+	/** One large array of combined image samplers that every draw can index into */
+	/**
+	 * Requires VK_EXT_descriptor_indexing, check "VulkanDevice::SupportsBindlessDescriptors"
+	 * before creating a table.
+	 *
+	 * Textures are registered once and get a fixed index into the array,
+	 * shaders receive that index (for example through a push constant) instead
+	 * of having a descriptor set bound per draw. The array is partially bound,
+	 * so unused slots do not need a valid descriptor.
+	 *
+	 * Each frame in flight has its own copy of the descriptor set. Changes are
+	 * recorded on the CPU and only written to the set of a frame by "Flush",
+	 * which must be called once the GPU has finished using that frame.
+	 *
+	 * All functions are thread-safe.
+	 */
+	class VulkanBindlessTextureTable
+	{
+	public:
+		VulkanBindlessTextureTable() noexcept(true);
+		~VulkanBindlessTextureTable() noexcept(true);
+
+		/** Create the descriptor set layout, pool, and one set per frame in flight */
+		/**
+		 * The number of slots is limited by the device, use "GetCapacity" to
+		 * find out how many textures fit in the table.
+		 */
+		void Create(
+			const VulkanDevice& device,
+			std::uint32_t maximum_texture_count,
+			std::uint32_t frame_count) noexcept(false);
+
+		/** Destroy all Vulkan resources */
+		void Destroy(const VulkanDevice& device) noexcept(true);
+
+		/** Add a texture to the table, returns the index shaders should use to sample it */
+		/**
+		 * Throws when the table is full.
+		 */
+		std::uint32_t Register(VkImageView image_view, VkSampler sampler) noexcept(false);
+
+		/** Point an existing slot to a different image view or sampler (e.g. after a texture changed residency) */
+		void Update(std::uint32_t index, VkImageView image_view, VkSampler sampler) noexcept(true);
+
+		/** Remove a texture from the table, its index may be handed out again */
+		void Unregister(std::uint32_t index) noexcept(true);
+
+		/** Write all changes made since the previous flush of this frame into the descriptor set of the frame */
+		void Flush(const VulkanDevice& device, std::uint32_t frame_index) noexcept(true);
+
+		/** Get the layout of the table, use it as a descriptor set layout in pipeline layouts */
+		VkDescriptorSetLayout GetLayout() const noexcept(true);
+
+		/** Get the descriptor set of a frame */
+		VkDescriptorSet GetSet(std::uint32_t frame_index) const noexcept(true);
+
+		/** Get the number of slots in the table */
+		std::uint32_t GetCapacity() const noexcept(true);
+
+	private:
+		/** Mark a slot as changed in every frame */
+		void MarkSlotDirty(std::uint32_t index) noexcept(true);
+
+	private:
+		/** Contents of a single slot, a null image view marks an unused slot */
+		struct Slot
+		{
+			VkImageView image_view = VK_NULL_HANDLE;
+			VkSampler sampler = VK_NULL_HANDLE;
+		};
+
+	private:
+		VkDescriptorSetLayout m_layout;
+		VkDescriptorPool m_pool;
+		std::vector<VkDescriptorSet> m_sets;
+
+		std::vector<Slot> m_slots;
+		std::vector<std::uint32_t> m_free_slots;
+
+		/** Slots that changed since the previous flush, per frame */
+		std::vector<std::vector<std::uint32_t>> m_dirty_slots;
+
+		std::uint32_t m_capacity;
+
+		mutable std::mutex m_slots_mutex;
+	};
+}
+
+#endif // VULKAN_BINDLESS_TEXTURE_TABLE_HPP
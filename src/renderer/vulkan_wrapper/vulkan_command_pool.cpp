@@ -12,10 +12,14 @@ VulkanCommandPool::VulkanCommandPool() noexcept(true)
 VulkanCommandPool::~VulkanCommandPool() noexcept(true)
 {}
 
-void VulkanCommandPool::Create(const VulkanDevice & device, CommandPoolType type) noexcept(false)
+void VulkanCommandPool::Create(
+	const VulkanDevice& device,
+	CommandPoolType type,
+	VkCommandPoolCreateFlags flags) noexcept(false)
 {
 	VkCommandPoolCreateInfo info = {};
 	info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	info.flags = flags;
 
 	auto queue_family_indices = device.GetQueueFamilyIndices();
 
@@ -21,7 +21,14 @@ namespace vkc::vk_wrapper
 		~VulkanCommandPool() noexcept(true);
 
 		/** Create a command pool */
-		void Create(const VulkanDevice& device, CommandPoolType type) noexcept(false);
+		/**
+		 * Pass "VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT" as a flag to
+		 * allow command buffers allocated from this pool to be re-recorded.
+		 */
+		void Create(
+			const VulkanDevice& device,
+			CommandPoolType type,
+			VkCommandPoolCreateFlags flags = 0) noexcept(false);
 
 		/** Deallocate used resources */
 		void Destroy(const VulkanDevice& device) const noexcept(true);
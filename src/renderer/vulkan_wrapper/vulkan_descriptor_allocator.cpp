@@ -0,0 +1,357 @@
+// Application
+#include "core/hash.hpp"
+#include "miscellaneous/exceptions.hpp"
+#include "miscellaneous/global_settings.hpp"
+#include "vulkan_descriptor_allocator.hpp"
+#include "vulkan_device.hpp"
+
+// C++ standard
+#include <algorithm>
+
+using namespace vkc::core;
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+namespace
+{
+	/** Average number of descriptors of each type in a single set, used to size new pools */
+	struct DescriptorTypeRatio
+	{
+		VkDescriptorType type;
+		float descriptors_per_set;
+	};
+
+	static const DescriptorTypeRatio descriptor_type_ratios[] =
+	{
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0.5f },
+		{ VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 0.5f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 0.5f },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 0.25f },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 0.25f },
+		{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0.25f }
+	};
+
+	bool IsBufferDescriptor(VkDescriptorType type) noexcept(true)
+	{
+		return
+			type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+			type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+			type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+			type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+	}
+}
+
+VulkanDescriptorAllocator::VulkanDescriptorAllocator() noexcept(true)
+	: m_allocated_set_count(0)
+	, m_cache_hit_count(0)
+	, m_cache_miss_count(0)
+{}
+
+VulkanDescriptorAllocator::~VulkanDescriptorAllocator() noexcept(true)
+{}
+
+void VulkanDescriptorAllocator::Create(std::uint32_t frame_count) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_pools_mutex);
+
+	m_persistent_pools.next_pool_set_count = global_settings::initial_descriptor_sets_per_pool;
+
+	PoolChain frame_chain = {};
+	frame_chain.next_pool_set_count = global_settings::initial_descriptor_sets_per_pool;
+	m_frame_pools.assign(frame_count, frame_chain);
+}
+
+void VulkanDescriptorAllocator::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_pools_mutex);
+
+	for (const auto& pool : m_persistent_pools.pools)
+	{
+		vkDestroyDescriptorPool(device.GetLogicalDeviceNative(), pool, nullptr);
+	}
+
+	for (const auto& chain : m_frame_pools)
+	{
+		for (const auto& pool : chain.pools)
+		{
+			vkDestroyDescriptorPool(device.GetLogicalDeviceNative(), pool, nullptr);
+		}
+	}
+
+	m_persistent_pools = {};
+	m_frame_pools.clear();
+	m_cached_sets.clear();
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::Allocate(
+	const VulkanDevice& device,
+	VkDescriptorSetLayout layout) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_pools_mutex);
+	return AllocateFromChain(device, m_persistent_pools, layout);
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::AllocateForFrame(
+	const VulkanDevice& device,
+	VkDescriptorSetLayout layout,
+	std::uint32_t frame_index) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_pools_mutex);
+	return AllocateFromChain(device, m_frame_pools.at(frame_index), layout);
+}
+
+void VulkanDescriptorAllocator::ResetFrame(
+	const VulkanDevice& device,
+	std::uint32_t frame_index) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_pools_mutex);
+
+	auto& chain = m_frame_pools.at(frame_index);
+
+	// Resetting a pool frees all of its sets at once, the pools themselves are kept for the next frame
+	for (const auto& pool : chain.pools)
+	{
+		vkResetDescriptorPool(device.GetLogicalDeviceNative(), pool, 0);
+	}
+
+	chain.current_pool_index = 0;
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::GetCachedSet(
+	const VulkanDevice& device,
+	VkDescriptorSetLayout layout,
+	const std::vector<DescriptorWrite>& writes) noexcept(false)
+{
+	const auto hash = HashCachedSet(layout, writes);
+
+	std::lock_guard<std::mutex> lock(m_pools_mutex);
+
+	auto [first, last] = m_cached_sets.equal_range(hash);
+
+	for (auto it = first; it != last; ++it)
+	{
+		if (it->second.layout == layout &&
+			std::equal(
+				writes.begin(), writes.end(),
+				it->second.writes.begin(), it->second.writes.end(),
+				AreWritesEqual))
+		{
+			++m_cache_hit_count;
+			return it->second.set;
+		}
+	}
+
+	++m_cache_miss_count;
+
+	CachedSet cached_set = {};
+	cached_set.layout = layout;
+	cached_set.writes = writes;
+	cached_set.set = AllocateFromChain(device, m_persistent_pools, layout);
+
+	WriteDescriptorSet(device, cached_set.set, writes);
+
+	m_cached_sets.emplace(hash, cached_set);
+
+	return cached_set.set;
+}
+
+void VulkanDescriptorAllocator::WriteDescriptorSet(
+	const VulkanDevice& device,
+	VkDescriptorSet set,
+	const std::vector<DescriptorWrite>& writes) noexcept(true)
+{
+	std::vector<VkWriteDescriptorSet> descriptor_writes;
+	descriptor_writes.reserve(writes.size());
+
+	for (const auto& write : writes)
+	{
+		VkWriteDescriptorSet descriptor_write = {};
+		descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptor_write.dstSet = set;
+		descriptor_write.dstBinding = write.binding;
+		descriptor_write.dstArrayElement = 0;
+		descriptor_write.descriptorType = write.type;
+		descriptor_write.descriptorCount = 1;
+
+		if (IsBufferDescriptor(write.type))
+		{
+			descriptor_write.pBufferInfo = &write.buffer_info;
+		}
+		else
+		{
+			descriptor_write.pImageInfo = &write.image_info;
+		}
+
+		descriptor_writes.push_back(descriptor_write);
+	}
+
+	vkUpdateDescriptorSets(
+		device.GetLogicalDeviceNative(),
+		static_cast<std::uint32_t>(descriptor_writes.size()),
+		descriptor_writes.data(),
+		0,
+		nullptr);
+}
+
+DescriptorAllocatorStatistics VulkanDescriptorAllocator::GetStatistics() const noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_pools_mutex);
+
+	DescriptorAllocatorStatistics statistics = {};
+	statistics.pool_count = static_cast<std::uint32_t>(m_persistent_pools.pools.size());
+
+	for (const auto& chain : m_frame_pools)
+	{
+		statistics.pool_count += static_cast<std::uint32_t>(chain.pools.size());
+	}
+
+	statistics.allocated_set_count = m_allocated_set_count;
+	statistics.cached_set_count = static_cast<std::uint32_t>(m_cached_sets.size());
+	statistics.cache_hit_count = m_cache_hit_count;
+	statistics.cache_miss_count = m_cache_miss_count;
+
+	const auto lookup_count = m_cache_hit_count + m_cache_miss_count;
+
+	if (lookup_count > 0)
+	{
+		statistics.cache_hit_ratio = static_cast<double>(m_cache_hit_count) / static_cast<double>(lookup_count);
+	}
+
+	return statistics;
+}
+
+VkDescriptorSet VulkanDescriptorAllocator::AllocateFromChain(
+	const VulkanDevice& device,
+	PoolChain& chain,
+	VkDescriptorSetLayout layout) noexcept(false)
+{
+	VkDescriptorSetAllocateInfo alloc_info = {};
+	alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	alloc_info.descriptorSetCount = 1;
+	alloc_info.pSetLayouts = &layout;
+
+	// Try the current pool first, move on to the next (or a new) pool when it is full
+	while (true)
+	{
+		auto is_new_pool = false;
+
+		if (chain.current_pool_index >= chain.pools.size())
+		{
+			chain.pools.push_back(CreatePool(device, chain));
+			is_new_pool = true;
+		}
+
+		alloc_info.descriptorPool = chain.pools[chain.current_pool_index];
+
+		VkDescriptorSet set = VK_NULL_HANDLE;
+		auto result = vkAllocateDescriptorSets(device.GetLogicalDeviceNative(), &alloc_info, &set);
+
+		if (result == VK_SUCCESS)
+		{
+			++m_allocated_set_count;
+			return set;
+		}
+		else if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+		{
+			throw CriticalVulkanError("Could not allocate a descriptor set.");
+		}
+
+		// A freshly created pool should always be able to hold a single set
+		if (is_new_pool)
+		{
+			throw CriticalVulkanError("Descriptor set layout does not fit in an empty descriptor pool.");
+		}
+
+		++chain.current_pool_index;
+	}
+}
+
+VkDescriptorPool VulkanDescriptorAllocator::CreatePool(
+	const VulkanDevice& device,
+	PoolChain& chain) noexcept(false)
+{
+	const auto set_count = std::max(chain.next_pool_set_count, global_settings::initial_descriptor_sets_per_pool);
+
+	std::vector<VkDescriptorPoolSize> pool_sizes;
+
+	for (const auto& ratio : descriptor_type_ratios)
+	{
+		const auto descriptor_count = static_cast<std::uint32_t>(ratio.descriptors_per_set * static_cast<float>(set_count));
+		pool_sizes.push_back({ ratio.type, std::max(descriptor_count, 1u) });
+	}
+
+	VkDescriptorPoolCreateInfo pool_create_info = {};
+	pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	pool_create_info.poolSizeCount = static_cast<std::uint32_t>(pool_sizes.size());
+	pool_create_info.pPoolSizes = pool_sizes.data();
+	pool_create_info.maxSets = set_count;
+
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+
+	if (vkCreateDescriptorPool(device.GetLogicalDeviceNative(), &pool_create_info, nullptr, &pool) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create a descriptor pool.");
+	}
+
+	// Chains that keep running out of space get bigger pools
+	chain.next_pool_set_count = std::min(set_count * 2, global_settings::maximum_descriptor_sets_per_pool);
+
+	return pool;
+}
+
+std::uint64_t VulkanDescriptorAllocator::HashCachedSet(
+	VkDescriptorSetLayout layout,
+	const std::vector<DescriptorWrite>& writes) noexcept(true)
+{
+	auto hash = fnv1a_offset_basis;
+	HashCombine(hash, layout);
+
+	for (const auto& write : writes)
+	{
+		HashCombine(hash, write.binding);
+		HashCombine(hash, static_cast<std::uint32_t>(write.type));
+
+		if (IsBufferDescriptor(write.type))
+		{
+			HashCombine(hash, write.buffer_info.buffer);
+			HashCombine(hash, write.buffer_info.offset);
+			HashCombine(hash, write.buffer_info.range);
+		}
+		else
+		{
+			HashCombine(hash, write.image_info.sampler);
+			HashCombine(hash, write.image_info.imageView);
+			HashCombine(hash, static_cast<std::uint32_t>(write.image_info.imageLayout));
+		}
+	}
+
+	return hash;
+}
+
+bool VulkanDescriptorAllocator::AreWritesEqual(
+	const DescriptorWrite& lhs,
+	const DescriptorWrite& rhs) noexcept(true)
+{
+	if (lhs.binding != rhs.binding || lhs.type != rhs.type)
+	{
+		return false;
+	}
+
+	if (IsBufferDescriptor(lhs.type))
+	{
+		return
+			lhs.buffer_info.buffer == rhs.buffer_info.buffer &&
+			lhs.buffer_info.offset == rhs.buffer_info.offset &&
+			lhs.buffer_info.range == rhs.buffer_info.range;
+	}
+
+	return
+		lhs.image_info.sampler == rhs.image_info.sampler &&
+		lhs.image_info.imageView == rhs.image_info.imageView &&
+		lhs.image_info.imageLayout == rhs.image_info.imageLayout;
+}
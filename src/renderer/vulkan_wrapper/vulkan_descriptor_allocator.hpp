@@ -0,0 +1,168 @@
+#ifndef VULKAN_DESCRIPTOR_ALLOCATOR_HPP
+#define VULKAN_DESCRIPTOR_ALLOCATOR_HPP
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	// Forward declarations
+	class VulkanDevice;
+
+	/** Contents of a single descriptor binding */
+	/**
+	 * Only the info that matches the descriptor type is used, buffer info for
+	 * (storage / uniform) buffers, image info for everything else.
+	 */
+	struct DescriptorWrite
+	{
+		std::uint32_t binding = 0;
+		VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+		VkDescriptorBufferInfo buffer_info = {};
+		VkDescriptorImageInfo image_info = {};
+	};
+
+	/** Usage statistics of a descriptor allocator */
+	struct DescriptorAllocatorStatistics
+	{
+		/** Descriptor pools that currently exist (persistent and per-frame) */
+		std::uint32_t pool_count = 0;
+
+		/** Sets allocated since creation, sets from reset frame pools are included */
+		std::uint64_t allocated_set_count = 0;
+
+		/** Sets that live in the immutable set cache */
+		std::uint32_t cached_set_count = 0;
+
+		std::uint64_t cache_hit_count = 0;
+		std::uint64_t cache_miss_count = 0;
+
+		/** Fraction of cache lookups that found an existing set, zero when the cache has not been used yet */
+		double cache_hit_ratio = 0.0;
+	};
+
+	/** Allocates descriptor sets from chains of descriptor pools that grow on demand */
+	/**
+	 * Three kinds of sets are handed out:
+	 *
+	 * - Persistent sets live until the allocator is destroyed.
+	 * - Per-frame sets live until "ResetFrame" is called for their frame
+	 *   index, all pools of that frame are reset at once, which is much
+	 *   cheaper than freeing sets one by one.
+	 * - Cached sets are persistent sets that are never written to after
+	 *   creation. Requesting a set with the same layout and contents returns
+	 *   the existing set, so identical material sets are only created once.
+	 *
+	 * When a pool runs out of space, a new pool is added to the chain. Pool
+	 * sizes are based on a fixed ratio of descriptor types per set.
+	 *
+	 * All functions are thread-safe.
+	 */
+	class VulkanDescriptorAllocator
+	{
+	public:
+		VulkanDescriptorAllocator() noexcept(true);
+		~VulkanDescriptorAllocator() noexcept(true);
+
+		/** Prepare a pool chain for each frame in flight */
+		void Create(std::uint32_t frame_count) noexcept(true);
+
+		/** Destroy all pools, every set allocated from them becomes invalid */
+		void Destroy(const VulkanDevice& device) noexcept(true);
+
+		/** Allocate a set that lives until the allocator is destroyed */
+		VkDescriptorSet Allocate(
+			const VulkanDevice& device,
+			VkDescriptorSetLayout layout) noexcept(false);
+
+		/** Allocate a set that lives until "ResetFrame" is called for the frame index */
+		VkDescriptorSet AllocateForFrame(
+			const VulkanDevice& device,
+			VkDescriptorSetLayout layout,
+			std::uint32_t frame_index) noexcept(false);
+
+		/** Reset all pools of a frame, the GPU must have finished using the sets of that frame */
+		void ResetFrame(
+			const VulkanDevice& device,
+			std::uint32_t frame_index) noexcept(false);
+
+		/** Get a set with the specified layout and contents, a new set is only created when no matching set exists */
+		/**
+		 * Cached sets must not be written to, as other users may share them.
+		 */
+		VkDescriptorSet GetCachedSet(
+			const VulkanDevice& device,
+			VkDescriptorSetLayout layout,
+			const std::vector<DescriptorWrite>& writes) noexcept(false);
+
+		/** Write descriptors into an existing set */
+		static void WriteDescriptorSet(
+			const VulkanDevice& device,
+			VkDescriptorSet set,
+			const std::vector<DescriptorWrite>& writes) noexcept(true);
+
+		/** Get the usage statistics of the allocator */
+		DescriptorAllocatorStatistics GetStatistics() const noexcept(true);
+
+	private:
+		/** Pools that sets are allocated from, pools before the current pool are full */
+		struct PoolChain
+		{
+			std::vector<VkDescriptorPool> pools;
+
+			/** Pools of a chain are re-used after a reset, this is the pool that is allocated from */
+			std::size_t current_pool_index = 0;
+
+			/** Number of sets the next new pool will hold */
+			std::uint32_t next_pool_set_count = 0;
+		};
+
+		/** Immutable set and the contents it was created with */
+		struct CachedSet
+		{
+			VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+			std::vector<DescriptorWrite> writes;
+			VkDescriptorSet set = VK_NULL_HANDLE;
+		};
+
+	private:
+		/** Allocate a set from a chain, a new pool is added when all pools are full */
+		VkDescriptorSet AllocateFromChain(
+			const VulkanDevice& device,
+			PoolChain& chain,
+			VkDescriptorSetLayout layout) noexcept(false);
+
+		/** Create a pool big enough for the next pool of the chain */
+		VkDescriptorPool CreatePool(
+			const VulkanDevice& device,
+			PoolChain& chain) noexcept(false);
+
+		static std::uint64_t HashCachedSet(
+			VkDescriptorSetLayout layout,
+			const std::vector<DescriptorWrite>& writes) noexcept(true);
+
+		static bool AreWritesEqual(
+			const DescriptorWrite& lhs,
+			const DescriptorWrite& rhs) noexcept(true);
+
+	private:
+		PoolChain m_persistent_pools;
+		std::vector<PoolChain> m_frame_pools;
+
+		std::unordered_multimap<std::uint64_t, CachedSet> m_cached_sets;
+
+		std::uint64_t m_allocated_set_count;
+		std::uint64_t m_cache_hit_count;
+		std::uint64_t m_cache_miss_count;
+
+		mutable std::mutex m_pools_mutex;
+	};
+}
+
+#endif // VULKAN_DESCRIPTOR_ALLOCATOR_HPP
@@ -0,0 +1,102 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_descriptor_update_template.hpp"
+#include "vulkan_device.hpp"
+
+// C++ standard
+#include <algorithm>
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+VulkanDescriptorUpdateTemplate::VulkanDescriptorUpdateTemplate() noexcept(true)
+	: m_update_template(VK_NULL_HANDLE)
+	, m_descriptor_count(0)
+{}
+
+VulkanDescriptorUpdateTemplate::~VulkanDescriptorUpdateTemplate() noexcept(true)
+{}
+
+void VulkanDescriptorUpdateTemplate::Create(
+	const VulkanDevice& device,
+	VkDescriptorSetLayout set_layout,
+	const std::vector<VkDescriptorSetLayoutBinding>& bindings) noexcept(false)
+{
+	auto sorted_bindings = bindings;
+	std::sort(
+		sorted_bindings.begin(),
+		sorted_bindings.end(),
+		[](const VkDescriptorSetLayoutBinding& lhs, const VkDescriptorSetLayoutBinding& rhs)
+		{
+			return lhs.binding < rhs.binding;
+		});
+
+	// One entry per binding, every descriptor takes up one "DescriptorTemplateData" in the packed data
+	std::vector<VkDescriptorUpdateTemplateEntry> entries;
+	m_descriptor_indices.clear();
+	m_descriptor_count = 0;
+
+	for (const auto& binding : sorted_bindings)
+	{
+		VkDescriptorUpdateTemplateEntry entry = {};
+		entry.dstBinding = binding.binding;
+		entry.dstArrayElement = 0;
+		entry.descriptorCount = binding.descriptorCount;
+		entry.descriptorType = binding.descriptorType;
+		entry.offset = m_descriptor_count * sizeof(DescriptorTemplateData);
+		entry.stride = sizeof(DescriptorTemplateData);
+
+		entries.push_back(entry);
+		m_descriptor_indices.push_back({ binding.binding, m_descriptor_count });
+
+		m_descriptor_count += binding.descriptorCount;
+	}
+
+	VkDescriptorUpdateTemplateCreateInfo template_info = {};
+	template_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+	template_info.descriptorUpdateEntryCount = static_cast<std::uint32_t>(entries.size());
+	template_info.pDescriptorUpdateEntries = entries.data();
+	template_info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+	template_info.descriptorSetLayout = set_layout;
+
+	if (vkCreateDescriptorUpdateTemplate(device.GetLogicalDeviceNative(), &template_info, nullptr, &m_update_template) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create a descriptor update template.");
+	}
+}
+
+void VulkanDescriptorUpdateTemplate::Destroy(const VulkanDevice& device) const noexcept(true)
+{
+	vkDestroyDescriptorUpdateTemplate(device.GetLogicalDeviceNative(), m_update_template, nullptr);
+}
+
+void VulkanDescriptorUpdateTemplate::Write(
+	const VulkanDevice& device,
+	VkDescriptorSet set,
+	const std::vector<DescriptorTemplateData>& data) const noexcept(true)
+{
+	vkUpdateDescriptorSetWithTemplate(device.GetLogicalDeviceNative(), set, m_update_template, data.data());
+}
+
+std::uint32_t VulkanDescriptorUpdateTemplate::GetDescriptorIndex(std::uint32_t binding) const noexcept(false)
+{
+	for (const auto& [binding_number, descriptor_index] : m_descriptor_indices)
+	{
+		if (binding_number == binding)
+		{
+			return descriptor_index;
+		}
+	}
+
+	throw CriticalVulkanError("Descriptor update template does not contain the requested binding.");
+}
+
+std::uint32_t VulkanDescriptorUpdateTemplate::GetDescriptorCount() const noexcept(true)
+{
+	return m_descriptor_count;
+}
+
+const VkDescriptorUpdateTemplate& VulkanDescriptorUpdateTemplate::GetNative() const noexcept(true)
+{
+	return m_update_template;
+}
@@ -0,0 +1,79 @@
+#ifndef VULKAN_DESCRIPTOR_UPDATE_TEMPLATE_HPP
+#define VULKAN_DESCRIPTOR_UPDATE_TEMPLATE_HPP
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	// Forward declarations
+	class VulkanDevice;
+
+	/** Contents of a single descriptor in the packed data passed to an update template */
+	/**
+	 * Fill in the member that matches the descriptor type of the binding.
+	 */
+	union DescriptorTemplateData
+	{
+		VkDescriptorImageInfo image_info;
+		VkDescriptorBufferInfo buffer_info;
+		VkBufferView texel_buffer_view;
+	};
+
+	/** Writes every descriptor of a set in a single call (vkUpdateDescriptorSetWithTemplate) */
+	/**
+	 * The template is generated from the bindings of a descriptor set layout.
+	 * Descriptors are read from a packed array of "DescriptorTemplateData",
+	 * bindings are laid out in ascending order, array elements of a binding
+	 * are stored next to each other. Use "GetDescriptorIndex" to find the
+	 * position of a binding in the array.
+	 */
+	class VulkanDescriptorUpdateTemplate
+	{
+	public:
+		VulkanDescriptorUpdateTemplate() noexcept(true);
+		~VulkanDescriptorUpdateTemplate() noexcept(true);
+
+		/** Create an update template for sets of the specified layout */
+		void Create(
+			const VulkanDevice& device,
+			VkDescriptorSetLayout set_layout,
+			const std::vector<VkDescriptorSetLayoutBinding>& bindings) noexcept(false);
+
+		/** Destroy the Vulkan update template */
+		void Destroy(const VulkanDevice& device) const noexcept(true);
+
+		/** Write all descriptors of a set, "data" needs to hold "GetDescriptorCount" descriptors */
+		void Write(
+			const VulkanDevice& device,
+			VkDescriptorSet set,
+			const std::vector<DescriptorTemplateData>& data) const noexcept(true);
+
+		/** Get the position of the first descriptor of a binding in the packed data */
+		/**
+		 * Throws when the layout does not contain the binding.
+		 */
+		std::uint32_t GetDescriptorIndex(std::uint32_t binding) const noexcept(false);
+
+		/** Get the number of descriptors in the packed data */
+		std::uint32_t GetDescriptorCount() const noexcept(true);
+
+		/** Get a reference to the underlaying Vulkan update template object */
+		const VkDescriptorUpdateTemplate& GetNative() const noexcept(true);
+
+	private:
+		VkDescriptorUpdateTemplate m_update_template;
+
+		/** Binding number and the index of its first descriptor in the packed data */
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> m_descriptor_indices;
+
+		std::uint32_t m_descriptor_count;
+	};
+}
+
+#endif // VULKAN_DESCRIPTOR_UPDATE_TEMPLATE_HPP
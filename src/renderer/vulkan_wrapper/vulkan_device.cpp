@@ -17,10 +17,11 @@ using namespace vkc::vk_wrapper;
 void VulkanDevice::Create(
 	const VulkanInstance& instance,
 	const VulkanSwapchain& swapchain,
-	const std::vector<std::string>& extensions) noexcept(false)
+	const std::vector<std::string>& extensions,
+	const std::vector<std::string>& optional_extensions) noexcept(false)
 {
 	// Get the best physical device available on this machine
-	SelectPhysicalDevice(instance, extensions);
+	SelectPhysicalDevice(instance, extensions, optional_extensions);
 
 	// Find queue all queue families
 	FindQueueFamilyIndices(swapchain);
@@ -32,7 +33,7 @@ void VulkanDevice::Create(
 	}
 
 	// Create the logical device
-	CreateLogicalDevice(extensions);
+	CreateLogicalDevice(m_enabled_extensions);
 
 	// Save handles to the queues
 	vkGetDeviceQueue(
@@ -96,9 +97,85 @@ const VkQueue& VulkanDevice::GetQueueNativeOfType(VulkanQueueType queue_type) co
 	}
 }
 
+bool VulkanDevice::IsExtensionEnabled(const std::string& extension) const noexcept(true)
+{
+	return (std::find(m_enabled_extensions.begin(), m_enabled_extensions.end(), extension) != m_enabled_extensions.end());
+}
+
+bool VulkanDevice::SupportsBindlessDescriptors() const noexcept(true)
+{
+	return m_supports_bindless_descriptors;
+}
+
+bool VulkanDevice::SupportsMultiDrawIndirect() const noexcept(true)
+{
+	return m_supports_multi_draw_indirect;
+}
+
+bool VulkanDevice::SupportsDrawIndirectCount() const noexcept(true)
+{
+	return m_supports_multi_draw_indirect && IsExtensionEnabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+}
+
+bool VulkanDevice::SupportsDrawIndirectFirstInstance() const noexcept(true)
+{
+	return m_supports_draw_indirect_first_instance;
+}
+
+bool VulkanDevice::SupportsPipelineStatisticsQueries() const noexcept(true)
+{
+	return m_supports_pipeline_statistics_queries;
+}
+
+VkSampleCountFlagBits VulkanDevice::FindSupportedSampleCount(std::uint32_t maximum_sample_count) const noexcept(true)
+{
+	VkPhysicalDeviceProperties properties = {};
+	vkGetPhysicalDeviceProperties(m_physical_device, &properties);
+
+	// Multisampled passes render to a color and a depth attachment with the same sample count
+	const auto supported_sample_counts =
+		properties.limits.framebufferColorSampleCounts &
+		properties.limits.framebufferDepthSampleCounts;
+
+	// Sample count flags are equal to the number of samples they stand for
+	for (auto sample_count = static_cast<std::uint32_t>(VK_SAMPLE_COUNT_64_BIT); sample_count > static_cast<std::uint32_t>(VK_SAMPLE_COUNT_1_BIT); sample_count >>= 1)
+	{
+		if (sample_count <= maximum_sample_count && (supported_sample_counts & sample_count) != 0)
+		{
+			return static_cast<VkSampleCountFlagBits>(sample_count);
+		}
+	}
+
+	return VK_SAMPLE_COUNT_1_BIT;
+}
+
+VkFormat VulkanDevice::FindSupportedFormat(
+	const std::vector<VkFormat>& candidates,
+	VkImageTiling tiling,
+	VkFormatFeatureFlags features) const noexcept(false)
+{
+	for (auto format : candidates)
+	{
+		VkFormatProperties format_properties = {};
+		vkGetPhysicalDeviceFormatProperties(m_physical_device, format, &format_properties);
+
+		const auto supported_features = (tiling == VK_IMAGE_TILING_LINEAR) ?
+			format_properties.linearTilingFeatures :
+			format_properties.optimalTilingFeatures;
+
+		if ((supported_features & features) == features)
+		{
+			return format;
+		}
+	}
+
+	throw exception::CriticalVulkanError("None of the candidate formats are supported by the device.");
+}
+
 void VulkanDevice::SelectPhysicalDevice(
 	const VulkanInstance& instance,
-	const std::vector<std::string> extensions) noexcept(false)
+	const std::vector<std::string> extensions,
+	const std::vector<std::string>& optional_extensions) noexcept(false)
 {
 	std::uint32_t physical_device_count = 0;
 	vkEnumeratePhysicalDevices(instance.GetNative(), &physical_device_count, nullptr);
@@ -157,6 +234,21 @@ void VulkanDevice::SelectPhysicalDevice(
 		throw exception::CriticalVulkanError("Not every device extension is supported.");
 	}
 
+	m_enabled_extensions = extensions;
+
+	// Optional extensions are only enabled when they are available
+	for (const auto& optional_extension : optional_extensions)
+	{
+		if (utility::AllRequiredItemsExistInVector({ optional_extension }, available_extension_names))
+		{
+			m_enabled_extensions.push_back(optional_extension);
+		}
+		else
+		{
+			spdlog::info("Optional device extension \"{}\" is not supported.", optional_extension);
+		}
+	}
+
 	m_physical_device = physical_device;
 }
 
@@ -278,6 +370,18 @@ void VulkanDevice::FindQueueFamilyIndices(
 
 		++index;
 	}
+
+	// Compute work only overlaps with graphics work when it runs on a family without graphics support
+	for (std::uint32_t family_index = 0; family_index < queue_families.size(); ++family_index)
+	{
+		const auto flags = queue_families[family_index].queueFlags;
+
+		if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT))
+		{
+			m_queue_family_indices.compute_family_index = { family_index, queue_families[family_index].queueCount };
+			break;
+		}
+	}
 }
 
 void VulkanDevice::CreateLogicalDevice(
@@ -309,9 +413,29 @@ void VulkanDevice::CreateLogicalDevice(
 		queue_infos.push_back(queue_create_info);
 	}
 
-	// Get all physical device features
-	VkPhysicalDeviceFeatures device_features;
-	vkGetPhysicalDeviceFeatures(m_physical_device, &device_features);
+	// Get all physical device features, extension features are chained behind the core features
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptor_indexing_features = {};
+	descriptor_indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+	VkPhysicalDeviceFeatures2 device_features = {};
+	device_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+
+	if (IsExtensionEnabled(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME))
+	{
+		device_features.pNext = &descriptor_indexing_features;
+	}
+
+	vkGetPhysicalDeviceFeatures2(m_physical_device, &device_features);
+
+	m_supports_bindless_descriptors =
+		descriptor_indexing_features.runtimeDescriptorArray &&
+		descriptor_indexing_features.shaderSampledImageArrayNonUniformIndexing &&
+		descriptor_indexing_features.descriptorBindingPartiallyBound &&
+		descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind;
+
+	m_supports_multi_draw_indirect = device_features.features.multiDrawIndirect;
+	m_supports_draw_indirect_first_instance = device_features.features.drawIndirectFirstInstance;
+	m_supports_pipeline_statistics_queries = device_features.features.pipelineStatisticsQuery;
 
 	// The create info below needs a c-string instead of std::string
 	auto extension_names_cstring = utility::ConvertVectorOfStringsToCString(extensions);
@@ -321,7 +445,8 @@ void VulkanDevice::CreateLogicalDevice(
 	device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	device_info.pQueueCreateInfos = queue_infos.data();
 	device_info.queueCreateInfoCount = static_cast<std::uint32_t>(queue_infos.size());
-	device_info.pEnabledFeatures = &device_features;
+	device_info.pNext = &device_features;
+	device_info.pEnabledFeatures = nullptr;
 	device_info.enabledExtensionCount = static_cast<std::uint32_t>(extensions.size());
 	device_info.ppEnabledExtensionNames = extension_names_cstring.data();
 
@@ -5,6 +5,7 @@
 #include <vulkan/vulkan.h>
 
 // C++ standard
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
@@ -45,14 +46,20 @@ namespace vkc::vk_wrapper
 	class VulkanDevice
 	{
 	public:
-		VulkanDevice() noexcept(true) : m_logical_device(VK_NULL_HANDLE), m_physical_device(VK_NULL_HANDLE) {}
+		VulkanDevice() noexcept(true) : m_logical_device(VK_NULL_HANDLE), m_physical_device(VK_NULL_HANDLE), m_supports_bindless_descriptors(false), m_supports_multi_draw_indirect(false), m_supports_draw_indirect_first_instance(false), m_supports_pipeline_statistics_queries(false) {}
 		~VulkanDevice() noexcept(true) {}
 
 		/** Create a physical device and a logical device */
+		/**
+		 * Every extension in "extensions" has to be supported by the device.
+		 * Extensions in "optional_extensions" are only enabled when the device
+		 * supports them, use "IsExtensionEnabled" to find out whether they are.
+		 */
 		void Create(
 			const VulkanInstance& instance,
 			const VulkanSwapchain& swapchain,
-			const std::vector<std::string>& extensions) noexcept(false);
+			const std::vector<std::string>& extensions,
+			const std::vector<std::string>& optional_extensions = {}) noexcept(false);
 
 		/** Destroy the logical device */
 		/**
@@ -73,11 +80,47 @@ namespace vkc::vk_wrapper
 		/** Get a reference to the requested queue */
 		const VkQueue& GetQueueNativeOfType(VulkanQueueType queue_type) const noexcept(false);
 
+		/** Check whether a device extension has been enabled on the logical device */
+		bool IsExtensionEnabled(const std::string& extension) const noexcept(true);
+
+		/** Check whether the device can index into large, partially bound texture arrays (VK_EXT_descriptor_indexing) */
+		bool SupportsBindlessDescriptors() const noexcept(true);
+
+		/** Check whether a single indirect draw call can issue more than one draw (multiDrawIndirect) */
+		bool SupportsMultiDrawIndirect() const noexcept(true);
+
+		/** Check whether indirect draws can read their draw count from a buffer (VK_KHR_draw_indirect_count) */
+		bool SupportsDrawIndirectCount() const noexcept(true);
+
+		/** Check whether indirect draw commands can start at an instance other than zero (drawIndirectFirstInstance) */
+		bool SupportsDrawIndirectFirstInstance() const noexcept(true);
+
+		/** Check whether queries can count pipeline statistics such as fragment shader invocations (pipelineStatisticsQuery) */
+		bool SupportsPipelineStatisticsQueries() const noexcept(true);
+
+		/** Get the highest sample count that color and depth attachments support, up to "maximum_sample_count" */
+		VkSampleCountFlagBits FindSupportedSampleCount(std::uint32_t maximum_sample_count) const noexcept(true);
+
+		/** Get the first format in "candidates" that supports all "features" with the specified tiling */
+		/**
+		 * Candidates are checked in order, so the preferred formats go first.
+		 * Throws when none of the formats are supported.
+		 */
+		VkFormat FindSupportedFormat(
+			const std::vector<VkFormat>& candidates,
+			VkImageTiling tiling,
+			VkFormatFeatureFlags features) const noexcept(false);
+
 	private:
 		/** Select and create a physical device */
+		/**
+		 * Stores the required extensions and the supported optional extensions
+		 * in the list of enabled extensions.
+		 */
 		void SelectPhysicalDevice(
 			const VulkanInstance& instance,
-			const std::vector<std::string> extensions) noexcept(false);
+			const std::vector<std::string> extensions,
+			const std::vector<std::string>& optional_extensions) noexcept(false);
 
 		/** Get the best physical device available */
 		VkPhysicalDevice FindBestPhysicalDevice(
@@ -88,6 +131,10 @@ namespace vkc::vk_wrapper
 			const VulkanSwapchain& swapchain) noexcept(false);
 
 		/** Create a logical device */
+		/**
+		 * Every feature the physical device supports is enabled, including the
+		 * descriptor indexing features when the extension is enabled.
+		 */
 		void CreateLogicalDevice(
 			const std::vector<std::string>& extensions) noexcept(false);
 
@@ -99,6 +146,16 @@ namespace vkc::vk_wrapper
 		VkQueue m_present_queue;
 
 		QueueFamilyIndices m_queue_family_indices;
+
+		/** Names of all extensions enabled on the logical device */
+		std::vector<std::string> m_enabled_extensions;
+
+		/** All descriptor indexing features needed for bindless textures are enabled */
+		bool m_supports_bindless_descriptors;
+
+		bool m_supports_multi_draw_indirect;
+		bool m_supports_draw_indirect_first_instance;
+		bool m_supports_pipeline_statistics_queries;
 	};
 }
 
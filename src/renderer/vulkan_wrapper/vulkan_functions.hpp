@@ -4,9 +4,8 @@
 // Application
 #include "miscellaneous/exceptions.hpp"
 #include "renderer/memory_manager/memory_manager.hpp"
-#include "vulkan_command_buffer.hpp"
-#include "vulkan_command_pool.hpp"
 #include "vulkan_device.hpp"
+#include "vulkan_immediate_submit_context.hpp"
 
 // Vulkan
 #include <vulkan/vulkan.h>
@@ -87,34 +86,36 @@ namespace vkc::vk_wrapper::func
 
 	//////////////////////////////////////////////////////////////////////////
 
-	/** Copy data from a host visible buffer to a device local buffer using the specified command pool */
-	inline void CopyHostVisibleBufferToDeviceLocalBuffer(
-		const VulkanDevice& device,
-		const VulkanCommandPool& command_pool,
+	/** Record a copy of a whole host visible buffer to a device local buffer */
+	inline void RecordBufferCopy(
+		const VkCommandBuffer& command_buffer,
 		const memory::VulkanBuffer& host_visible_buffer,
 		const memory::VulkanBuffer& device_local_buffer) noexcept(true)
 	{
-		VulkanCommandBuffer cmd_buffer = {};
-		cmd_buffer.Create(device, command_pool, 1);
-		cmd_buffer.BeginRecording(CommandBufferUsage::OneTimeSubmit);
-
 		VkBufferCopy region = {};
 		region.srcOffset = host_visible_buffer.info.offset;
 		region.size = host_visible_buffer.info.size;
 		region.dstOffset = device_local_buffer.info.offset;
 
 		// Copy command
-		vkCmdCopyBuffer(cmd_buffer.GetNative(), host_visible_buffer.buffer, device_local_buffer.buffer, 1, &region);
-
-		// Get hold of the graphics queue since that one is guaranteed to be able to perform transfers as well
-		auto& queue = device.GetQueueNativeOfType(VulkanQueueType::Graphics);
+		vkCmdCopyBuffer(command_buffer, host_visible_buffer.buffer, device_local_buffer.buffer, 1, &region);
+	}
 
-		// Execute the command
-		cmd_buffer.StopRecording();
-		cmd_buffer.Submit(queue);
-		vkQueueWaitIdle(queue);
+	//////////////////////////////////////////////////////////////////////////
 
-		cmd_buffer.Destroy(device, command_pool);
+	/** Copy data from a host visible buffer to a device local buffer, returns once the copy has finished */
+	inline void CopyHostVisibleBufferToDeviceLocalBuffer(
+		const VulkanDevice& device,
+		VulkanImmediateSubmitContext& immediate_submit,
+		const memory::VulkanBuffer& host_visible_buffer,
+		const memory::VulkanBuffer& device_local_buffer) noexcept(false)
+	{
+		immediate_submit.Execute(
+			device,
+			[&host_visible_buffer, &device_local_buffer](const VkCommandBuffer& command_buffer)
+			{
+				RecordBufferCopy(command_buffer, host_visible_buffer, device_local_buffer);
+			});
 	}
 
 	//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,156 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_image_state_tracker.hpp"
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+bool vkc::vk_wrapper::NeedsImageBarrier(const ImageSubresourceState& old_state, const ImageSubresourceState& new_state) noexcept(true)
+{
+	if (old_state.layout != new_state.layout || (new_state.access & write_access_mask) != 0)
+	{
+		return true;
+	}
+
+	return
+		(new_state.stages & ~old_state.visible_stages) != 0 ||
+		(new_state.access & ~old_state.visible_access) != 0;
+}
+
+void vkc::vk_wrapper::MergeImageSubresourceStates(ImageSubresourceState& state, const ImageSubresourceState& read_state) noexcept(true)
+{
+	state.stages |= read_state.stages;
+	state.access |= read_state.access;
+}
+
+ImageSubresourceState vkc::vk_wrapper::GetStateAfterImageBarrier(const ImageSubresourceState& old_state, const ImageSubresourceState& new_state) noexcept(true)
+{
+	ImageSubresourceState state = {};
+	state.layout = new_state.layout;
+	state.stages = new_state.stages;
+	state.access = new_state.access;
+
+	if ((new_state.access & write_access_mask) != 0)
+	{
+		// Nothing has seen the new write yet
+		state.write_stages = new_state.stages;
+		state.write_access = new_state.access & write_access_mask;
+	}
+	else
+	{
+		state.write_stages = old_state.write_stages;
+		state.write_access = old_state.write_access;
+		state.visible_stages = new_state.stages;
+		state.visible_access = new_state.access;
+
+		// Without a layout transition, the stages that have seen the write before still see it
+		if (old_state.layout == new_state.layout)
+		{
+			state.visible_stages |= old_state.visible_stages;
+			state.visible_access |= old_state.visible_access;
+		}
+	}
+
+	return state;
+}
+
+VkPipelineStageFlags vkc::vk_wrapper::GetBarrierSourceStageMask(const ImageSubresourceState& old_state) noexcept(true)
+{
+	return old_state.stages | old_state.write_stages;
+}
+
+VkAccessFlags vkc::vk_wrapper::GetBarrierSourceAccessMask(const ImageSubresourceState& old_state) noexcept(true)
+{
+	return old_state.write_access | (old_state.access & write_access_mask);
+}
+
+VulkanImageStateTracker::VulkanImageStateTracker() noexcept(true)
+{}
+
+VulkanImageStateTracker::~VulkanImageStateTracker() noexcept(true)
+{}
+
+void VulkanImageStateTracker::Track(
+	VkImage image,
+	std::uint32_t mip_level_count,
+	std::uint32_t array_layer_count,
+	VkImageAspectFlags aspect_mask,
+	const ImageSubresourceState& state) noexcept(false)
+{
+	if (mip_level_count == 0 || array_layer_count == 0)
+	{
+		throw CriticalVulkanError("Cannot track an image without any subresources.");
+	}
+
+	auto& tracked_image = m_images[image];
+	tracked_image.mip_level_count = mip_level_count;
+	tracked_image.array_layer_count = array_layer_count;
+	tracked_image.aspect_mask = aspect_mask;
+	tracked_image.states.assign(static_cast<std::size_t>(mip_level_count) * array_layer_count, state);
+}
+
+void VulkanImageStateTracker::Untrack(VkImage image) noexcept(true)
+{
+	m_images.erase(image);
+}
+
+void VulkanImageStateTracker::Clear() noexcept(true)
+{
+	m_images.clear();
+}
+
+bool VulkanImageStateTracker::IsTracked(VkImage image) const noexcept(true)
+{
+	return m_images.find(image) != m_images.end();
+}
+
+const ImageSubresourceState& VulkanImageStateTracker::GetState(
+	VkImage image,
+	std::uint32_t mip_level,
+	std::uint32_t array_layer) const noexcept(false)
+{
+	const auto& tracked_image = GetTrackedImage(image);
+
+	if (mip_level >= tracked_image.mip_level_count || array_layer >= tracked_image.array_layer_count)
+	{
+		throw CriticalVulkanError("Image subresource is out of range.");
+	}
+
+	return tracked_image.states[array_layer * tracked_image.mip_level_count + mip_level];
+}
+
+void VulkanImageStateTracker::SetState(
+	VkImage image,
+	std::uint32_t mip_level,
+	std::uint32_t array_layer,
+	const ImageSubresourceState& state) noexcept(false)
+{
+	const_cast<ImageSubresourceState&>(GetState(image, mip_level, array_layer)) = state;
+}
+
+std::uint32_t VulkanImageStateTracker::GetMipLevelCount(VkImage image) const noexcept(false)
+{
+	return GetTrackedImage(image).mip_level_count;
+}
+
+std::uint32_t VulkanImageStateTracker::GetArrayLayerCount(VkImage image) const noexcept(false)
+{
+	return GetTrackedImage(image).array_layer_count;
+}
+
+VkImageAspectFlags VulkanImageStateTracker::GetAspectMask(VkImage image) const noexcept(false)
+{
+	return GetTrackedImage(image).aspect_mask;
+}
+
+const VulkanImageStateTracker::TrackedImage& VulkanImageStateTracker::GetTrackedImage(VkImage image) const noexcept(false)
+{
+	auto tracked_image = m_images.find(image);
+
+	if (tracked_image == m_images.end())
+	{
+		throw CriticalVulkanError("Image is not tracked.");
+	}
+
+	return tracked_image->second;
+}
@@ -0,0 +1,204 @@
+#ifndef VULKAN_IMAGE_STATE_TRACKER_HPP
+#define VULKAN_IMAGE_STATE_TRACKER_HPP
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	/** Layout of an image subresource, and the pipeline stages and access of the commands that last used it */
+	/**
+	 * The states in "image_state" only describe how an image is about to be
+	 * used. Tracked states also remember the last write, and the stages and
+	 * access it has been made visible to, so a read by another stage in the
+	 * same layout still waits for the write.
+	 */
+	struct ImageSubresourceState
+	{
+		VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkPipelineStageFlags stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		VkAccessFlags access = 0;
+
+		/** Stages and access of the last write */
+		VkPipelineStageFlags write_stages = 0;
+		VkAccessFlags write_access = 0;
+
+		/** Stages and access the last write (and layout transition) has been made visible to by a barrier */
+		VkPipelineStageFlags visible_stages = 0;
+		VkAccessFlags visible_access = 0;
+	};
+
+	/** Access that makes the previous contents of an image unavailable to later commands */
+	static const constexpr VkAccessFlags write_access_mask =
+		VK_ACCESS_SHADER_WRITE_BIT |
+		VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_TRANSFER_WRITE_BIT |
+		VK_ACCESS_HOST_WRITE_BIT |
+		VK_ACCESS_MEMORY_WRITE_BIT;
+
+	/** Check whether moving an image subresource from one state to another needs a barrier */
+	/**
+	 * Layout transitions and writes always need a barrier. Reads in the
+	 * same layout only need one when the last write has not been made
+	 * visible to their stages or access yet, otherwise their stages and
+	 * access are merged into the current state instead (see
+	 * "MergeImageSubresourceStates") so that a later write waits for them.
+	 */
+	bool NeedsImageBarrier(const ImageSubresourceState& old_state, const ImageSubresourceState& new_state) noexcept(true);
+
+	/** Add the stages and access of a read that does not need a barrier to the current state */
+	void MergeImageSubresourceStates(ImageSubresourceState& state, const ImageSubresourceState& read_state) noexcept(true);
+
+	/** State of an image subresource once a barrier has moved it from one state to another */
+	ImageSubresourceState GetStateAfterImageBarrier(const ImageSubresourceState& old_state, const ImageSubresourceState& new_state) noexcept(true);
+
+	/** Source stage mask of a barrier, waits for every use since the last barrier and for the last write */
+	VkPipelineStageFlags GetBarrierSourceStageMask(const ImageSubresourceState& old_state) noexcept(true);
+
+	/** Source access mask of a barrier, only writes have to be made available, reads just need an execution dependency */
+	VkAccessFlags GetBarrierSourceAccessMask(const ImageSubresourceState& old_state) noexcept(true);
+
+	/** States of the most common image usages */
+	namespace image_state
+	{
+		/** Contents are discarded, used for images that have just been created */
+		static const constexpr ImageSubresourceState undefined = {
+			VK_IMAGE_LAYOUT_UNDEFINED,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			0
+		};
+
+		static const constexpr ImageSubresourceState transfer_source = {
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_ACCESS_TRANSFER_READ_BIT
+		};
+
+		static const constexpr ImageSubresourceState transfer_destination = {
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_ACCESS_TRANSFER_WRITE_BIT
+		};
+
+		static const constexpr ImageSubresourceState fragment_shader_read = {
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			VK_ACCESS_SHADER_READ_BIT
+		};
+
+		static const constexpr ImageSubresourceState compute_shader_read = {
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_ACCESS_SHADER_READ_BIT
+		};
+
+		static const constexpr ImageSubresourceState color_attachment = {
+			VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+		};
+
+		static const constexpr ImageSubresourceState depth_stencil_attachment = {
+			VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+		};
+
+		/** Presentation engine reads happen outside of the pipeline, the semaphores take care of the synchronization */
+		static const constexpr ImageSubresourceState present = {
+			VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+			VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+			0
+		};
+	}
+
+	/** Keeps track of the state of every subresource (mip level and array layer) of a set of images */
+	/**
+	 * The tracked state is the state the image will be in once every command
+	 * recorded so far has executed, not the state of the image on the device
+	 * right now. "VulkanBarrierBatcher" reads the current state to fill in the
+	 * source half of every barrier, and updates it to the new state.
+	 *
+	 * Images have to be tracked before they can be transitioned, and should
+	 * be untracked before they are destroyed (handles may be reused).
+	 */
+	class VulkanImageStateTracker
+	{
+	public:
+		VulkanImageStateTracker() noexcept(true);
+		~VulkanImageStateTracker() noexcept(true);
+
+		/** Start tracking an image, every subresource starts out in the same state */
+		/**
+		 * Tracking an image that is already tracked resets all of its
+		 * subresources to the specified state.
+		 */
+		void Track(
+			VkImage image,
+			std::uint32_t mip_level_count,
+			std::uint32_t array_layer_count,
+			VkImageAspectFlags aspect_mask,
+			const ImageSubresourceState& state = image_state::undefined) noexcept(false);
+
+		/** Stop tracking an image */
+		void Untrack(VkImage image) noexcept(true);
+
+		/** Stop tracking all images */
+		void Clear() noexcept(true);
+
+		/** Check whether an image is tracked */
+		bool IsTracked(VkImage image) const noexcept(true);
+
+		/** Get the state of a single subresource, throws when the image is not tracked */
+		const ImageSubresourceState& GetState(
+			VkImage image,
+			std::uint32_t mip_level,
+			std::uint32_t array_layer = 0) const noexcept(false);
+
+		/** Overwrite the state of a single subresource, throws when the image is not tracked */
+		/**
+		 * Only meant for transitions that happen outside of the barrier
+		 * batcher, such as the final layout of a render pass attachment.
+		 */
+		void SetState(
+			VkImage image,
+			std::uint32_t mip_level,
+			std::uint32_t array_layer,
+			const ImageSubresourceState& state) noexcept(false);
+
+		/** Get the number of mip levels of a tracked image, throws when the image is not tracked */
+		std::uint32_t GetMipLevelCount(VkImage image) const noexcept(false);
+
+		/** Get the number of array layers of a tracked image, throws when the image is not tracked */
+		std::uint32_t GetArrayLayerCount(VkImage image) const noexcept(false);
+
+		/** Get the aspects of a tracked image, throws when the image is not tracked */
+		VkImageAspectFlags GetAspectMask(VkImage image) const noexcept(false);
+
+	private:
+		struct TrackedImage
+		{
+			std::uint32_t mip_level_count = 1;
+			std::uint32_t array_layer_count = 1;
+			VkImageAspectFlags aspect_mask = VK_IMAGE_ASPECT_COLOR_BIT;
+
+			/** One state per subresource, all mip levels of the first array layer come first */
+			std::vector<ImageSubresourceState> states;
+		};
+
+	private:
+		/** Find a tracked image, throws when the image is not tracked */
+		const TrackedImage& GetTrackedImage(VkImage image) const noexcept(false);
+
+	private:
+		std::unordered_map<VkImage, TrackedImage> m_images;
+	};
+}
+
+#endif // VULKAN_IMAGE_STATE_TRACKER_HPP
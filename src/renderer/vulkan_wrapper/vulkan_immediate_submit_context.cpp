@@ -0,0 +1,180 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_immediate_submit_context.hpp"
+
+// C++ standard
+#include <limits>
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+VulkanImmediateSubmitContext::VulkanImmediateSubmitContext() noexcept(true)
+	: m_queue(VK_NULL_HANDLE)
+	, m_next_submission(1)
+	, m_next_command_buffer(0)
+	, m_recording_command_buffer(0)
+	, m_is_recording(false)
+{}
+
+VulkanImmediateSubmitContext::~VulkanImmediateSubmitContext() noexcept(true)
+{}
+
+void VulkanImmediateSubmitContext::Create(
+	const VulkanDevice& device,
+	CommandPoolType type,
+	std::uint32_t command_buffer_count) noexcept(false)
+{
+	if (command_buffer_count == 0)
+	{
+		throw CriticalVulkanError("The immediate submit context needs at least one command buffer.");
+	}
+
+	// Command buffers are short-lived and reset individually
+	m_command_pool.Create(device, type, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+	m_command_buffers.Create(device, m_command_pool, command_buffer_count);
+
+	// Signaled on creation, command buffers that were never submitted do not have to be waited on
+	VkFenceCreateInfo fence_create_info = {};
+	fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	fence_create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+	m_fences.resize(command_buffer_count, VK_NULL_HANDLE);
+	m_submissions.resize(command_buffer_count, 0);
+
+	for (auto& fence : m_fences)
+	{
+		if (vkCreateFence(device.GetLogicalDeviceNative(), &fence_create_info, nullptr, &fence) != VK_SUCCESS)
+		{
+			throw CriticalVulkanError("Could not create the fences of the immediate submit context.");
+		}
+	}
+
+	m_queue = device.GetQueueNativeOfType((type == CommandPoolType::Compute) ? VulkanQueueType::Compute : VulkanQueueType::Graphics);
+}
+
+void VulkanImmediateSubmitContext::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	WaitIdle(device);
+
+	for (auto fence : m_fences)
+	{
+		vkDestroyFence(device.GetLogicalDeviceNative(), fence, nullptr);
+	}
+
+	m_fences.clear();
+	m_submissions.clear();
+
+	m_command_buffers.Destroy(device, m_command_pool);
+	m_command_pool.Destroy(device);
+
+	m_is_recording = false;
+}
+
+const VkCommandBuffer& VulkanImmediateSubmitContext::Begin(const VulkanDevice& device) noexcept(false)
+{
+	if (m_is_recording)
+	{
+		throw CriticalVulkanError("The immediate submit context is already recording, submit the previous operations first.");
+	}
+
+	// Command buffers are used in order, so this is the oldest submission
+	m_recording_command_buffer = m_next_command_buffer;
+	m_next_command_buffer = (m_next_command_buffer + 1) % static_cast<std::uint32_t>(m_fences.size());
+
+	vkWaitForFences(device.GetLogicalDeviceNative(), 1, &m_fences[m_recording_command_buffer], VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+
+	// Implicitly resets the command buffer
+	m_command_buffers.BeginRecording(m_recording_command_buffer, CommandBufferUsage::OneTimeSubmit);
+	m_is_recording = true;
+
+	return m_command_buffers.GetNative(m_recording_command_buffer);
+}
+
+ImmediateSubmission VulkanImmediateSubmitContext::Submit(const VulkanDevice& device, bool wait_for_completion) noexcept(false)
+{
+	if (!m_is_recording)
+	{
+		throw CriticalVulkanError("The immediate submit context is not recording, call \"Begin\" first.");
+	}
+
+	m_is_recording = false;
+	m_command_buffers.StopRecording(m_recording_command_buffer);
+
+	VkSubmitInfo submit_info = {};
+	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers = &m_command_buffers.GetNative(m_recording_command_buffer);
+
+	auto& fence = m_fences[m_recording_command_buffer];
+	vkResetFences(device.GetLogicalDeviceNative(), 1, &fence);
+
+	if (vkQueueSubmit(m_queue, 1, &submit_info, fence) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not submit the immediate submit context.");
+	}
+
+	auto submission = m_next_submission++;
+	m_submissions[m_recording_command_buffer] = submission;
+
+	if (wait_for_completion)
+	{
+		vkWaitForFences(device.GetLogicalDeviceNative(), 1, &fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+	}
+
+	return submission;
+}
+
+void VulkanImmediateSubmitContext::Execute(
+	const VulkanDevice& device,
+	const std::function<void(const VkCommandBuffer&)>& record) noexcept(false)
+{
+	record(Begin(device));
+	Submit(device, true);
+}
+
+void VulkanImmediateSubmitContext::Wait(const VulkanDevice& device, ImmediateSubmission submission) noexcept(true)
+{
+	auto command_buffer_index = FindCommandBuffer(submission);
+
+	// The command buffer has been reused, so the submission finished long ago
+	if (command_buffer_index == m_fences.size())
+	{
+		return;
+	}
+
+	vkWaitForFences(device.GetLogicalDeviceNative(), 1, &m_fences[command_buffer_index], VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+}
+
+void VulkanImmediateSubmitContext::WaitIdle(const VulkanDevice& device) noexcept(true)
+{
+	if (m_fences.empty())
+	{
+		return;
+	}
+
+	vkWaitForFences(
+		device.GetLogicalDeviceNative(),
+		static_cast<std::uint32_t>(m_fences.size()),
+		m_fences.data(),
+		VK_TRUE,
+		std::numeric_limits<std::uint64_t>::max());
+}
+
+bool VulkanImmediateSubmitContext::IsRecording() const noexcept(true)
+{
+	return m_is_recording;
+}
+
+std::uint32_t VulkanImmediateSubmitContext::FindCommandBuffer(ImmediateSubmission submission) const noexcept(true)
+{
+	for (std::uint32_t index = 0; index < static_cast<std::uint32_t>(m_submissions.size()); ++index)
+	{
+		if (m_submissions[index] == submission)
+		{
+			return index;
+		}
+	}
+
+	return static_cast<std::uint32_t>(m_submissions.size());
+}
@@ -0,0 +1,98 @@
+#ifndef VULKAN_IMMEDIATE_SUBMIT_CONTEXT_HPP
+#define VULKAN_IMMEDIATE_SUBMIT_CONTEXT_HPP
+
+// Application
+#include "vulkan_command_buffer.hpp"
+#include "vulkan_command_pool.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	class VulkanDevice;
+
+	/** Identifies a submission of the immediate submit context, used to wait for it later on */
+	using ImmediateSubmission = std::uint64_t;
+
+	/** Executes one-off GPU work (uploads, layout transitions) outside of the frame command buffers */
+	/**
+	 * A small ring of command buffers is allocated once and reset between
+	 * uses, every command buffer has its own fence. Waiting only waits for the
+	 * fence of the submission, other work on the queue keeps running.
+	 *
+	 * Any number of operations can be recorded between "Begin" and "Submit",
+	 * they are executed with a single submission. When all command buffers
+	 * are in flight, "Begin" waits for the oldest one.
+	 *
+	 * Not thread-safe, only use the context from the thread that owns it.
+	 */
+	class VulkanImmediateSubmitContext
+	{
+	public:
+		VulkanImmediateSubmitContext() noexcept(true);
+		~VulkanImmediateSubmitContext() noexcept(true);
+
+		/** Create the command pool, command buffers, and fences */
+		void Create(
+			const VulkanDevice& device,
+			CommandPoolType type,
+			std::uint32_t command_buffer_count) noexcept(false);
+
+		/** Wait for all submissions and destroy all Vulkan objects */
+		void Destroy(const VulkanDevice& device) noexcept(true);
+
+		/** Start recording a command buffer, returns the command buffer to record the operations into */
+		const VkCommandBuffer& Begin(const VulkanDevice& device) noexcept(false);
+
+		/** Submit the command buffer that is being recorded, and optionally wait until it finishes executing */
+		/**
+		 * Resources used by the commands (e.g. staging buffers) have to stay
+		 * alive until the submission finishes, use "Wait" when not waiting
+		 * right away.
+		 */
+		ImmediateSubmission Submit(const VulkanDevice& device, bool wait_for_completion = true) noexcept(false);
+
+		/** Record the operations of the callback and execute them right away, returns once they finish executing */
+		void Execute(
+			const VulkanDevice& device,
+			const std::function<void(const VkCommandBuffer&)>& record) noexcept(false);
+
+		/** Wait until a submission finishes executing, returns immediately when it already has */
+		void Wait(const VulkanDevice& device, ImmediateSubmission submission) noexcept(true);
+
+		/** Wait until every submission finishes executing */
+		void WaitIdle(const VulkanDevice& device) noexcept(true);
+
+		/** Check whether a command buffer is being recorded */
+		bool IsRecording() const noexcept(true);
+
+	private:
+		/** Find the index of the command buffer that carries a submission, or the count when it has been reused */
+		std::uint32_t FindCommandBuffer(ImmediateSubmission submission) const noexcept(true);
+
+	private:
+		VulkanCommandPool m_command_pool;
+		VulkanCommandBuffer m_command_buffers;
+
+		/** Signaled once the last submission of the command buffer at the same index finishes */
+		std::vector<VkFence> m_fences;
+
+		/** Last submission of the command buffer at the same index, zero when it was never submitted */
+		std::vector<ImmediateSubmission> m_submissions;
+
+		VkQueue m_queue;
+
+		ImmediateSubmission m_next_submission;
+		std::uint32_t m_next_command_buffer;
+		std::uint32_t m_recording_command_buffer;
+		bool m_is_recording;
+	};
+}
+
+#endif // VULKAN_IMMEDIATE_SUBMIT_CONTEXT_HPP
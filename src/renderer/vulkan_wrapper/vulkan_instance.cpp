@@ -42,7 +42,7 @@ void VulkanInstance::Create(
 	app_info.applicationVersion	= app_version_number;
 	app_info.pEngineName		= engine_name.c_str();
 	app_info.engineVersion		= engine_version_number;
-	app_info.apiVersion			= VK_API_VERSION_1_0;
+	app_info.apiVersion			= VK_API_VERSION_1_1;
 
 	std::vector<std::string> available_extension_names;
 	std::vector<std::string> available_layer_names;
@@ -0,0 +1,77 @@
+// Application
+#include "vulkan_instance_buffer.hpp"
+
+// C++ standard
+#include <algorithm>
+
+using namespace vkc::memory;
+using namespace vkc::vk_wrapper;
+
+VulkanInstanceBuffer::VulkanInstanceBuffer() noexcept(true)
+{}
+
+VulkanInstanceBuffer::~VulkanInstanceBuffer() noexcept(true)
+{}
+
+void VulkanInstanceBuffer::Create(std::uint32_t frame_count, VkDeviceSize initial_size) noexcept(false)
+{
+	m_buffers.clear();
+	m_buffer_sizes.assign(frame_count, initial_size);
+
+	for (std::uint32_t index = 0; index < frame_count; ++index)
+	{
+		m_buffers.push_back(AllocateBuffer(initial_size));
+	}
+}
+
+void VulkanInstanceBuffer::Destroy() noexcept(true)
+{
+	for (const auto& buffer : m_buffers)
+	{
+		MemoryManager::GetInstance().Free(buffer);
+	}
+
+	m_buffers.clear();
+	m_buffer_sizes.clear();
+}
+
+const VkBuffer& VulkanInstanceBuffer::GetNative(std::uint32_t frame_index) const noexcept(true)
+{
+	return m_buffers[frame_index].buffer;
+}
+
+void VulkanInstanceBuffer::Reserve(std::uint32_t frame_index, VkDeviceSize size) noexcept(false)
+{
+	if (size <= m_buffer_sizes[frame_index])
+	{
+		return;
+	}
+
+	auto new_size = std::max<VkDeviceSize>(m_buffer_sizes[frame_index], 1);
+
+	while (new_size < size)
+	{
+		new_size *= 2;
+	}
+
+	// The fence of this frame has been waited on, so the old buffer is not in use anymore
+	MemoryManager::GetInstance().Free(m_buffers[frame_index]);
+
+	m_buffers[frame_index] = AllocateBuffer(new_size);
+	m_buffer_sizes[frame_index] = new_size;
+}
+
+VulkanBuffer VulkanInstanceBuffer::AllocateBuffer(VkDeviceSize size) noexcept(false)
+{
+	BufferAllocationInfo buffer_alloc_info = {};
+	buffer_alloc_info.buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_alloc_info.buffer_create_info.size = size;
+	buffer_alloc_info.buffer_create_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+	buffer_alloc_info.buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	buffer_alloc_info.allocation_info.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+	buffer_alloc_info.allocation_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+	buffer_alloc_info.allocation_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+	return MemoryManager::GetInstance().Allocate(buffer_alloc_info);
+}
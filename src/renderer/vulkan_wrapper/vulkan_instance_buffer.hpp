@@ -0,0 +1,72 @@
+#ifndef VULKAN_INSTANCE_BUFFER_HPP
+#define VULKAN_INSTANCE_BUFFER_HPP
+
+// Application
+#include "renderer/memory_manager/memory_manager.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	/** Host-visible vertex buffer for per-instance data that is rewritten every frame */
+	/**
+	 * Every in-flight frame gets its own persistently mapped buffer, so data
+	 * can be written as soon as the fence of the frame has been waited on.
+	 * Buffers grow (doubling in size) when a frame needs more room, they
+	 * never shrink.
+	 */
+	class VulkanInstanceBuffer
+	{
+	public:
+		VulkanInstanceBuffer() noexcept(true);
+		~VulkanInstanceBuffer() noexcept(true);
+
+		/** Create a buffer for every in-flight frame, each with room for "initial_size" bytes */
+		void Create(std::uint32_t frame_count, VkDeviceSize initial_size) noexcept(false);
+
+		/** Free the buffers of all frames */
+		void Destroy() noexcept(true);
+
+		/** Replace the instance data of a frame */
+		template<class INSTANCE>
+		void Update(std::uint32_t frame_index, const std::vector<INSTANCE>& instances) noexcept(false);
+
+		/** Get a reference to the underlaying Vulkan buffer object of a frame */
+		const VkBuffer& GetNative(std::uint32_t frame_index) const noexcept(true);
+
+	private:
+		/** Make sure the buffer of a frame can hold at least "size" bytes */
+		void Reserve(std::uint32_t frame_index, VkDeviceSize size) noexcept(false);
+
+		/** Allocate a persistently mapped buffer of the specified size */
+		static memory::VulkanBuffer AllocateBuffer(VkDeviceSize size) noexcept(false);
+
+	private:
+		std::vector<memory::VulkanBuffer> m_buffers;
+		std::vector<VkDeviceSize> m_buffer_sizes;
+	};
+
+	template<class INSTANCE>
+	inline void VulkanInstanceBuffer::Update(std::uint32_t frame_index, const std::vector<INSTANCE>& instances) noexcept(false)
+	{
+		const VkDeviceSize size = sizeof(INSTANCE) * instances.size();
+
+		if (size == 0)
+		{
+			return;
+		}
+
+		Reserve(frame_index, size);
+
+		// Memory is host-coherent, no flush needed
+		memcpy(m_buffers[frame_index].info.pMappedData, instances.data(), static_cast<size_t>(size));
+	}
+}
+
+#endif // VULKAN_INSTANCE_BUFFER_HPP
@@ -0,0 +1,246 @@
+// Application
+#include "core/hash.hpp"
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_layout_cache.hpp"
+
+// C++ standard
+#include <algorithm>
+
+using namespace vkc::core;
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+namespace
+{
+	/** Bindings are hashed and compared after sorting, the order in which shaders declare them does not matter */
+	std::vector<VkDescriptorSetLayoutBinding> SortBindings(std::vector<VkDescriptorSetLayoutBinding> bindings) noexcept(true)
+	{
+		std::sort(
+			bindings.begin(),
+			bindings.end(),
+			[](const VkDescriptorSetLayoutBinding& lhs, const VkDescriptorSetLayoutBinding& rhs)
+			{
+				return lhs.binding < rhs.binding;
+			});
+
+		return bindings;
+	}
+
+	bool AreBindingsEqual(const VkDescriptorSetLayoutBinding& lhs, const VkDescriptorSetLayoutBinding& rhs) noexcept(true)
+	{
+		return
+			lhs.binding == rhs.binding &&
+			lhs.descriptorType == rhs.descriptorType &&
+			lhs.descriptorCount == rhs.descriptorCount &&
+			lhs.stageFlags == rhs.stageFlags &&
+			lhs.pImmutableSamplers == rhs.pImmutableSamplers;
+	}
+
+	bool ArePushConstantRangesEqual(const VkPushConstantRange& lhs, const VkPushConstantRange& rhs) noexcept(true)
+	{
+		return
+			lhs.stageFlags == rhs.stageFlags &&
+			lhs.offset == rhs.offset &&
+			lhs.size == rhs.size;
+	}
+}
+
+void VulkanLayoutCache::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_layouts_mutex);
+
+	for (const auto& [set_layout, update_template] : m_update_templates)
+	{
+		update_template.Destroy(device);
+	}
+
+	// Pipeline layouts reference the descriptor set layouts, destroy them first
+	for (const auto& [hash, cached_layout] : m_pipeline_layouts)
+	{
+		vkDestroyPipelineLayout(device.GetLogicalDeviceNative(), cached_layout.layout, nullptr);
+	}
+
+	for (const auto& [hash, cached_layout] : m_descriptor_set_layouts)
+	{
+		vkDestroyDescriptorSetLayout(device.GetLogicalDeviceNative(), cached_layout.layout, nullptr);
+	}
+
+	m_update_templates.clear();
+	m_pipeline_layouts.clear();
+	m_descriptor_set_layouts.clear();
+}
+
+VkDescriptorSetLayout VulkanLayoutCache::GetDescriptorSetLayout(
+	const VulkanDevice& device,
+	const std::vector<VkDescriptorSetLayoutBinding>& bindings) noexcept(false)
+{
+	const auto sorted_bindings = SortBindings(bindings);
+
+	auto hash = fnv1a_offset_basis;
+
+	for (const auto& binding : sorted_bindings)
+	{
+		HashCombine(hash, binding.binding);
+		HashCombine(hash, static_cast<std::uint32_t>(binding.descriptorType));
+		HashCombine(hash, binding.descriptorCount);
+		HashCombine(hash, binding.stageFlags);
+	}
+
+	std::lock_guard<std::mutex> lock(m_layouts_mutex);
+
+	auto [first, last] = m_descriptor_set_layouts.equal_range(hash);
+
+	for (auto it = first; it != last; ++it)
+	{
+		if (std::equal(
+			sorted_bindings.begin(), sorted_bindings.end(),
+			it->second.bindings.begin(), it->second.bindings.end(),
+			AreBindingsEqual))
+		{
+			return it->second.layout;
+		}
+	}
+
+	VkDescriptorSetLayoutCreateInfo layout_info = {};
+	layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layout_info.bindingCount = static_cast<std::uint32_t>(sorted_bindings.size());
+	layout_info.pBindings = sorted_bindings.data();
+
+	CachedDescriptorSetLayout cached_layout = {};
+	cached_layout.bindings = sorted_bindings;
+
+	if (vkCreateDescriptorSetLayout(device.GetLogicalDeviceNative(), &layout_info, nullptr, &cached_layout.layout) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create a descriptor set layout.");
+	}
+
+	m_descriptor_set_layouts.emplace(hash, cached_layout);
+
+	return cached_layout.layout;
+}
+
+std::vector<VkDescriptorSetLayout> VulkanLayoutCache::GetDescriptorSetLayouts(
+	const VulkanDevice& device,
+	const ShaderReflection& reflection) noexcept(false)
+{
+	std::vector<VkDescriptorSetLayout> set_layouts;
+
+	for (std::uint32_t set = 0; set < GetDescriptorSetCount(reflection); ++set)
+	{
+		set_layouts.push_back(GetDescriptorSetLayout(device, GetDescriptorSetLayoutBindings(reflection, set)));
+	}
+
+	return set_layouts;
+}
+
+VkPipelineLayout VulkanLayoutCache::GetPipelineLayout(
+	const VulkanDevice& device,
+	const std::vector<VkDescriptorSetLayout>& set_layouts,
+	const std::vector<VkPushConstantRange>& push_constant_ranges) noexcept(false)
+{
+	auto hash = fnv1a_offset_basis;
+
+	for (const auto& set_layout : set_layouts)
+	{
+		HashCombine(hash, set_layout);
+	}
+
+	for (const auto& range : push_constant_ranges)
+	{
+		HashCombine(hash, range.stageFlags);
+		HashCombine(hash, range.offset);
+		HashCombine(hash, range.size);
+	}
+
+	std::lock_guard<std::mutex> lock(m_layouts_mutex);
+
+	auto [first, last] = m_pipeline_layouts.equal_range(hash);
+
+	for (auto it = first; it != last; ++it)
+	{
+		if (it->second.set_layouts == set_layouts &&
+			std::equal(
+				push_constant_ranges.begin(), push_constant_ranges.end(),
+				it->second.push_constant_ranges.begin(), it->second.push_constant_ranges.end(),
+				ArePushConstantRangesEqual))
+		{
+			return it->second.layout;
+		}
+	}
+
+	// Every device supports at least 128 bytes, anything beyond that is not portable
+	VkPhysicalDeviceProperties device_properties = {};
+	vkGetPhysicalDeviceProperties(device.GetPhysicalDeviceNative(), &device_properties);
+
+	for (const auto& range : push_constant_ranges)
+	{
+		if (range.offset + range.size > device_properties.limits.maxPushConstantsSize)
+		{
+			throw CriticalVulkanError("Push constant range exceeds the maximum push constant size of the device.");
+		}
+	}
+
+	VkPipelineLayoutCreateInfo layout_info = {};
+	layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	layout_info.setLayoutCount = static_cast<std::uint32_t>(set_layouts.size());
+	layout_info.pSetLayouts = set_layouts.data();
+	layout_info.pushConstantRangeCount = static_cast<std::uint32_t>(push_constant_ranges.size());
+	layout_info.pPushConstantRanges = push_constant_ranges.data();
+
+	CachedPipelineLayout cached_layout = {};
+	cached_layout.set_layouts = set_layouts;
+	cached_layout.push_constant_ranges = push_constant_ranges;
+
+	if (vkCreatePipelineLayout(device.GetLogicalDeviceNative(), &layout_info, nullptr, &cached_layout.layout) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create a pipeline layout.");
+	}
+
+	m_pipeline_layouts.emplace(hash, cached_layout);
+
+	return cached_layout.layout;
+}
+
+VkPipelineLayout VulkanLayoutCache::GetPipelineLayout(
+	const VulkanDevice& device,
+	const ShaderReflection& reflection) noexcept(false)
+{
+	return GetPipelineLayout(
+		device,
+		GetDescriptorSetLayouts(device, reflection),
+		reflection.push_constant_ranges);
+}
+
+const VulkanDescriptorUpdateTemplate& VulkanLayoutCache::GetUpdateTemplate(
+	const VulkanDevice& device,
+	VkDescriptorSetLayout set_layout) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_layouts_mutex);
+
+	auto existing_template = m_update_templates.find(set_layout);
+
+	if (existing_template != m_update_templates.end())
+	{
+		return existing_template->second;
+	}
+
+	// The bindings the layout was created with describe the template entries
+	auto cached_layout = std::find_if(
+		m_descriptor_set_layouts.begin(),
+		m_descriptor_set_layouts.end(),
+		[set_layout](const auto& entry)
+		{
+			return entry.second.layout == set_layout;
+		});
+
+	if (cached_layout == m_descriptor_set_layouts.end())
+	{
+		throw CriticalVulkanError("Cannot create an update template for a descriptor set layout that is not in the layout cache.");
+	}
+
+	VulkanDescriptorUpdateTemplate update_template;
+	update_template.Create(device, set_layout, cached_layout->second.bindings);
+
+	return m_update_templates.emplace(set_layout, update_template).first->second;
+}
@@ -0,0 +1,103 @@
+#ifndef VULKAN_LAYOUT_CACHE_HPP
+#define VULKAN_LAYOUT_CACHE_HPP
+
+// Application
+#include "vulkan_descriptor_update_template.hpp"
+#include "vulkan_shader_reflection.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	// Forward declarations
+	class VulkanDevice;
+
+	/** Creates descriptor set layouts and pipeline layouts, identical layouts are only created once */
+	/**
+	 * Layouts are looked up by a hash of their create info contents, shaders
+	 * that declare the same resources end up with the same Vulkan objects,
+	 * which also keeps their descriptor sets compatible with each other.
+	 *
+	 * The cache owns every layout it hands out, do not destroy them manually.
+	 * All functions are thread-safe.
+	 */
+	class VulkanLayoutCache
+	{
+	public:
+		VulkanLayoutCache() noexcept(true) {}
+		~VulkanLayoutCache() noexcept(true) {}
+
+		/** Destroy all cached layouts and update templates */
+		void Destroy(const VulkanDevice& device) noexcept(true);
+
+		/** Get a descriptor set layout with the specified bindings */
+		VkDescriptorSetLayout GetDescriptorSetLayout(
+			const VulkanDevice& device,
+			const std::vector<VkDescriptorSetLayoutBinding>& bindings) noexcept(false);
+
+		/** Get a descriptor set layout for every set used by the shader reflection data */
+		/**
+		 * Sets that are not used by any shader stage (but come before a set
+		 * that is used) get an empty layout, so the index into the returned
+		 * vector always matches the set number.
+		 */
+		std::vector<VkDescriptorSetLayout> GetDescriptorSetLayouts(
+			const VulkanDevice& device,
+			const ShaderReflection& reflection) noexcept(false);
+
+		/** Get a pipeline layout with the specified descriptor set layouts and push constant ranges */
+		/**
+		 * Throws when a push constant range does not fit in the push constant
+		 * memory of the device.
+		 */
+		VkPipelineLayout GetPipelineLayout(
+			const VulkanDevice& device,
+			const std::vector<VkDescriptorSetLayout>& set_layouts,
+			const std::vector<VkPushConstantRange>& push_constant_ranges) noexcept(false);
+
+		/** Get a pipeline layout that matches the shader reflection data */
+		VkPipelineLayout GetPipelineLayout(
+			const VulkanDevice& device,
+			const ShaderReflection& reflection) noexcept(false);
+
+		/** Get an update template that writes every binding of a descriptor set layout created by this cache */
+		/**
+		 * Templates are created on first use. Throws when the layout did not
+		 * come from this cache.
+		 */
+		const VulkanDescriptorUpdateTemplate& GetUpdateTemplate(
+			const VulkanDevice& device,
+			VkDescriptorSetLayout set_layout) noexcept(false);
+
+	private:
+		/** Layouts with the same hash, the create info contents are compared to resolve collisions */
+		struct CachedDescriptorSetLayout
+		{
+			std::vector<VkDescriptorSetLayoutBinding> bindings;
+			VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+		};
+
+		struct CachedPipelineLayout
+		{
+			std::vector<VkDescriptorSetLayout> set_layouts;
+			std::vector<VkPushConstantRange> push_constant_ranges;
+			VkPipelineLayout layout = VK_NULL_HANDLE;
+		};
+
+	private:
+		std::unordered_multimap<std::uint64_t, CachedDescriptorSetLayout> m_descriptor_set_layouts;
+		std::unordered_multimap<std::uint64_t, CachedPipelineLayout> m_pipeline_layouts;
+		std::unordered_map<VkDescriptorSetLayout, VulkanDescriptorUpdateTemplate> m_update_templates;
+
+		std::mutex m_layouts_mutex;
+	};
+}
+
+#endif // VULKAN_LAYOUT_CACHE_HPP
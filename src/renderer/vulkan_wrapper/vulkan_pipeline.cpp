@@ -4,6 +4,13 @@
 #include "vulkan_device.hpp"
 #include "vulkan_pipeline.hpp"
 
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <algorithm>
+#include <cstring>
+
 using namespace vkc::core;
 using namespace vkc::exception;
 using namespace vkc::vk_wrapper;
@@ -16,21 +23,37 @@ void VulkanPipeline::Create(
 	PipelineType type,
 	VkPipelineLayout layout,
 	VkRenderPass render_pass,
-	const std::vector<std::pair<std::string, ShaderType>>& shader_files) noexcept(false)
+	const std::vector<std::pair<std::string, ShaderType>>& shader_files,
+	VkPipelineCache pipeline_cache) noexcept(false)
 {
 	// Create a shader out of the specified shader source files
 	VulkanShader shader;
 	shader.Create(device, shader_files);
 
+	Create(device, pipeline_info, type, layout, render_pass, shader, pipeline_cache);
+
+	// No need to keep the shader around after the pipeline has been created
+	shader.Destroy(device);
+}
+
+void VulkanPipeline::Create(
+	const VulkanDevice& device,
+	const VulkanPipelineInfo* const pipeline_info,
+	PipelineType type,
+	VkPipelineLayout layout,
+	VkRenderPass render_pass,
+	const VulkanShader& shader,
+	VkPipelineCache pipeline_cache) noexcept(false)
+{
 	// Create a pipeline based on the specified pipeline type
 	switch (type)
 	{
 		case PipelineType::Graphics:
-			CreateGraphicsPipeline(layout, render_pass, device, shader, pipeline_info);
+			CreateGraphicsPipeline(layout, render_pass, device, shader, pipeline_info, pipeline_cache);
 			break;
 
 		case PipelineType::Compute:
-			CreateComputePipeline(pipeline_info);
+			CreateComputePipeline(layout, device, shader, pipeline_info, pipeline_cache);
 			break;
 
 		case PipelineType::RayTracing_NV:
@@ -41,9 +64,6 @@ void VulkanPipeline::Create(
 			throw CriticalVulkanError("Invalid pipeline type specified.");
 			break;
 	}
-
-	// No need to keep the shader around after the pipeline has been created
-	shader.Destroy(device);
 }
 
 const VkPipeline& VulkanPipeline::GetNative() const noexcept(true)
@@ -51,6 +71,11 @@ const VkPipeline& VulkanPipeline::GetNative() const noexcept(true)
 	return m_pipeline;
 }
 
+const std::array<std::uint32_t, 3>& VulkanPipeline::GetLocalSize() const noexcept(true)
+{
+	return m_local_size;
+}
+
 void VulkanPipeline::Destroy(const VulkanDevice& device) const noexcept(true)
 {
 	vkDestroyPipeline(device.GetLogicalDeviceNative(), m_pipeline, nullptr);
@@ -61,7 +86,8 @@ void VulkanPipeline::CreateGraphicsPipeline(
 	VkRenderPass render_pass,
 	const VulkanDevice& device,
 	const VulkanShader& shader,
-	const VulkanPipelineInfo* const pipeline_info) noexcept(false)
+	const VulkanPipelineInfo* const pipeline_info,
+	VkPipelineCache pipeline_cache) noexcept(false)
 {
 	const VulkanGraphicsPipelineInfo *graphics_pipeline_info = dynamic_cast<const VulkanGraphicsPipelineInfo *>(pipeline_info);
 	if (!graphics_pipeline_info)
@@ -69,6 +95,30 @@ void VulkanPipeline::CreateGraphicsPipeline(
 		throw CriticalVulkanError("Invalid pipeline info specified.");
 	}
 
+	// Every vertex shader input needs a matching vertex attribute
+	for (const auto& vertex_input : shader.GetReflection().vertex_inputs)
+	{
+		auto attribute = std::find_if(
+			graphics_pipeline_info->vertex_attribute_descs.begin(),
+			graphics_pipeline_info->vertex_attribute_descs.end(),
+			[&vertex_input](const VkVertexInputAttributeDescription& attribute_desc)
+			{
+				return attribute_desc.location == vertex_input.location;
+			});
+
+		if (attribute == graphics_pipeline_info->vertex_attribute_descs.end())
+		{
+			spdlog::error("Vertex shader input \"{}\" at location {} has no vertex attribute.", vertex_input.name, vertex_input.location);
+			throw CriticalVulkanError("Vertex attributes do not match the vertex shader inputs.");
+		}
+
+		// Attributes with fewer components than the input are allowed, the missing components get default values
+		if (attribute->format != vertex_input.format)
+		{
+			spdlog::warn("Vertex shader input \"{}\" at location {} does not match the format of its vertex attribute.", vertex_input.name, vertex_input.location);
+		}
+	}
+
 	VkPipelineVertexInputStateCreateInfo vertex_input_state = {};
 	vertex_input_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 	vertex_input_state.vertexBindingDescriptionCount = static_cast<std::uint32_t>(
@@ -107,10 +157,20 @@ void VulkanPipeline::CreateGraphicsPipeline(
 	VkPipelineMultisampleStateCreateInfo multisample_state = {};
 	multisample_state.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
 	multisample_state.sampleShadingEnable = VK_FALSE;
-	multisample_state.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+	multisample_state.rasterizationSamples = graphics_pipeline_info->sample_count;
+
+	VkPipelineDepthStencilStateCreateInfo depth_stencil_state = {};
+	depth_stencil_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depth_stencil_state.depthTestEnable = graphics_pipeline_info->enable_depth_test;
+	depth_stencil_state.depthWriteEnable = graphics_pipeline_info->enable_depth_write;
+	depth_stencil_state.depthCompareOp = static_cast<VkCompareOp>(
+		graphics_pipeline_info->depth_compare_operation);
+	depth_stencil_state.depthBoundsTestEnable = VK_FALSE;
+	depth_stencil_state.stencilTestEnable = VK_FALSE;
 
+	// Depth-only pipelines still need a blend state for every color attachment of the subpass
 	VkPipelineColorBlendAttachmentState color_blend_attachment = {};
-	color_blend_attachment.colorWriteMask =
+	color_blend_attachment.colorWriteMask = graphics_pipeline_info->depth_only ? 0 :
 		VK_COLOR_COMPONENT_R_BIT |
 		VK_COLOR_COMPONENT_G_BIT |
 		VK_COLOR_COMPONENT_B_BIT |
@@ -123,16 +183,42 @@ void VulkanPipeline::CreateGraphicsPipeline(
 	color_blend_state.attachmentCount = 1;
 	color_blend_state.pAttachments = &color_blend_attachment;
 
+	// Every stage gets the same specialization constants, stages that do not declare a constant ignore it
+	const auto specialization_info = graphics_pipeline_info->GetSpecializationInfo();
+	auto stage_infos = shader.GetPipelineShaderStageInfos();
+
+	// Without a fragment stage only the depth is written, the vertex stage is shared with the regular pipeline
+	if (graphics_pipeline_info->depth_only)
+	{
+		stage_infos.erase(
+			std::remove_if(
+				stage_infos.begin(),
+				stage_infos.end(),
+				[](const VkPipelineShaderStageCreateInfo& stage_info)
+				{
+					return stage_info.stage == VK_SHADER_STAGE_FRAGMENT_BIT;
+				}),
+			stage_infos.end());
+	}
+
+	if (!graphics_pipeline_info->specialization_map_entries.empty())
+	{
+		for (auto& stage_info : stage_infos)
+		{
+			stage_info.pSpecializationInfo = &specialization_info;
+		}
+	}
+
 	VkGraphicsPipelineCreateInfo pipeline_create_info = {};
 	pipeline_create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-	pipeline_create_info.stageCount = static_cast<std::uint32_t>(
-		shader.GetPipelineShaderStageInfos().size());
-	pipeline_create_info.pStages = shader.GetPipelineShaderStageInfos().data();
+	pipeline_create_info.stageCount = static_cast<std::uint32_t>(stage_infos.size());
+	pipeline_create_info.pStages = stage_infos.data();
 	pipeline_create_info.pVertexInputState = &vertex_input_state;
 	pipeline_create_info.pInputAssemblyState = &input_assembly_state;
 	pipeline_create_info.pViewportState = &viewport_state;
 	pipeline_create_info.pRasterizationState = &rasterization_state;
 	pipeline_create_info.pMultisampleState = &multisample_state;
+	pipeline_create_info.pDepthStencilState = &depth_stencil_state;
 	pipeline_create_info.pColorBlendState = &color_blend_state;
 	pipeline_create_info.layout = layout;
 	pipeline_create_info.renderPass = render_pass;
@@ -140,7 +226,7 @@ void VulkanPipeline::CreateGraphicsPipeline(
 
 	auto result = vkCreateGraphicsPipelines(
 		device.GetLogicalDeviceNative(),
-		VK_NULL_HANDLE,
+		pipeline_cache,
 		1,
 		&pipeline_create_info,
 		nullptr,
@@ -153,13 +239,116 @@ void VulkanPipeline::CreateGraphicsPipeline(
 }
 
 void VulkanPipeline::CreateComputePipeline(
-	const VulkanPipelineInfo* const pipeline_info) noexcept(false)
+	VkPipelineLayout layout,
+	const VulkanDevice& device,
+	const VulkanShader& shader,
+	const VulkanPipelineInfo* const pipeline_info,
+	VkPipelineCache pipeline_cache) noexcept(false)
 {
 	const VulkanComputePipelineInfo* compute_pipeline_info = dynamic_cast<const VulkanComputePipelineInfo*>(pipeline_info);
 	if (!compute_pipeline_info)
 	{
 		throw CriticalVulkanError("Invalid pipeline info specified.");
 	}
+
+	// A compute pipeline consists of a single compute stage
+	const auto& stage_infos = shader.GetPipelineShaderStageInfos();
+	auto compute_stage = std::find_if(
+		stage_infos.begin(),
+		stage_infos.end(),
+		[](const VkPipelineShaderStageCreateInfo& stage_info)
+		{
+			return stage_info.stage == VK_SHADER_STAGE_COMPUTE_BIT;
+		});
+
+	if (compute_stage == stage_infos.end())
+	{
+		throw CriticalVulkanError("Compute pipeline needs a compute shader.");
+	}
+
+	const auto& reflection = shader.GetReflection();
+
+	// The work group size override is just another specialization constant
+	VulkanComputePipelineInfo specialization = *compute_pipeline_info;
+
+	for (std::size_t axis = 0; axis < m_local_size.size(); ++axis)
+	{
+		if (compute_pipeline_info->local_size[axis] == 0)
+		{
+			continue;
+		}
+
+		if (reflection.local_size_constant_ids[axis] == no_specialization_constant)
+		{
+			throw CriticalVulkanError("Compute shader does not allow its work group size to be specialized.");
+		}
+
+		specialization.SetSpecializationConstant(reflection.local_size_constant_ids[axis], compute_pipeline_info->local_size[axis]);
+	}
+
+	// Resolve the final work group size, constants that were not set keep the default from the shader
+	m_local_size = reflection.local_size;
+
+	for (const auto& entry : specialization.specialization_map_entries)
+	{
+		auto declared_constant = std::find_if(
+			reflection.specialization_constants.begin(),
+			reflection.specialization_constants.end(),
+			[&entry](const ReflectedSpecializationConstant& constant)
+			{
+				return constant.constant_id == entry.constantID;
+			});
+
+		if (declared_constant == reflection.specialization_constants.end())
+		{
+			spdlog::warn("Compute shader does not declare specialization constant {}, its value is ignored.", entry.constantID);
+			continue;
+		}
+
+		for (std::size_t axis = 0; axis < m_local_size.size(); ++axis)
+		{
+			if (reflection.local_size_constant_ids[axis] == entry.constantID && entry.size == sizeof(std::uint32_t))
+			{
+				std::memcpy(&m_local_size[axis], specialization.specialization_data.data() + entry.offset, sizeof(std::uint32_t));
+			}
+		}
+	}
+
+	VkPhysicalDeviceProperties device_properties = {};
+	vkGetPhysicalDeviceProperties(device.GetPhysicalDeviceNative(), &device_properties);
+
+	const auto& limits = device_properties.limits;
+
+	if (m_local_size[0] == 0 || m_local_size[1] == 0 || m_local_size[2] == 0 ||
+		m_local_size[0] > limits.maxComputeWorkGroupSize[0] ||
+		m_local_size[1] > limits.maxComputeWorkGroupSize[1] ||
+		m_local_size[2] > limits.maxComputeWorkGroupSize[2] ||
+		static_cast<std::uint64_t>(m_local_size[0]) * m_local_size[1] * m_local_size[2] > limits.maxComputeWorkGroupInvocations)
+	{
+		spdlog::error("Compute work group size ({}, {}, {}) is not supported by the device.", m_local_size[0], m_local_size[1], m_local_size[2]);
+		throw CriticalVulkanError("Invalid compute work group size.");
+	}
+
+	const auto specialization_info = specialization.GetSpecializationInfo();
+
+	VkComputePipelineCreateInfo pipeline_create_info = {};
+	pipeline_create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipeline_create_info.stage = *compute_stage;
+	pipeline_create_info.stage.pSpecializationInfo = specialization.specialization_map_entries.empty() ? nullptr : &specialization_info;
+	pipeline_create_info.layout = layout;
+
+	auto result = vkCreateComputePipelines(
+		device.GetLogicalDeviceNative(),
+		pipeline_cache,
+		1,
+		&pipeline_create_info,
+		nullptr,
+		&m_pipeline);
+
+	if (result != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create a compute pipeline.");
+	}
 }
 
 void VulkanPipeline::CreateRayTracingPipeline(
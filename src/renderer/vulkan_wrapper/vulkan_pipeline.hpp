@@ -9,6 +9,8 @@
 #include <vulkan/vulkan.h>
 
 // C++ standard
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -39,7 +41,7 @@ namespace vkc
 		class VulkanPipeline
 		{
 		public:
-			VulkanPipeline() noexcept(true) : m_pipeline(VK_NULL_HANDLE) {}
+			VulkanPipeline() noexcept(true) : m_pipeline(VK_NULL_HANDLE), m_local_size({ 0, 0, 0 }) {}
 			~VulkanPipeline() noexcept(true) {}
 
 			/** Create a Vulkan pipeline */
@@ -48,6 +50,9 @@ namespace vkc
 			 * structure. Internally the structure is casted to a child class of
 			 * the correct type. Make sure the "VulkanPipelineInfo" passed to
 			 * this function is compatible with the specified "PipelineType".
+			 *
+			 * Pipelines created with a pipeline cache reuse the driver's
+			 * compiled code of identical shader stages and states.
 			 */
 			void Create(
 				const VulkanDevice& device,
@@ -55,11 +60,30 @@ namespace vkc
 				PipelineType type,
 				VkPipelineLayout layout,
 				VkRenderPass render_pass,
-				const std::vector<std::pair<std::string, ShaderType>>& shader_files) noexcept(false);
+				const std::vector<std::pair<std::string, ShaderType>>& shader_files,
+				VkPipelineCache pipeline_cache = VK_NULL_HANDLE) noexcept(false);
+
+			/** Create a Vulkan pipeline out of an existing shader */
+			/**
+			 * The shader is not destroyed, so it can be shared between multiple
+			 * pipelines. The vertex attributes in the pipeline info are checked
+			 * against the inputs the vertex shader expects.
+			 */
+			void Create(
+				const VulkanDevice& device,
+				const VulkanPipelineInfo* const pipeline_info,
+				PipelineType type,
+				VkPipelineLayout layout,
+				VkRenderPass render_pass,
+				const VulkanShader& shader,
+				VkPipelineCache pipeline_cache = VK_NULL_HANDLE) noexcept(false);
 
 			/** Get a reference to the underlaying Vulkan pipeline object */
 			const VkPipeline& GetNative() const noexcept(true);
 
+			/** Get the work group size of a compute pipeline after specialization, all zero for other pipelines */
+			const std::array<std::uint32_t, 3>& GetLocalSize() const noexcept(true);
+
 			/** Destroy Vulkan resources */
 			void Destroy(const VulkanDevice& device) const noexcept(true);
 
@@ -70,11 +94,20 @@ namespace vkc
 				VkRenderPass render_pass,
 				const VulkanDevice& device,
 				const VulkanShader& shader,
-				const VulkanPipelineInfo* const pipeline_info) noexcept(false);
+				const VulkanPipelineInfo* const pipeline_info,
+				VkPipelineCache pipeline_cache) noexcept(false);
 
 			/** Create a compute pipeline */
+			/**
+			 * Throws when the work group size override cannot be applied, or when
+			 * the resulting work group exceeds the limits of the device.
+			 */
 			void CreateComputePipeline(
-				const VulkanPipelineInfo* const pipeline_info) noexcept(false);
+				VkPipelineLayout layout,
+				const VulkanDevice& device,
+				const VulkanShader& shader,
+				const VulkanPipelineInfo* const pipeline_info,
+				VkPipelineCache pipeline_cache) noexcept(false);
 			
 			/** Create a ray-tracing pipeline using VK_NV_raytracing */
 			void CreateRayTracingPipeline(
@@ -82,6 +115,9 @@ namespace vkc
 
 		private:
 			VkPipeline m_pipeline;
+
+			/** Used to turn a number of invocations into a number of work groups */
+			std::array<std::uint32_t, 3> m_local_size;
 		};
 	}
 }
@@ -0,0 +1,119 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_pipeline_cache.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+VulkanPipelineCache::VulkanPipelineCache() noexcept(true)
+	: m_pipeline_cache(VK_NULL_HANDLE)
+{}
+
+VulkanPipelineCache::~VulkanPipelineCache() noexcept(true)
+{}
+
+void VulkanPipelineCache::Create(const VulkanDevice& device, const std::string& path) noexcept(false)
+{
+	m_path = path;
+
+	std::string data;
+	std::ifstream file(path, std::ios::binary);
+
+	if (file.is_open())
+	{
+		data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	if (!data.empty() && !IsCompatible(device, data))
+	{
+		spdlog::warn("Pipeline cache \"{}\" was created by a different driver or device, starting with an empty cache.", path);
+		data.clear();
+	}
+
+	VkPipelineCacheCreateInfo create_info = {};
+	create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	create_info.initialDataSize = data.size();
+	create_info.pInitialData = data.empty() ? nullptr : data.data();
+
+	if (vkCreatePipelineCache(device.GetLogicalDeviceNative(), &create_info, nullptr, &m_pipeline_cache) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create a pipeline cache.");
+	}
+
+	spdlog::info("Created a pipeline cache with {} byte(s) of initial data.", data.size());
+}
+
+void VulkanPipelineCache::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	Save(device);
+
+	vkDestroyPipelineCache(device.GetLogicalDeviceNative(), m_pipeline_cache, nullptr);
+	m_pipeline_cache = VK_NULL_HANDLE;
+}
+
+void VulkanPipelineCache::Save(const VulkanDevice& device) const noexcept(true)
+{
+	std::size_t size = 0;
+
+	if (vkGetPipelineCacheData(device.GetLogicalDeviceNative(), m_pipeline_cache, &size, nullptr) != VK_SUCCESS || size == 0)
+	{
+		return;
+	}
+
+	std::string data(size, '\0');
+
+	if (vkGetPipelineCacheData(device.GetLogicalDeviceNative(), m_pipeline_cache, &size, data.data()) != VK_SUCCESS)
+	{
+		spdlog::warn("Could not retrieve the pipeline cache data.");
+		return;
+	}
+
+	std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		spdlog::warn("Could not write the pipeline cache to \"{}\".", m_path);
+		return;
+	}
+
+	file.write(data.data(), static_cast<std::streamsize>(size));
+}
+
+const VkPipelineCache& VulkanPipelineCache::GetNative() const noexcept(true)
+{
+	return m_pipeline_cache;
+}
+
+bool VulkanPipelineCache::IsCompatible(const VulkanDevice& device, const std::string& data) const noexcept(true)
+{
+	// Header version one: length, version, vendor ID, device ID, and the pipeline cache UUID
+	const std::size_t header_size = sizeof(std::uint32_t) * 4 + VK_UUID_SIZE;
+
+	if (data.size() < header_size)
+	{
+		return false;
+	}
+
+	std::uint32_t header[4] = {};
+	std::memcpy(header, data.data(), sizeof(header));
+
+	VkPhysicalDeviceProperties device_properties = {};
+	vkGetPhysicalDeviceProperties(device.GetPhysicalDeviceNative(), &device_properties);
+
+	return
+		header[0] >= header_size &&
+		header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+		header[2] == device_properties.vendorID &&
+		header[3] == device_properties.deviceID &&
+		std::memcmp(data.data() + sizeof(header), device_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
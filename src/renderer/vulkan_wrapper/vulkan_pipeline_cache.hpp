@@ -0,0 +1,53 @@
+#ifndef VULKAN_PIPELINE_CACHE_HPP
+#define VULKAN_PIPELINE_CACHE_HPP
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <string>
+
+namespace vkc::vk_wrapper
+{
+	// Forward declarations
+	class VulkanDevice;
+
+	/** Pipeline cache that is stored on disk between runs of the application */
+	/**
+	 * The driver stores the compiled code of every pipeline created through
+	 * the cache, so creating the same pipeline again (in this run or the next
+	 * one) skips most of the backend compilation. Cache data of a different
+	 * driver or device is detected through its header and ignored.
+	 *
+	 * Pipeline caches are internally synchronized, pipelines can be created
+	 * through the same cache from multiple threads at once.
+	 */
+	class VulkanPipelineCache
+	{
+	public:
+		VulkanPipelineCache() noexcept(true);
+		~VulkanPipelineCache() noexcept(true);
+
+		/** Create the pipeline cache, starting out with the data stored at the path (if any) */
+		void Create(const VulkanDevice& device, const std::string& path) noexcept(false);
+
+		/** Write the cache data to disk and destroy the pipeline cache */
+		void Destroy(const VulkanDevice& device) noexcept(true);
+
+		/** Write the cache data to the path the cache was created with */
+		void Save(const VulkanDevice& device) const noexcept(true);
+
+		/** Get a reference to the underlaying Vulkan pipeline cache object */
+		const VkPipelineCache& GetNative() const noexcept(true);
+
+	private:
+		/** Check whether the cache data was written by the driver and device that are in use */
+		bool IsCompatible(const VulkanDevice& device, const std::string& data) const noexcept(true);
+
+	private:
+		VkPipelineCache m_pipeline_cache;
+		std::string m_path;
+	};
+}
+
+#endif // VULKAN_PIPELINE_CACHE_HPP
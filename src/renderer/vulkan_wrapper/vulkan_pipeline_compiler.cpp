@@ -0,0 +1,221 @@
+// Application
+#include "core/thread_pool.hpp"
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_pipeline_compiler.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <chrono>
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+VulkanPipelineCompiler::VulkanPipelineCompiler() noexcept(true)
+	: m_thread_pool(nullptr)
+	, m_next_handle(0)
+{}
+
+VulkanPipelineCompiler::~VulkanPipelineCompiler() noexcept(true)
+{}
+
+void VulkanPipelineCompiler::Create(
+	const VulkanDevice& device,
+	core::ThreadPool& thread_pool,
+	const std::string& pipeline_cache_path) noexcept(false)
+{
+	m_thread_pool = &thread_pool;
+	m_pipeline_cache.Create(device, pipeline_cache_path);
+}
+
+void VulkanPipelineCompiler::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	for (auto& [handle, entry] : m_pipelines)
+	{
+		Poll(entry, true);
+
+		if (entry.state == PipelineState::Ready)
+		{
+			entry.pipeline.Destroy(device);
+		}
+	}
+
+	m_pipelines.clear();
+	m_pipeline_cache.Destroy(device);
+}
+
+template<class FUNCTION>
+PipelineHandle VulkanPipelineCompiler::Enqueue(FUNCTION&& create_pipeline) noexcept(false)
+{
+	const auto handle = m_next_handle++;
+
+	PipelineEntry entry = {};
+	entry.job = m_thread_pool->Enqueue(
+		[create_pipeline = std::forward<FUNCTION>(create_pipeline)]()
+		{
+			const auto start_time = std::chrono::steady_clock::now();
+
+			CompiledPipeline compiled_pipeline = {};
+			create_pipeline(compiled_pipeline.pipeline);
+
+			compiled_pipeline.compile_time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+			return compiled_pipeline;
+		});
+
+	m_pipelines.emplace(handle, std::move(entry));
+	++m_statistics.requested_pipeline_count;
+
+	return handle;
+}
+
+PipelineHandle VulkanPipelineCompiler::RequestPipeline(
+	const VulkanDevice& device,
+	std::shared_ptr<const VulkanPipelineInfo> pipeline_info,
+	PipelineType type,
+	VkPipelineLayout layout,
+	VkRenderPass render_pass,
+	const VulkanShader& shader) noexcept(false)
+{
+	// The shader only holds handles, the caller keeps the shader modules alive
+	return Enqueue(
+		[&device, pipeline_info, type, layout, render_pass, shader, pipeline_cache = m_pipeline_cache.GetNative()](VulkanPipeline& pipeline)
+		{
+			pipeline.Create(device, pipeline_info.get(), type, layout, render_pass, shader, pipeline_cache);
+		});
+}
+
+PipelineHandle VulkanPipelineCompiler::RequestPipeline(
+	const VulkanDevice& device,
+	std::shared_ptr<const VulkanPipelineInfo> pipeline_info,
+	PipelineType type,
+	VkPipelineLayout layout,
+	VkRenderPass render_pass,
+	const std::vector<std::pair<std::string, ShaderType>>& shader_files) noexcept(false)
+{
+	return Enqueue(
+		[&device, pipeline_info, type, layout, render_pass, shader_files, pipeline_cache = m_pipeline_cache.GetNative()](VulkanPipeline& pipeline)
+		{
+			pipeline.Create(device, pipeline_info.get(), type, layout, render_pass, shader_files, pipeline_cache);
+		});
+}
+
+void VulkanPipelineCompiler::Wait(PipelineHandle handle) noexcept(true)
+{
+	auto entry = m_pipelines.find(handle);
+
+	if (entry != m_pipelines.end())
+	{
+		Poll(entry->second, true);
+	}
+}
+
+PipelineState VulkanPipelineCompiler::GetState(PipelineHandle handle) noexcept(true)
+{
+	auto entry = m_pipelines.find(handle);
+
+	if (entry == m_pipelines.end())
+	{
+		return PipelineState::Failed;
+	}
+
+	Poll(entry->second, false);
+
+	return entry->second.state;
+}
+
+VkPipeline VulkanPipelineCompiler::GetPipeline(PipelineHandle handle, VkPipeline fallback) noexcept(true)
+{
+	auto entry = m_pipelines.find(handle);
+
+	if (entry != m_pipelines.end())
+	{
+		Poll(entry->second, false);
+
+		if (entry->second.state == PipelineState::Ready)
+		{
+			return entry->second.pipeline.GetNative();
+		}
+	}
+
+	if (fallback != VK_NULL_HANDLE)
+	{
+		++m_statistics.fallback_count;
+	}
+	else
+	{
+		++m_statistics.skipped_count;
+	}
+
+	return fallback;
+}
+
+void VulkanPipelineCompiler::Release(const VulkanDevice& device, PipelineHandle handle) noexcept(true)
+{
+	auto entry = m_pipelines.find(handle);
+
+	if (entry == m_pipelines.end())
+	{
+		return;
+	}
+
+	// The compile job references the pipeline layout and render pass, which may be destroyed after this call
+	Poll(entry->second, true);
+
+	if (entry->second.state == PipelineState::Ready)
+	{
+		entry->second.pipeline.Destroy(device);
+	}
+
+	m_pipelines.erase(entry);
+}
+
+VkPipelineCache VulkanPipelineCompiler::GetPipelineCache() const noexcept(true)
+{
+	return m_pipeline_cache.GetNative();
+}
+
+const PipelineCompilerStatistics& VulkanPipelineCompiler::GetStatistics() const noexcept(true)
+{
+	return m_statistics;
+}
+
+void VulkanPipelineCompiler::Poll(PipelineEntry& entry, bool wait) noexcept(true)
+{
+	if (entry.state != PipelineState::Compiling)
+	{
+		return;
+	}
+
+	if (!wait && entry.job.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		return;
+	}
+
+	try
+	{
+		const auto compiled_pipeline = entry.job.get();
+
+		entry.pipeline = compiled_pipeline.pipeline;
+		entry.state = PipelineState::Ready;
+
+		m_statistics.compile_time_ms += compiled_pipeline.compile_time_ms;
+	}
+	catch (CriticalVulkanError& error)
+	{
+		// Draws keep using the fallback pipeline, a broken shader should not take the application down
+		spdlog::error("Could not compile a pipeline: {}", error.what());
+
+		entry.state = PipelineState::Failed;
+		++m_statistics.failed_pipeline_count;
+	}
+	catch (...)
+	{
+		spdlog::error("Could not compile a pipeline.");
+
+		entry.state = PipelineState::Failed;
+		++m_statistics.failed_pipeline_count;
+	}
+}
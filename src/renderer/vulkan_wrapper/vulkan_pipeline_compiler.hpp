@@ -0,0 +1,155 @@
+#ifndef VULKAN_PIPELINE_COMPILER_HPP
+#define VULKAN_PIPELINE_COMPILER_HPP
+
+// Application
+#include "vulkan_pipeline.hpp"
+#include "vulkan_pipeline_cache.hpp"
+#include "vulkan_pipeline_info.hpp"
+#include "vulkan_shader.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vkc
+{
+	namespace core
+	{
+		class ThreadPool;
+	}
+
+	namespace vk_wrapper
+	{
+		class VulkanDevice;
+
+		/** Handle to a pipeline requested from the pipeline compiler, stays valid until it is released */
+		using PipelineHandle = std::uint32_t;
+
+		/** Life cycle of a requested pipeline */
+		enum class PipelineState
+		{
+			Compiling,	// Shaders and pipeline are being compiled on a worker thread
+			Ready,		// Pipeline can be bound
+			Failed		// Compilation failed, the fallback pipeline is used instead
+		};
+
+		/** Counters that show how often the draw path had to wait for pipelines */
+		struct PipelineCompilerStatistics
+		{
+			std::uint64_t requested_pipeline_count = 0;
+			std::uint64_t failed_pipeline_count = 0;
+
+			/** Total time spent compiling on the worker threads */
+			double compile_time_ms = 0.0;
+
+			/** Pipeline lookups that returned the fallback pipeline, or nothing, because the pipeline was not ready */
+			std::uint64_t fallback_count = 0;
+			std::uint64_t skipped_count = 0;
+		};
+
+		/** Creates pipelines on worker threads, so new pipelines do not stall the render thread */
+		/**
+		 * Requesting a pipeline returns a handle right away. Until the pipeline
+		 * is ready, "GetPipeline" returns the fallback pipeline passed to it,
+		 * which may be VK_NULL_HANDLE to skip the draw altogether. All pipelines
+		 * go through a shared pipeline cache that is stored on disk, so the
+		 * pipelines of a previous run are created much faster.
+		 *
+		 * The shader, pipeline layout, and render pass of a request have to
+		 * stay alive until its pipeline is ready (or released). Only call the
+		 * compiler from the render thread, the worker threads never touch it.
+		 */
+		class VulkanPipelineCompiler
+		{
+		public:
+			VulkanPipelineCompiler() noexcept(true);
+			~VulkanPipelineCompiler() noexcept(true);
+
+			/** Create the pipeline cache, loading the cache data stored at the path */
+			void Create(
+				const VulkanDevice& device,
+				core::ThreadPool& thread_pool,
+				const std::string& pipeline_cache_path) noexcept(false);
+
+			/** Wait for all pending compilations, destroy all pipelines, and store the pipeline cache */
+			void Destroy(const VulkanDevice& device) noexcept(true);
+
+			/** Compile a pipeline that uses an existing shader on a worker thread */
+			PipelineHandle RequestPipeline(
+				const VulkanDevice& device,
+				std::shared_ptr<const VulkanPipelineInfo> pipeline_info,
+				PipelineType type,
+				VkPipelineLayout layout,
+				VkRenderPass render_pass,
+				const VulkanShader& shader) noexcept(false);
+
+			/** Compile the shader sources and a pipeline that uses them on a worker thread */
+			PipelineHandle RequestPipeline(
+				const VulkanDevice& device,
+				std::shared_ptr<const VulkanPipelineInfo> pipeline_info,
+				PipelineType type,
+				VkPipelineLayout layout,
+				VkRenderPass render_pass,
+				const std::vector<std::pair<std::string, ShaderType>>& shader_files) noexcept(false);
+
+			/** Block until the pipeline is no longer compiling */
+			void Wait(PipelineHandle handle) noexcept(true);
+
+			/** Check whether the pipeline has finished compiling */
+			PipelineState GetState(PipelineHandle handle) noexcept(true);
+
+			/** Get the pipeline, or the fallback pipeline when it is not ready (yet) */
+			VkPipeline GetPipeline(PipelineHandle handle, VkPipeline fallback = VK_NULL_HANDLE) noexcept(true);
+
+			/** Destroy the pipeline, waits when it is still compiling, the device must not be using it */
+			void Release(const VulkanDevice& device, PipelineHandle handle) noexcept(true);
+
+			/** Pipeline cache shared by every pipeline of the compiler, pipelines created elsewhere can use it too */
+			VkPipelineCache GetPipelineCache() const noexcept(true);
+
+			/** Get the counters of all pipelines requested so far */
+			const PipelineCompilerStatistics& GetStatistics() const noexcept(true);
+
+		private:
+			/** Result of a compile job */
+			struct CompiledPipeline
+			{
+				VulkanPipeline pipeline;
+				double compile_time_ms = 0.0;
+			};
+
+			struct PipelineEntry
+			{
+				PipelineState state = PipelineState::Compiling;
+				std::future<CompiledPipeline> job;
+				VulkanPipeline pipeline;
+			};
+
+			/** Pick up the result of the compile job once it is done */
+			void Poll(PipelineEntry& entry, bool wait) noexcept(true);
+
+			/** Queue a compile job and hand out a handle for it */
+			template<class FUNCTION>
+			PipelineHandle Enqueue(FUNCTION&& create_pipeline) noexcept(false);
+
+		private:
+			core::ThreadPool* m_thread_pool;
+			VulkanPipelineCache m_pipeline_cache;
+
+			std::unordered_map<PipelineHandle, PipelineEntry> m_pipelines;
+			PipelineHandle m_next_handle;
+
+			PipelineCompilerStatistics m_statistics;
+		};
+	}
+}
+
+#endif // VULKAN_PIPELINE_COMPILER_HPP
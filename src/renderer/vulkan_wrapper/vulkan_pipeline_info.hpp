@@ -5,6 +5,11 @@
 #include <vulkan/vulkan.h>
 
 // C++ standard
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include <vector>
 
 namespace vkc::vk_wrapper
@@ -49,15 +54,78 @@ namespace vkc::vk_wrapper
 		CounterClockwise	= VK_FRONT_FACE_COUNTER_CLOCKWISE,
 	};
 
+	/** Comparison used by the depth test, the incoming depth is on the left-hand side */
+	enum class CompareOperation
+	{
+		Never			= VK_COMPARE_OP_NEVER,
+		Less			= VK_COMPARE_OP_LESS,
+		Equal			= VK_COMPARE_OP_EQUAL,
+		LessOrEqual		= VK_COMPARE_OP_LESS_OR_EQUAL,
+		Greater			= VK_COMPARE_OP_GREATER,
+		NotEqual		= VK_COMPARE_OP_NOT_EQUAL,
+		GreaterOrEqual	= VK_COMPARE_OP_GREATER_OR_EQUAL,
+		Always			= VK_COMPARE_OP_ALWAYS
+	};
+
 	/** Base class for a Vulkan pipeline information structure */
+	/**
+	 * Specialization constants are passed to every shader stage of the
+	 * pipeline, stages that do not declare a constant ignore its value.
+	 */
 	struct VulkanPipelineInfo
 	{
 		virtual ~VulkanPipelineInfo() {}
+
+		/** Specialization constant values, use "SetSpecializationConstant" to fill these in */
+		std::vector<VkSpecializationMapEntry> specialization_map_entries;
+		std::vector<std::uint8_t> specialization_data;
+
+		/** Set the value of the specialization constant with the specified constant ID */
+		/**
+		 * Booleans need to be passed as a VkBool32. Setting a constant again
+		 * replaces the previous value.
+		 */
+		template<typename T>
+		void SetSpecializationConstant(std::uint32_t constant_id, const T& value) noexcept(true)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Specialization constant data is copied byte for byte.");
+
+			specialization_map_entries.erase(
+				std::remove_if(
+					specialization_map_entries.begin(),
+					specialization_map_entries.end(),
+					[constant_id](const VkSpecializationMapEntry& entry)
+					{
+						return entry.constantID == constant_id;
+					}),
+				specialization_map_entries.end());
+
+			VkSpecializationMapEntry entry = {};
+			entry.constantID = constant_id;
+			entry.offset = static_cast<std::uint32_t>(specialization_data.size());
+			entry.size = sizeof(T);
+
+			specialization_data.resize(specialization_data.size() + sizeof(T));
+			std::memcpy(specialization_data.data() + entry.offset, &value, sizeof(T));
+
+			specialization_map_entries.push_back(entry);
+		}
+
+		/** Get a specialization info that points into this structure, it stays valid until a constant is set */
+		VkSpecializationInfo GetSpecializationInfo() const noexcept(true)
+		{
+			VkSpecializationInfo specialization_info = {};
+			specialization_info.mapEntryCount = static_cast<std::uint32_t>(specialization_map_entries.size());
+			specialization_info.pMapEntries = specialization_map_entries.data();
+			specialization_info.dataSize = specialization_data.size();
+			specialization_info.pData = specialization_data.data();
+
+			return specialization_info;
+		}
 	};
 
 	/** All information to create a graphics pipeline */
 	/** #TODO: Refactor this structure and split it up into multiple structures */
-	/** #TODO: Add multi sampling configuration */
 	/** #TODO: Add color blending configuration */
 	struct VulkanGraphicsPipelineInfo : public VulkanPipelineInfo
 	{
@@ -78,11 +146,30 @@ namespace vkc::vk_wrapper
 		PolygonFaceCullMode cull_mode;
 		TriangleWindingOrder winding_order;
 		bool enable_depth_bias;
+
+		/** Has to match the sample count of the attachments of the render pass */
+		VkSampleCountFlagBits sample_count = VK_SAMPLE_COUNT_1_BIT;
+
+		// Depth state, ignored by render passes without a depth attachment
+		bool enable_depth_test = false;
+		bool enable_depth_write = false;
+		CompareOperation depth_compare_operation = CompareOperation::Less;
+
+		/** Only run the vertex stage and leave the color attachments untouched, e.g. for a depth prepass */
+		bool depth_only = false;
 	};
 
 	/** All information to create a compute pipeline */
+	/**
+	 * The work group size can only be changed for dimensions that the shader
+	 * declares with "local_size_x_id" (or y, z), any other dimension keeps
+	 * the size that was compiled into the shader.
+	 */
 	struct VulkanComputePipelineInfo : public VulkanPipelineInfo
-	{};
+	{
+		/** Work group size override, zero keeps the size declared by the shader */
+		std::array<std::uint32_t, 3> local_size = { 0, 0, 0 };
+	};
 
 	/** All information to create a ray-tracing pipeline */
 	struct VulkanRayTracingPipelineInfo : public VulkanPipelineInfo
@@ -0,0 +1,92 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_query_pool.hpp"
+
+// C++ standard
+#include <bitset>
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+VulkanQueryPool::VulkanQueryPool() noexcept(true)
+	: m_query_pool(VK_NULL_HANDLE)
+	, m_counter_count(0)
+{}
+
+VulkanQueryPool::~VulkanQueryPool() noexcept(true)
+{}
+
+void VulkanQueryPool::Create(
+	const VulkanDevice& device,
+	VkQueryType type,
+	std::uint32_t query_count,
+	VkQueryPipelineStatisticFlags pipeline_statistics) noexcept(false)
+{
+	VkQueryPoolCreateInfo create_info = {};
+	create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	create_info.queryType = type;
+	create_info.queryCount = query_count;
+	create_info.pipelineStatistics = (type == VK_QUERY_TYPE_PIPELINE_STATISTICS) ? pipeline_statistics : 0;
+
+	if (vkCreateQueryPool(device.GetLogicalDeviceNative(), &create_info, nullptr, &m_query_pool) != VK_SUCCESS)
+	{
+		throw CriticalVulkanError("Could not create a query pool.");
+	}
+
+	// Pipeline statistics queries write one counter per statistic, every other query type writes a single value
+	m_counter_count = (type == VK_QUERY_TYPE_PIPELINE_STATISTICS) ?
+		static_cast<std::uint32_t>(std::bitset<32>(pipeline_statistics).count()) :
+		1;
+}
+
+void VulkanQueryPool::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	vkDestroyQueryPool(device.GetLogicalDeviceNative(), m_query_pool, nullptr);
+
+	m_query_pool = VK_NULL_HANDLE;
+	m_counter_count = 0;
+}
+
+void VulkanQueryPool::Reset(const VkCommandBuffer& command_buffer, std::uint32_t first_query, std::uint32_t query_count) const noexcept(true)
+{
+	vkCmdResetQueryPool(command_buffer, m_query_pool, first_query, query_count);
+}
+
+void VulkanQueryPool::Begin(const VkCommandBuffer& command_buffer, std::uint32_t query) const noexcept(true)
+{
+	vkCmdBeginQuery(command_buffer, m_query_pool, query, 0);
+}
+
+void VulkanQueryPool::End(const VkCommandBuffer& command_buffer, std::uint32_t query) const noexcept(true)
+{
+	vkCmdEndQuery(command_buffer, m_query_pool, query);
+}
+
+bool VulkanQueryPool::GetResults(const VulkanDevice& device, std::uint32_t query, std::vector<std::uint64_t>& results) const noexcept(true)
+{
+	results.resize(m_counter_count);
+
+	// Without the wait flag the call returns "VK_NOT_READY" instead of blocking
+	const auto result = vkGetQueryPoolResults(
+		device.GetLogicalDeviceNative(),
+		m_query_pool,
+		query,
+		1,
+		results.size() * sizeof(std::uint64_t),
+		results.data(),
+		sizeof(std::uint64_t) * m_counter_count,
+		VK_QUERY_RESULT_64_BIT);
+
+	return result == VK_SUCCESS;
+}
+
+std::uint32_t VulkanQueryPool::GetCounterCount() const noexcept(true)
+{
+	return m_counter_count;
+}
+
+const VkQueryPool& VulkanQueryPool::GetNative() const noexcept(true)
+{
+	return m_query_pool;
+}
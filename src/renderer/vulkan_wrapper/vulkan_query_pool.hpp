@@ -0,0 +1,69 @@
+#ifndef VULKAN_QUERY_POOL_HPP
+#define VULKAN_QUERY_POOL_HPP
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	class VulkanDevice;
+
+	/** Pool of queries that the GPU writes results into, e.g. pipeline statistics */
+	/**
+	 * Queries have to be reset before they are used, resets are recorded
+	 * outside of a render pass. Results are read on the CPU once the commands
+	 * that wrote them have finished executing.
+	 */
+	class VulkanQueryPool
+	{
+	public:
+		VulkanQueryPool() noexcept(true);
+		~VulkanQueryPool() noexcept(true);
+
+		/** Create a pool of "query_count" queries of the specified type */
+		/**
+		 * Pipeline statistics queries count every statistic in
+		 * "pipeline_statistics", other query types ignore it.
+		 */
+		void Create(
+			const VulkanDevice& device,
+			VkQueryType type,
+			std::uint32_t query_count,
+			VkQueryPipelineStatisticFlags pipeline_statistics = 0) noexcept(false);
+
+		/** Destroy the query pool */
+		void Destroy(const VulkanDevice& device) noexcept(true);
+
+		/** Record a reset of a range of queries, has to be recorded outside of a render pass */
+		void Reset(const VkCommandBuffer& command_buffer, std::uint32_t first_query, std::uint32_t query_count = 1) const noexcept(true);
+
+		/** Start counting into a query, the commands up to "End" are counted */
+		void Begin(const VkCommandBuffer& command_buffer, std::uint32_t query) const noexcept(true);
+
+		/** Stop counting into a query */
+		void End(const VkCommandBuffer& command_buffer, std::uint32_t query) const noexcept(true);
+
+		/** Read the results of a query without waiting, returns false when they are not available (yet) */
+		/**
+		 * Every counter of the query is written as a 64-bit value, pipeline
+		 * statistics are ordered by their bit in the statistic flags.
+		 */
+		bool GetResults(const VulkanDevice& device, std::uint32_t query, std::vector<std::uint64_t>& results) const noexcept(true);
+
+		/** Get the number of counters every query writes */
+		std::uint32_t GetCounterCount() const noexcept(true);
+
+		/** Get a reference to the Vulkan query pool object */
+		const VkQueryPool& GetNative() const noexcept(true);
+
+	private:
+		VkQueryPool m_query_pool;
+		std::uint32_t m_counter_count;
+	};
+}
+
+#endif // VULKAN_QUERY_POOL_HPP
@@ -18,7 +18,7 @@ void VulkanRenderPass::Create(
 	create_info.attachmentCount = static_cast<std::uint32_t>(
 		info.attachment_descriptions.size());
 	create_info.subpassCount = static_cast<std::uint32_t>(
-		info.attachment_descriptions.size());
+		info.subpass_descriptions.size());
 	create_info.dependencyCount = static_cast<std::uint32_t>(
 		info.subpass_dependencies.size());
 	create_info.pAttachments = info.attachment_descriptions.data();
@@ -4,6 +4,9 @@
 // Vulkan
 #include <vulkan/vulkan.h>
 
+// C++ standard
+#include <vector>
+
 namespace vkc::vk_wrapper
 {
 	class VulkanDevice;
@@ -0,0 +1,118 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_sampler_cache.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <limits>
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+VulkanSamplerCache::VulkanSamplerCache() noexcept(true)
+	: m_maximum_sampler_count(std::numeric_limits<std::uint32_t>::max())
+{}
+
+VulkanSamplerCache::~VulkanSamplerCache() noexcept(true)
+{}
+
+void VulkanSamplerCache::Create(const VulkanDevice& device) noexcept(true)
+{
+	VkPhysicalDeviceProperties properties = {};
+	vkGetPhysicalDeviceProperties(device.GetPhysicalDeviceNative(), &properties);
+
+	m_maximum_sampler_count = properties.limits.maxSamplerAllocationCount;
+}
+
+void VulkanSamplerCache::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_samplers_mutex);
+
+	for (const auto& [settings, cached_sampler] : m_samplers)
+	{
+		if (cached_sampler.usage_count > 0)
+		{
+			spdlog::warn("Destroying a sampler that is still used by {} user(s).", cached_sampler.usage_count);
+		}
+
+		cached_sampler.sampler.Destroy(device);
+	}
+
+	m_samplers.clear();
+}
+
+VkSampler VulkanSamplerCache::Acquire(const VulkanDevice& device, const TextureSamplerSettings& settings) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_samplers_mutex);
+
+	auto existing_sampler = m_samplers.find(settings);
+
+	if (existing_sampler != m_samplers.end())
+	{
+		++existing_sampler->second.usage_count;
+		return existing_sampler->second.sampler.GetNative();
+	}
+
+	if (m_samplers.size() >= m_maximum_sampler_count)
+	{
+		throw CriticalVulkanError("Cannot create another sampler, the device sampler limit has been reached.");
+	}
+
+	CachedSampler cached_sampler = {};
+	cached_sampler.sampler.Create(device, settings);
+	cached_sampler.usage_count = 1;
+
+	auto sampler = cached_sampler.sampler.GetNative();
+	m_samplers.emplace(settings, cached_sampler);
+
+	return sampler;
+}
+
+void VulkanSamplerCache::Release(const TextureSamplerSettings& settings) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_samplers_mutex);
+
+	auto existing_sampler = m_samplers.find(settings);
+
+	if (existing_sampler == m_samplers.end() || existing_sampler->second.usage_count == 0)
+	{
+		spdlog::warn("Released a sampler that has not been acquired.");
+		return;
+	}
+
+	--existing_sampler->second.usage_count;
+}
+
+void VulkanSamplerCache::DestroyUnusedSamplers(const VulkanDevice& device) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_samplers_mutex);
+
+	for (auto it = m_samplers.begin(); it != m_samplers.end();)
+	{
+		if (it->second.usage_count > 0)
+		{
+			++it;
+			continue;
+		}
+
+		it->second.sampler.Destroy(device);
+		it = m_samplers.erase(it);
+	}
+}
+
+std::uint32_t VulkanSamplerCache::GetSamplerCount() const noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_samplers_mutex);
+	return static_cast<std::uint32_t>(m_samplers.size());
+}
+
+std::uint32_t VulkanSamplerCache::GetUsageCount(const TextureSamplerSettings& settings) const noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_samplers_mutex);
+
+	auto existing_sampler = m_samplers.find(settings);
+	return (existing_sampler != m_samplers.end()) ? existing_sampler->second.usage_count : 0;
+}
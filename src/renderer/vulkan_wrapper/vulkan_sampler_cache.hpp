@@ -0,0 +1,83 @@
+#ifndef VULKAN_SAMPLER_CACHE_HPP
+#define VULKAN_SAMPLER_CACHE_HPP
+
+// Application
+#include "vulkan_texture_sampler.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace vkc::vk_wrapper
+{
+	// Forward declarations
+	class VulkanDevice;
+
+	/** Shares sampler objects between users that request identical sampler settings */
+	/**
+	 * Devices limit the number of samplers that can exist at the same time
+	 * (maxSamplerAllocationCount), while most materials use one of a handful
+	 * of sampler configurations. Every unique set of sampler settings creates
+	 * a single sampler, which is handed out to every user of those settings.
+	 *
+	 * Samplers are not destroyed when their usage count drops to zero, as
+	 * frames in flight may still use them. Call "DestroyUnusedSamplers" when
+	 * the device is idle to get rid of them.
+	 *
+	 * All functions are thread-safe.
+	 */
+	class VulkanSamplerCache
+	{
+	public:
+		VulkanSamplerCache() noexcept(true);
+		~VulkanSamplerCache() noexcept(true);
+
+		/** Query the sampler limits of the device */
+		void Create(const VulkanDevice& device) noexcept(true);
+
+		/** Destroy all cached samplers */
+		void Destroy(const VulkanDevice& device) noexcept(true);
+
+		/** Get a sampler that matches the settings, a new sampler is only created when no matching sampler exists */
+		/**
+		 * Increases the usage count of the sampler, call "Release" with the
+		 * same settings once the sampler is no longer needed. Throws when the
+		 * device cannot hold any more samplers.
+		 */
+		VkSampler Acquire(const VulkanDevice& device, const TextureSamplerSettings& settings) noexcept(false);
+
+		/** Decrease the usage count of the sampler that matches the settings */
+		void Release(const TextureSamplerSettings& settings) noexcept(true);
+
+		/** Destroy samplers that are not used anymore, the device must not be using them */
+		void DestroyUnusedSamplers(const VulkanDevice& device) noexcept(true);
+
+		/** Get the number of samplers in the cache */
+		std::uint32_t GetSamplerCount() const noexcept(true);
+
+		/** Get the usage count of the sampler that matches the settings, zero when it is not in the cache */
+		std::uint32_t GetUsageCount(const TextureSamplerSettings& settings) const noexcept(true);
+
+	private:
+		/** Sampler and the number of users that acquired it */
+		struct CachedSampler
+		{
+			VulkanTextureSampler sampler;
+			std::uint32_t usage_count = 0;
+		};
+
+	private:
+		std::unordered_map<TextureSamplerSettings, CachedSampler, TextureSamplerSettingsHash> m_samplers;
+
+		/** Device limit on the number of samplers that exist at the same time */
+		std::uint32_t m_maximum_sampler_count;
+
+		mutable std::mutex m_samplers_mutex;
+	};
+}
+
+#endif // VULKAN_SAMPLER_CACHE_HPP
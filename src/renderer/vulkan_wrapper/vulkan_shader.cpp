@@ -1,265 +1,226 @@
-// Glslang (needs to be included before Vulkan header)
-#include <SPIRV/GlslangToSpv.h>
-#include <StandAlone/DirStackFileIncluder.h>
-
 // Application
+#include "core/thread_pool.hpp"
 #include "miscellaneous/exceptions.hpp"
 #include "vulkan_device.hpp"
 #include "vulkan_shader.hpp"
+#include "vulkan_shader_bundle.hpp"
+#include "vulkan_shader_compiler.hpp"
 
 // Spdlog
 #include <spdlog/spdlog.h>
 
 // C++ standard
-#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <future>
 
-using namespace glslang;
 using namespace vkc::vk_wrapper;
 
 void vkc::vk_wrapper::VulkanShader::Create(
 	const VulkanDevice& device,
-	const std::vector<std::pair<std::string, ShaderType>>& shader_files) noexcept(false)
+	const std::vector<std::pair<std::string, ShaderType>>& shader_files,
+	const std::vector<std::string>& defines) noexcept(false)
 {
-	// Create all pipeline shader stage create infos
+	std::vector<CompiledStage> stages;
+
 	for (const auto& shader : shader_files)
 	{
-		const auto shader_bytecode = GetSPIRV(shader.first);
-		const auto shader_module = CreateShaderModule(device, shader_bytecode);
-
-		VkPipelineShaderStageCreateInfo shader_stage_info = {};
-		shader_stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-		shader_stage_info.stage = static_cast<VkShaderStageFlagBits>(shader.second);
-		shader_stage_info.module = shader_module;
-		shader_stage_info.pName = "main";
-
-		m_shader_modules.push_back(shader_module);
-		m_shader_stage_infos.push_back(shader_stage_info);
+		stages.push_back(CompileStage(shader.first, shader.second, defines));
 	}
+
+	CreateFromCompiledStages(device, stages);
 }
 
-void VulkanShader::Destroy(const VulkanDevice& device) const noexcept(true)
+std::vector<VulkanShader> VulkanShader::CreateBatch(
+	const VulkanDevice& device,
+	core::ThreadPool& thread_pool,
+	const std::vector<ShaderCompileRequest>& requests) noexcept(false)
 {
-	for (const auto& shader_module : m_shader_modules)
+	const auto start_time = std::chrono::steady_clock::now();
+
+	// One job per stage, so a single shader with many stages is spread out as well
+	std::vector<std::vector<std::future<CompiledStage>>> compile_jobs(requests.size());
+	std::size_t stage_count = 0;
+
+	for (std::size_t request_index = 0; request_index < requests.size(); ++request_index)
 	{
-		vkDestroyShaderModule(
-			device.GetLogicalDeviceNative(),
-			shader_module,
-			nullptr);
+		const auto& request = requests[request_index];
+
+		for (const auto& [path, type] : request.shader_files)
+		{
+			compile_jobs[request_index].push_back(thread_pool.Enqueue(
+				[path = path, type = type, &defines = request.defines]()
+				{
+					return CompileStage(path, type, defines);
+				}));
+
+			++stage_count;
+		}
 	}
-}
 
-const std::vector<VkPipelineShaderStageCreateInfo>& VulkanShader::GetPipelineShaderStageInfos() const noexcept(true)
-{
-	return m_shader_stage_infos;
-}
+	// Wait for every job before rethrowing, the jobs reference the requests
+	std::vector<std::vector<CompiledStage>> compiled_stages(requests.size());
+	std::exception_ptr first_error = nullptr;
 
-std::vector<std::uint32_t> VulkanShader::GetSPIRV(
-	const std::string& path) const noexcept(false)
-{
-	if (!glsl_lang_initialized)
+	for (std::size_t request_index = 0; request_index < requests.size(); ++request_index)
+	{
+		for (auto& job : compile_jobs[request_index])
+		{
+			try
+			{
+				compiled_stages[request_index].push_back(job.get());
+			}
+			catch (...)
+			{
+				if (!first_error)
+				{
+					first_error = std::current_exception();
+				}
+			}
+		}
+	}
+
+	if (first_error)
 	{
-		InitializeProcess();
-		glsl_lang_initialized = true;
+		std::rethrow_exception(first_error);
 	}
 
-	// Open the GLSL file
-	std::ifstream shader_file(path);
+	// Shader modules are cheap to create compared to compiling GLSL
+	std::vector<VulkanShader> shaders(requests.size());
 
-	if (!shader_file.is_open())
+	for (std::size_t request_index = 0; request_index < requests.size(); ++request_index)
 	{
-		// Could not open the file
-		throw exception::CriticalIOError("Could not open shader file.");
+		shaders[request_index].CreateFromCompiledStages(device, compiled_stages[request_index]);
 	}
 
-	// Dump the contents of the entire file into a string
-	std::string glsl_str(
-		(std::istreambuf_iterator<char>(shader_file)),
-		std::istreambuf_iterator<char>());
-
-	// Convert to a C-string
-	const auto glsl_cstr = glsl_str.c_str();
-
-	// Determine shader type
-	const auto shader_stage_type = GetShaderStageType(path);
-
-	// Configure a Glslang shader object
-	const int client_input_semantics_version = 100;	// #define VULKAN 100
-	const auto vulkan_client_version = EShTargetVulkan_1_0;
-	const auto target_version = EShTargetSpv_1_0;
-
-	TShader shader(shader_stage_type);
-	shader.setStrings(&glsl_cstr, 1);
-	shader.setEnvInput(
-		EShSourceGlsl,
-		shader_stage_type,
-		EShClientVulkan,
-		client_input_semantics_version);
-	shader.setEnvClient(EShClientVulkan, vulkan_client_version);
-	shader.setEnvTarget(EShTargetSpv, target_version);
-
-	// Values copied from the default configuration file generated by
-	// glslangvalidator.exe
-	TBuiltInResource default_built_in_resource							= {};
-	default_built_in_resource.maxLights									= 32;
-	default_built_in_resource.maxClipPlanes								= 6;
-	default_built_in_resource.maxTextureUnits							= 32;
-	default_built_in_resource.maxTextureCoords							= 32;
-	default_built_in_resource.maxVertexAttribs							= 64;
-	default_built_in_resource.maxVertexUniformComponents				= 4096;
-	default_built_in_resource.maxVaryingFloats							= 64;
-	default_built_in_resource.maxVertexTextureImageUnits				= 32;
-	default_built_in_resource.maxCombinedTextureImageUnits				= 80;
-	default_built_in_resource.maxTextureImageUnits						= 32;
-	default_built_in_resource.maxFragmentUniformComponents				= 4096;
-	default_built_in_resource.maxDrawBuffers							= 32;
-	default_built_in_resource.maxVertexUniformVectors					= 128;
-	default_built_in_resource.maxVaryingVectors							= 8;
-	default_built_in_resource.maxFragmentUniformVectors					= 16;
-	default_built_in_resource.maxVertexOutputVectors					= 16;
-	default_built_in_resource.maxFragmentInputVectors					= 15;
-	default_built_in_resource.minProgramTexelOffset						= -8;
-	default_built_in_resource.maxProgramTexelOffset						= 7;
-	default_built_in_resource.maxClipDistances							= 8;
-	default_built_in_resource.maxComputeWorkGroupCountX					= 65535;
-	default_built_in_resource.maxComputeWorkGroupCountY					= 65535;
-	default_built_in_resource.maxComputeWorkGroupCountZ					= 65535;
-	default_built_in_resource.maxComputeWorkGroupSizeX					= 1024;
-	default_built_in_resource.maxComputeWorkGroupSizeY					= 1024;
-	default_built_in_resource.maxComputeWorkGroupSizeZ					= 64;
-	default_built_in_resource.maxComputeUniformComponents				= 1024;
-	default_built_in_resource.maxComputeTextureImageUnits				= 16;
-	default_built_in_resource.maxComputeImageUniforms					= 8;
-	default_built_in_resource.maxComputeAtomicCounters					= 8;
-	default_built_in_resource.maxComputeAtomicCounterBuffers			= 1;
-	default_built_in_resource.maxVaryingComponents						= 60;
-	default_built_in_resource.maxVertexOutputComponents					= 64;
-	default_built_in_resource.maxGeometryInputComponents				= 64;
-	default_built_in_resource.maxGeometryOutputComponents				= 128;
-	default_built_in_resource.maxFragmentInputComponents				= 128;
-	default_built_in_resource.maxImageUnits								= 8;
-	default_built_in_resource.maxCombinedImageUnitsAndFragmentOutputs	= 8;
-	default_built_in_resource.maxCombinedShaderOutputResources			= 8;
-	default_built_in_resource.maxImageSamples							= 0;
-	default_built_in_resource.maxVertexImageUniforms					= 0;
-	default_built_in_resource.maxTessControlImageUniforms				= 0;
-	default_built_in_resource.maxTessEvaluationImageUniforms			= 0;
-	default_built_in_resource.maxGeometryImageUniforms					= 0;
-	default_built_in_resource.maxFragmentImageUniforms					= 8;
-	default_built_in_resource.maxCombinedImageUniforms					= 8;
-	default_built_in_resource.maxGeometryTextureImageUnits				= 16;
-	default_built_in_resource.maxGeometryOutputVertices					= 256;
-	default_built_in_resource.maxGeometryTotalOutputComponents			= 1024;
-	default_built_in_resource.maxGeometryUniformComponents				= 1024;
-	default_built_in_resource.maxGeometryVaryingComponents				= 64;
-	default_built_in_resource.maxTessControlInputComponents				= 128;
-	default_built_in_resource.maxTessControlOutputComponents			= 128;
-	default_built_in_resource.maxTessControlTextureImageUnits			= 16;
-	default_built_in_resource.maxTessControlUniformComponents			= 1024;
-	default_built_in_resource.maxTessControlTotalOutputComponents		= 4096;
-	default_built_in_resource.maxTessEvaluationInputComponents			= 128;
-	default_built_in_resource.maxTessEvaluationOutputComponents			= 128;
-	default_built_in_resource.maxTessEvaluationTextureImageUnits		= 16;
-	default_built_in_resource.maxTessEvaluationUniformComponents		= 1024;
-	default_built_in_resource.maxTessPatchComponents					= 120;
-	default_built_in_resource.maxPatchVertices							= 32;
-	default_built_in_resource.maxTessGenLevel							= 64;
-	default_built_in_resource.maxViewports								= 16;
-	default_built_in_resource.maxVertexAtomicCounters					= 0;
-	default_built_in_resource.maxTessControlAtomicCounters				= 0;
-	default_built_in_resource.maxTessEvaluationAtomicCounters			= 0;
-	default_built_in_resource.maxGeometryAtomicCounters					= 0;
-	default_built_in_resource.maxFragmentAtomicCounters					= 8;
-	default_built_in_resource.maxCombinedAtomicCounters					= 8;
-	default_built_in_resource.maxAtomicCounterBindings					= 1;
-	default_built_in_resource.maxVertexAtomicCounterBuffers				= 0;
-	default_built_in_resource.maxTessControlAtomicCounterBuffers		= 0;
-	default_built_in_resource.maxTessEvaluationAtomicCounterBuffers		= 0;
-	default_built_in_resource.maxGeometryAtomicCounterBuffers			= 0;
-	default_built_in_resource.maxFragmentAtomicCounterBuffers			= 1;
-	default_built_in_resource.maxCombinedAtomicCounterBuffers			= 1;
-	default_built_in_resource.maxAtomicCounterBufferSize				= 16384;
-	default_built_in_resource.maxTransformFeedbackBuffers				= 4;
-	default_built_in_resource.maxTransformFeedbackInterleavedComponents	= 64;
-	default_built_in_resource.maxCullDistances							= 8;
-	default_built_in_resource.maxCombinedClipAndCullDistances			= 8;
-	default_built_in_resource.maxSamples								= 4;
-	default_built_in_resource.maxMeshOutputVerticesNV					= 256;
-	default_built_in_resource.maxMeshOutputPrimitivesNV					= 512;
-	default_built_in_resource.maxMeshWorkGroupSizeX_NV					= 32;
-	default_built_in_resource.maxMeshWorkGroupSizeY_NV					= 1;
-	default_built_in_resource.maxMeshWorkGroupSizeZ_NV					= 1;
-	default_built_in_resource.maxTaskWorkGroupSizeX_NV					= 32;
-	default_built_in_resource.maxTaskWorkGroupSizeY_NV					= 1;
-	default_built_in_resource.maxTaskWorkGroupSizeZ_NV					= 1;
-	default_built_in_resource.maxMeshViewCountNV						= 4;
-
-	EShMessages messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
-	const std::uint32_t default_version = 100;
-
-	// Preprocessing GLSL
-	DirStackFileIncluder shader_includer = {};
-	shader_includer.pushExternalLocalDirectory(path);
-
-	std::string preprocessed_glsl_str = {};
-
-	if (!shader.preprocess(
-		&default_built_in_resource,
-		default_version,
-		ENoProfile,
-		false,
-		false,
-		messages,
-		&preprocessed_glsl_str,
-		shader_includer))
+	const auto elapsed_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time);
+
+	spdlog::info(
+		"Compiled {} shader stage(s) of {} shader(s) on {} worker thread(s) in {:.1f} ms.",
+		stage_count,
+		requests.size(),
+		thread_pool.GetThreadCount(),
+		elapsed_time.count());
+
+	return shaders;
+}
+
+void VulkanShader::CreateFromCompiledStages(
+	const VulkanDevice& device,
+	const std::vector<CompiledStage>& stages) noexcept(false)
+{
+	// Create all pipeline shader stage create infos
+	for (const auto& stage : stages)
 	{
-		spdlog::error("Could not pre-process GLSL for: \"{}\".", path);
-		spdlog::error(shader.getInfoLog());
-		spdlog::error(shader.getInfoDebugLog());
+		const auto shader_module = CreateShaderModule(device, stage.spirv);
+
+		VkPipelineShaderStageCreateInfo shader_stage_info = {};
+		shader_stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shader_stage_info.stage = static_cast<VkShaderStageFlagBits>(stage.type);
+		shader_stage_info.module = shader_module;
+		shader_stage_info.pName = "main";
 
-		throw exception::CriticalVulkanError("Failed to preprocess GLSL.");
+		m_shader_modules.push_back(shader_module);
+		m_shader_stage_infos.push_back(shader_stage_info);
+
+		// Collect the resources used by this stage
+		MergeShaderReflection(m_reflection, stage.reflection);
+
+		m_dependencies.insert(m_dependencies.end(), stage.dependencies.begin(), stage.dependencies.end());
 	}
 
-	// Save preprocessed GLSL to the shader (replaces old GLSL)
-	const auto preprocessed_glsl_cstr = preprocessed_glsl_str.c_str();
-	shader.setStrings(&preprocessed_glsl_cstr, 1);
+	std::sort(m_dependencies.begin(), m_dependencies.end());
+	m_dependencies.erase(std::unique(m_dependencies.begin(), m_dependencies.end()), m_dependencies.end());
+}
 
-	// Parse the shader
-	if (!shader.parse(
-		&default_built_in_resource,
-		default_version,
-		false,
-		messages))
+VulkanShader::CompiledStage VulkanShader::CompileStage(
+	const std::string& path,
+	ShaderType type,
+	const std::vector<std::string>& defines) noexcept(false)
+{
+	CompiledStage stage = {};
+	stage.type = type;
+	stage.dependencies.push_back(path);
+
+	BakedShaderStage baked_stage = {};
+	auto use_baked_stage = false;
+
+	if (shader_bundle && shader_bundle->Find(path, defines, baked_stage))
 	{
-		spdlog::error("Could not parse GLSL for: \"{}\".", path);
-		spdlog::error(shader.getInfoLog());
-		spdlog::error(shader.getInfoDebugLog());
+		std::uint64_t source_hash = 0;
+
+		// Builds that ship without the GLSL sources always use the bundle
+		const auto has_sources = VulkanShaderBundle::HashSourceFiles(baked_stage.dependencies, source_hash);
+		use_baked_stage = !has_sources || source_hash == baked_stage.source_hash;
+
+#ifdef VKC_NO_RUNTIME_SHADER_COMPILATION
+		if (!use_baked_stage)
+		{
+			spdlog::warn("Shader stage \"{}\" changed since the shader bundle was baked, runtime shader compilation is disabled so the baked stage is used.", VulkanShaderBundle::MakeKey(path, defines));
+			use_baked_stage = true;
+		}
+#else
+		if (!use_baked_stage)
+		{
+			spdlog::warn("Shader stage \"{}\" changed since the shader bundle was baked, compiling it from source instead (bake the shaders again to update the bundle).", VulkanShaderBundle::MakeKey(path, defines));
+		}
+#endif // VKC_NO_RUNTIME_SHADER_COMPILATION
+
+		// Baked stages are watched through the sources they were baked from, an edit recompiles them from source
+		if (use_baked_stage)
+		{
+			stage.dependencies = has_sources ? baked_stage.dependencies : std::vector<std::string>{};
+		}
+	}
 
-		throw exception::CriticalVulkanError("Failed to parse GLSL.");
+	if (use_baked_stage)
+	{
+		stage.spirv.assign(baked_stage.spirv, baked_stage.spirv + baked_stage.word_count);
+	}
+	else
+	{
+#ifdef VKC_NO_RUNTIME_SHADER_COMPILATION
+		spdlog::error("Shader stage \"{}\" is not in the shader bundle.", VulkanShaderBundle::MakeKey(path, defines));
+		throw exception::CriticalIOError("Shader stage is missing from the shader bundle, and runtime shader compilation is disabled.");
+#else
+		stage.spirv = CompileGLSL(path, defines, stage.dependencies);
+#endif // VKC_NO_RUNTIME_SHADER_COMPILATION
 	}
+	stage.reflection = ReflectSPIRV(stage.spirv, static_cast<VkShaderStageFlagBits>(type));
 
-	// Link the shader to a program
-	TProgram shader_program = {};
-	shader_program.addShader(&shader);
+	return stage;
+}
 
-	if (!shader_program.link(messages))
-	{
-		spdlog::error("Could not link GLSL program for: \"{}\".", path);
-		spdlog::error(shader.getInfoLog());
-		spdlog::error(shader.getInfoDebugLog());
+void VulkanShader::UseShaderBundle(const VulkanShaderBundle* bundle) noexcept(true)
+{
+	shader_bundle = bundle;
+}
 
-		throw exception::CriticalVulkanError("Failed to link GLSL program.");
+void VulkanShader::Destroy(const VulkanDevice& device) const noexcept(true)
+{
+	for (const auto& shader_module : m_shader_modules)
+	{
+		vkDestroyShaderModule(
+			device.GetLogicalDeviceNative(),
+			shader_module,
+			nullptr);
 	}
+}
 
-	std::vector<std::uint32_t> spirv = {};
-	spv::SpvBuildLogger spirv_logger = {};
-	SpvOptions spirv_options = {};
-	GlslangToSpv(
-		*shader_program.getIntermediate(shader_stage_type),
-		spirv,
-		&spirv_logger,
-		&spirv_options);
+const std::vector<VkPipelineShaderStageCreateInfo>& VulkanShader::GetPipelineShaderStageInfos() const noexcept(true)
+{
+	return m_shader_stage_infos;
+}
 
-	return spirv;
+const ShaderReflection& VulkanShader::GetReflection() const noexcept(true)
+{
+	return m_reflection;
+}
+
+const std::vector<std::string>& VulkanShader::GetDependencies() const noexcept(true)
+{
+	return m_dependencies;
 }
 
 VkShaderModule VulkanShader::CreateShaderModule(
@@ -286,42 +247,3 @@ VkShaderModule VulkanShader::CreateShaderModule(
 
 	return shader_module;
 }
-
-EShLanguage VulkanShader::GetShaderStageType(
-	const std::string& path) const noexcept(false)
-{
-	// Get the file extension
-	auto extension_start = path.rfind('.');
-	auto extension = path.substr(extension_start + 1);
-
-	// Find the correct shader type
-	if (extension == "vert")
-	{
-		return EShLangVertex;
-	}
-	else if (extension == "tesc")
-	{
-		return EShLangTessControl;
-	}
-	else if (extension == "tese")
-	{
-		return EShLangTessEvaluation;
-	}
-	else if (extension == "geom")
-	{
-		return EShLangGeometry;
-	}
-	else if (extension == "frag")
-	{
-		return EShLangFragment;
-	}
-	else if (extension == "comp")
-	{
-		return EShLangCompute;
-	}
-	else
-	{
-		throw exception::CriticalIOError("Unknown shader file extension.");
-		return EShLangCount;
-	}
-}
@@ -1,8 +1,8 @@
 #ifndef VULKAN_SHADER_HPP
 #define VULKAN_SHADER_HPP
 
-// Glslang (needs to be included before Vulkan header)
-#include <glslang/Public/ShaderLang.h>
+// Application
+#include "vulkan_shader_reflection.hpp"
 
 // Vulkan
 #include <vulkan/vulkan.h>
@@ -11,9 +11,15 @@
 #include <string>
 #include <vector>
 
+namespace vkc::core
+{
+	class ThreadPool;
+}
+
 namespace vkc::vk_wrapper
 {
 	class VulkanDevice;
+	class VulkanShaderBundle;
 
 	/** Types of shader supported by this application */
 	enum class ShaderType
@@ -30,6 +36,13 @@ namespace vkc::vk_wrapper
 		RayAnyHit_NV = VK_SHADER_STAGE_ANY_HIT_BIT_NV
 	};
 
+	/** Sources and preprocessor definitions of a shader that is compiled as part of a batch */
+	struct ShaderCompileRequest
+	{
+		std::vector<std::pair<std::string, ShaderType>> shader_files;
+		std::vector<std::string> defines;
+	};
+
 	class VulkanShader
 	{
 	public:
@@ -37,9 +50,35 @@ namespace vkc::vk_wrapper
 		~VulkanShader() noexcept(true) {}
 
 		/** Create a Vulkan shader (includes loading / storing) */
+		/**
+		 * Every stage is compiled with the preprocessor definitions in
+		 * "defines", either "NAME" or "NAME=VALUE".
+		 */
 		void Create(
 			const VulkanDevice& device,
-			const std::vector<std::pair<std::string, ShaderType>>& shader_files) noexcept(false);
+			const std::vector<std::pair<std::string, ShaderType>>& shader_files,
+			const std::vector<std::string>& defines = {}) noexcept(false);
+
+		/** Compile many shaders at once, every stage of every shader is compiled as a separate job */
+		/**
+		 * Blocks until all jobs are done, the shaders are returned in the same
+		 * order as the requests. Throws the first compile error after every
+		 * job has finished, in which case no shader is created at all.
+		 */
+		static std::vector<VulkanShader> CreateBatch(
+			const VulkanDevice& device,
+			core::ThreadPool& thread_pool,
+			const std::vector<ShaderCompileRequest>& requests) noexcept(false);
+
+		/** Load precompiled SPIR-V from a shader bundle instead of compiling GLSL */
+		/**
+		 * Stages that are not in the bundle, or whose sources changed since
+		 * they were baked, are still compiled from GLSL, unless runtime shader
+		 * compilation has been disabled in the build.
+		 * Call this before any shader is created, pass nullptr to go back to
+		 * compiling every stage.
+		 */
+		static void UseShaderBundle(const VulkanShaderBundle* bundle) noexcept(true);
 
 		/** Destroy all Vulkan objects */
 		void Destroy(const VulkanDevice& device) const noexcept(true);
@@ -47,33 +86,60 @@ namespace vkc::vk_wrapper
 		/** Get a reference to the pipeline shader stage create info vector */
 		const std::vector<VkPipelineShaderStageCreateInfo>& GetPipelineShaderStageInfos() const noexcept(true);
 
-	private:
-		/** Load GLSL from file and convert to byte code */
+		/** Get the resources used by all stages of the shader */
 		/**
-		 * GLSL -> SPIRV referenced from: https://forestsharp.com/glslang-cpp/
-		 * Shader includes are supported as long as each shader file has the
-		 * following code at the top:
-		 *
-		 * "#extension GL_GOOGLE_include_directive : enable"
+		 * Use this to create descriptor set layouts, pipeline layouts, and
+		 * descriptor pools instead of describing the shader interface by hand.
 		 */
-		std::vector<std::uint32_t> GetSPIRV(
-			const std::string& path) const noexcept(false);
+		const ShaderReflection& GetReflection() const noexcept(true);
+
+		/** Get the source files of all stages, along with every file they include */
+		/**
+		 * Paths are stored the way the files were opened, a change to any of
+		 * these files means the shader has to be recompiled.
+		 */
+		const std::vector<std::string>& GetDependencies() const noexcept(true);
+
+	private:
+		/** Compiled bytecode of a single stage, along with its reflection data */
+		struct CompiledStage
+		{
+			ShaderType type = ShaderType::Vertex;
+			std::vector<std::uint32_t> spirv;
+			ShaderReflection reflection;
+
+			/** Source file of the stage and the files it includes */
+			std::vector<std::string> dependencies;
+		};
+
+		/** Create the shader modules of stages that have already been compiled */
+		void CreateFromCompiledStages(
+			const VulkanDevice& device,
+			const std::vector<CompiledStage>& stages) noexcept(false);
+
+		/** Compile (or load from the shader bundle) and reflect a single stage, safe to call from any thread */
+		static CompiledStage CompileStage(
+			const std::string& path,
+			ShaderType type,
+			const std::vector<std::string>& defines) noexcept(false);
 
 		/** Create a shader module out of shader bytecode */
 		VkShaderModule CreateShaderModule(
 			const VulkanDevice& device,
 			const std::vector<std::uint32_t>& bytecode) const noexcept(false);
 
-		/** Return the correct GLslang shader type based on file extension */
-		EShLanguage GetShaderStageType(
-			const std::string& path) const noexcept(false);
-
 	private:
 		std::vector<VkShaderModule> m_shader_modules;
 		std::vector<VkPipelineShaderStageCreateInfo> m_shader_stage_infos;
 
-		/** Glslang only needs to be initialized once in the application */
-		static inline bool glsl_lang_initialized = false;
+		/** Reflection data of all shader stages merged together */
+		ShaderReflection m_reflection;
+
+		/** Sorted, without duplicates */
+		std::vector<std::string> m_dependencies;
+
+		/** Precompiled SPIR-V, not owned by the shader */
+		static inline const VulkanShaderBundle* shader_bundle = nullptr;
 	};
 }
 
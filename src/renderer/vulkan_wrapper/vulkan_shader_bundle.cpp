@@ -0,0 +1,275 @@
+// Application
+#include "core/hash.hpp"
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_shader_bundle.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+#ifdef _WIN32
+// Windows
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+VulkanShaderBundle::VulkanShaderBundle() noexcept(true)
+	: m_data(nullptr)
+	, m_size(0)
+#ifdef _WIN32
+	, m_file_handle(nullptr)
+	, m_mapping_handle(nullptr)
+#else
+	, m_file_descriptor(-1)
+#endif // _WIN32
+{}
+
+VulkanShaderBundle::~VulkanShaderBundle() noexcept(true)
+{}
+
+void VulkanShaderBundle::Open(const std::string& path) noexcept(false)
+{
+#ifdef _WIN32
+	m_file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (m_file_handle == INVALID_HANDLE_VALUE)
+	{
+		m_file_handle = nullptr;
+		throw CriticalIOError("Could not open the shader bundle.");
+	}
+
+	LARGE_INTEGER file_size = {};
+	GetFileSizeEx(m_file_handle, &file_size);
+	m_size = static_cast<std::size_t>(file_size.QuadPart);
+
+	m_mapping_handle = CreateFileMappingA(m_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (m_mapping_handle)
+	{
+		m_data = static_cast<const std::uint8_t*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+	}
+#else
+	m_file_descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (m_file_descriptor < 0)
+	{
+		throw CriticalIOError("Could not open the shader bundle.");
+	}
+
+	struct stat file_status = {};
+	fstat(m_file_descriptor, &file_status);
+	m_size = static_cast<std::size_t>(file_status.st_size);
+
+	if (m_size > 0)
+	{
+		auto data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file_descriptor, 0);
+		m_data = (data == MAP_FAILED) ? nullptr : static_cast<const std::uint8_t*>(data);
+	}
+#endif // _WIN32
+
+	if (!m_data)
+	{
+		Close();
+		throw CriticalIOError("Could not map the shader bundle into memory.");
+	}
+
+	if (!Validate())
+	{
+		Close();
+		throw CriticalIOError("Shader bundle is corrupt or was baked by an incompatible version of the shader baker.");
+	}
+
+	spdlog::info("Mapped shader bundle \"{}\" with {} shader stage(s).", path, GetEntryCount());
+}
+
+void VulkanShaderBundle::Close() noexcept(true)
+{
+#ifdef _WIN32
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+	}
+
+	if (m_mapping_handle)
+	{
+		CloseHandle(m_mapping_handle);
+	}
+
+	if (m_file_handle)
+	{
+		CloseHandle(m_file_handle);
+	}
+
+	m_mapping_handle = nullptr;
+	m_file_handle = nullptr;
+#else
+	if (m_data)
+	{
+		munmap(const_cast<std::uint8_t*>(m_data), m_size);
+	}
+
+	if (m_file_descriptor >= 0)
+	{
+		close(m_file_descriptor);
+	}
+
+	m_file_descriptor = -1;
+#endif // _WIN32
+
+	m_data = nullptr;
+	m_size = 0;
+}
+
+bool VulkanShaderBundle::IsOpen() const noexcept(true)
+{
+	return m_data != nullptr;
+}
+
+bool VulkanShaderBundle::Find(
+	const std::string& path,
+	const std::vector<std::string>& defines,
+	BakedShaderStage& stage) const noexcept(false)
+{
+	if (!m_data)
+	{
+		return false;
+	}
+
+	const auto key = MakeKey(path, defines);
+	const auto get_key = [this](const ShaderBundleEntry& entry)
+	{
+		return std::string_view(reinterpret_cast<const char*>(m_data + entry.key_offset), entry.key_size);
+	};
+
+	// Entries are sorted by key
+	const auto entries_begin = GetEntries();
+	const auto entries_end = entries_begin + GetEntryCount();
+	auto entry = std::lower_bound(
+		entries_begin,
+		entries_end,
+		key,
+		[&get_key](const ShaderBundleEntry& entry, const std::string& key)
+		{
+			return get_key(entry) < key;
+		});
+
+	if (entry == entries_end || get_key(*entry) != key)
+	{
+		return false;
+	}
+
+	stage.spirv = reinterpret_cast<const std::uint32_t*>(m_data + entry->spirv_offset);
+	stage.word_count = entry->spirv_word_count;
+	stage.source_hash = entry->source_hash;
+	stage.dependencies.clear();
+
+	const auto dependencies = std::string_view(reinterpret_cast<const char*>(m_data + entry->dependencies_offset), entry->dependencies_size);
+
+	for (std::size_t begin = 0; begin < dependencies.size();)
+	{
+		auto end = dependencies.find('\n', begin);
+		end = (end == std::string_view::npos) ? dependencies.size() : end;
+
+		stage.dependencies.emplace_back(dependencies.substr(begin, end - begin));
+		begin = end + 1;
+	}
+
+	return true;
+}
+
+std::uint32_t VulkanShaderBundle::GetEntryCount() const noexcept(true)
+{
+	return m_data ? reinterpret_cast<const ShaderBundleHeader*>(m_data)->entry_count : 0;
+}
+
+std::string VulkanShaderBundle::MakeKey(
+	const std::string& path,
+	const std::vector<std::string>& defines) noexcept(true)
+{
+	auto key = std::filesystem::path(path).lexically_normal().generic_string();
+
+	for (const auto& define : defines)
+	{
+		key += '|' + define;
+	}
+
+	return key;
+}
+
+bool VulkanShaderBundle::HashSourceFiles(
+	const std::vector<std::string>& paths,
+	std::uint64_t& hash) noexcept(false)
+{
+	hash = core::fnv1a_offset_basis;
+
+	for (const auto& path : paths)
+	{
+		std::ifstream file(path, std::ios::binary);
+
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		const auto size = static_cast<std::uint64_t>(contents.size());
+
+		// The size keeps the boundaries between files apart
+		hash = core::HashBytes(&size, sizeof(size), hash);
+		hash = core::HashBytes(contents.data(), contents.size(), hash);
+	}
+
+	return true;
+}
+
+bool VulkanShaderBundle::Validate() const noexcept(true)
+{
+	if (m_size < sizeof(ShaderBundleHeader))
+	{
+		return false;
+	}
+
+	const auto header = reinterpret_cast<const ShaderBundleHeader*>(m_data);
+
+	if (header->magic != shader_bundle_magic ||
+		header->version != shader_bundle_version ||
+		sizeof(ShaderBundleHeader) + static_cast<std::size_t>(header->entry_count) * sizeof(ShaderBundleEntry) > m_size)
+	{
+		return false;
+	}
+
+	const auto entries = GetEntries();
+
+	return std::all_of(
+		entries,
+		entries + header->entry_count,
+		[this](const ShaderBundleEntry& entry)
+		{
+			return
+				static_cast<std::size_t>(entry.key_offset) + entry.key_size <= m_size &&
+				static_cast<std::size_t>(entry.dependencies_offset) + entry.dependencies_size <= m_size &&
+				entry.spirv_offset % sizeof(std::uint32_t) == 0 &&
+				static_cast<std::size_t>(entry.spirv_offset) + static_cast<std::size_t>(entry.spirv_word_count) * sizeof(std::uint32_t) <= m_size;
+		});
+}
+
+const ShaderBundleEntry* VulkanShaderBundle::GetEntries() const noexcept(true)
+{
+	return reinterpret_cast<const ShaderBundleEntry*>(m_data + sizeof(ShaderBundleHeader));
+}
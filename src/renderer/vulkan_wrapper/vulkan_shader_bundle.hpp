@@ -0,0 +1,125 @@
+#ifndef VULKAN_SHADER_BUNDLE_HPP
+#define VULKAN_SHADER_BUNDLE_HPP
+
+// C++ standard
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	/** First four bytes of every shader bundle ("VKSB") */
+	static const constexpr std::uint32_t shader_bundle_magic = 0x42534b56;
+
+	/** Bumped whenever the layout of the bundle changes */
+	static const constexpr std::uint32_t shader_bundle_version = 2;
+
+	/** Start of a shader bundle file */
+	/**
+	 * The header is followed by "entry_count" entries sorted by key, the key
+	 * and dependency strings, and finally the SPIR-V of every entry (aligned
+	 * to four bytes). All offsets are in bytes from the start of the file.
+	 */
+	struct ShaderBundleHeader
+	{
+		std::uint32_t magic = shader_bundle_magic;
+		std::uint32_t version = shader_bundle_version;
+		std::uint32_t entry_count = 0;
+		std::uint32_t reserved = 0;
+	};
+
+	/** Location of the SPIR-V of a single shader stage in the bundle */
+	struct ShaderBundleEntry
+	{
+		std::uint32_t key_offset = 0;
+		std::uint32_t key_size = 0;
+		std::uint32_t spirv_offset = 0;
+		std::uint32_t spirv_word_count = 0;
+
+		/** Source file and included files of the stage, separated by newlines */
+		std::uint32_t dependencies_offset = 0;
+		std::uint32_t dependencies_size = 0;
+
+		/** Hash of the contents of all dependencies when the stage was baked */
+		std::uint64_t source_hash = 0;
+	};
+
+	/** Shader stage found in a shader bundle */
+	struct BakedShaderStage
+	{
+		/** Points into the mapped file, stays valid until the bundle is closed */
+		const std::uint32_t* spirv = nullptr;
+		std::size_t word_count = 0;
+
+		std::vector<std::string> dependencies;
+		std::uint64_t source_hash = 0;
+	};
+
+	/** Precompiled SPIR-V of all shader stages and permutations, produced by the shader baker */
+	/**
+	 * The bundle is memory-mapped, looking up a shader stage does not read or
+	 * compile anything. Stages are looked up by their source path and the
+	 * preprocessor definitions they were compiled with, in that order.
+	 *
+	 * Every stage remembers its source files and a hash of their contents,
+	 * so a stage whose sources changed after baking can be detected.
+	 *
+	 * The bundle has to stay open while shaders are being created from it.
+	 * Lookups are thread-safe.
+	 */
+	class VulkanShaderBundle
+	{
+	public:
+		VulkanShaderBundle() noexcept(true);
+		~VulkanShaderBundle() noexcept(true);
+
+		/** Map the bundle into memory, throws when the file is missing or not a valid bundle */
+		void Open(const std::string& path) noexcept(false);
+
+		/** Unmap the bundle */
+		void Close() noexcept(true);
+
+		/** Check whether a bundle is mapped */
+		bool IsOpen() const noexcept(true);
+
+		/** Find a shader stage, returns false when the bundle does not contain it */
+		bool Find(
+			const std::string& path,
+			const std::vector<std::string>& defines,
+			BakedShaderStage& stage) const noexcept(false);
+
+		/** Get the number of shader stages in the bundle */
+		std::uint32_t GetEntryCount() const noexcept(true);
+
+		/** Key a shader stage is stored under, the normalized path followed by every definition */
+		static std::string MakeKey(
+			const std::string& path,
+			const std::vector<std::string>& defines) noexcept(true);
+
+		/** Hash the contents of the source files of a stage, returns false when any of them cannot be read */
+		static bool HashSourceFiles(
+			const std::vector<std::string>& paths,
+			std::uint64_t& hash) noexcept(false);
+
+	private:
+		/** Check the header and make sure every entry lies within the file */
+		bool Validate() const noexcept(true);
+
+		/** Get the entries, they directly follow the header */
+		const ShaderBundleEntry* GetEntries() const noexcept(true);
+
+	private:
+		const std::uint8_t* m_data;
+		std::size_t m_size;
+
+#ifdef _WIN32
+		void* m_file_handle;
+		void* m_mapping_handle;
+#else
+		int m_file_descriptor;
+#endif // _WIN32
+	};
+}
+
+#endif // VULKAN_SHADER_BUNDLE_HPP
@@ -0,0 +1,321 @@
+// Glslang
+#include <SPIRV/GlslangToSpv.h>
+#include <StandAlone/DirStackFileIncluder.h>
+#include <glslang/Public/ShaderLang.h>
+
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_shader_compiler.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <fstream>
+#include <mutex>
+
+using namespace glslang;
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+namespace
+{
+	/** Glslang only needs to be initialized once in the application, the first compiling thread does it */
+	std::once_flag glslang_initialized;
+
+	/** Include handler that remembers every file it included, used to find the shaders affected by a file change */
+	class DependencyTrackingIncluder : public DirStackFileIncluder
+	{
+	public:
+		explicit DependencyTrackingIncluder(std::vector<std::string>& included_files)
+			: m_included_files(included_files)
+		{}
+
+		IncludeResult* includeLocal(
+			const char* header_name,
+			const char* includer_name,
+			size_t inclusion_depth) override
+		{
+			auto result = DirStackFileIncluder::includeLocal(header_name, includer_name, inclusion_depth);
+
+			if (result)
+			{
+				// The header name of the result is the path the file was opened with
+				m_included_files.push_back(result->headerName);
+			}
+
+			return result;
+		}
+
+	private:
+		std::vector<std::string>& m_included_files;
+	};
+
+	/** Return the correct GLslang shader type based on file extension */
+	EShLanguage GetShaderStageType(const std::string& path) noexcept(false)
+	{
+		// Get the file extension
+		auto extension_start = path.rfind('.');
+		auto extension = path.substr(extension_start + 1);
+
+		// Find the correct shader type
+		if (extension == "vert")
+		{
+			return EShLangVertex;
+		}
+		else if (extension == "tesc")
+		{
+			return EShLangTessControl;
+		}
+		else if (extension == "tese")
+		{
+			return EShLangTessEvaluation;
+		}
+		else if (extension == "geom")
+		{
+			return EShLangGeometry;
+		}
+		else if (extension == "frag")
+		{
+			return EShLangFragment;
+		}
+		else if (extension == "comp")
+		{
+			return EShLangCompute;
+		}
+		else
+		{
+			throw CriticalIOError("Unknown shader file extension.");
+			return EShLangCount;
+		}
+	}
+}
+
+std::vector<std::uint32_t> vkc::vk_wrapper::CompileGLSL(
+	const std::string& path,
+	const std::vector<std::string>& defines,
+	std::vector<std::string>& included_files,
+	const GlslCompileOptions& options) noexcept(false)
+{
+	std::call_once(glslang_initialized, []() { InitializeProcess(); });
+
+	// Open the GLSL file
+	std::ifstream shader_file(path);
+
+	if (!shader_file.is_open())
+	{
+		// Could not open the file
+		throw CriticalIOError("Could not open shader file.");
+	}
+
+	// Dump the contents of the entire file into a string
+	std::string glsl_str(
+		(std::istreambuf_iterator<char>(shader_file)),
+		std::istreambuf_iterator<char>());
+
+	// Convert to a C-string
+	const auto glsl_cstr = glsl_str.c_str();
+
+	// Determine shader type
+	const auto shader_stage_type = GetShaderStageType(path);
+
+	// Configure a Glslang shader object
+	const int client_input_semantics_version = 100;	// #define VULKAN 100
+	const auto vulkan_client_version = EShTargetVulkan_1_0;
+	const auto target_version = EShTargetSpv_1_0;
+
+	// Definitions end up right after the "#version" directive, "NAME=VALUE" becomes "#define NAME VALUE"
+	std::string preamble = {};
+
+	for (const auto& define : defines)
+	{
+		auto definition = define;
+		const auto value_start = definition.find('=');
+
+		if (value_start != std::string::npos)
+		{
+			definition[value_start] = ' ';
+		}
+
+		preamble += "#define " + definition + "\n";
+	}
+
+	TShader shader(shader_stage_type);
+	shader.setStrings(&glsl_cstr, 1);
+	shader.setPreamble(preamble.c_str());
+	shader.setEnvInput(
+		EShSourceGlsl,
+		shader_stage_type,
+		EShClientVulkan,
+		client_input_semantics_version);
+	shader.setEnvClient(EShClientVulkan, vulkan_client_version);
+	shader.setEnvTarget(EShTargetSpv, target_version);
+
+	// Values copied from the default configuration file generated by
+	// glslangvalidator.exe
+	TBuiltInResource default_built_in_resource							= {};
+	default_built_in_resource.maxLights									= 32;
+	default_built_in_resource.maxClipPlanes								= 6;
+	default_built_in_resource.maxTextureUnits							= 32;
+	default_built_in_resource.maxTextureCoords							= 32;
+	default_built_in_resource.maxVertexAttribs							= 64;
+	default_built_in_resource.maxVertexUniformComponents				= 4096;
+	default_built_in_resource.maxVaryingFloats							= 64;
+	default_built_in_resource.maxVertexTextureImageUnits				= 32;
+	default_built_in_resource.maxCombinedTextureImageUnits				= 80;
+	default_built_in_resource.maxTextureImageUnits						= 32;
+	default_built_in_resource.maxFragmentUniformComponents				= 4096;
+	default_built_in_resource.maxDrawBuffers							= 32;
+	default_built_in_resource.maxVertexUniformVectors					= 128;
+	default_built_in_resource.maxVaryingVectors							= 8;
+	default_built_in_resource.maxFragmentUniformVectors					= 16;
+	default_built_in_resource.maxVertexOutputVectors					= 16;
+	default_built_in_resource.maxFragmentInputVectors					= 15;
+	default_built_in_resource.minProgramTexelOffset						= -8;
+	default_built_in_resource.maxProgramTexelOffset						= 7;
+	default_built_in_resource.maxClipDistances							= 8;
+	default_built_in_resource.maxComputeWorkGroupCountX					= 65535;
+	default_built_in_resource.maxComputeWorkGroupCountY					= 65535;
+	default_built_in_resource.maxComputeWorkGroupCountZ					= 65535;
+	default_built_in_resource.maxComputeWorkGroupSizeX					= 1024;
+	default_built_in_resource.maxComputeWorkGroupSizeY					= 1024;
+	default_built_in_resource.maxComputeWorkGroupSizeZ					= 64;
+	default_built_in_resource.maxComputeUniformComponents				= 1024;
+	default_built_in_resource.maxComputeTextureImageUnits				= 16;
+	default_built_in_resource.maxComputeImageUniforms					= 8;
+	default_built_in_resource.maxComputeAtomicCounters					= 8;
+	default_built_in_resource.maxComputeAtomicCounterBuffers			= 1;
+	default_built_in_resource.maxVaryingComponents						= 60;
+	default_built_in_resource.maxVertexOutputComponents					= 64;
+	default_built_in_resource.maxGeometryInputComponents				= 64;
+	default_built_in_resource.maxGeometryOutputComponents				= 128;
+	default_built_in_resource.maxFragmentInputComponents				= 128;
+	default_built_in_resource.maxImageUnits								= 8;
+	default_built_in_resource.maxCombinedImageUnitsAndFragmentOutputs	= 8;
+	default_built_in_resource.maxCombinedShaderOutputResources			= 8;
+	default_built_in_resource.maxImageSamples							= 0;
+	default_built_in_resource.maxVertexImageUniforms					= 0;
+	default_built_in_resource.maxTessControlImageUniforms				= 0;
+	default_built_in_resource.maxTessEvaluationImageUniforms			= 0;
+	default_built_in_resource.maxGeometryImageUniforms					= 0;
+	default_built_in_resource.maxFragmentImageUniforms					= 8;
+	default_built_in_resource.maxCombinedImageUniforms					= 8;
+	default_built_in_resource.maxGeometryTextureImageUnits				= 16;
+	default_built_in_resource.maxGeometryOutputVertices					= 256;
+	default_built_in_resource.maxGeometryTotalOutputComponents			= 1024;
+	default_built_in_resource.maxGeometryUniformComponents				= 1024;
+	default_built_in_resource.maxGeometryVaryingComponents				= 64;
+	default_built_in_resource.maxTessControlInputComponents				= 128;
+	default_built_in_resource.maxTessControlOutputComponents			= 128;
+	default_built_in_resource.maxTessControlTextureImageUnits			= 16;
+	default_built_in_resource.maxTessControlUniformComponents			= 1024;
+	default_built_in_resource.maxTessControlTotalOutputComponents		= 4096;
+	default_built_in_resource.maxTessEvaluationInputComponents			= 128;
+	default_built_in_resource.maxTessEvaluationOutputComponents			= 128;
+	default_built_in_resource.maxTessEvaluationTextureImageUnits		= 16;
+	default_built_in_resource.maxTessEvaluationUniformComponents		= 1024;
+	default_built_in_resource.maxTessPatchComponents					= 120;
+	default_built_in_resource.maxPatchVertices							= 32;
+	default_built_in_resource.maxTessGenLevel							= 64;
+	default_built_in_resource.maxViewports								= 16;
+	default_built_in_resource.maxVertexAtomicCounters					= 0;
+	default_built_in_resource.maxTessControlAtomicCounters				= 0;
+	default_built_in_resource.maxTessEvaluationAtomicCounters			= 0;
+	default_built_in_resource.maxGeometryAtomicCounters					= 0;
+	default_built_in_resource.maxFragmentAtomicCounters					= 8;
+	default_built_in_resource.maxCombinedAtomicCounters					= 8;
+	default_built_in_resource.maxAtomicCounterBindings					= 1;
+	default_built_in_resource.maxVertexAtomicCounterBuffers				= 0;
+	default_built_in_resource.maxTessControlAtomicCounterBuffers		= 0;
+	default_built_in_resource.maxTessEvaluationAtomicCounterBuffers		= 0;
+	default_built_in_resource.maxGeometryAtomicCounterBuffers			= 0;
+	default_built_in_resource.maxFragmentAtomicCounterBuffers			= 1;
+	default_built_in_resource.maxCombinedAtomicCounterBuffers			= 1;
+	default_built_in_resource.maxAtomicCounterBufferSize				= 16384;
+	default_built_in_resource.maxTransformFeedbackBuffers				= 4;
+	default_built_in_resource.maxTransformFeedbackInterleavedComponents	= 64;
+	default_built_in_resource.maxCullDistances							= 8;
+	default_built_in_resource.maxCombinedClipAndCullDistances			= 8;
+	default_built_in_resource.maxSamples								= 4;
+	default_built_in_resource.maxMeshOutputVerticesNV					= 256;
+	default_built_in_resource.maxMeshOutputPrimitivesNV					= 512;
+	default_built_in_resource.maxMeshWorkGroupSizeX_NV					= 32;
+	default_built_in_resource.maxMeshWorkGroupSizeY_NV					= 1;
+	default_built_in_resource.maxMeshWorkGroupSizeZ_NV					= 1;
+	default_built_in_resource.maxTaskWorkGroupSizeX_NV					= 32;
+	default_built_in_resource.maxTaskWorkGroupSizeY_NV					= 1;
+	default_built_in_resource.maxTaskWorkGroupSizeZ_NV					= 1;
+	default_built_in_resource.maxMeshViewCountNV						= 4;
+
+	EShMessages messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+	const std::uint32_t default_version = 100;
+
+	// Preprocessing GLSL, includes are resolved relative to the directory of the shader
+	// The includer keeps a directory stack, so every compile (and thread) needs its own
+	DependencyTrackingIncluder shader_includer(included_files);
+	shader_includer.pushExternalLocalDirectory(path.substr(0, path.find_last_of("/\\")));
+
+	std::string preprocessed_glsl_str = {};
+
+	if (!shader.preprocess(
+		&default_built_in_resource,
+		default_version,
+		ENoProfile,
+		false,
+		false,
+		messages,
+		&preprocessed_glsl_str,
+		shader_includer))
+	{
+		spdlog::error("Could not pre-process GLSL for: \"{}\".", path);
+		spdlog::error(shader.getInfoLog());
+		spdlog::error(shader.getInfoDebugLog());
+
+		throw CriticalVulkanError("Failed to preprocess GLSL.");
+	}
+
+	// Save preprocessed GLSL to the shader (replaces old GLSL)
+	const auto preprocessed_glsl_cstr = preprocessed_glsl_str.c_str();
+	shader.setStrings(&preprocessed_glsl_cstr, 1);
+
+	// Parse the shader
+	if (!shader.parse(
+		&default_built_in_resource,
+		default_version,
+		false,
+		messages))
+	{
+		spdlog::error("Could not parse GLSL for: \"{}\".", path);
+		spdlog::error(shader.getInfoLog());
+		spdlog::error(shader.getInfoDebugLog());
+
+		throw CriticalVulkanError("Failed to parse GLSL.");
+	}
+
+	// Link the shader to a program
+	TProgram shader_program = {};
+	shader_program.addShader(&shader);
+
+	if (!shader_program.link(messages))
+	{
+		spdlog::error("Could not link GLSL program for: \"{}\".", path);
+		spdlog::error(shader.getInfoLog());
+		spdlog::error(shader.getInfoDebugLog());
+
+		throw CriticalVulkanError("Failed to link GLSL program.");
+	}
+
+	std::vector<std::uint32_t> spirv = {};
+	spv::SpvBuildLogger spirv_logger = {};
+	SpvOptions spirv_options = {};
+	spirv_options.disableOptimizer = !options.optimize;
+	spirv_options.optimizeSize = options.optimize;
+	spirv_options.stripDebugInfo = options.strip_debug_info;
+	GlslangToSpv(
+		*shader_program.getIntermediate(shader_stage_type),
+		spirv,
+		&spirv_logger,
+		&spirv_options);
+
+	return spirv;
+}
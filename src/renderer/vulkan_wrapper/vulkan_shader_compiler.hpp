@@ -0,0 +1,44 @@
+#ifndef VULKAN_SHADER_COMPILER_HPP
+#define VULKAN_SHADER_COMPILER_HPP
+
+// C++ standard
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	/** Settings of the GLSL to SPIR-V compiler */
+	struct GlslCompileOptions
+	{
+		/** Run the SPIR-V optimizer, only has an effect when glslang is built with SPIRV-Tools */
+		bool optimize = false;
+
+		/** Remove names and other debug information, reflected resources lose their names */
+		bool strip_debug_info = false;
+	};
+
+	/** Load GLSL from file and convert to byte code */
+	/**
+	 * GLSL -> SPIRV referenced from: https://forestsharp.com/glslang-cpp/
+	 * Shader includes are supported as long as each shader file has the
+	 * following code at the top:
+	 *
+	 * "#extension GL_GOOGLE_include_directive : enable"
+	 *
+	 * Every stage is compiled with the preprocessor definitions in "defines",
+	 * either "NAME" or "NAME=VALUE". The paths of all included files are
+	 * appended to "included_files".
+	 *
+	 * Safe to call from multiple threads at once, every call uses its own
+	 * include handler. This is the only place the application uses glslang,
+	 * builds without runtime shader compilation leave it out altogether.
+	 */
+	std::vector<std::uint32_t> CompileGLSL(
+		const std::string& path,
+		const std::vector<std::string>& defines,
+		std::vector<std::string>& included_files,
+		const GlslCompileOptions& options = {}) noexcept(false);
+}
+
+#endif // VULKAN_SHADER_COMPILER_HPP
@@ -0,0 +1,274 @@
+// Application
+#include "core/thread_pool.hpp"
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_device.hpp"
+#include "vulkan_shader_permutations.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <algorithm>
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+VulkanShaderPermutations::VulkanShaderPermutations() noexcept(true)
+	: m_define_mask(0)
+{}
+
+VulkanShaderPermutations::~VulkanShaderPermutations() noexcept(true)
+{}
+
+void VulkanShaderPermutations::Create(
+	const std::vector<std::pair<std::string, ShaderType>>& shader_files,
+	const std::vector<ShaderKeyword>& keywords) noexcept(false)
+{
+	if (shader_files.empty())
+	{
+		throw CriticalVulkanError("Shader permutations need at least one shader file.");
+	}
+
+	if (keywords.size() > maximum_keyword_count)
+	{
+		throw CriticalVulkanError("Too many shader keywords, a permutation key has room for 32 keywords.");
+	}
+
+	m_shader_files = shader_files;
+	m_keywords = keywords;
+	m_define_mask = 0;
+
+	for (std::uint32_t keyword_index = 0; keyword_index < m_keywords.size(); ++keyword_index)
+	{
+		const auto& keyword = m_keywords[keyword_index];
+
+		const auto name_count = std::count_if(
+			m_keywords.begin(),
+			m_keywords.end(),
+			[&keyword](const ShaderKeyword& other)
+			{
+				return other.name == keyword.name;
+			});
+
+		if (name_count > 1)
+		{
+			spdlog::error("Shader keyword \"{}\" is declared more than once.", keyword.name);
+			throw CriticalVulkanError("Duplicate shader keyword.");
+		}
+
+		if (keyword.type == ShaderKeywordType::Define)
+		{
+			m_define_mask |= (1u << keyword_index);
+		}
+	}
+}
+
+void VulkanShaderPermutations::Destroy(const VulkanDevice& device) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_variants_mutex);
+
+	for (const auto& [define_key, shader] : m_variants)
+	{
+		shader.Destroy(device);
+	}
+
+	m_variants.clear();
+}
+
+ShaderPermutationKey VulkanShaderPermutations::GetKey(const std::vector<std::string>& enabled_keywords) const noexcept(false)
+{
+	ShaderPermutationKey key = 0;
+
+	for (const auto& name : enabled_keywords)
+	{
+		auto keyword = std::find_if(
+			m_keywords.begin(),
+			m_keywords.end(),
+			[&name](const ShaderKeyword& other)
+			{
+				return other.name == name;
+			});
+
+		if (keyword == m_keywords.end())
+		{
+			spdlog::error("Shader keyword \"{}\" has not been declared.", name);
+			throw CriticalVulkanError("Unknown shader keyword.");
+		}
+
+		key |= (1u << static_cast<std::uint32_t>(keyword - m_keywords.begin()));
+	}
+
+	return key;
+}
+
+const VulkanShader& VulkanShaderPermutations::GetShader(const VulkanDevice& device, ShaderPermutationKey key) noexcept(false)
+{
+	// Specialization constant keywords do not change the compiled shader
+	const auto define_key = key & m_define_mask;
+
+	{
+		std::lock_guard<std::mutex> lock(m_variants_mutex);
+
+		auto variant = m_variants.find(define_key);
+
+		if (variant != m_variants.end())
+		{
+			return variant->second;
+		}
+	}
+
+	// Compile without holding the lock, other variants can be requested in the meantime
+	VulkanShader shader;
+	shader.Create(device, m_shader_files, GetDefines(define_key));
+
+	ValidateSpecializationConstants(shader);
+
+	return AddVariant(device, define_key, shader);
+}
+
+void VulkanShaderPermutations::CompileVariants(
+	const VulkanDevice& device,
+	core::ThreadPool& thread_pool,
+	const std::vector<ShaderPermutationKey>& keys) noexcept(false)
+{
+	std::vector<ShaderPermutationKey> define_keys;
+	std::vector<ShaderCompileRequest> requests;
+
+	{
+		std::lock_guard<std::mutex> lock(m_variants_mutex);
+
+		for (const auto key : keys)
+		{
+			const auto define_key = key & m_define_mask;
+
+			// Several keys can share a variant when they only differ in specialization constants
+			if (m_variants.count(define_key) == 0 &&
+				std::find(define_keys.begin(), define_keys.end(), define_key) == define_keys.end())
+			{
+				define_keys.push_back(define_key);
+				requests.push_back({ m_shader_files, GetDefines(define_key) });
+			}
+		}
+	}
+
+	if (requests.empty())
+	{
+		return;
+	}
+
+	const auto shaders = VulkanShader::CreateBatch(device, thread_pool, requests);
+
+	for (std::size_t index = 0; index < shaders.size(); ++index)
+	{
+		ValidateSpecializationConstants(shaders[index]);
+		AddVariant(device, define_keys[index], shaders[index]);
+	}
+}
+
+ShaderCompileRequest VulkanShaderPermutations::GetCompileRequest(ShaderPermutationKey key) const noexcept(true)
+{
+	return { m_shader_files, GetDefines(key & m_define_mask) };
+}
+
+VulkanShader VulkanShaderPermutations::ReplaceVariant(ShaderPermutationKey key, const VulkanShader& shader) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(m_variants_mutex);
+
+	auto variant = m_variants.find(key & m_define_mask);
+
+	if (variant == m_variants.end())
+	{
+		throw CriticalVulkanError("Cannot replace a shader variant that has not been compiled.");
+	}
+
+	ValidateSpecializationConstants(shader);
+
+	auto previous_shader = variant->second;
+	variant->second = shader;
+
+	return previous_shader;
+}
+
+void VulkanShaderPermutations::ApplySpecializationConstants(ShaderPermutationKey key, VulkanPipelineInfo& pipeline_info) const noexcept(true)
+{
+	for (std::uint32_t keyword_index = 0; keyword_index < m_keywords.size(); ++keyword_index)
+	{
+		const auto& keyword = m_keywords[keyword_index];
+
+		if (keyword.type == ShaderKeywordType::SpecializationConstant)
+		{
+			const VkBool32 enabled = (key & (1u << keyword_index)) ? VK_TRUE : VK_FALSE;
+			pipeline_info.SetSpecializationConstant(keyword.constant_id, enabled);
+		}
+	}
+}
+
+std::uint32_t VulkanShaderPermutations::GetCompiledVariantCount() const noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_variants_mutex);
+
+	return static_cast<std::uint32_t>(m_variants.size());
+}
+
+std::vector<std::string> VulkanShaderPermutations::GetDefines(ShaderPermutationKey define_key) const noexcept(true)
+{
+	std::vector<std::string> defines;
+
+	for (std::uint32_t keyword_index = 0; keyword_index < m_keywords.size(); ++keyword_index)
+	{
+		if (define_key & (1u << keyword_index))
+		{
+			defines.push_back(m_keywords[keyword_index].name);
+		}
+	}
+
+	return defines;
+}
+
+void VulkanShaderPermutations::ValidateSpecializationConstants(const VulkanShader& shader) const noexcept(true)
+{
+	const auto& constants = shader.GetReflection().specialization_constants;
+
+	for (const auto& keyword : m_keywords)
+	{
+		if (keyword.type != ShaderKeywordType::SpecializationConstant)
+		{
+			continue;
+		}
+
+		const auto is_declared = std::any_of(
+			constants.begin(),
+			constants.end(),
+			[&keyword](const ReflectedSpecializationConstant& constant)
+			{
+				return constant.constant_id == keyword.constant_id;
+			});
+
+		if (!is_declared)
+		{
+			spdlog::warn("Shader keyword \"{}\" uses specialization constant {}, which the shader does not declare.", keyword.name, keyword.constant_id);
+		}
+	}
+}
+
+const VulkanShader& VulkanShaderPermutations::AddVariant(
+	const VulkanDevice& device,
+	ShaderPermutationKey define_key,
+	const VulkanShader& shader) noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(m_variants_mutex);
+
+	// Another thread may have compiled the same variant, keep the first one
+	auto [variant, inserted] = m_variants.emplace(define_key, shader);
+
+	if (!inserted)
+	{
+		shader.Destroy(device);
+	}
+	else
+	{
+		spdlog::info("Compiled shader variant {:#x} of \"{}\" ({} variant(s) compiled).", define_key, m_shader_files.front().first, m_variants.size());
+	}
+
+	return variant->second;
+}
@@ -0,0 +1,144 @@
+#ifndef VULKAN_SHADER_PERMUTATIONS_HPP
+#define VULKAN_SHADER_PERMUTATIONS_HPP
+
+// Application
+#include "vulkan_pipeline_info.hpp"
+#include "vulkan_shader.hpp"
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkc::core
+{
+	class ThreadPool;
+}
+
+namespace vkc::vk_wrapper
+{
+	class VulkanDevice;
+
+	/** How an enabled shader keyword reaches the shader */
+	enum class ShaderKeywordType
+	{
+		/** "#define NAME" in every stage, every combination of these keywords is compiled separately */
+		Define,
+
+		/** Boolean specialization constant, all combinations share a single compiled shader */
+		SpecializationConstant
+	};
+
+	/** Feature that can be switched on and off per permutation */
+	struct ShaderKeyword
+	{
+		std::string name;
+		ShaderKeywordType type = ShaderKeywordType::Define;
+
+		/** ID of the "layout(constant_id = ...) const bool" in the shader, only used by specialization constant keywords */
+		std::uint32_t constant_id = 0;
+	};
+
+	/** Bit N is set when keyword N (in declaration order) is enabled */
+	using ShaderPermutationKey = std::uint32_t;
+
+	/** Variants of a shader that differ in the keywords that are enabled */
+	/**
+	 * Hot shaders can strip the code of disabled features at compile time
+	 * instead of branching on them at runtime. Define keywords are resolved
+	 * by the preprocessor, so variants are only compiled the first time they
+	 * are requested. Specialization constant keywords do not need a separate
+	 * compile, the driver removes the dead branches when the pipeline is
+	 * created.
+	 *
+	 * Descriptor set and pipeline layouts still go through the layout cache,
+	 * variants that declare the same resources share their layouts.
+	 *
+	 * All functions except "Create" and "Destroy" are thread-safe.
+	 */
+	class VulkanShaderPermutations
+	{
+	public:
+		/** Every keyword needs a bit in the permutation key */
+		static const constexpr std::uint32_t maximum_keyword_count = 32;
+
+		VulkanShaderPermutations() noexcept(true);
+		~VulkanShaderPermutations() noexcept(true);
+
+		/** Declare the shader files and keywords, nothing is compiled yet */
+		/**
+		 * Throws when there are too many keywords, or when a keyword name is
+		 * used more than once.
+		 */
+		void Create(
+			const std::vector<std::pair<std::string, ShaderType>>& shader_files,
+			const std::vector<ShaderKeyword>& keywords) noexcept(false);
+
+		/** Destroy every variant that has been compiled */
+		void Destroy(const VulkanDevice& device) noexcept(true);
+
+		/** Get the key of the permutation with the specified keywords enabled, throws on unknown keywords */
+		ShaderPermutationKey GetKey(const std::vector<std::string>& enabled_keywords) const noexcept(false);
+
+		/** Get the shader of a permutation, it is compiled when it is requested for the first time */
+		const VulkanShader& GetShader(const VulkanDevice& device, ShaderPermutationKey key) noexcept(false);
+
+		/** Compile all variants of the keys that have not been compiled yet in parallel */
+		/**
+		 * Use this to warm up variants that are known to be needed, instead of
+		 * compiling them one after another when they are first requested.
+		 */
+		void CompileVariants(
+			const VulkanDevice& device,
+			core::ThreadPool& thread_pool,
+			const std::vector<ShaderPermutationKey>& keys) noexcept(false);
+
+		/** Get the sources and preprocessor definitions the variant of a key is compiled with */
+		ShaderCompileRequest GetCompileRequest(ShaderPermutationKey key) const noexcept(true);
+
+		/** Replace the compiled variant of a key, used to hot-reload a variant after its sources changed */
+		/**
+		 * Returns the previous variant, destroy it once the GPU no longer uses
+		 * pipelines created from it. References returned by "GetShader" refer
+		 * to the new variant from now on. Throws when the variant has not been
+		 * compiled before.
+		 */
+		VulkanShader ReplaceVariant(ShaderPermutationKey key, const VulkanShader& shader) noexcept(false);
+
+		/** Set the specialization constants of all specialization constant keywords of a permutation */
+		void ApplySpecializationConstants(ShaderPermutationKey key, VulkanPipelineInfo& pipeline_info) const noexcept(true);
+
+		/** Number of variants that have been compiled so far */
+		std::uint32_t GetCompiledVariantCount() const noexcept(true);
+
+	private:
+		/** Preprocessor definitions of the define keywords that are enabled in the key */
+		std::vector<std::string> GetDefines(ShaderPermutationKey define_key) const noexcept(true);
+
+		/** Warn about specialization constant keywords that the compiled shader does not declare */
+		void ValidateSpecializationConstants(const VulkanShader& shader) const noexcept(true);
+
+		/** Store a compiled variant, returns the existing variant (and destroys the new one) when it was already added */
+		const VulkanShader& AddVariant(
+			const VulkanDevice& device,
+			ShaderPermutationKey define_key,
+			const VulkanShader& shader) noexcept(true);
+
+		std::vector<std::pair<std::string, ShaderType>> m_shader_files;
+		std::vector<ShaderKeyword> m_keywords;
+
+		/** Bits of the keywords that need their own compiled variant */
+		ShaderPermutationKey m_define_mask;
+
+		/** Compiled variants by the define bits of their key, references stay valid when variants are added */
+		std::unordered_map<ShaderPermutationKey, VulkanShader> m_variants;
+		mutable std::mutex m_variants_mutex;
+	};
+}
+
+#endif // VULKAN_SHADER_PERMUTATIONS_HPP
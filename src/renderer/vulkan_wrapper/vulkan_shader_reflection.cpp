@@ -0,0 +1,964 @@
+// Application
+#include "miscellaneous/exceptions.hpp"
+#include "vulkan_shader_reflection.hpp"
+
+// C++ standard
+#include <algorithm>
+#include <limits>
+
+using namespace vkc::exception;
+using namespace vkc::vk_wrapper;
+
+namespace
+{
+	/** SPIR-V constants used by the reflection code, taken from the SPIR-V specification */
+	static const constexpr std::uint32_t spirv_magic_number = 0x07230203;
+	static const constexpr std::uint32_t spirv_header_word_count = 5;
+
+	enum class SpirvOp : std::uint16_t
+	{
+		Name = 5,
+		MemberName = 6,
+		ExecutionMode = 16,
+		Decorate = 71,
+		MemberDecorate = 72,
+		TypeVoid = 19,
+		TypeBool = 20,
+		TypeInt = 21,
+		TypeFloat = 22,
+		TypeVector = 23,
+		TypeMatrix = 24,
+		TypeImage = 25,
+		TypeSampler = 26,
+		TypeSampledImage = 27,
+		TypeArray = 28,
+		TypeRuntimeArray = 29,
+		TypeStruct = 30,
+		TypePointer = 32,
+		Constant = 43,
+		SpecConstantTrue = 48,
+		SpecConstantFalse = 49,
+		SpecConstant = 50,
+		SpecConstantComposite = 51,
+		Variable = 59,
+		TypeAccelerationStructure = 5341
+	};
+
+	enum class SpirvDecoration : std::uint32_t
+	{
+		SpecId = 1,
+		Block = 2,
+		BufferBlock = 3,
+		ArrayStride = 6,
+		MatrixStride = 7,
+		BuiltIn = 11,
+		Location = 30,
+		Binding = 33,
+		DescriptorSet = 34,
+		Offset = 35
+	};
+
+	/** Execution mode that holds the work group size ("local_size_x" and friends) */
+	static const constexpr std::uint32_t spirv_execution_mode_local_size = 17;
+
+	/** Built-in of the constant composite that overrides the local size ("local_size_x_id" and friends) */
+	static const constexpr std::uint32_t spirv_built_in_workgroup_size = 25;
+
+	enum class SpirvStorageClass : std::uint32_t
+	{
+		UniformConstant = 0,
+		Input = 1,
+		Uniform = 2,
+		PushConstant = 9,
+		StorageBuffer = 12
+	};
+
+	/** Values of the "Dim" operand of OpTypeImage that change the descriptor type */
+	static const constexpr std::uint32_t spirv_image_dimension_buffer = 5;
+	static const constexpr std::uint32_t spirv_image_dimension_subpass_data = 6;
+
+	/** Value of the "Sampled" operand of OpTypeImage for storage images */
+	static const constexpr std::uint32_t spirv_image_used_without_sampler = 2;
+
+	/** Decorations of a single id or struct member */
+	struct SpirvDecorations
+	{
+		bool has_set = false;
+		bool has_binding = false;
+		bool has_location = false;
+		bool is_block = false;
+		bool is_buffer_block = false;
+		bool is_built_in = false;
+		bool has_spec_id = false;
+
+		std::uint32_t built_in = 0;
+		std::uint32_t spec_id = 0;
+		std::uint32_t set = 0;
+		std::uint32_t binding = 0;
+		std::uint32_t location = 0;
+		std::uint32_t offset = 0;
+		std::uint32_t array_stride = 0;
+		std::uint32_t matrix_stride = 0;
+	};
+
+	/** Everything the reflection code needs to know about a SPIR-V id */
+	struct SpirvId
+	{
+		SpirvOp op = SpirvOp::TypeVoid;
+		bool is_defined = false;
+
+		std::string name;
+		SpirvDecorations decorations;
+		std::vector<SpirvDecorations> member_decorations;
+
+		/** Type operands (component type, pointee type, member types...), result type and constituents of constants */
+		std::vector<std::uint32_t> operands;
+
+		/** Storage class of pointers and variables */
+		SpirvStorageClass storage_class = SpirvStorageClass::UniformConstant;
+
+		/** Value of integer constants */
+		std::uint32_t constant_value = 0;
+	};
+
+	/** Parsed SPIR-V module */
+	class SpirvModule
+	{
+	public:
+		explicit SpirvModule(const std::vector<std::uint32_t>& spirv) noexcept(false)
+		{
+			if (spirv.size() < spirv_header_word_count || spirv[0] != spirv_magic_number)
+			{
+				throw CriticalVulkanError("Shader bytecode is not valid SPIR-V.");
+			}
+
+			// The id bound is stored in the header
+			m_ids.resize(spirv[3]);
+
+			std::size_t word_index = spirv_header_word_count;
+
+			while (word_index < spirv.size())
+			{
+				const auto word_count = static_cast<std::uint16_t>(spirv[word_index] >> 16);
+				const auto op = static_cast<SpirvOp>(spirv[word_index] & 0xffff);
+
+				if (word_count == 0 || word_index + word_count > spirv.size())
+				{
+					throw CriticalVulkanError("Shader bytecode contains a malformed SPIR-V instruction.");
+				}
+
+				ParseInstruction(op, &spirv[word_index + 1], word_count - 1u);
+
+				word_index += word_count;
+			}
+		}
+
+		/** Get an id, throws when the id is outside of the id bound */
+		const SpirvId& GetId(std::uint32_t id) const noexcept(false)
+		{
+			if (id >= m_ids.size())
+			{
+				throw CriticalVulkanError("SPIR-V id is out of bounds.");
+			}
+
+			return m_ids[id];
+		}
+
+		/** Ids of all global variables, in declaration order */
+		const std::vector<std::uint32_t>& GetVariables() const noexcept(true)
+		{
+			return m_variables;
+		}
+
+		/** Ids of all specialization constants, including composites, in declaration order */
+		const std::vector<std::uint32_t>& GetSpecializationConstants() const noexcept(true)
+		{
+			return m_specialization_constants;
+		}
+
+		/** Work group size from the "LocalSize" execution mode, all zero when there is none */
+		const std::array<std::uint32_t, 3>& GetLocalSize() const noexcept(true)
+		{
+			return m_local_size;
+		}
+
+	private:
+		void ParseInstruction(SpirvOp op, const std::uint32_t* operands, std::uint32_t operand_count) noexcept(false)
+		{
+			switch (op)
+			{
+				case SpirvOp::Name:
+					if (operand_count >= 2)
+					{
+						GetMutableId(operands[0]).name = ReadString(&operands[1], operand_count - 1);
+					}
+					break;
+
+				case SpirvOp::ExecutionMode:
+					if (operand_count >= 5 && operands[1] == spirv_execution_mode_local_size)
+					{
+						m_local_size = { operands[2], operands[3], operands[4] };
+					}
+					break;
+
+				case SpirvOp::Decorate:
+					if (operand_count >= 2)
+					{
+						ApplyDecoration(GetMutableId(operands[0]).decorations, &operands[1], operand_count - 1);
+					}
+					break;
+
+				case SpirvOp::MemberDecorate:
+					if (operand_count >= 3)
+					{
+						auto& member_decorations = GetMutableId(operands[0]).member_decorations;
+
+						if (member_decorations.size() <= operands[1])
+						{
+							member_decorations.resize(operands[1] + 1);
+						}
+
+						ApplyDecoration(member_decorations[operands[1]], &operands[2], operand_count - 2);
+					}
+					break;
+
+				case SpirvOp::TypeVoid:
+				case SpirvOp::TypeBool:
+				case SpirvOp::TypeInt:
+				case SpirvOp::TypeFloat:
+				case SpirvOp::TypeVector:
+				case SpirvOp::TypeMatrix:
+				case SpirvOp::TypeImage:
+				case SpirvOp::TypeSampler:
+				case SpirvOp::TypeSampledImage:
+				case SpirvOp::TypeArray:
+				case SpirvOp::TypeRuntimeArray:
+				case SpirvOp::TypeStruct:
+				case SpirvOp::TypeAccelerationStructure:
+					if (operand_count >= 1)
+					{
+						auto& type = GetMutableId(operands[0]);
+						type.op = op;
+						type.is_defined = true;
+						type.operands.assign(operands + 1, operands + operand_count);
+					}
+					break;
+
+				case SpirvOp::TypePointer:
+					if (operand_count >= 3)
+					{
+						auto& type = GetMutableId(operands[0]);
+						type.op = op;
+						type.is_defined = true;
+						type.storage_class = static_cast<SpirvStorageClass>(operands[1]);
+						type.operands = { operands[2] };
+					}
+					break;
+
+				case SpirvOp::Constant:
+				case SpirvOp::SpecConstant:
+					// Only the low word matters, array sizes are never larger than 32 bits
+					if (operand_count >= 3)
+					{
+						auto& constant = GetMutableId(operands[1]);
+						constant.op = op;
+						constant.is_defined = true;
+						constant.constant_value = operands[2];
+						constant.operands = { operands[0] };
+
+						if (op == SpirvOp::SpecConstant)
+						{
+							m_specialization_constants.push_back(operands[1]);
+						}
+					}
+					break;
+
+				case SpirvOp::SpecConstantTrue:
+				case SpirvOp::SpecConstantFalse:
+				case SpirvOp::SpecConstantComposite:
+					if (operand_count >= 2)
+					{
+						auto& constant = GetMutableId(operands[1]);
+						constant.op = op;
+						constant.is_defined = true;
+						constant.constant_value = (op == SpirvOp::SpecConstantTrue) ? 1 : 0;
+						constant.operands.assign(operands, operands + operand_count);
+						constant.operands.erase(constant.operands.begin() + 1);
+
+						m_specialization_constants.push_back(operands[1]);
+					}
+					break;
+
+				case SpirvOp::Variable:
+					if (operand_count >= 3)
+					{
+						auto& variable = GetMutableId(operands[1]);
+						variable.op = op;
+						variable.is_defined = true;
+						variable.storage_class = static_cast<SpirvStorageClass>(operands[2]);
+						variable.operands = { operands[0] };
+
+						// Function-local variables are filtered out by their storage class later on
+						m_variables.push_back(operands[1]);
+					}
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		void ApplyDecoration(SpirvDecorations& decorations, const std::uint32_t* operands, std::uint32_t operand_count) const noexcept(true)
+		{
+			const auto decoration = static_cast<SpirvDecoration>(operands[0]);
+			const auto value = (operand_count >= 2) ? operands[1] : 0u;
+
+			switch (decoration)
+			{
+				case SpirvDecoration::Block:
+					decorations.is_block = true;
+					break;
+
+				case SpirvDecoration::BufferBlock:
+					decorations.is_buffer_block = true;
+					break;
+
+				case SpirvDecoration::BuiltIn:
+					decorations.is_built_in = true;
+					decorations.built_in = value;
+					break;
+
+				case SpirvDecoration::SpecId:
+					decorations.has_spec_id = true;
+					decorations.spec_id = value;
+					break;
+
+				case SpirvDecoration::DescriptorSet:
+					decorations.has_set = true;
+					decorations.set = value;
+					break;
+
+				case SpirvDecoration::Binding:
+					decorations.has_binding = true;
+					decorations.binding = value;
+					break;
+
+				case SpirvDecoration::Location:
+					decorations.has_location = true;
+					decorations.location = value;
+					break;
+
+				case SpirvDecoration::Offset:
+					decorations.offset = value;
+					break;
+
+				case SpirvDecoration::ArrayStride:
+					decorations.array_stride = value;
+					break;
+
+				case SpirvDecoration::MatrixStride:
+					decorations.matrix_stride = value;
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		SpirvId& GetMutableId(std::uint32_t id) noexcept(false)
+		{
+			if (id >= m_ids.size())
+			{
+				throw CriticalVulkanError("SPIR-V id is out of bounds.");
+			}
+
+			return m_ids[id];
+		}
+
+		/** Strings are nul-terminated and packed four characters per word (little-endian) */
+		static std::string ReadString(const std::uint32_t* words, std::uint32_t word_count) noexcept(true)
+		{
+			std::string result;
+
+			for (std::uint32_t word_index = 0; word_index < word_count; ++word_index)
+			{
+				for (std::uint32_t byte_index = 0; byte_index < 4; ++byte_index)
+				{
+					const auto character = static_cast<char>((words[word_index] >> (byte_index * 8)) & 0xff);
+
+					if (character == '\0')
+					{
+						return result;
+					}
+
+					result.push_back(character);
+				}
+			}
+
+			return result;
+		}
+
+	private:
+		std::vector<SpirvId> m_ids;
+		std::vector<std::uint32_t> m_variables;
+		std::vector<std::uint32_t> m_specialization_constants;
+		std::array<std::uint32_t, 3> m_local_size = { 0, 0, 0 };
+	};
+
+	/** Calculate the size in bytes of a type inside of a buffer block */
+	/**
+	 * Matrix and array strides are decorated on the struct member that holds
+	 * them, which is why they are passed in separately.
+	 */
+	std::uint32_t CalculateTypeSize(const SpirvModule& module, std::uint32_t type_id, const SpirvDecorations& member_decorations) noexcept(false)
+	{
+		const auto& type = module.GetId(type_id);
+
+		switch (type.op)
+		{
+			case SpirvOp::TypeBool:
+				return 4;
+
+			case SpirvOp::TypeInt:
+			case SpirvOp::TypeFloat:
+				return type.operands.at(0) / 8;
+
+			case SpirvOp::TypeVector:
+				return CalculateTypeSize(module, type.operands.at(0), member_decorations) * type.operands.at(1);
+
+			case SpirvOp::TypeMatrix:
+			{
+				const auto column_count = type.operands.at(1);
+
+				if (member_decorations.matrix_stride > 0)
+				{
+					return member_decorations.matrix_stride * column_count;
+				}
+
+				return CalculateTypeSize(module, type.operands.at(0), member_decorations) * column_count;
+			}
+
+			case SpirvOp::TypeArray:
+			{
+				const auto element_count = module.GetId(type.operands.at(1)).constant_value;
+				const auto array_stride = type.decorations.array_stride;
+
+				if (array_stride > 0)
+				{
+					return array_stride * element_count;
+				}
+
+				return CalculateTypeSize(module, type.operands.at(0), member_decorations) * element_count;
+			}
+
+			case SpirvOp::TypeStruct:
+			{
+				std::uint32_t size = 0;
+
+				for (std::size_t member_index = 0; member_index < type.operands.size(); ++member_index)
+				{
+					const auto decorations = (member_index < type.member_decorations.size())
+						? type.member_decorations[member_index]
+						: SpirvDecorations{};
+
+					size = std::max(size, decorations.offset + CalculateTypeSize(module, type.operands[member_index], decorations));
+				}
+
+				return size;
+			}
+
+			// Runtime arrays do not add to the size of the block
+			default:
+				return 0;
+		}
+	}
+
+	/** Get the descriptor type of a type used by a uniform, storage, or uniform constant variable */
+	VkDescriptorType GetDescriptorType(const SpirvId& type, SpirvStorageClass storage_class) noexcept(false)
+	{
+		switch (storage_class)
+		{
+			case SpirvStorageClass::Uniform:
+				return type.decorations.is_buffer_block
+					? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+					: VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+			case SpirvStorageClass::StorageBuffer:
+				return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
+			default:
+				break;
+		}
+
+		switch (type.op)
+		{
+			case SpirvOp::TypeSampler:
+				return VK_DESCRIPTOR_TYPE_SAMPLER;
+
+			case SpirvOp::TypeSampledImage:
+				return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+			case SpirvOp::TypeImage:
+			{
+				const auto dimension = type.operands.at(1);
+				const auto is_storage = (type.operands.at(5) == spirv_image_used_without_sampler);
+
+				if (dimension == spirv_image_dimension_subpass_data)
+				{
+					return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+				}
+				else if (dimension == spirv_image_dimension_buffer)
+				{
+					return is_storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+				}
+
+				return is_storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+			}
+
+			case SpirvOp::TypeAccelerationStructure:
+				return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_NV;
+
+			default:
+				throw CriticalVulkanError("Shader uses a resource type that cannot be reflected.");
+		}
+	}
+
+	/** Get the vertex attribute format of a scalar or vector type */
+	VkFormat GetVertexInputFormat(const SpirvModule& module, const SpirvId& type) noexcept(false)
+	{
+		const SpirvId* component_type = &type;
+		std::uint32_t component_count = 1;
+
+		if (type.op == SpirvOp::TypeVector)
+		{
+			component_type = &module.GetId(type.operands.at(0));
+			component_count = type.operands.at(1);
+		}
+
+		const auto width = component_type->operands.at(0);
+
+		if (component_type->op == SpirvOp::TypeFloat)
+		{
+			static const VkFormat float_formats[] = { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+			static const VkFormat double_formats[] = { VK_FORMAT_R64_SFLOAT, VK_FORMAT_R64G64_SFLOAT, VK_FORMAT_R64G64B64_SFLOAT, VK_FORMAT_R64G64B64A64_SFLOAT };
+
+			return (width == 64) ? double_formats[component_count - 1] : float_formats[component_count - 1];
+		}
+		else if (component_type->op == SpirvOp::TypeInt)
+		{
+			static const VkFormat signed_formats[] = { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+			static const VkFormat unsigned_formats[] = { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+
+			const auto is_signed = (component_type->operands.at(1) == 1);
+			return is_signed ? signed_formats[component_count - 1] : unsigned_formats[component_count - 1];
+		}
+
+		throw CriticalVulkanError("Vertex shader input has a type that cannot be reflected.");
+	}
+
+	/** Add the vertex attributes of an input variable, matrices and arrays occupy multiple locations */
+	void ReflectVertexInput(const SpirvModule& module, const SpirvId& variable, ShaderReflection& reflection) noexcept(false)
+	{
+		const auto* type = &module.GetId(module.GetId(variable.operands.at(0)).operands.at(0));
+		auto location = variable.decorations.location;
+
+		std::uint32_t element_count = 1;
+
+		if (type->op == SpirvOp::TypeArray)
+		{
+			element_count = module.GetId(type->operands.at(1)).constant_value;
+			type = &module.GetId(type->operands.at(0));
+		}
+
+		for (std::uint32_t element_index = 0; element_index < element_count; ++element_index)
+		{
+			if (type->op == SpirvOp::TypeMatrix)
+			{
+				const auto format = GetVertexInputFormat(module, module.GetId(type->operands.at(0)));
+
+				for (std::uint32_t column_index = 0; column_index < type->operands.at(1); ++column_index)
+				{
+					reflection.vertex_inputs.push_back({ location++, format, variable.name });
+				}
+			}
+			else
+			{
+				reflection.vertex_inputs.push_back({ location++, GetVertexInputFormat(module, *type), variable.name });
+			}
+		}
+	}
+
+	/** Add the specialization constants and the work group size of a module */
+	void ReflectSpecializationConstants(const SpirvModule& module, ShaderReflection& reflection) noexcept(false)
+	{
+		reflection.local_size = module.GetLocalSize();
+
+		for (auto constant_id : module.GetSpecializationConstants())
+		{
+			const auto& constant = module.GetId(constant_id);
+
+			// A "WorkgroupSize" composite overrides the execution mode, its constituents may be specialization constants
+			if (constant.op == SpirvOp::SpecConstantComposite)
+			{
+				if (!constant.decorations.is_built_in || constant.decorations.built_in != spirv_built_in_workgroup_size)
+				{
+					continue;
+				}
+
+				for (std::size_t axis = 0; axis < reflection.local_size.size() && axis + 1 < constant.operands.size(); ++axis)
+				{
+					const auto& dimension = module.GetId(constant.operands[axis + 1]);
+					reflection.local_size[axis] = dimension.constant_value;
+
+					if (dimension.decorations.has_spec_id)
+					{
+						reflection.local_size_constant_ids[axis] = dimension.decorations.spec_id;
+					}
+				}
+
+				continue;
+			}
+
+			if (!constant.decorations.has_spec_id)
+			{
+				continue;
+			}
+
+			ReflectedSpecializationConstant specialization_constant = {};
+			specialization_constant.constant_id = constant.decorations.spec_id;
+			specialization_constant.name = constant.name;
+
+			// Booleans (OpSpecConstantTrue / OpSpecConstantFalse) keep the size of a VkBool32
+			if (constant.op == SpirvOp::SpecConstant)
+			{
+				specialization_constant.size = CalculateTypeSize(module, constant.operands.at(0), {});
+			}
+
+			ShaderReflection stage_reflection = {};
+			stage_reflection.specialization_constants.push_back(specialization_constant);
+
+			MergeShaderReflection(reflection, stage_reflection);
+		}
+	}
+}
+
+ShaderReflection vkc::vk_wrapper::ReflectSPIRV(
+	const std::vector<std::uint32_t>& spirv,
+	VkShaderStageFlagBits stage) noexcept(false)
+{
+	const SpirvModule module(spirv);
+	ShaderReflection reflection = {};
+
+	for (auto variable_id : module.GetVariables())
+	{
+		const auto& variable = module.GetId(variable_id);
+		const auto& pointer_type = module.GetId(variable.operands.at(0));
+		const auto& pointee_type = module.GetId(pointer_type.operands.at(0));
+
+		switch (variable.storage_class)
+		{
+			case SpirvStorageClass::Input:
+				if (stage == VK_SHADER_STAGE_VERTEX_BIT &&
+					!variable.decorations.is_built_in &&
+					variable.decorations.has_location)
+				{
+					ReflectVertexInput(module, variable, reflection);
+				}
+				break;
+
+			case SpirvStorageClass::PushConstant:
+			{
+				// Push constant blocks may start at a non-zero offset when stages share a block
+				std::uint32_t first_offset = std::numeric_limits<std::uint32_t>::max();
+
+				for (const auto& member_decorations : pointee_type.member_decorations)
+				{
+					first_offset = std::min(first_offset, member_decorations.offset);
+				}
+
+				if (pointee_type.member_decorations.empty())
+				{
+					first_offset = 0;
+				}
+
+				VkPushConstantRange range = {};
+				range.stageFlags = stage;
+				range.offset = first_offset;
+				range.size = CalculateTypeSize(module, pointer_type.operands.at(0), {}) - first_offset;
+
+				ShaderReflection range_reflection = {};
+				range_reflection.push_constant_ranges.push_back(range);
+
+				MergeShaderReflection(reflection, range_reflection);
+				break;
+			}
+
+			case SpirvStorageClass::UniformConstant:
+			case SpirvStorageClass::Uniform:
+			case SpirvStorageClass::StorageBuffer:
+			{
+				if (!variable.decorations.has_binding)
+				{
+					break;
+				}
+
+				ReflectedDescriptorBinding binding = {};
+				binding.set = variable.decorations.set;
+				binding.binding = variable.decorations.binding;
+				binding.stages = stage;
+				binding.name = variable.name;
+
+				// Arrays of resources become a single binding with multiple descriptors
+				auto resource_type_id = pointer_type.operands.at(0);
+				const auto* resource_type = &pointee_type;
+
+				if (resource_type->op == SpirvOp::TypeArray)
+				{
+					binding.count = module.GetId(resource_type->operands.at(1)).constant_value;
+					resource_type_id = resource_type->operands.at(0);
+				}
+				else if (resource_type->op == SpirvOp::TypeRuntimeArray)
+				{
+					binding.count = 0;
+					resource_type_id = resource_type->operands.at(0);
+				}
+
+				resource_type = &module.GetId(resource_type_id);
+
+				binding.type = GetDescriptorType(*resource_type, variable.storage_class);
+
+				if (resource_type->op == SpirvOp::TypeStruct)
+				{
+					binding.block_size = CalculateTypeSize(module, resource_type_id, {});
+
+					// Anonymous blocks are named after their type
+					if (binding.name.empty())
+					{
+						binding.name = resource_type->name;
+					}
+				}
+
+				ShaderReflection binding_reflection = {};
+				binding_reflection.descriptor_bindings.push_back(binding);
+
+				MergeShaderReflection(reflection, binding_reflection);
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+
+	// Only compute shaders declare a work group size, the local size of other stages stays zero
+	ReflectSpecializationConstants(module, reflection);
+
+	return reflection;
+}
+
+void vkc::vk_wrapper::MergeShaderReflection(
+	ShaderReflection& pipeline_reflection,
+	const ShaderReflection& stage_reflection) noexcept(false)
+{
+	for (const auto& binding : stage_reflection.descriptor_bindings)
+	{
+		auto existing_binding = std::find_if(
+			pipeline_reflection.descriptor_bindings.begin(),
+			pipeline_reflection.descriptor_bindings.end(),
+			[&binding](const ReflectedDescriptorBinding& other)
+			{
+				return other.set == binding.set && other.binding == binding.binding;
+			});
+
+		if (existing_binding == pipeline_reflection.descriptor_bindings.end())
+		{
+			pipeline_reflection.descriptor_bindings.push_back(binding);
+			continue;
+		}
+
+		if (existing_binding->type != binding.type)
+		{
+			throw CriticalVulkanError("Shader stages use the same descriptor binding with different descriptor types.");
+		}
+
+		existing_binding->stages |= binding.stages;
+		existing_binding->count = std::max(existing_binding->count, binding.count);
+		existing_binding->block_size = std::max(existing_binding->block_size, binding.block_size);
+	}
+
+	std::sort(
+		pipeline_reflection.descriptor_bindings.begin(),
+		pipeline_reflection.descriptor_bindings.end(),
+		[](const ReflectedDescriptorBinding& lhs, const ReflectedDescriptorBinding& rhs)
+		{
+			return (lhs.set != rhs.set) ? (lhs.set < rhs.set) : (lhs.binding < rhs.binding);
+		});
+
+	// A single range that covers every stage is always valid, and keeps pipeline layouts compatible
+	for (const auto& range : stage_reflection.push_constant_ranges)
+	{
+		if (pipeline_reflection.push_constant_ranges.empty())
+		{
+			pipeline_reflection.push_constant_ranges.push_back(range);
+			continue;
+		}
+
+		auto& merged_range = pipeline_reflection.push_constant_ranges.front();
+		const auto end = std::max(merged_range.offset + merged_range.size, range.offset + range.size);
+
+		merged_range.stageFlags |= range.stageFlags;
+		merged_range.offset = std::min(merged_range.offset, range.offset);
+		merged_range.size = end - merged_range.offset;
+	}
+
+	pipeline_reflection.vertex_inputs.insert(
+		pipeline_reflection.vertex_inputs.end(),
+		stage_reflection.vertex_inputs.begin(),
+		stage_reflection.vertex_inputs.end());
+
+	std::sort(
+		pipeline_reflection.vertex_inputs.begin(),
+		pipeline_reflection.vertex_inputs.end(),
+		[](const ReflectedVertexInput& lhs, const ReflectedVertexInput& rhs)
+		{
+			return lhs.location < rhs.location;
+		});
+
+	// Stages may share a specialization constant ID, a single value is passed for all of them
+	for (const auto& specialization_constant : stage_reflection.specialization_constants)
+	{
+		auto existing_constant = std::find_if(
+			pipeline_reflection.specialization_constants.begin(),
+			pipeline_reflection.specialization_constants.end(),
+			[&specialization_constant](const ReflectedSpecializationConstant& other)
+			{
+				return other.constant_id == specialization_constant.constant_id;
+			});
+
+		if (existing_constant == pipeline_reflection.specialization_constants.end())
+		{
+			pipeline_reflection.specialization_constants.push_back(specialization_constant);
+		}
+		else if (existing_constant->size != specialization_constant.size)
+		{
+			throw CriticalVulkanError("Shader stages use the same specialization constant ID with different sizes.");
+		}
+	}
+
+	std::sort(
+		pipeline_reflection.specialization_constants.begin(),
+		pipeline_reflection.specialization_constants.end(),
+		[](const ReflectedSpecializationConstant& lhs, const ReflectedSpecializationConstant& rhs)
+		{
+			return lhs.constant_id < rhs.constant_id;
+		});
+
+	// Only compute shaders have a work group size, and a compute pipeline has a single stage
+	if (stage_reflection.local_size != std::array<std::uint32_t, 3>{ 0, 0, 0 })
+	{
+		pipeline_reflection.local_size = stage_reflection.local_size;
+		pipeline_reflection.local_size_constant_ids = stage_reflection.local_size_constant_ids;
+	}
+}
+
+bool vkc::vk_wrapper::IsLayoutCompatible(
+	const ShaderReflection& reflection,
+	const ShaderReflection& other_reflection) noexcept(true)
+{
+	const auto same_binding = [](const ReflectedDescriptorBinding& binding, const ReflectedDescriptorBinding& other_binding)
+	{
+		return
+			binding.set == other_binding.set &&
+			binding.binding == other_binding.binding &&
+			binding.type == other_binding.type &&
+			binding.count == other_binding.count &&
+			binding.stages == other_binding.stages;
+	};
+
+	const auto same_range = [](const VkPushConstantRange& range, const VkPushConstantRange& other_range)
+	{
+		return
+			range.stageFlags == other_range.stageFlags &&
+			range.offset == other_range.offset &&
+			range.size == other_range.size;
+	};
+
+	// Both lists are sorted, so they can be compared element by element
+	return
+		std::equal(
+			reflection.descriptor_bindings.begin(), reflection.descriptor_bindings.end(),
+			other_reflection.descriptor_bindings.begin(), other_reflection.descriptor_bindings.end(),
+			same_binding) &&
+		std::equal(
+			reflection.push_constant_ranges.begin(), reflection.push_constant_ranges.end(),
+			other_reflection.push_constant_ranges.begin(), other_reflection.push_constant_ranges.end(),
+			same_range);
+}
+
+std::uint32_t vkc::vk_wrapper::GetDescriptorSetCount(const ShaderReflection& reflection) noexcept(true)
+{
+	// Bindings are sorted by set, so the last binding uses the highest set
+	if (reflection.descriptor_bindings.empty())
+	{
+		return 0;
+	}
+
+	return reflection.descriptor_bindings.back().set + 1;
+}
+
+std::vector<VkDescriptorSetLayoutBinding> vkc::vk_wrapper::GetDescriptorSetLayoutBindings(
+	const ShaderReflection& reflection,
+	std::uint32_t set) noexcept(true)
+{
+	std::vector<VkDescriptorSetLayoutBinding> layout_bindings;
+
+	for (const auto& binding : reflection.descriptor_bindings)
+	{
+		if (binding.set != set)
+		{
+			continue;
+		}
+
+		VkDescriptorSetLayoutBinding layout_binding = {};
+		layout_binding.binding = binding.binding;
+		layout_binding.descriptorType = binding.type;
+		layout_binding.descriptorCount = std::max(binding.count, 1u);
+		layout_binding.stageFlags = binding.stages;
+		layout_binding.pImmutableSamplers = nullptr;
+
+		layout_bindings.push_back(layout_binding);
+	}
+
+	return layout_bindings;
+}
+
+std::vector<VkDescriptorPoolSize> vkc::vk_wrapper::CalculateDescriptorPoolSizes(
+	const ShaderReflection& reflection,
+	std::uint32_t set_count) noexcept(true)
+{
+	std::vector<VkDescriptorPoolSize> pool_sizes;
+
+	for (const auto& binding : reflection.descriptor_bindings)
+	{
+		const auto descriptor_count = std::max(binding.count, 1u) * set_count;
+
+		auto existing_pool_size = std::find_if(
+			pool_sizes.begin(),
+			pool_sizes.end(),
+			[&binding](const VkDescriptorPoolSize& pool_size)
+			{
+				return pool_size.type == binding.type;
+			});
+
+		if (existing_pool_size != pool_sizes.end())
+		{
+			existing_pool_size->descriptorCount += descriptor_count;
+		}
+		else
+		{
+			pool_sizes.push_back({ binding.type, descriptor_count });
+		}
+	}
+
+	return pool_sizes;
+}
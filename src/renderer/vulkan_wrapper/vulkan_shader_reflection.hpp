@@ -0,0 +1,127 @@
+#ifndef VULKAN_SHADER_REFLECTION_HPP
+#define VULKAN_SHADER_REFLECTION_HPP
+
+// Vulkan
+#include <vulkan/vulkan.h>
+
+// C++ standard
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vkc::vk_wrapper
+{
+	/** Descriptor binding used by a shader */
+	struct ReflectedDescriptorBinding
+	{
+		std::uint32_t set = 0;
+		std::uint32_t binding = 0;
+		VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+
+		/** Number of array elements, zero for runtime-sized arrays */
+		std::uint32_t count = 1;
+
+		/** Stages that access the binding */
+		VkShaderStageFlags stages = 0;
+
+		/** Size of the buffer block in bytes, zero for bindings that are not buffers */
+		std::uint32_t block_size = 0;
+
+		std::string name;
+	};
+
+	/** Vertex attribute read by a vertex shader */
+	struct ReflectedVertexInput
+	{
+		std::uint32_t location = 0;
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		std::string name;
+	};
+
+	/** Specialization constant declared by a shader ("layout(constant_id = ...)") */
+	struct ReflectedSpecializationConstant
+	{
+		std::uint32_t constant_id = 0;
+
+		/** Size of the constant in bytes, booleans are four bytes (VkBool32) */
+		std::uint32_t size = 4;
+
+		std::string name;
+	};
+
+	/** Work group dimension that is not backed by a specialization constant */
+	static const constexpr std::uint32_t no_specialization_constant = 0xffffffff;
+
+	/** Resources used by a shader, extracted from its SPIR-V */
+	/**
+	 * Reflection data of multiple shader stages can be merged, the result
+	 * describes all resources a pipeline needs.
+	 */
+	struct ShaderReflection
+	{
+		/** Sorted by set, then by binding */
+		std::vector<ReflectedDescriptorBinding> descriptor_bindings;
+
+		/** At most one range, covering the push constant blocks of all stages */
+		std::vector<VkPushConstantRange> push_constant_ranges;
+
+		/** Sorted by location, only filled for vertex shaders */
+		std::vector<ReflectedVertexInput> vertex_inputs;
+
+		/** Sorted by constant ID */
+		std::vector<ReflectedSpecializationConstant> specialization_constants;
+
+		/** Work group size of compute shaders, all zero for other stages */
+		std::array<std::uint32_t, 3> local_size = { 0, 0, 0 };
+
+		/** Specialization constant ID of every work group dimension declared with "local_size_*_id" */
+		std::array<std::uint32_t, 3> local_size_constant_ids = { no_specialization_constant, no_specialization_constant, no_specialization_constant };
+	};
+
+	/** Extract the resources used by a SPIR-V module */
+	/**
+	 * This is a minimal SPIR-V parser that only looks at names, decorations,
+	 * types, constants, execution modes, and global variables. Throws when
+	 * the bytecode is not valid SPIR-V.
+	 */
+	ShaderReflection ReflectSPIRV(
+		const std::vector<std::uint32_t>& spirv,
+		VkShaderStageFlagBits stage) noexcept(false);
+
+	/** Add the reflection data of a shader stage to the reflection data of a pipeline */
+	/**
+	 * Throws when both stages declare the same binding with different
+	 * descriptor types.
+	 */
+	void MergeShaderReflection(
+		ShaderReflection& pipeline_reflection,
+		const ShaderReflection& stage_reflection) noexcept(false);
+
+	/** Check whether two shaders can use the same descriptor set layouts and pipeline layout */
+	/**
+	 * Compares the descriptor bindings and push constant ranges, names and
+	 * block sizes are allowed to differ.
+	 */
+	bool IsLayoutCompatible(
+		const ShaderReflection& reflection,
+		const ShaderReflection& other_reflection) noexcept(true);
+
+	/** Get the number of descriptor sets a pipeline layout needs, including unused sets in between */
+	std::uint32_t GetDescriptorSetCount(const ShaderReflection& reflection) noexcept(true);
+
+	/** Get the layout bindings of a single descriptor set */
+	/**
+	 * Runtime-sized arrays are given a single descriptor.
+	 */
+	std::vector<VkDescriptorSetLayoutBinding> GetDescriptorSetLayoutBindings(
+		const ShaderReflection& reflection,
+		std::uint32_t set) noexcept(true);
+
+	/** Get the descriptor pool sizes needed to allocate "set_count" copies of every descriptor set */
+	std::vector<VkDescriptorPoolSize> CalculateDescriptorPoolSizes(
+		const ShaderReflection& reflection,
+		std::uint32_t set_count) noexcept(true);
+}
+
+#endif // VULKAN_SHADER_REFLECTION_HPP
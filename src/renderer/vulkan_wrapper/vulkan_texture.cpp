@@ -1,6 +1,7 @@
 // Application
 #include "miscellaneous/exceptions.hpp"
 #include "renderer/memory_manager/memory_manager.hpp"
+#include "vulkan_barrier_batcher.hpp"
 #include "vulkan_device.hpp"
 #include "vulkan_texture.hpp"
 #include "vulkan_utility.hpp"
@@ -9,6 +10,8 @@
 #include <stb_image.h>
 
 // C++ standard
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 using namespace vkc::exception;
@@ -20,6 +23,7 @@ VulkanTexture::VulkanTexture()
 	: m_width(0)
 	, m_height(0)
 	, m_channel_count(0)
+	, m_mip_level_count(1)
 	, m_format(VK_FORMAT_UNDEFINED)
 	, m_image_view(VK_NULL_HANDLE)
 	, m_image(nullptr)
@@ -29,95 +33,322 @@ VulkanTexture::~VulkanTexture()
 {}
 
 void VulkanTexture::Create(
-	const std::string_view path,
+	const TexturePixelData& pixel_data,
 	VkFormat format,
 	const VulkanDevice& device,
-	const VulkanCommandPool& command_pool) noexcept(false)
+	std::uint32_t mip_level_count) noexcept(false)
 {
 	m_format = format;
+	m_width = static_cast<int>(pixel_data.width);
+	m_height = static_cast<int>(pixel_data.height);
+	m_channel_count = static_cast<int>(pixel_data.channel_count);
+	m_mip_level_count = mip_level_count;
 
-	// Load image pixel data from file
-	unsigned char* pixel_data = LoadDataFromFile(path);
+	// Create the Vulkan image object
+	CreateImage();
+
+	// Create an image view for the newly created image
+	CreateImageView(device);
+}
+
+TexturePixelData VulkanTexture::LoadPixelData(const std::string_view path) noexcept(false)
+{
+	// The string view is not guaranteed to be null-terminated
+	const std::string path_str(path);
+
+	int width = 0, height = 0, file_channel_count = 0;
+	unsigned char* data = stbi_load(path_str.c_str(), &width, &height, &file_channel_count, STBI_rgb_alpha);
 
+	if (!data)
+	{
+		// Failed to load the image
+		throw CriticalIOError("Unable to load the texture data at: " + path_str);
+	}
+
+	TexturePixelData pixel_data = {};
+	pixel_data.width = static_cast<std::uint32_t>(width);
+	pixel_data.height = static_cast<std::uint32_t>(height);
+	pixel_data.channel_count = STBI_rgb_alpha;
+	pixel_data.pixels.assign(data, data + (pixel_data.width * pixel_data.height * pixel_data.channel_count));
+
+	// Clean-up the image pixel data
+	stbi_image_free(data);
+
+	return pixel_data;
+}
+
+std::uint32_t VulkanTexture::CalculateMipLevelCount(std::uint32_t width, std::uint32_t height) noexcept(true)
+{
+	std::uint32_t mip_level_count = 1;
+	auto largest_dimension = (std::max)(width, height);
+
+	while (largest_dimension > 1)
+	{
+		largest_dimension /= 2;
+		++mip_level_count;
+	}
+
+	return mip_level_count;
+}
+
+std::vector<TexturePixelData> VulkanTexture::GenerateMipChain(TexturePixelData pixel_data) noexcept(false)
+{
+	auto mip_level_count = CalculateMipLevelCount(pixel_data.width, pixel_data.height);
+
+	std::vector<TexturePixelData> mip_chain;
+	mip_chain.reserve(mip_level_count);
+	mip_chain.push_back(std::move(pixel_data));
+
+	for (std::uint32_t mip_level = 1; mip_level < mip_level_count; ++mip_level)
+	{
+		const auto& source = mip_chain.back();
+
+		TexturePixelData destination = {};
+		destination.width = (std::max)(source.width / 2, 1u);
+		destination.height = (std::max)(source.height / 2, 1u);
+		destination.channel_count = source.channel_count;
+		destination.pixels.resize(destination.width * destination.height * destination.channel_count);
+
+		for (std::uint32_t y = 0; y < destination.height; ++y)
+		{
+			// Clamp to the edge, dimensions that are not a power of two have an odd row or column
+			auto y0 = (std::min)(y * 2, source.height - 1);
+			auto y1 = (std::min)(y * 2 + 1, source.height - 1);
+
+			for (std::uint32_t x = 0; x < destination.width; ++x)
+			{
+				auto x0 = (std::min)(x * 2, source.width - 1);
+				auto x1 = (std::min)(x * 2 + 1, source.width - 1);
+
+				for (std::uint32_t channel = 0; channel < destination.channel_count; ++channel)
+				{
+					auto texel = [&source, channel](std::uint32_t texel_x, std::uint32_t texel_y) {
+						return static_cast<std::uint32_t>(source.pixels[(texel_y * source.width + texel_x) * source.channel_count + channel]);
+					};
+
+					// Box filter, rounded to the nearest value
+					auto sum = texel(x0, y0) + texel(x1, y0) + texel(x0, y1) + texel(x1, y1);
+					destination.pixels[(y * destination.width + x) * destination.channel_count + channel] = static_cast<unsigned char>((sum + 2) / 4);
+				}
+			}
+		}
+
+		mip_chain.push_back(std::move(destination));
+	}
+
+	return mip_chain;
+}
+
+VulkanBuffer VulkanTexture::CreateStagingBuffer(const TexturePixelData& pixel_data) const noexcept(false)
+{
 	// Number of bytes per image color channel
-	std::uint32_t bytes_per_channel = VulkanFormatToBytesPerChannel(format);
+	std::uint32_t bytes_per_channel = VulkanFormatToBytesPerChannel(m_format);
 
 	// Size of the texture data
-	VkDeviceSize data_size = static_cast<VkDeviceSize>(m_width * m_height * m_channel_count * bytes_per_channel);
+	VkDeviceSize data_size = static_cast<VkDeviceSize>(pixel_data.width * pixel_data.height * pixel_data.channel_count * bytes_per_channel);
 
-	// Staging buffer used to upload the texture data to device memory
-	auto texture_staging_buffer = CreateStagingBuffer(data_size);
+	memory::BufferAllocationInfo texture_staging_buffer_info = {};
+	texture_staging_buffer_info.buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	texture_staging_buffer_info.buffer_create_info.size = data_size;
+	texture_staging_buffer_info.buffer_create_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	texture_staging_buffer_info.buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	texture_staging_buffer_info.allocation_info.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+	texture_staging_buffer_info.allocation_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	VulkanBuffer staging_buffer = MemoryManager::GetInstance().Allocate(texture_staging_buffer_info);
 
 	// Copy texture data to the staging buffer
-	memcpy(texture_staging_buffer.info.pMappedData, pixel_data, data_size);
+	std::memcpy(staging_buffer.info.pMappedData, pixel_data.pixels.data(), static_cast<std::size_t>(data_size));
 
-	// Clean-up the image pixel data
-	stbi_image_free(pixel_data);
+	return staging_buffer;
+}
 
-	// Create the Vulkan image object
-	CreateImage();
+VulkanBuffer VulkanTexture::CreateStagingBuffer(
+	const std::vector<TexturePixelData>& mip_chain,
+	std::uint32_t first_mip_level) const noexcept(false)
+{
+	if (first_mip_level + m_mip_level_count > mip_chain.size())
+	{
+		throw CriticalVulkanError("Mip chain does not contain enough levels for this texture.");
+	}
+
+	VkDeviceSize data_size = 0;
+
+	for (std::uint32_t mip_level = 0; mip_level < m_mip_level_count; ++mip_level)
+	{
+		data_size += static_cast<VkDeviceSize>(mip_chain[first_mip_level + mip_level].pixels.size());
+	}
+
+	memory::BufferAllocationInfo texture_staging_buffer_info = {};
+	texture_staging_buffer_info.buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	texture_staging_buffer_info.buffer_create_info.size = data_size;
+	texture_staging_buffer_info.buffer_create_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	texture_staging_buffer_info.buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	texture_staging_buffer_info.allocation_info.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+	texture_staging_buffer_info.allocation_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	VulkanBuffer staging_buffer = MemoryManager::GetInstance().Allocate(texture_staging_buffer_info);
+
+	// Mip levels are tightly packed, most detailed level first
+	auto destination = static_cast<unsigned char*>(staging_buffer.info.pMappedData);
+
+	for (std::uint32_t mip_level = 0; mip_level < m_mip_level_count; ++mip_level)
+	{
+		const auto& pixels = mip_chain[first_mip_level + mip_level].pixels;
+
+		std::memcpy(destination, pixels.data(), pixels.size());
+		destination += pixels.size();
+	}
+
+	return staging_buffer;
+}
+
+void VulkanTexture::RecordUpload(
+	const VkCommandBuffer& command_buffer,
+	const memory::VulkanBuffer& staging_buffer) const noexcept(false)
+{
+	VulkanImageStateTracker image_states;
+	VulkanBarrierBatcher barriers(image_states);
+
+	Track(image_states, image_state::undefined);
 
 	// Transition image layout so it can be used as a copy destination
-	TransitionImageLayout(device, command_pool, m_image->image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	Transition(barriers, image_state::transfer_destination);
+	barriers.Flush(command_buffer);
 
 	// Now that the image can be copied to, copy the staging buffer to the device local memory for the image
-	CopyStagingBufferToDeviceLocal(texture_staging_buffer, device, command_pool);
+	RecordCopyFromBuffer(command_buffer, staging_buffer);
 
 	// Transition image layout so it can be used in the fragment shader to sample from
-	TransitionImageLayout(device, command_pool, m_image->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-	// Create an image view for the newly created image
-	CreateImageView(device);
-
-	// Delete the staging buffer
-	MemoryManager::GetInstance().Free(texture_staging_buffer);
+	Transition(barriers, image_state::fragment_shader_read);
+	barriers.Flush(command_buffer);
 }
 
-void VulkanTexture::Destroy(const VulkanDevice& device)
+void VulkanTexture::Track(
+	VulkanImageStateTracker& tracker,
+	const ImageSubresourceState& state) const noexcept(false)
 {
-	vkDestroyImageView(device.GetLogicalDeviceNative(), m_image_view, nullptr);
-	MemoryManager::GetInstance().Free(*m_image);
+	tracker.Track(m_image->image, m_mip_level_count, 1, VK_IMAGE_ASPECT_COLOR_BIT, state);
 }
 
-const VulkanImage& VulkanTexture::GetImage() const noexcept(true)
+void VulkanTexture::Transition(
+	VulkanBarrierBatcher& batcher,
+	const ImageSubresourceState& new_state,
+	std::uint32_t base_mip_level,
+	std::uint32_t mip_level_count) const noexcept(false)
 {
-	return *m_image;
+	batcher.Transition(m_image->image, new_state, base_mip_level, mip_level_count);
 }
 
-const VkImageView& VulkanTexture::GetImageView() const noexcept(true)
+void VulkanTexture::RecordCopyFromBuffer(
+	const VkCommandBuffer& command_buffer,
+	const memory::VulkanBuffer& staging_buffer) const noexcept(true)
 {
-	return m_image_view;
+	// Number of bytes per image color channel
+	std::uint32_t bytes_per_channel = VulkanFormatToBytesPerChannel(m_format);
+
+	std::vector<VkBufferImageCopy> copy_regions(m_mip_level_count);
+	VkDeviceSize buffer_offset = 0;
+
+	// Mip levels are tightly packed in the staging buffer
+	for (std::uint32_t mip_level = 0; mip_level < m_mip_level_count; ++mip_level)
+	{
+		auto mip_width = (std::max)(static_cast<std::uint32_t>(m_width) >> mip_level, 1u);
+		auto mip_height = (std::max)(static_cast<std::uint32_t>(m_height) >> mip_level, 1u);
+
+		auto& copy_region = copy_regions[mip_level];
+
+		// Padding
+		copy_region.bufferOffset = buffer_offset;
+		copy_region.bufferRowLength = 0;
+		copy_region.bufferImageHeight = 0;
+
+		// Mip and array levels
+		copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copy_region.imageSubresource.baseArrayLayer = 0;
+		copy_region.imageSubresource.mipLevel = mip_level;
+		copy_region.imageSubresource.layerCount = 1;
+
+		// Copy the entire mip level
+		copy_region.imageOffset = { 0, 0, 0 };
+		copy_region.imageExtent = { mip_width, mip_height, 1 };
+
+		buffer_offset += static_cast<VkDeviceSize>(mip_width * mip_height * m_channel_count * bytes_per_channel);
+	}
+
+	// Queue the copy command
+	vkCmdCopyBufferToImage(
+		command_buffer,
+		staging_buffer.buffer,
+		m_image->image,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		static_cast<std::uint32_t>(copy_regions.size()),
+		copy_regions.data());
 }
 
-unsigned char* vkc::vk_wrapper::VulkanTexture::LoadDataFromFile(const std::string_view path) noexcept(false)
+void VulkanTexture::RecordCopyFromTexture(
+	const VkCommandBuffer& command_buffer,
+	const VulkanTexture& source,
+	std::uint32_t source_mip_level) const noexcept(false)
 {
-	// Attempt to load the image from the specified file
-	unsigned char* data = stbi_load(path.data(), &m_width, &m_height, &m_channel_count, 0);
+	if (source_mip_level + m_mip_level_count > source.m_mip_level_count)
+	{
+		throw CriticalVulkanError("Source texture does not contain enough mip levels for this texture.");
+	}
 
-	if (!data)
+	std::vector<VkImageCopy> copy_regions(m_mip_level_count);
+
+	for (std::uint32_t mip_level = 0; mip_level < m_mip_level_count; ++mip_level)
 	{
-		// Failed to load the image
-		throw CriticalIOError("Unable to load the texture data at: " + std::string(path));
+		auto& copy_region = copy_regions[mip_level];
+
+		copy_region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copy_region.srcSubresource.mipLevel = source_mip_level + mip_level;
+		copy_region.srcSubresource.baseArrayLayer = 0;
+		copy_region.srcSubresource.layerCount = 1;
+
+		copy_region.dstSubresource = copy_region.srcSubresource;
+		copy_region.dstSubresource.mipLevel = mip_level;
+
+		copy_region.extent.width = (std::max)(static_cast<std::uint32_t>(m_width) >> mip_level, 1u);
+		copy_region.extent.height = (std::max)(static_cast<std::uint32_t>(m_height) >> mip_level, 1u);
+		copy_region.extent.depth = 1;
 	}
 
-	return data;
+	vkCmdCopyImage(
+		command_buffer,
+		source.m_image->image,
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		m_image->image,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		static_cast<std::uint32_t>(copy_regions.size()),
+		copy_regions.data());
 }
 
-const VulkanBuffer& VulkanTexture::CreateStagingBuffer(const VkDeviceSize buffer_size) noexcept(true)
+void VulkanTexture::Destroy(const VulkanDevice& device)
 {
-	memory::BufferAllocationInfo texture_staging_buffer_info = {};
-	texture_staging_buffer_info.buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-	texture_staging_buffer_info.buffer_create_info.size = buffer_size;
-	texture_staging_buffer_info.buffer_create_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-	texture_staging_buffer_info.buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	vkDestroyImageView(device.GetLogicalDeviceNative(), m_image_view, nullptr);
+	MemoryManager::GetInstance().Free(*m_image);
+}
 
-	texture_staging_buffer_info.allocation_info.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-	texture_staging_buffer_info.allocation_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+const VulkanImage& VulkanTexture::GetImage() const noexcept(true)
+{
+	return *m_image;
+}
+
+const VkImageView& VulkanTexture::GetImageView() const noexcept(true)
+{
+	return m_image_view;
+}
 
-	return MemoryManager::GetInstance().Allocate(texture_staging_buffer_info);
+std::uint32_t VulkanTexture::GetMipLevelCount() const noexcept(true)
+{
+	return m_mip_level_count;
 }
 
-void VulkanTexture::CreateImage() noexcept(true)
+void VulkanTexture::CreateImage() noexcept(false)
 {
 	memory::ImageAllocationInfo texture_image_allocation_info = {};
 	texture_image_allocation_info.image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -125,12 +356,12 @@ void VulkanTexture::CreateImage() noexcept(true)
 	texture_image_allocation_info.image_create_info.extent.width = m_width;
 	texture_image_allocation_info.image_create_info.extent.height = m_height;
 	texture_image_allocation_info.image_create_info.extent.depth = 1;
-	texture_image_allocation_info.image_create_info.mipLevels = 1;
+	texture_image_allocation_info.image_create_info.mipLevels = m_mip_level_count;
 	texture_image_allocation_info.image_create_info.arrayLayers = 1;
 	texture_image_allocation_info.image_create_info.format = m_format;
 	texture_image_allocation_info.image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
 	texture_image_allocation_info.image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	texture_image_allocation_info.image_create_info.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	texture_image_allocation_info.image_create_info.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 	texture_image_allocation_info.image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 	texture_image_allocation_info.image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
 
@@ -139,46 +370,6 @@ void VulkanTexture::CreateImage() noexcept(true)
 	m_image = std::make_unique<VulkanImage>(MemoryManager::GetInstance().Allocate(texture_image_allocation_info));
 }
 
-void vkc::vk_wrapper::VulkanTexture::CopyStagingBufferToDeviceLocal(
-	const memory::VulkanBuffer& staging_buffer,
-	const VulkanDevice& device,
-	const VulkanCommandPool& command_pool)
-{
-	VulkanCommandBuffer cmd_buffer = {};
-	cmd_buffer.Create(device, command_pool, 1);
-	cmd_buffer.BeginRecording(CommandBufferUsage::OneTimeSubmit);
-
-	VkBufferImageCopy copy_region = {};
-
-	// Padding
-	copy_region.bufferOffset = 0;
-	copy_region.bufferRowLength = 0;
-	copy_region.bufferImageHeight = 0;
-
-	// Mip and array levels
-	copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	copy_region.imageSubresource.baseArrayLayer = 0;
-	copy_region.imageSubresource.mipLevel = 0;
-	copy_region.imageSubresource.layerCount = 1;
-
-	// Copy the entire image
-	copy_region.imageOffset = { 0, 0, 0 };
-	copy_region.imageExtent = { static_cast<std::uint32_t>(m_width), static_cast<std::uint32_t>(m_height), 1 };
-
-	// Queue the copy command
-	vkCmdCopyBufferToImage(cmd_buffer.GetNative(), staging_buffer.buffer, m_image->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy_region);
-
-	auto graphics_queue = device.GetQueueNativeOfType(VulkanQueueType::Graphics);
-
-	// Execute the staging buffer to device local memory copy
-	cmd_buffer.StopRecording();
-	cmd_buffer.Submit(graphics_queue);
-	vkQueueWaitIdle(graphics_queue);
-
-	// Command buffer is no longer needed
-	cmd_buffer.Destroy(device, command_pool);
-}
-
 void VulkanTexture::CreateImageView(const VulkanDevice& device) noexcept(false)
 {
 	VkImageViewCreateInfo create_info = {};
@@ -188,7 +379,7 @@ void VulkanTexture::CreateImageView(const VulkanDevice& device) noexcept(false)
 	create_info.format = m_format;
 	create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 	create_info.subresourceRange.layerCount = 1;
-	create_info.subresourceRange.levelCount = 1;
+	create_info.subresourceRange.levelCount = m_mip_level_count;
 	create_info.subresourceRange.baseArrayLayer = 0;
 	create_info.subresourceRange.baseMipLevel = 0;
 	create_info.components = {
@@ -1,12 +1,17 @@
 #ifndef VULKAN_TEXTURE_HPP
 #define VULKAN_TEXTURE_HPP
 
+// Application
+#include "vulkan_image_state_tracker.hpp"
+
 // Vulkan
 #include <vulkan/vulkan.h>
 
 // C++ standard
+#include <cstdint>
 #include <memory>
 #include <string_view>
+#include <vector>
 
 namespace vkc
 {
@@ -18,9 +23,24 @@ namespace vkc
 
 	namespace vk_wrapper
 	{
-		class VulkanCommandPool;
+		class VulkanBarrierBatcher;
 		class VulkanDevice;
 
+		/** Decoded texture pixels that are not tied to any Vulkan object yet */
+		/**
+		 * Pixel data can be loaded on any thread, which makes it possible to
+		 * decode image files on worker threads and create the Vulkan objects
+		 * on the render thread later on.
+		 */
+		struct TexturePixelData
+		{
+			std::uint32_t width = 0;
+			std::uint32_t height = 0;
+			std::uint32_t channel_count = 0;
+
+			std::vector<unsigned char> pixels;
+		};
+
 		/**
 		 * Class used to wrap all image-related Vulkan calls.
 		 * Things such as image views, memory management, etc. are all taken care of.
@@ -31,12 +51,98 @@ namespace vkc
 			VulkanTexture();
 			~VulkanTexture();
 
-			/** Create a Vulkan texture from the specified image file */
+			/** Create an (uninitialized) Vulkan texture that matches the specified pixel data */
+			/**
+			 * Only the image and image view are created, no data is uploaded.
+			 * Use "CreateStagingBuffer" and "RecordUpload" to upload the pixel
+			 * data using a command buffer owned by the caller.
+			 *
+			 * The pixel data describes the most detailed mip level of the image,
+			 * "mip_level_count" levels are allocated starting from there.
+			 */
 			void Create(
-				const std::string_view path,
+				const TexturePixelData& pixel_data,
 				VkFormat format,
 				const VulkanDevice& device,
-				const VulkanCommandPool& command_pool) noexcept(false);
+				std::uint32_t mip_level_count = 1) noexcept(false);
+
+			/** Load the pixel data from the specified file (thread-safe), will throw when the file cannot be read from */
+			/**
+			 * Pixels are always expanded to four channels per pixel.
+			 */
+			static TexturePixelData LoadPixelData(const std::string_view path) noexcept(false);
+
+			/** Get the number of mip levels of a full mip chain for an image of the specified size */
+			static std::uint32_t CalculateMipLevelCount(std::uint32_t width, std::uint32_t height) noexcept(true);
+
+			/** Generate a full mip chain on the CPU by averaging 2x2 blocks of pixels (thread-safe) */
+			/**
+			 * The first element of the returned vector is the specified pixel
+			 * data, every next element is half the size of the previous one,
+			 * down to a 1x1 image.
+			 */
+			static std::vector<TexturePixelData> GenerateMipChain(TexturePixelData pixel_data) noexcept(false);
+
+			/** Create a staging buffer that holds a copy of the pixel data */
+			/**
+			 * The caller owns the staging buffer and has to free it once the
+			 * upload recorded by "RecordUpload" has finished executing.
+			 */
+			memory::VulkanBuffer CreateStagingBuffer(const TexturePixelData& pixel_data) const noexcept(false);
+
+			/** Create a staging buffer that holds a copy of every mip level of this texture */
+			/**
+			 * "first_mip_level" is the index in the mip chain of the most
+			 * detailed level of this texture, the levels are stored one after
+			 * another in the staging buffer.
+			 */
+			memory::VulkanBuffer CreateStagingBuffer(
+				const std::vector<TexturePixelData>& mip_chain,
+				std::uint32_t first_mip_level) const noexcept(false);
+
+			/** Record the commands that copy the staging buffer to the image */
+			/**
+			 * The image is transitioned to a transfer destination, the staging
+			 * buffer is copied to it, and the image is transitioned to a
+			 * shader read-only layout afterwards.
+			 *
+			 * To upload many textures with a single barrier before and after the
+			 * copies, "Track" and "Transition" them through a shared barrier
+			 * batcher, and record the copies with "RecordCopyFromBuffer".
+			 */
+			void RecordUpload(
+				const VkCommandBuffer& command_buffer,
+				const memory::VulkanBuffer& staging_buffer) const noexcept(false);
+
+			/** Start tracking the state of every mip level of this texture */
+			void Track(
+				VulkanImageStateTracker& tracker,
+				const ImageSubresourceState& state) const noexcept(false);
+
+			/** Add the barrier that transitions a range of mip levels of this (tracked) texture to a new state */
+			/**
+			 * Nothing is recorded until the batcher is flushed.
+			 */
+			void Transition(
+				VulkanBarrierBatcher& batcher,
+				const ImageSubresourceState& new_state,
+				std::uint32_t base_mip_level = 0,
+				std::uint32_t mip_level_count = VK_REMAINING_MIP_LEVELS) const noexcept(false);
+
+			/** Record the copy of the staging buffer to every mip level, the image has to be a transfer destination */
+			void RecordCopyFromBuffer(
+				const VkCommandBuffer& command_buffer,
+				const memory::VulkanBuffer& staging_buffer) const noexcept(true);
+
+			/** Record the copy of the mip levels of another texture, starting at "source_mip_level" */
+			/**
+			 * The source has to be a transfer source and this texture a transfer
+			 * destination, the caller records the transitions through "Transition".
+			 */
+			void RecordCopyFromTexture(
+				const VkCommandBuffer& command_buffer,
+				const VulkanTexture& source,
+				std::uint32_t source_mip_level) const noexcept(false);
 
 			/** Destroy allocated resources */
 			void Destroy(const VulkanDevice& device);
@@ -47,21 +153,12 @@ namespace vkc
 			/** Get a reference to the image view backing this texture */
 			const VkImageView& GetImageView() const noexcept(true);
 
-		private:
-			/** Load the pixel data from the specified file, will throw when the file cannot be read from */
-			unsigned char* LoadDataFromFile(const std::string_view path) noexcept(false);
-
-			/** Create a staging buffer to use it to upload the texture to device memory */
-			const memory::VulkanBuffer& CreateStagingBuffer(const VkDeviceSize buffer_size) noexcept(true);
+			/** Get the number of mip levels of this texture */
+			std::uint32_t GetMipLevelCount() const noexcept(true);
 
+		private:
 			/** Create a Vulkan image object */
-			void CreateImage() noexcept(true);
-
-			/** Copy the staging buffer to the image device memory */
-			void CopyStagingBufferToDeviceLocal(
-				const memory::VulkanBuffer& staging_buffer,
-				const VulkanDevice& device,
-				const VulkanCommandPool& command_pool);
+			void CreateImage() noexcept(false);
 
 			/** Create an image view for this image */
 			void CreateImageView(const VulkanDevice& device) noexcept(false);
@@ -71,6 +168,8 @@ namespace vkc
 			int m_height;
 			int m_channel_count;
 
+			std::uint32_t m_mip_level_count;
+
 			VkFormat m_format;
 			VkImageView m_image_view;
 
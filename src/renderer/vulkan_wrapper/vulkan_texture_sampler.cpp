@@ -1,4 +1,5 @@
 // Application
+#include "core/hash.hpp"
 #include "miscellaneous/exceptions.hpp"
 #include "vulkan_device.hpp"
 #include "vulkan_texture_sampler.hpp"
@@ -58,3 +59,44 @@ const VkSampler& VulkanTextureSampler::GetNative() const noexcept(true)
 {
 	return m_sampler;
 }
+
+bool vkc::vk_wrapper::operator==(const TextureSamplerSettings& lhs, const TextureSamplerSettings& rhs) noexcept(true)
+{
+	return (
+		lhs.min_filter == rhs.min_filter &&
+		lhs.mag_filter == rhs.mag_filter &&
+		lhs.behavior_u == rhs.behavior_u &&
+		lhs.behavior_v == rhs.behavior_v &&
+		lhs.behavior_w == rhs.behavior_w &&
+		lhs.anisotropy_enabled == rhs.anisotropy_enabled &&
+		lhs.anisotropy_value == rhs.anisotropy_value &&
+		lhs.mipmap_mode == rhs.mipmap_mode &&
+		lhs.mipmap_lod_bias == rhs.mipmap_lod_bias &&
+		lhs.min_lod == rhs.min_lod &&
+		lhs.max_lod == rhs.max_lod &&
+		lhs.use_normalized_coordinates == rhs.use_normalized_coordinates &&
+		lhs.comparison_enabled == rhs.comparison_enabled &&
+		lhs.compare_operation == rhs.compare_operation);
+}
+
+std::size_t TextureSamplerSettingsHash::operator()(const TextureSamplerSettings& settings) const noexcept(true)
+{
+	std::uint64_t hash = core::fnv1a_offset_basis;
+
+	core::HashCombine(hash, settings.min_filter);
+	core::HashCombine(hash, settings.mag_filter);
+	core::HashCombine(hash, settings.behavior_u);
+	core::HashCombine(hash, settings.behavior_v);
+	core::HashCombine(hash, settings.behavior_w);
+	core::HashCombine(hash, settings.anisotropy_enabled);
+	core::HashCombine(hash, settings.anisotropy_value);
+	core::HashCombine(hash, settings.mipmap_mode);
+	core::HashCombine(hash, settings.mipmap_lod_bias);
+	core::HashCombine(hash, settings.min_lod);
+	core::HashCombine(hash, settings.max_lod);
+	core::HashCombine(hash, settings.use_normalized_coordinates);
+	core::HashCombine(hash, settings.comparison_enabled);
+	core::HashCombine(hash, settings.compare_operation);
+
+	return static_cast<std::size_t>(hash);
+}
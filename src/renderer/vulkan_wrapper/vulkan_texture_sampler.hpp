@@ -4,6 +4,9 @@
 // Vulkan
 #include <vulkan/vulkan.h>
 
+// C++ standard
+#include <cstddef>
+
 namespace vkc::vk_wrapper
 {
 	// Forward declarations
@@ -94,6 +97,15 @@ namespace vkc::vk_wrapper
 		SamplerCompareOperation compare_operation = SamplerCompareOperation::Always;
 	};
 
+	/** Two sampler settings are equal when they would create identical samplers */
+	bool operator==(const TextureSamplerSettings& lhs, const TextureSamplerSettings& rhs) noexcept(true);
+
+	/** Hash function object, allows sampler settings to be used as a key in unordered containers */
+	struct TextureSamplerSettingsHash
+	{
+		std::size_t operator()(const TextureSamplerSettings& settings) const noexcept(true);
+	};
+
 	/** Wrapper class that handles texture sampler creation */
     class VulkanTextureSampler
     {
@@ -6,9 +6,13 @@
 #include "vulkan_command_buffer.hpp"
 #include "vulkan_command_pool.hpp"
 #include "vulkan_device.hpp"
+#include "vulkan_pipeline.hpp"
 
 // C++ standard
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace vkc::vk_wrapper::utility
@@ -70,76 +74,52 @@ namespace vkc::vk_wrapper::utility
 		return true;
 	}
 
-	/** Transition an image layout from the current layout to a new layout */
-	inline void TransitionImageLayout(
-		const VulkanDevice& device,
-		const VulkanCommandPool& command_pool,
-		const VkImage& image,
-		VkImageLayout current_layout,
-		VkImageLayout new_layout) noexcept(false)
+	/** Record a push constant update that copies a whole struct into push constant memory */
+	/**
+	 * The struct needs to match the layout of the push constant block in the
+	 * shaders, "stages" needs to contain every stage of the pipeline layout
+	 * range that overlaps the written bytes.
+	 */
+	template<typename T>
+	inline void RecordPushConstants(
+		const VkCommandBuffer& command_buffer,
+		VkPipelineLayout pipeline_layout,
+		VkShaderStageFlags stages,
+		const T& data,
+		std::uint32_t offset = 0) noexcept(true)
 	{
-		VulkanCommandBuffer cmd_buffer = {};
-		cmd_buffer.Create(device, command_pool, 1);
-		cmd_buffer.BeginRecording(CommandBufferUsage::OneTimeSubmit);
-
-		VkPipelineStageFlags source_stage = {}, destination_stage = {};
-
-		VkImageMemoryBarrier barrier = {};
-		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-		barrier.oldLayout = current_layout;
-		barrier.newLayout = new_layout;
-		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.image = image;
-		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		barrier.subresourceRange.layerCount = 1;
-		barrier.subresourceRange.levelCount = 1;
-		barrier.subresourceRange.baseArrayLayer = 0;
-		barrier.subresourceRange.baseMipLevel = 0;
+		static_assert(std::is_trivially_copyable_v<T>, "Push constant data is copied byte for byte.");
+		static_assert(sizeof(T) % 4 == 0, "Push constant data size needs to be a multiple of four.");
+		static_assert(sizeof(T) <= 128, "Push constant data does not fit in the guaranteed 128 bytes of push constant memory.");
 
-		if (current_layout == VK_IMAGE_LAYOUT_UNDEFINED && new_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-		{
-			barrier.srcAccessMask = 0;
-			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPushConstants(command_buffer, pipeline_layout, stages, offset, static_cast<std::uint32_t>(sizeof(T)), &data);
+	}
 
-			source_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-			destination_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		}
-		else if (current_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && new_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-		{
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	/** Record a dispatch of a compute pipeline that covers at least the specified number of invocations */
+	/**
+	 * The number of work groups is rounded up in every dimension, the shader
+	 * needs to skip the invocations that fall outside of the range itself.
+	 */
+	inline void RecordDispatch(
+		const VkCommandBuffer& command_buffer,
+		const VulkanPipeline& compute_pipeline,
+		std::uint32_t invocation_count_x,
+		std::uint32_t invocation_count_y = 1,
+		std::uint32_t invocation_count_z = 1) noexcept(true)
+	{
+		const auto& local_size = compute_pipeline.GetLocalSize();
 
-			source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-			destination_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-		}
-		else
+		const auto group_count = [](std::uint32_t invocation_count, std::uint32_t group_size)
 		{
-			throw exception::CriticalVulkanError("Unsupported image layout transition.");
-		}
-
-		// Record the transition commands
-		vkCmdPipelineBarrier(
-			cmd_buffer.GetNative(),
-			source_stage,
-			destination_stage,
-			0,	// Flags
-			0,	// No memory barriers
-			nullptr,
-			0,	// No buffer memory barriers
-			nullptr,
-			1,	// One image barrier
-			&barrier);
-
-		auto graphics_queue = device.GetQueueNativeOfType(VulkanQueueType::Graphics);
-		
-		// Execute the commands on the graphics queue
-		cmd_buffer.StopRecording();
-		cmd_buffer.Submit(graphics_queue);
-		vkQueueWaitIdle(graphics_queue);
+			group_size = std::max(group_size, 1u);
+			return (invocation_count + group_size - 1) / group_size;
+		};
 
-		// Command buffer is no longer needed
-		cmd_buffer.Destroy(device, command_pool);
+		vkCmdDispatch(
+			command_buffer,
+			group_count(invocation_count_x, local_size[0]),
+			group_count(invocation_count_y, local_size[1]),
+			group_count(invocation_count_z, local_size[2]));
 	}
 
 	/** Get the number of bits per channel from a VkFormat (some uncommon formats have been excluded, invalid format == 0) */
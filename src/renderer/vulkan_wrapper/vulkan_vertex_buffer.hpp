@@ -3,9 +3,9 @@
 
 // Application
 #include "renderer/memory_manager/memory_manager.hpp"
-#include "vulkan_command_pool.hpp"
 #include "vulkan_device.hpp"
 #include "vulkan_functions.hpp"
+#include "vulkan_immediate_submit_context.hpp"
 
 // Vulkan
 #include <vulkan/vulkan.h>
@@ -26,8 +26,8 @@ namespace vkc::vk_wrapper
 		template<class VERTEX>
 		void Create(
 			const VulkanDevice& device,
-			const VulkanCommandPool& command_pool,
-			const std::vector<VERTEX>& vertices) noexcept(true);
+			VulkanImmediateSubmitContext& immediate_submit,
+			const std::vector<VERTEX>& vertices) noexcept(false);
 
 		/** Free the allocated vertex buffer memory */
 		void Destroy() const noexcept(true);
@@ -42,8 +42,8 @@ namespace vkc::vk_wrapper
 	template<class VERTEX>
 	inline void VulkanVertexBuffer::Create(
 		const VulkanDevice& device,
-		const VulkanCommandPool& command_pool,
-		const std::vector<VERTEX>& vertices) noexcept(true)
+		VulkanImmediateSubmitContext& immediate_submit,
+		const std::vector<VERTEX>& vertices) noexcept(false)
 	{
 		VkDeviceSize buffer_size = sizeof(VERTEX) * vertices.size();
 
@@ -74,7 +74,7 @@ namespace vkc::vk_wrapper
 		m_vertex_buffer = memory::MemoryManager::GetInstance().Allocate(vertex_buffer_alloc_info);
 
 		// Copy the staging buffer to device local memory
-		func::CopyHostVisibleBufferToDeviceLocalBuffer(device, command_pool, staging_buffer, m_vertex_buffer);
+		func::CopyHostVisibleBufferToDeviceLocalBuffer(device, immediate_submit, staging_buffer, m_vertex_buffer);
 
 		// No need to keep the staging buffer around anymore
 		memory::MemoryManager::GetInstance().Free(staging_buffer);
@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////////
+
+// Application renderer
+#include "renderer/vulkan_wrapper/vulkan_barrier_batcher.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <cstdint>
+
+//////////////////////////////////////////////////////////////////////////
+
+using namespace vkc::vk_wrapper;
+
+namespace
+{
+	/** The tracker and the batcher never touch the image itself, any handle works as a key */
+	static const VkImage test_image = VK_NULL_HANDLE;
+
+	int failure_count = 0;
+
+	void Check(bool condition, const char* description)
+	{
+		if (!condition)
+		{
+			spdlog::error("    FAILED: {}", description);
+			++failure_count;
+		}
+	}
+
+	/** Transition the test image, and return the number of barriers that were needed, barriers are dropped as if they had been flushed */
+	std::uint32_t Transition(VulkanBarrierBatcher& batcher, const ImageSubresourceState& new_state)
+	{
+		batcher.Transition(test_image, new_state);
+
+		const auto barrier_count = batcher.GetPendingBarrierCount();
+		batcher.Reset();
+
+		return barrier_count;
+	}
+
+	/** A read by another stage in the same layout still has to wait for the last write */
+	void TestReadAfterWriteByAnotherStage()
+	{
+		spdlog::info("Transfer write, fragment shader read, compute shader read:");
+
+		VulkanImageStateTracker tracker;
+		VulkanBarrierBatcher batcher(tracker);
+		tracker.Track(test_image, 1, 1, VK_IMAGE_ASPECT_COLOR_BIT);
+
+		Check(Transition(batcher, image_state::transfer_destination) == 1, "the transfer write needs a barrier");
+		Check(Transition(batcher, image_state::fragment_shader_read) == 1, "the fragment shader read needs a barrier");
+
+		const auto state = tracker.GetState(test_image, 0);
+
+		Check(NeedsImageBarrier(state, image_state::compute_shader_read), "the compute shader read needs a barrier");
+		Check((GetBarrierSourceStageMask(state) & VK_PIPELINE_STAGE_TRANSFER_BIT) != 0, "the barrier waits for the transfer stage");
+		Check(GetBarrierSourceAccessMask(state) == VK_ACCESS_TRANSFER_WRITE_BIT, "the barrier makes the transfer write available");
+		Check(Transition(batcher, image_state::compute_shader_read) == 1, "the batcher records a barrier for the compute shader read");
+
+		// Both shader stages have seen the write now
+		Check(Transition(batcher, image_state::fragment_shader_read) == 0, "a second fragment shader read needs no barrier");
+		Check(Transition(batcher, image_state::compute_shader_read) == 0, "a second compute shader read needs no barrier");
+	}
+
+	/** A write has to wait for every read since the last barrier */
+	void TestWriteAfterReads()
+	{
+		spdlog::info("Fragment and compute shader reads, transfer write:");
+
+		VulkanImageStateTracker tracker;
+		VulkanBarrierBatcher batcher(tracker);
+		tracker.Track(test_image, 1, 1, VK_IMAGE_ASPECT_COLOR_BIT);
+
+		Transition(batcher, image_state::transfer_destination);
+		Transition(batcher, image_state::fragment_shader_read);
+		Transition(batcher, image_state::compute_shader_read);
+		Transition(batcher, image_state::fragment_shader_read);
+
+		const auto state = tracker.GetState(test_image, 0);
+		const auto source_stages = GetBarrierSourceStageMask(state);
+
+		Check((source_stages & VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT) != 0, "the write waits for the fragment shader read");
+		Check((source_stages & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT) != 0, "the write waits for the compute shader read");
+		Check(Transition(batcher, image_state::transfer_destination) == 1, "the transfer write needs a barrier");
+	}
+}
+
+int main()
+{
+	TestReadAfterWriteByAnotherStage();
+	TestWriteAfterReads();
+
+	if (failure_count > 0)
+	{
+		spdlog::error("{} check(s) failed.", failure_count);
+		return 1;
+	}
+
+	spdlog::info("All checks passed.");
+	return 0;
+}
@@ -0,0 +1,169 @@
+//////////////////////////////////////////////////////////////////////////
+
+// Application core
+#include "core/thread_pool.hpp"
+
+// Application renderer
+#include "renderer/frustum_culler.hpp"
+
+// GLM
+#include <glm/gtc/matrix_transform.hpp>
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+
+using namespace vkc;
+
+namespace
+{
+	/** Object counts the culler is benchmarked with */
+	static const constexpr std::uint32_t object_counts[] = { 100000, 1000000 };
+
+	/** Timed culls per configuration, the first cull of every configuration is a warm-up */
+	static const constexpr std::uint32_t default_iteration_count = 50;
+
+	const char* GetImplementationName(CullingImplementation implementation)
+	{
+		switch (implementation)
+		{
+		case CullingImplementation::SSE:
+			return "SSE";
+
+		case CullingImplementation::AVX2:
+			return "AVX2";
+
+		default:
+			return "scalar";
+		}
+	}
+
+	/** Objects of all sizes scattered around the camera, about one in twenty ends up inside of the frustum */
+	void AddRandomObjects(FrustumCuller& culler, std::uint32_t object_count)
+	{
+		// Fixed seed, every run culls the same scene
+		std::mt19937 generator(1337);
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		std::uniform_real_distribution<float> extent(0.1f, 5.0f);
+
+		for (std::uint32_t object = 0; object < object_count; ++object)
+		{
+			const auto center = glm::vec3(position(generator), position(generator), position(generator));
+			const auto extents = glm::vec3(extent(generator), extent(generator), extent(generator));
+
+			culler.Add(center, extents);
+		}
+	}
+
+	/** Average time of a single cull in milliseconds */
+	double MeasureCull(
+		FrustumCuller& culler,
+		const glm::mat4& view_projection_matrix,
+		core::ThreadPool* thread_pool,
+		std::uint32_t iteration_count)
+	{
+		culler.Cull(view_projection_matrix, thread_pool);
+
+		const auto start = std::chrono::steady_clock::now();
+
+		for (std::uint32_t iteration = 0; iteration < iteration_count; ++iteration)
+		{
+			culler.Cull(view_projection_matrix, thread_pool);
+		}
+
+		const auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+		return duration.count() / static_cast<double>(iteration_count);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	auto iteration_count = default_iteration_count;
+
+	if (argc > 2)
+	{
+		spdlog::info("Usage: CullBenchmark [iteration count]");
+		return 1;
+	}
+
+	if (argc == 2)
+	{
+		iteration_count = static_cast<std::uint32_t>(std::stoul(argv[1]));
+
+		if (iteration_count == 0)
+		{
+			spdlog::error("The iteration count has to be at least one.");
+			return 1;
+		}
+	}
+
+	core::ThreadPool thread_pool;
+	thread_pool.Create();
+
+	const auto view_matrix = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const auto projection_matrix = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 400.0f);
+	const auto view_projection_matrix = projection_matrix * view_matrix;
+
+	const CullingImplementation implementations[] = { CullingImplementation::Scalar, CullingImplementation::SSE, CullingImplementation::AVX2 };
+
+	int exit_code = 0;
+
+	for (const auto object_count : object_counts)
+	{
+		FrustumCuller culler;
+		AddRandomObjects(culler, object_count);
+
+		// Every implementation has to agree with the single-threaded scalar one
+		culler.SetImplementation(CullingImplementation::Scalar);
+		const auto reference_visible_objects = culler.Cull(view_projection_matrix);
+		double reference_time_ms = 0.0;
+
+		spdlog::info("{} object(s), {} visible:", object_count, reference_visible_objects.size());
+
+		for (const auto implementation : implementations)
+		{
+			if (!culler.SetImplementation(implementation))
+			{
+				spdlog::info("    {} is not supported by this CPU.", GetImplementationName(implementation));
+				continue;
+			}
+
+			for (const auto use_worker_threads : { false, true })
+			{
+				auto* worker_threads = use_worker_threads ? &thread_pool : nullptr;
+				const auto time_ms = MeasureCull(culler, view_projection_matrix, worker_threads, iteration_count);
+
+				if (culler.Cull(view_projection_matrix, worker_threads) != reference_visible_objects)
+				{
+					spdlog::error("    {} produced a different visible list.", GetImplementationName(implementation));
+					exit_code = 1;
+				}
+
+				if (reference_time_ms == 0.0)
+				{
+					reference_time_ms = time_ms;
+				}
+
+				spdlog::info(
+					"    {:<6} {:<22} {:8.3f} ms, {:7.1f} M object(s) per second, {:5.1f}x",
+					GetImplementationName(implementation),
+					use_worker_threads ? fmt::format("({} worker thread(s))", thread_pool.GetThreadCount()) : std::string("(calling thread)"),
+					time_ms,
+					static_cast<double>(object_count) / (time_ms * 1000.0),
+					reference_time_ms / time_ms);
+			}
+		}
+	}
+
+	thread_pool.Destroy();
+
+	return exit_code;
+}
@@ -0,0 +1,281 @@
+//////////////////////////////////////////////////////////////////////////
+
+// Application core
+#include "core/thread_pool.hpp"
+
+// Application renderer
+#include "renderer/vulkan_wrapper/vulkan_shader_bundle.hpp"
+#include "renderer/vulkan_wrapper/vulkan_shader_compiler.hpp"
+
+// Application miscellaneous
+#include "miscellaneous/exceptions.hpp"
+
+// Spdlog
+#include <spdlog/spdlog.h>
+
+// C++ standard
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+
+using namespace vkc;
+
+namespace
+{
+	/** Shader stage listed in the manifest */
+	struct BakeRequest
+	{
+		std::string path;
+		std::vector<std::string> defines;
+		std::string key;
+	};
+
+	/** Compiled stage, and the files it was compiled from */
+	struct BakedStage
+	{
+		std::vector<std::uint32_t> spirv;
+
+		/** Source file followed by every included file, the renderer hashes them again to detect stale stages */
+		std::vector<std::string> dependencies;
+		std::uint64_t source_hash = 0;
+	};
+
+	/** Compile a stage and hash the sources it was compiled from */
+	BakedStage BakeStage(const BakeRequest& request, const vk_wrapper::GlslCompileOptions& options)
+	{
+		BakedStage stage = {};
+		stage.dependencies.push_back(request.path);
+		stage.spirv = vk_wrapper::CompileGLSL(request.path, request.defines, stage.dependencies, options);
+
+		if (!vk_wrapper::VulkanShaderBundle::HashSourceFiles(stage.dependencies, stage.source_hash))
+		{
+			throw exception::CriticalIOError("Could not read the sources of a shader stage.");
+		}
+
+		return stage;
+	}
+
+	/** Read the stages to bake, one per line: "<path> [DEFINE | DEFINE=VALUE ...]" */
+	std::vector<BakeRequest> ReadManifest(const std::string& manifest_path)
+	{
+		std::ifstream manifest(manifest_path);
+
+		if (!manifest.is_open())
+		{
+			throw exception::CriticalIOError("Could not open the shader manifest.");
+		}
+
+		std::vector<BakeRequest> requests;
+		std::string line;
+
+		while (std::getline(manifest, line))
+		{
+			std::istringstream tokens(line);
+			BakeRequest request = {};
+
+			// Empty lines and comments
+			if (!(tokens >> request.path) || request.path.front() == '#')
+			{
+				continue;
+			}
+
+			for (std::string define; tokens >> define;)
+			{
+				request.defines.push_back(define);
+			}
+
+			request.key = vk_wrapper::VulkanShaderBundle::MakeKey(request.path, request.defines);
+			requests.push_back(request);
+		}
+
+		// The bundle is searched with a binary search on the keys
+		std::sort(
+			requests.begin(),
+			requests.end(),
+			[](const BakeRequest& request, const BakeRequest& other_request)
+			{
+				return request.key < other_request.key;
+			});
+
+		requests.erase(
+			std::unique(
+				requests.begin(),
+				requests.end(),
+				[](const BakeRequest& request, const BakeRequest& other_request)
+				{
+					return request.key == other_request.key;
+				}),
+			requests.end());
+
+		return requests;
+	}
+
+	/** Write the header, the entries, the keys, the dependencies, and the SPIR-V of every stage */
+	void WriteBundle(
+		const std::string& bundle_path,
+		const std::vector<BakeRequest>& requests,
+		const std::vector<BakedStage>& stages)
+	{
+		vk_wrapper::ShaderBundleHeader header = {};
+		header.entry_count = static_cast<std::uint32_t>(requests.size());
+
+		std::vector<vk_wrapper::ShaderBundleEntry> entries(requests.size());
+		std::uint32_t offset = static_cast<std::uint32_t>(sizeof(header) + sizeof(vk_wrapper::ShaderBundleEntry) * entries.size());
+
+		for (std::size_t index = 0; index < requests.size(); ++index)
+		{
+			entries[index].key_offset = offset;
+			entries[index].key_size = static_cast<std::uint32_t>(requests[index].key.size());
+			offset += entries[index].key_size;
+		}
+
+		// Dependencies of a stage are stored as a single newline separated string
+		std::vector<std::string> dependencies(stages.size());
+
+		for (std::size_t index = 0; index < stages.size(); ++index)
+		{
+			for (const auto& dependency : stages[index].dependencies)
+			{
+				dependencies[index] += (dependencies[index].empty() ? "" : "\n") + dependency;
+			}
+
+			entries[index].dependencies_offset = offset;
+			entries[index].dependencies_size = static_cast<std::uint32_t>(dependencies[index].size());
+			entries[index].source_hash = stages[index].source_hash;
+			offset += entries[index].dependencies_size;
+		}
+
+		// SPIR-V is read in place through the memory mapping, so every module starts at a four byte boundary
+		const auto strings_end = offset;
+		offset = (offset + 3u) & ~3u;
+		const auto padding_size = offset - strings_end;
+
+		for (std::size_t index = 0; index < requests.size(); ++index)
+		{
+			entries[index].spirv_offset = offset;
+			entries[index].spirv_word_count = static_cast<std::uint32_t>(stages[index].spirv.size());
+			offset += entries[index].spirv_word_count * static_cast<std::uint32_t>(sizeof(std::uint32_t));
+		}
+
+		std::ofstream bundle(bundle_path, std::ios::binary | std::ios::trunc);
+
+		if (!bundle.is_open())
+		{
+			throw exception::CriticalIOError("Could not write the shader bundle.");
+		}
+
+		bundle.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		bundle.write(reinterpret_cast<const char*>(entries.data()), sizeof(vk_wrapper::ShaderBundleEntry) * entries.size());
+
+		for (const auto& request : requests)
+		{
+			bundle.write(request.key.data(), request.key.size());
+		}
+
+		for (const auto& stage_dependencies : dependencies)
+		{
+			bundle.write(stage_dependencies.data(), stage_dependencies.size());
+		}
+
+		const char padding[4] = {};
+		bundle.write(padding, padding_size);
+
+		for (const auto& stage : stages)
+		{
+			bundle.write(reinterpret_cast<const char*>(stage.spirv.data()), sizeof(std::uint32_t) * stage.spirv.size());
+		}
+
+		spdlog::info("Wrote {} shader stage(s) ({} byte(s)) to \"{}\".", requests.size(), offset, bundle_path);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		spdlog::info("Usage: ShaderBaker <manifest> <output bundle> [--optimize] [--strip]");
+		return 1;
+	}
+
+	const std::string manifest_path = argv[1];
+	const std::string bundle_path = argv[2];
+
+	vk_wrapper::GlslCompileOptions options = {};
+
+	for (int index = 3; index < argc; ++index)
+	{
+		const std::string argument = argv[index];
+
+		if (argument == "--optimize")
+		{
+			options.optimize = true;
+		}
+		else if (argument == "--strip")
+		{
+			options.strip_debug_info = true;
+		}
+		else
+		{
+			spdlog::error("Unknown argument \"{}\".", argument);
+			return 1;
+		}
+	}
+
+	core::ThreadPool thread_pool;
+	thread_pool.Create();
+
+	int exit_code = 0;
+
+	try
+	{
+		const auto requests = ReadManifest(manifest_path);
+
+		// Every stage is compiled on its own worker thread
+		std::vector<std::future<BakedStage>> jobs;
+
+		for (const auto& request : requests)
+		{
+			jobs.push_back(thread_pool.Enqueue(
+				[&request, &options]()
+				{
+					return BakeStage(request, options);
+				}));
+		}
+
+		std::vector<BakedStage> stages;
+
+		for (std::size_t index = 0; index < jobs.size(); ++index)
+		{
+			try
+			{
+				stages.push_back(jobs[index].get());
+				spdlog::info("Baked \"{}\" ({} byte(s)).", requests[index].key, stages.back().spirv.size() * sizeof(std::uint32_t));
+			}
+			catch (...)
+			{
+				spdlog::error("Could not bake \"{}\".", requests[index].key);
+				exit_code = 1;
+			}
+		}
+
+		if (exit_code == 0)
+		{
+			WriteBundle(bundle_path, requests, stages);
+		}
+	}
+	catch (exception::CriticalIOError& error)
+	{
+		spdlog::error(error.what());
+		exit_code = 1;
+	}
+
+	thread_pool.Destroy();
+
+	return exit_code;
+}